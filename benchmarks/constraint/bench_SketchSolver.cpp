@@ -0,0 +1,346 @@
+// Constraint solver benchmark.
+//
+// Generates synthetic sketches of increasing size and times each stage of a solve,
+// printing one JSON document so runs can be diffed or charted across versions:
+//
+//   hz_constraint_bench [--max-constraints N] [--repeat N] [--generator NAME]
+//                       [--output FILE]
+//
+// Every timing is the fastest of --repeat runs, in milliseconds.
+
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "horizon/constraint/Constraint.h"
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/GeometryRef.h"
+#include "horizon/constraint/ParameterTable.h"
+#include "horizon/constraint/SketchSolver.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/math/Vec2.h"
+
+using namespace hz;
+
+namespace hz::cstr {
+
+/// The solver's private assembly steps, timed on their own.
+struct SketchSolverAccess {
+    static Eigen::VectorXd residuals(const SketchSolver& solver, const ParameterTable& params,
+                                     const ConstraintSystem& constraints) {
+        return solver.buildResiduals(params, constraints);
+    }
+    static Eigen::SparseMatrix<double> jacobian(const SketchSolver& solver,
+                                                const ParameterTable& params,
+                                                const ConstraintSystem& constraints) {
+        return solver.buildSparseJacobian(params, constraints);
+    }
+};
+
+}  // namespace hz::cstr
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Sketch {
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+};
+
+cstr::GeometryRef point(uint64_t id, int index) {
+    return {id, cstr::FeatureType::Point, index};
+}
+
+/// Small deterministic offset so every solve starts away from the solution.
+math::Vec2 jitter(int k) { return {0.05 * std::sin(k * 1.3), 0.05 * std::cos(k * 2.1)}; }
+
+uint64_t addLine(Sketch& s, const math::Vec2& a, const math::Vec2& b) {
+    const int k = static_cast<int>(s.doc.entities().size());
+    auto line = std::make_shared<draft::DraftLine>(a + jitter(2 * k), b + jitter(2 * k + 1));
+    s.doc.addEntity(line);
+    return line->id();
+}
+
+template <typename T, typename... Args>
+void add(Sketch& s, Args&&... args) {
+    s.sys.addConstraint(std::make_shared<T>(std::forward<Args>(args)...));
+}
+
+/// An n x n grid of unit cells built from separate lines.  Edges are horizontal or
+/// vertical, the bottom row and left column are dimensioned, and the line ends meeting
+/// at a node are coincident.  Fully constrained; with @p redundant every edge is
+/// dimensioned, which over-constrains it (consistently).
+void grid(Sketch& s, int n, bool redundant) {
+    std::vector<std::vector<cstr::GeometryRef>> ends((n + 1) * (n + 1));
+    auto node = [n](int i, int j) { return j * (n + 1) + i; };
+    auto edge = [&](int i0, int j0, int i1, int j1, bool horizontal, bool dimensioned) {
+        uint64_t id = addLine(s, {double(i0), double(j0)}, {double(i1), double(j1)});
+        if (horizontal) {
+            add<cstr::HorizontalConstraint>(s, point(id, 0), point(id, 1));
+        } else {
+            add<cstr::VerticalConstraint>(s, point(id, 0), point(id, 1));
+        }
+        if (dimensioned) add<cstr::DistanceConstraint>(s, point(id, 0), point(id, 1), 1.0);
+        ends[node(i0, j0)].push_back(point(id, 0));
+        ends[node(i1, j1)].push_back(point(id, 1));
+    };
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i < n; ++i) edge(i, j, i + 1, j, true, redundant || j == 0);
+    }
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j < n; ++j) edge(i, j, i, j + 1, false, redundant || i == 0);
+    }
+    for (const auto& refs : ends) {
+        for (size_t k = 1; k < refs.size(); ++k) {
+            add<cstr::CoincidentConstraint>(s, refs[0], refs[k]);
+        }
+    }
+    add<cstr::FixedConstraint>(s, ends[0][0], math::Vec2{0.0, 0.0});
+}
+
+/// A staircase of unit lines, alternately horizontal and vertical, joined end to start
+/// with the first point fixed.  Fully constrained.
+void chain(Sketch& s, int steps) {
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < steps; ++i) {
+        const math::Vec2 a{double((i + 1) / 2), double(i / 2)};
+        ids.push_back(addLine(s, a, a + (i % 2 == 0 ? math::Vec2{1, 0} : math::Vec2{0, 1})));
+        if (i % 2 == 0) {
+            add<cstr::HorizontalConstraint>(s, point(ids[i], 0), point(ids[i], 1));
+        } else {
+            add<cstr::VerticalConstraint>(s, point(ids[i], 0), point(ids[i], 1));
+        }
+        add<cstr::DistanceConstraint>(s, point(ids[i], 0), point(ids[i], 1), 1.0);
+        if (i > 0) add<cstr::CoincidentConstraint>(s, point(ids[i - 1], 1), point(ids[i], 0));
+    }
+    add<cstr::FixedConstraint>(s, point(ids[0], 0), math::Vec2{0.0, 0.0});
+}
+
+/// Independent 2 x 1 rectangles, each pinned at a corner: many small rigid components.
+void clusters(Sketch& s, int count) {
+    for (int r = 0; r < count; ++r) {
+        const math::Vec2 o{10.0 * (r % 100), 10.0 * (r / 100)};
+        const math::Vec2 corners[] = {o, o + math::Vec2{2, 0}, o + math::Vec2{2, 1},
+                                      o + math::Vec2{0, 1}};
+        uint64_t ids[4];
+        for (int i = 0; i < 4; ++i) ids[i] = addLine(s, corners[i], corners[(i + 1) % 4]);
+        for (int i = 0; i < 4; ++i) {
+            add<cstr::CoincidentConstraint>(s, point(ids[i], 1), point(ids[(i + 1) % 4], 0));
+            if (i % 2 == 0) {
+                add<cstr::HorizontalConstraint>(s, point(ids[i], 0), point(ids[i], 1));
+            } else {
+                add<cstr::VerticalConstraint>(s, point(ids[i], 0), point(ids[i], 1));
+            }
+        }
+        add<cstr::DistanceConstraint>(s, point(ids[0], 0), point(ids[0], 1), 2.0);
+        add<cstr::DistanceConstraint>(s, point(ids[1], 0), point(ids[1], 1), 1.0);
+        add<cstr::FixedConstraint>(s, point(ids[0], 0), o);
+    }
+}
+
+/// A zigzag linkage of unit links with free joints: one degree of freedom per link.
+void linkage(Sketch& s, int links) {
+    auto joint = [](int i) { return math::Vec2{0.8 * i, i % 2 == 0 ? 0.0 : 0.6}; };
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < links; ++i) {
+        ids.push_back(addLine(s, joint(i), joint(i + 1)));
+        add<cstr::DistanceConstraint>(s, point(ids[i], 0), point(ids[i], 1), 1.0);
+        if (i > 0) add<cstr::CoincidentConstraint>(s, point(ids[i - 1], 1), point(ids[i], 0));
+    }
+    add<cstr::FixedConstraint>(s, point(ids[0], 0), math::Vec2{0.0, 0.0});
+}
+
+/// A generator and the size argument that yields roughly @p constraints constraints.
+struct Generator {
+    std::string name;
+    std::string description;
+    std::function<void(Sketch&, int constraints)> build;
+};
+
+const std::vector<Generator>& generators() {
+    auto root = [](int constraints, double perCell) {
+        return std::max(1, static_cast<int>(std::lround(std::sqrt(constraints / perCell))));
+    };
+    static const std::vector<Generator> all = {
+        {"grid", "fully constrained grid of lines",
+         [=](Sketch& s, int c) { grid(s, root(c, 5.0), false); }},
+        {"chain", "fully constrained staircase",
+         [](Sketch& s, int c) { chain(s, std::max(1, c / 3)); }},
+        {"clusters", "independent rigid rectangles",
+         [](Sketch& s, int c) { clusters(s, std::max(1, c / 11)); }},
+        {"over_constrained", "grid with every edge dimensioned",
+         [=](Sketch& s, int c) { grid(s, root(c, 7.0), true); }},
+        {"under_constrained", "linkage with free joints",
+         [](Sketch& s, int c) { linkage(s, std::max(1, c / 2)); }},
+    };
+    return all;
+}
+
+const char* statusName(cstr::SolveStatus status) {
+    switch (status) {
+        case cstr::SolveStatus::Success:
+            return "Success";
+        case cstr::SolveStatus::Converged:
+            return "Converged";
+        case cstr::SolveStatus::OverConstrained:
+            return "OverConstrained";
+        case cstr::SolveStatus::UnderConstrained:
+            return "UnderConstrained";
+        case cstr::SolveStatus::FailedToConverge:
+            return "FailedToConverge";
+        case cstr::SolveStatus::Inconsistent:
+            return "Inconsistent";
+        case cstr::SolveStatus::NoConstraints:
+            return "NoConstraints";
+    }
+    return "Unknown";
+}
+
+/// Fastest of @p repeat runs of @p fn, in milliseconds.
+double bestOf(int repeat, const std::function<void()>& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < repeat; ++r) {
+        auto start = Clock::now();
+        fn();
+        best = std::min(best,
+                        std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+nlohmann::ordered_json runCase(const Generator& gen, int target, int repeat) {
+    Sketch sketch;
+    gen.build(sketch, target);
+    const auto& entities = sketch.doc.entities();
+    const auto& sys = sketch.sys;
+    cstr::SketchSolver solver;
+
+    nlohmann::ordered_json timings;
+    cstr::ParameterTable params;
+    timings["build"] = bestOf(repeat, [&] {
+        params = cstr::ParameterTable::buildFromEntities(entities, sys);
+    });
+    timings["components"] = bestOf(repeat, [&] {
+        cstr::ConstraintSystem copy = sys;  // a fresh copy has no cached components
+        copy.components();
+    });
+    using Access = cstr::SketchSolverAccess;
+    timings["residual"] = bestOf(repeat, [&] { Access::residuals(solver, params, sys); });
+
+    Eigen::SparseMatrix<double> J;
+    timings["jacobian"] = bestOf(repeat, [&] { J = Access::jacobian(solver, params, sys); });
+
+    // One Levenberg-Marquardt step's factorization, as the sparse path performs it.
+    Eigen::SparseMatrix<double> JtJ = Eigen::SparseMatrix<double>(J.transpose()) * J;
+    Eigen::SparseMatrix<double> identity(JtJ.rows(), JtJ.cols());
+    identity.setIdentity();
+    JtJ += 1e-3 * identity;
+    timings["factorization"] = bestOf(repeat, [&] {
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(JtJ);
+    });
+
+    cstr::SolveResult result;
+    timings["solve"] = bestOf(repeat, [&] {
+        cstr::ParameterTable working = params;
+        result = solver.solve(working, sys);
+    });
+
+    cstr::DOFAnalysis dof;
+    timings["dof"] = bestOf(repeat, [&] { dof = solver.analyzeDOF(params, sys); });
+    cstr::DOFCache cache;
+    solver.analyzeDOF(params, sys, cache);
+    timings["dof_cached"] = bestOf(repeat, [&] { solver.analyzeDOF(params, sys, cache); });
+
+    int overConstrained = 0;
+    for (const auto& [id, status] : dof.entityStatus) {
+        if (status == cstr::EntityDOFStatus::OverConstrained) ++overConstrained;
+    }
+
+    return {
+        {"generator", gen.name},
+        {"target_constraints", target},
+        {"constraints", sys.constraints().size()},
+        {"equations", sys.totalEquations()},
+        {"parameters", params.parameterCount()},
+        {"entities", entities.size()},
+        {"components", sys.components().size()},
+        {"jacobian_nonzeros", J.nonZeros()},
+        {"timings_ms", timings},
+        {"iterations", result.iterations},
+        {"status", statusName(result.status)},
+        {"residual_norm", result.residualNorm},
+        {"degrees_of_freedom", dof.totalDOF},
+        {"over_constrained_entities", overConstrained},
+    };
+}
+
+int usage(const char* argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--max-constraints N] [--repeat N] [--generator NAME] [--output FILE]\n"
+                 "generators:";
+    for (const auto& gen : generators()) std::cerr << ' ' << gen.name;
+    std::cerr << '\n';
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int maxConstraints = 50000;
+    int repeat = 3;
+    std::string only;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return usage(argv[0]);
+        if (arg == "--max-constraints") {
+            maxConstraints = std::atoi(argv[++i]);
+        } else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--generator") {
+            only = argv[++i];
+        } else if (arg == "--output") {
+            output = argv[++i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    nlohmann::ordered_json cases = nlohmann::ordered_json::array();
+    for (const auto& gen : generators()) {
+        if (!only.empty() && gen.name != only) continue;
+        for (int target : {10, 100, 1000, 10000, 50000}) {
+            if (target > maxConstraints) break;
+            std::cerr << gen.name << " ~" << target << " constraints\n";
+            cases.push_back(runCase(gen, target, repeat));
+        }
+    }
+    if (cases.empty()) return usage(argv[0]);
+
+    nlohmann::ordered_json report = {
+        {"benchmark", "constraint_solver"},
+        {"repeat", repeat},
+        {"hardware_threads", std::thread::hardware_concurrency()},
+        {"sparse_threshold", cstr::SketchSolver::kSparseThreshold},
+        {"cases", cases},
+    };
+    if (output.empty()) {
+        std::cout << report.dump(2) << '\n';
+    } else {
+        std::ofstream(output) << report.dump(2) << '\n';
+    }
+    return 0;
+}
@@ -13,6 +13,32 @@ namespace hz::cstr {
 
 class ParameterTable;
 
+/// Destination for Constraint::jacobian(): either a dense matrix, or a list of
+/// (row, column, value) entries from which the solver assembles a sparse one.
+/// Constraints accumulate with `jac(row, col) += value` either way; in the sparse case
+/// every access appends an entry, and duplicates are summed on assembly.
+class JacobianSink {
+public:
+    struct Entry {
+        int row;
+        int col;
+        double value;
+    };
+
+    explicit JacobianSink(Eigen::MatrixXd& dense) : m_dense(&dense) {}
+    explicit JacobianSink(std::vector<Entry>& entries) : m_entries(&entries) {}
+
+    double& operator()(int row, int col) {
+        if (m_dense) return (*m_dense)(row, col);
+        m_entries->push_back({row, col, 0.0});
+        return m_entries->back().value;
+    }
+
+private:
+    Eigen::MatrixXd* m_dense = nullptr;
+    std::vector<Entry>* m_entries = nullptr;
+};
+
 enum class ConstraintType {
     Coincident,
     Horizontal,
@@ -56,7 +82,7 @@ public:
                           int offset) const = 0;
 
     /// Fill Jacobian rows for this constraint.
-    virtual void jacobian(const ParameterTable& params, Eigen::MatrixXd& jacobian,
+    virtual void jacobian(const ParameterTable& params, JacobianSink& jacobian,
                           int offset) const = 0;
 
     /// Whether this constraint has an editable dimensional value.
@@ -94,7 +120,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& pointA() const { return m_pointA; }
@@ -115,7 +141,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& refA() const { return m_refA; }
@@ -135,7 +161,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& refA() const { return m_refA; }
@@ -155,7 +181,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& lineA() const { return m_lineA; }
@@ -175,7 +201,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& lineA() const { return m_lineA; }
@@ -195,7 +221,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& lineRef() const { return m_lineRef; }
@@ -215,7 +241,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     const GeometryRef& refA() const { return m_refA; }
@@ -235,13 +261,14 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     bool hasDimensionalValue() const override { return false; }
 
     const GeometryRef& pointRef() const { return m_pointRef; }
     const math::Vec2& position() const { return m_position; }
+    void setPosition(const math::Vec2& position) { m_position = position; }
 
 private:
     GeometryRef m_pointRef;
@@ -258,7 +285,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     bool hasDimensionalValue() const override { return true; }
@@ -283,7 +310,7 @@ public:
     std::vector<uint64_t> referencedEntityIds() const override;
     void evaluate(const ParameterTable& params, Eigen::VectorXd& residuals,
                   int offset) const override;
-    void jacobian(const ParameterTable& params, Eigen::MatrixXd& jac, int offset) const override;
+    void jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const override;
     std::shared_ptr<Constraint> clone() const override;
 
     bool hasDimensionalValue() const override { return true; }
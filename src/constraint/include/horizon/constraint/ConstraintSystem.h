@@ -4,12 +4,21 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "horizon/constraint/Constraint.h"
 
 namespace hz::cstr {
 
+/// Constraints linked through shared entities, directly or via other constraints, and
+/// the entities they reference.  Separate components can be solved independently.
+struct ConstraintComponent {
+    std::vector<size_t> constraintIndices;  ///< into ConstraintSystem::constraints(), ascending
+    std::vector<uint64_t> entityIds;        ///< ascending
+    int equationCount = 0;
+};
+
 /// Stores and manages all geometric constraints for a document.
 class ConstraintSystem {
 public:
@@ -22,7 +31,8 @@ public:
 
     const std::vector<std::shared_ptr<Constraint>>& constraints() const { return m_constraints; }
 
-    /// All constraints referencing a given entity.
+    /// All constraints referencing a given entity, in constraints() order.  Looked up in
+    /// an entity-to-constraints index, so the cost is independent of the system's size.
     std::vector<const Constraint*> constraintsForEntity(uint64_t entityId) const;
 
     /// Remove all constraints that reference the given entity. Returns removed constraints.
@@ -36,8 +46,26 @@ public:
     bool empty() const { return m_constraints.empty(); }
     void clear();
 
+    /// Connected components of the constraint-entity graph, ordered by their first
+    /// constraint.  Computed on first use and cached until a constraint is added or
+    /// removed; not safe to call concurrently with itself.
+    const std::vector<ConstraintComponent>& components() const;
+
+    /// Bumped whenever a constraint is added or removed.
+    uint64_t revision() const { return m_revision; }
+
 private:
+    void indexConstraint(Constraint* constraint);
+    void unindexConstraint(const Constraint* constraint);
+
     std::vector<std::shared_ptr<Constraint>> m_constraints;
+    uint64_t m_revision = 0;
+
+    /// Entity id -> constraints referencing it, each list in m_constraints order.
+    std::unordered_map<uint64_t, std::vector<Constraint*>> m_byEntity;
+
+    mutable std::vector<ConstraintComponent> m_components;
+    mutable uint64_t m_componentsRevision = ~uint64_t{0};
 };
 
 }  // namespace hz::cstr
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "horizon/constraint/Constraint.h"
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/GeometryRef.h"
+#include "horizon/constraint/ParameterTable.h"
+#include "horizon/constraint/SketchSolver.h"
+#include "horizon/math/Vec2.h"
+
+namespace hz::draft {
+class DraftEntity;
+}
+
+namespace hz::cstr {
+
+/// Solver state for one interactive drag of a constrained point.
+///
+/// Created when the drag starts, it holds the parameters of the constraint component
+/// the grabbed entity belongs to, a Fixed constraint pinning the grabbed point to the
+/// cursor, and a solver workspace.  Each drag() re-solves only that component, warm
+/// started from the previous event's solution and damping and reusing the sparse
+/// factorization's symbolic analysis.  Entities outside the component cannot move and
+/// are never touched.
+class DragSession {
+public:
+    /// Iteration cap per drag event; a drag that cannot follow gives up quickly.
+    static constexpr int kMaxIterations = 25;
+
+    /// @param grip  the grabbed Point feature
+    DragSession(const std::vector<std::shared_ptr<draft::DraftEntity>>& entities,
+                const ConstraintSystem& constraints, const GeometryRef& grip);
+
+    /// Whether the grabbed entity has constraints.  If not, drag() does nothing and the
+    /// caller should move the entity directly.
+    bool constrained() const { return m_constrained; }
+
+    /// Pull the grabbed point to @p target and re-solve the component.  When the
+    /// constraints cannot follow, the previous solution is kept, so the geometry stays
+    /// where it last could be.
+    SolveResult drag(const math::Vec2& target);
+
+    /// Entities of the dragged component, ascending; the only ones drag() can move.
+    const std::vector<uint64_t>& entityIds() const { return m_entityIds; }
+
+    /// The component's parameters at the last accepted solution.
+    const ParameterTable& params() const { return m_params; }
+
+    /// Write the last accepted solution into those of @p entities in the component.
+    void apply(const std::vector<std::shared_ptr<draft::DraftEntity>>& entities) const;
+
+private:
+    ConstraintSystem m_system;  ///< the component's constraints plus m_drag
+    ParameterTable m_params;
+    std::shared_ptr<FixedConstraint> m_drag;
+    SketchSolver m_solver;
+    SolverWorkspace m_workspace;
+    std::vector<uint64_t> m_entityIds;
+    bool m_constrained = false;
+};
+
+}  // namespace hz::cstr
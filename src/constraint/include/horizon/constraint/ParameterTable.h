@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "horizon/constraint/GeometryRef.h"
@@ -55,6 +56,13 @@ public:
     /// Check if an entity is registered.
     bool hasEntity(uint64_t entityId) const;
 
+    /// A table holding just the parameters of @p entityIds (those registered here), in
+    /// the order given.  Used to solve one constraint component on its own.
+    ParameterTable subset(const std::vector<uint64_t>& entityIds) const;
+
+    /// Copy the current values of every entity in @p part back into this table.
+    void assign(const ParameterTable& part);
+
 private:
     struct EntityParams {
         uint64_t entityId = 0;
@@ -65,6 +73,8 @@ private:
 
     Eigen::VectorXd m_values;
     std::vector<EntityParams> m_entityParams;
+    /// Entity id -> its entry in m_entityParams; every parameter lookup goes through it.
+    std::unordered_map<uint64_t, size_t> m_index;
 
     const EntityParams* findEntityParams(uint64_t entityId) const;
 };
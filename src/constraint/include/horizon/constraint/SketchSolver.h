@@ -1,9 +1,12 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace hz::cstr {
 
@@ -26,6 +29,8 @@ struct SolveResult {
     double residualNorm = 0.0;
     int degreesOfFreedom = 0;
     std::string message;
+    /// Status of each ConstraintSystem::components() entry, in that order.
+    std::vector<SolveStatus> componentStatus;
 };
 
 /// Per-entity constraint status for DOF visualization.
@@ -37,32 +42,124 @@ struct DOFAnalysis {
     int totalDOF = 0;
 };
 
+/// DOF results kept between analyses of a sketch that changes a little at a time.
+///
+/// Each entry is one constraint component, keyed by its entities and its Jacobian, so
+/// after an edit only the components the edit touched are analysed again; the rest
+/// reuse their rank.  Entries for components that no longer exist are dropped.
+struct DOFCache {
+    struct Entry {
+        std::vector<uint64_t> entityIds;
+        Eigen::SparseMatrix<double> jacobian;
+        int rank = 0;
+    };
+    std::unordered_map<uint64_t, Entry> entries;
+
+    /// How the last analysis settled each component's rank.
+    int reused = 0;      ///< unchanged since the previous analysis
+    int structural = 0;  ///< from the sparsity pattern alone
+    int numeric = 0;     ///< from a factorization
+};
+
+/// Linear algebra used for the Jacobian and the least-squares steps.
+enum class SolverBackend {
+    Automatic,  ///< dense for small systems, sparse from kSparseThreshold up
+    Dense,
+    Sparse,
+};
+
+/// State kept across repeated solves of one system, e.g. the events of an interactive
+/// drag: the sparse Cholesky symbolic analysis, redone only when the sparsity pattern
+/// of J^T J changes (it can, as constraints leave entries out at degenerate
+/// configurations), and the damping the last successful solve ended with, so the next
+/// one (floored at a small minimum) starts there instead of from the configured damping.
+struct SolverWorkspace {
+    using StorageIndex = Eigen::SparseMatrix<double>::StorageIndex;
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt;
+    /// Column starts and row indices of the analysed pattern; empty for none.
+    std::vector<StorageIndex> patternOuter;
+    std::vector<StorageIndex> patternInner;
+    double damping = 0.0;  ///< <= 0 starts from the solver's damping factor
+};
+
 /// Newton-Raphson constraint solver with Levenberg-Marquardt damping.
+///
+/// Each constraint touches a handful of parameters, so the Jacobian of a large sketch
+/// is almost entirely zeros.  Small systems use dense matrices, which are fastest at
+/// that size; larger ones assemble the Jacobian from triplets and solve with sparse
+/// Cholesky (falling back to sparse QR), with rank from a sparse column-pivoted QR, so
+/// time and memory grow with the number of non-zeros rather than equations x parameters.
 class SketchSolver {
 public:
+    /// Equations or parameters at which SolverBackend::Automatic switches to sparse.
+    static constexpr int kSparseThreshold = 32;
+
+    /// Smallest number of equations per worker thread when solving components.
+    static constexpr int kParallelMinEquations = 256;
+
     SketchSolver();
 
+    /// Solve all constraints.  Independent components of the system (see
+    /// ConstraintSystem::components()) are solved separately, in parallel when the
+    /// system is large; the result reports the worst component's status.
     SolveResult solve(ParameterTable& params, const ConstraintSystem& constraints);
 
-    /// Analyze degrees of freedom per entity without modifying parameters.
+    /// Solve @p constraints as one system, reusing and updating @p workspace.  The
+    /// workspace must only ever be used with this one system.
+    SolveResult solve(ParameterTable& params, const ConstraintSystem& constraints,
+                      SolverWorkspace& workspace);
+
+    /// Analyze degrees of freedom per entity without modifying parameters.  Each
+    /// component of the system is analysed on its own, and its entities get its status.
     DOFAnalysis analyzeDOF(const ParameterTable& params, const ConstraintSystem& constraints) const;
 
+    /// As above, reusing the ranks of components unchanged since the analysis that last
+    /// updated @p cache.
+    DOFAnalysis analyzeDOF(const ParameterTable& params, const ConstraintSystem& constraints,
+                           DOFCache& cache) const;
+
     void setMaxIterations(int n) { m_maxIterations = n; }
     void setTolerance(double tol) { m_tolerance = tol; }
     void setDampingFactor(double d) { m_damping = d; }
+    void setBackend(SolverBackend backend) { m_backend = backend; }
+    /// When off, solves skip the rank computations: one that satisfies every constraint
+    /// reports SolveStatus::Converged, and a failed one is classified by its equation
+    /// count and residual alone.
+    void setRankAnalysis(bool on) { m_rankAnalysis = on; }
 
     int maxIterations() const { return m_maxIterations; }
     double tolerance() const { return m_tolerance; }
+    SolverBackend backend() const { return m_backend; }
+
+    /// Whether a system of @p equations x @p parameters is solved sparsely.
+    bool usesSparse(int equations, int parameters) const;
 
 private:
+    /// Reaches the assembly steps and jacobianRank() for unit tests and benchmarks;
+    /// defined by the executable that uses it.
+    friend struct SketchSolverAccess;
+
+    /// Solve @p constraints as one system.
+    SolveResult solveComponent(ParameterTable& params, const ConstraintSystem& constraints,
+                               SolverWorkspace* workspace = nullptr) const;
+
     Eigen::VectorXd buildResiduals(const ParameterTable& params,
                                    const ConstraintSystem& constraints) const;
     Eigen::MatrixXd buildJacobian(const ParameterTable& params,
                                   const ConstraintSystem& constraints) const;
+    Eigen::SparseMatrix<double> buildSparseJacobian(const ParameterTable& params,
+                                                    const ConstraintSystem& constraints) const;
+
+    /// Rank of the Jacobian at the current parameters.
+    int jacobianRank(const ParameterTable& params, const ConstraintSystem& constraints,
+                     bool sparse) const;
 
     int m_maxIterations = 100;
     double m_tolerance = 1e-10;
     double m_damping = 1.0;
+    SolverBackend m_backend = SolverBackend::Automatic;
+    bool m_rankAnalysis = true;
 };
 
 }  // namespace hz::cstr
@@ -44,7 +44,7 @@ void CoincidentConstraint::evaluate(const ParameterTable& params, Eigen::VectorX
     residuals(offset + 1) = pA.y - pB.y;
 }
 
-void CoincidentConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void CoincidentConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                     int offset) const {
     int iA = params.parameterIndex(m_pointA);
     int iB = params.parameterIndex(m_pointB);
@@ -78,7 +78,7 @@ void HorizontalConstraint::evaluate(const ParameterTable& params, Eigen::VectorX
     residuals(offset) = pA.y - pB.y;
 }
 
-void HorizontalConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void HorizontalConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                     int offset) const {
     int iA = params.parameterIndex(m_refA);
     int iB = params.parameterIndex(m_refB);
@@ -108,7 +108,7 @@ void VerticalConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd&
     residuals(offset) = pA.x - pB.x;
 }
 
-void VerticalConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void VerticalConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                   int offset) const {
     int iA = params.parameterIndex(m_refA);
     int iB = params.parameterIndex(m_refB);
@@ -141,7 +141,7 @@ void PerpendicularConstraint::evaluate(const ParameterTable& params, Eigen::Vect
     residuals(offset) = dx1 * dx2 + dy1 * dy2;
 }
 
-void PerpendicularConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void PerpendicularConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                        int offset) const {
     auto [sA, eA] = params.lineEndpoints(m_lineA);
     auto [sB, eB] = params.lineEndpoints(m_lineB);
@@ -191,7 +191,7 @@ void ParallelConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd&
     residuals(offset) = dx1 * dy2 - dy1 * dx2;
 }
 
-void ParallelConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void ParallelConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                   int offset) const {
     auto [sA, eA] = params.lineEndpoints(m_lineA);
     auto [sB, eB] = params.lineEndpoints(m_lineB);
@@ -244,7 +244,7 @@ void TangentConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd&
     residuals(offset) = cross * cross - radius * radius * lenSq;
 }
 
-void TangentConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void TangentConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                  int offset) const {
     auto [s, e] = params.lineEndpoints(m_lineRef);
     auto [center, radius] = params.circleData(m_circleRef);
@@ -335,8 +335,7 @@ void EqualConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd& re
     }
 }
 
-void EqualConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
-                               int offset) const {
+void EqualConstraint::jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const {
     if (m_refA.featureType == FeatureType::Line) {
         auto [sA, eA] = params.lineEndpoints(m_refA);
         auto [sB, eB] = params.lineEndpoints(m_refB);
@@ -384,8 +383,7 @@ void FixedConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd& re
     residuals(offset + 1) = p.y - m_position.y;
 }
 
-void FixedConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
-                               int offset) const {
+void FixedConstraint::jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const {
     int idx = params.parameterIndex(m_pointRef);
     jac(offset + 0, idx + 0) += 1.0;
     jac(offset + 1, idx + 1) += 1.0;
@@ -416,7 +414,7 @@ void DistanceConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd&
     residuals(offset) = dx * dx + dy * dy - m_distance * m_distance;
 }
 
-void DistanceConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
+void DistanceConstraint::jacobian(const ParameterTable& params, JacobianSink& jac,
                                   int offset) const {
     auto pA = params.pointPosition(m_refA);
     auto pB = params.pointPosition(m_refB);
@@ -464,8 +462,7 @@ void AngleConstraint::evaluate(const ParameterTable& params, Eigen::VectorXd& re
     residuals(offset) = diff;
 }
 
-void AngleConstraint::jacobian(const ParameterTable& params, Eigen::MatrixXd& jac,
-                               int offset) const {
+void AngleConstraint::jacobian(const ParameterTable& params, JacobianSink& jac, int offset) const {
     auto [sA, eA] = params.lineEndpoints(m_lineA);
     auto [sB, eB] = params.lineEndpoints(m_lineB);
     double dx1 = eA.x - sA.x, dy1 = eA.y - sA.y;
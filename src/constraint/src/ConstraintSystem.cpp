@@ -1,12 +1,33 @@
 #include "horizon/constraint/ConstraintSystem.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace hz::cstr {
 
+void ConstraintSystem::indexConstraint(Constraint* constraint) {
+    for (uint64_t id : constraint->referencedEntityIds()) {
+        m_byEntity[id].push_back(constraint);
+    }
+}
+
+void ConstraintSystem::unindexConstraint(const Constraint* constraint) {
+    for (uint64_t id : constraint->referencedEntityIds()) {
+        auto it = m_byEntity.find(id);
+        if (it == m_byEntity.end()) continue;
+        auto& list = it->second;
+        if (auto pos = std::find(list.begin(), list.end(), constraint); pos != list.end()) {
+            list.erase(pos);
+        }
+        if (list.empty()) m_byEntity.erase(it);
+    }
+}
+
 uint64_t ConstraintSystem::addConstraint(std::shared_ptr<Constraint> constraint) {
     uint64_t cid = constraint->id();
+    indexConstraint(constraint.get());
     m_constraints.push_back(std::move(constraint));
+    ++m_revision;
     return cid;
 }
 
@@ -15,6 +36,8 @@ std::shared_ptr<Constraint> ConstraintSystem::removeConstraint(uint64_t constrai
         if ((*it)->id() == constraintId) {
             auto removed = std::move(*it);
             m_constraints.erase(it);
+            unindexConstraint(removed.get());
+            ++m_revision;
             return removed;
         }
     }
@@ -36,37 +59,28 @@ Constraint* ConstraintSystem::getConstraint(uint64_t constraintId) {
 }
 
 std::vector<const Constraint*> ConstraintSystem::constraintsForEntity(uint64_t entityId) const {
-    std::vector<const Constraint*> result;
-    for (const auto& c : m_constraints) {
-        auto ids = c->referencedEntityIds();
-        for (uint64_t id : ids) {
-            if (id == entityId) {
-                result.push_back(c.get());
-                break;
-            }
-        }
-    }
-    return result;
+    auto it = m_byEntity.find(entityId);
+    if (it == m_byEntity.end()) return {};
+    return {it->second.begin(), it->second.end()};
 }
 
 std::vector<std::shared_ptr<Constraint>> ConstraintSystem::removeConstraintsForEntity(
     uint64_t entityId) {
     std::vector<std::shared_ptr<Constraint>> removed;
+    auto it = m_byEntity.find(entityId);
+    if (it == m_byEntity.end()) return removed;
+    const std::unordered_set<const Constraint*> doomed(it->second.begin(), it->second.end());
 
     // Use stable_partition to avoid O(n^2) repeated mid-vector erases.
-    auto partition = std::stable_partition(m_constraints.begin(), m_constraints.end(),
-                                           [entityId, &removed](const auto& c) {
-                                               auto ids = c->referencedEntityIds();
-                                               for (uint64_t id : ids) {
-                                                   if (id == entityId) {
-                                                       removed.push_back(c);
-                                                       return false;  // Move to "remove" partition
-                                                   }
-                                               }
-                                               return true;  // Keep
-                                           });
+    auto partition = std::stable_partition(
+        m_constraints.begin(), m_constraints.end(),
+        [&doomed](const auto& c) { return !doomed.count(c.get()); });
 
+    removed.assign(std::make_move_iterator(partition),
+                   std::make_move_iterator(m_constraints.end()));
     m_constraints.erase(partition, m_constraints.end());
+    for (const auto& c : removed) unindexConstraint(c.get());
+    ++m_revision;
     return removed;
 }
 
@@ -90,6 +104,63 @@ int ConstraintSystem::totalEquations() const {
 
 void ConstraintSystem::clear() {
     m_constraints.clear();
+    m_byEntity.clear();
+    ++m_revision;
+}
+
+const std::vector<ConstraintComponent>& ConstraintSystem::components() const {
+    if (m_componentsRevision == m_revision) return m_components;
+
+    // Union-find over entities; each constraint joins everything it references.
+    std::unordered_map<uint64_t, uint32_t> entityIndex;
+    std::vector<uint32_t> parent;
+    auto find = [&](uint32_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    auto indexOf = [&](uint64_t entityId) {
+        const auto next = static_cast<uint32_t>(parent.size());
+        auto [it, inserted] = entityIndex.try_emplace(entityId, next);
+        if (inserted) parent.push_back(next);
+        return it->second;
+    };
+
+    std::vector<std::vector<uint64_t>> referenced(m_constraints.size());
+    for (size_t c = 0; c < m_constraints.size(); ++c) {
+        referenced[c] = m_constraints[c]->referencedEntityIds();
+        if (referenced[c].empty()) continue;
+        uint32_t root = find(indexOf(referenced[c].front()));
+        for (size_t k = 1; k < referenced[c].size(); ++k) {
+            uint32_t other = find(indexOf(referenced[c][k]));
+            if (other != root) parent[other] = root;
+        }
+    }
+
+    // Number components by their first constraint.  A constraint referencing no
+    // entity forms a component of its own.
+    constexpr uint32_t kNone = ~uint32_t{0};
+    std::vector<uint32_t> componentOfRoot(parent.size(), kNone);
+    m_components.clear();
+    for (size_t c = 0; c < m_constraints.size(); ++c) {
+        uint32_t component = static_cast<uint32_t>(m_components.size());
+        if (!referenced[c].empty()) {
+            uint32_t& slot = componentOfRoot[find(entityIndex.at(referenced[c].front()))];
+            if (slot == kNone) slot = component;
+            component = slot;
+        }
+        if (component == m_components.size()) m_components.emplace_back();
+        m_components[component].constraintIndices.push_back(c);
+        m_components[component].equationCount += m_constraints[c]->equationCount();
+    }
+    for (const auto& [entityId, index] : entityIndex) {
+        m_components[componentOfRoot[find(index)]].entityIds.push_back(entityId);
+    }
+    for (auto& component : m_components) {
+        std::sort(component.entityIds.begin(), component.entityIds.end());
+    }
+
+    m_componentsRevision = m_revision;
+    return m_components;
 }
 
 }  // namespace hz::cstr
@@ -0,0 +1,55 @@
+#include "horizon/constraint/DragSession.h"
+
+#include <algorithm>
+
+#include "horizon/drafting/DraftEntity.h"
+
+namespace hz::cstr {
+
+DragSession::DragSession(const std::vector<std::shared_ptr<draft::DraftEntity>>& entities,
+                         const ConstraintSystem& constraints, const GeometryRef& grip) {
+    for (const auto& component : constraints.components()) {
+        if (!std::binary_search(component.entityIds.begin(), component.entityIds.end(),
+                                grip.entityId)) {
+            continue;
+        }
+        for (size_t c : component.constraintIndices) {
+            m_system.addConstraint(constraints.constraints()[c]);
+        }
+        m_entityIds = component.entityIds;
+        break;
+    }
+    if (m_system.empty()) return;
+
+    m_params = ParameterTable::buildFromEntities(entities, m_system);
+    if (!m_params.hasEntity(grip.entityId)) return;
+
+    m_drag = std::make_shared<FixedConstraint>(grip, m_params.pointPosition(grip));
+    m_system.addConstraint(m_drag);
+    m_solver.setMaxIterations(kMaxIterations);
+    m_solver.setRankAnalysis(false);
+    m_constrained = true;
+}
+
+SolveResult DragSession::drag(const math::Vec2& target) {
+    if (!m_constrained) return {};
+
+    m_drag->setPosition(target);
+    Eigen::VectorXd previous = m_params.values();
+    SolveResult result = m_solver.solve(m_params, m_system, m_workspace);
+    if (result.status != SolveStatus::Converged) m_params.values() = previous;
+    return result;
+}
+
+void DragSession::apply(const std::vector<std::shared_ptr<draft::DraftEntity>>& entities) const {
+    std::vector<std::shared_ptr<draft::DraftEntity>> moved;
+    moved.reserve(m_entityIds.size());
+    for (const auto& e : entities) {
+        if (std::binary_search(m_entityIds.begin(), m_entityIds.end(), e->id())) {
+            moved.push_back(e);
+        }
+    }
+    m_params.applyToEntities(moved);
+}
+
+}  // namespace hz::cstr
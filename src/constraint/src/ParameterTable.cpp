@@ -65,21 +65,52 @@ int ParameterTable::registerEntity(const draft::DraftEntity& entity) {
         return -1;
     }
 
+    m_index.try_emplace(ep.entityId, m_entityParams.size());
     m_entityParams.push_back(ep);
     return startIdx;
 }
 
 const ParameterTable::EntityParams* ParameterTable::findEntityParams(uint64_t entityId) const {
-    for (const auto& ep : m_entityParams) {
-        if (ep.entityId == entityId) return &ep;
-    }
-    return nullptr;
+    auto it = m_index.find(entityId);
+    return it == m_index.end() ? nullptr : &m_entityParams[it->second];
 }
 
 bool ParameterTable::hasEntity(uint64_t entityId) const {
     return findEntityParams(entityId) != nullptr;
 }
 
+ParameterTable ParameterTable::subset(const std::vector<uint64_t>& entityIds) const {
+    ParameterTable part;
+    int count = 0;
+    for (uint64_t id : entityIds) {
+        if (const auto* ep = findEntityParams(id)) count += ep->paramCount;
+    }
+    part.m_values.resize(count);
+    for (uint64_t id : entityIds) {
+        const auto* ep = findEntityParams(id);
+        if (!ep) continue;
+        EntityParams copy = *ep;
+        copy.startIndex = part.m_entityParams.empty()
+                              ? 0
+                              : part.m_entityParams.back().startIndex +
+                                    part.m_entityParams.back().paramCount;
+        part.m_values.segment(copy.startIndex, copy.paramCount) =
+            m_values.segment(ep->startIndex, ep->paramCount);
+        part.m_index.try_emplace(id, part.m_entityParams.size());
+        part.m_entityParams.push_back(std::move(copy));
+    }
+    return part;
+}
+
+void ParameterTable::assign(const ParameterTable& part) {
+    for (const auto& src : part.m_entityParams) {
+        const auto* dst = findEntityParams(src.entityId);
+        if (!dst || dst->paramCount != src.paramCount) continue;
+        m_values.segment(dst->startIndex, dst->paramCount) =
+            part.m_values.segment(src.startIndex, src.paramCount);
+    }
+}
+
 int ParameterTable::parameterIndex(const GeometryRef& ref) const {
     const auto* ep = findEntityParams(ref.entityId);
     if (!ep) {
@@ -229,34 +260,32 @@ std::pair<math::Vec2, double> ParameterTable::circleData(const GeometryRef& ref)
 
 void ParameterTable::applyToEntities(
     std::vector<std::shared_ptr<draft::DraftEntity>>& entities) const {
-    for (const auto& ep : m_entityParams) {
-        for (auto& entity : entities) {
-            if (entity->id() != ep.entityId) continue;
-            int base = ep.startIndex;
+    for (auto& entity : entities) {
+        const auto* ep = findEntityParams(entity->id());
+        if (!ep) continue;
+        int base = ep->startIndex;
 
-            if (auto* line = dynamic_cast<draft::DraftLine*>(entity.get())) {
-                line->setStart({m_values(base), m_values(base + 1)});
-                line->setEnd({m_values(base + 2), m_values(base + 3)});
-            } else if (auto* circle = dynamic_cast<draft::DraftCircle*>(entity.get())) {
-                circle->setCenter({m_values(base), m_values(base + 1)});
-                circle->setRadius(m_values(base + 2));
-            } else if (auto* arc = dynamic_cast<draft::DraftArc*>(entity.get())) {
-                arc->setCenter({m_values(base), m_values(base + 1)});
-                arc->setRadius(m_values(base + 2));
-                arc->setStartAngle(m_values(base + 3));
-                arc->setEndAngle(m_values(base + 4));
-            } else if (auto* rect = dynamic_cast<draft::DraftRectangle*>(entity.get())) {
-                rect->setCorner1({m_values(base), m_values(base + 1)});
-                rect->setCorner2({m_values(base + 2), m_values(base + 3)});
-            } else if (auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get())) {
-                int n = ep.paramCount / 2;
-                std::vector<math::Vec2> pts(n);
-                for (int i = 0; i < n; ++i) {
-                    pts[i] = {m_values(base + 2 * i), m_values(base + 2 * i + 1)};
-                }
-                poly->setPoints(pts);
+        if (auto* line = dynamic_cast<draft::DraftLine*>(entity.get())) {
+            line->setStart({m_values(base), m_values(base + 1)});
+            line->setEnd({m_values(base + 2), m_values(base + 3)});
+        } else if (auto* circle = dynamic_cast<draft::DraftCircle*>(entity.get())) {
+            circle->setCenter({m_values(base), m_values(base + 1)});
+            circle->setRadius(m_values(base + 2));
+        } else if (auto* arc = dynamic_cast<draft::DraftArc*>(entity.get())) {
+            arc->setCenter({m_values(base), m_values(base + 1)});
+            arc->setRadius(m_values(base + 2));
+            arc->setStartAngle(m_values(base + 3));
+            arc->setEndAngle(m_values(base + 4));
+        } else if (auto* rect = dynamic_cast<draft::DraftRectangle*>(entity.get())) {
+            rect->setCorner1({m_values(base), m_values(base + 1)});
+            rect->setCorner2({m_values(base + 2), m_values(base + 3)});
+        } else if (auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get())) {
+            int n = ep->paramCount / 2;
+            std::vector<math::Vec2> pts(n);
+            for (int i = 0; i < n; ++i) {
+                pts[i] = {m_values(base + 2 * i), m_values(base + 2 * i + 1)};
             }
-            break;
+            poly->setPoints(pts);
         }
     }
 }
@@ -1,16 +1,338 @@
 #include "horizon/constraint/SketchSolver.h"
 
 #include <Eigen/SVD>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseQR>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <set>
+#include <future>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include "horizon/constraint/ConstraintSystem.h"
 #include "horizon/constraint/ParameterTable.h"
 
 namespace hz::cstr {
 
+namespace {
+
+using SparseMatrix = Eigen::SparseMatrix<double>;
+
+/// Lowest damping a warm-started solve begins with.  Solves often end nearly undamped,
+/// and an undamped first step on a rank-deficient system (any drag of an
+/// under-constrained sketch) amplifies round-off along its null space; in the drag
+/// benchmarks starting here takes fewer iterations than starting lower or cold.
+constexpr double kMinWarmDamping = 1e-3;
+
+/// Levenberg-Marquardt step: (J^T J + lambda * I) * dx = -J^T F.
+Eigen::VectorXd dampedStep(const Eigen::MatrixXd& J, const Eigen::VectorXd& F, double damping) {
+    Eigen::MatrixXd JtJ = J.transpose() * J;
+    Eigen::VectorXd JtF = J.transpose() * F;
+
+    if (damping > 0.0) {
+        JtJ.diagonal().array() += damping;
+    }
+
+    return JtJ.colPivHouseholderQr().solve(-JtF);
+}
+
+/// Sparse Levenberg-Marquardt step.  J^T J + lambda * I is symmetric positive definite
+/// whenever lambda > 0, so a sparse LDL^T factorization is enough; sparse QR covers the
+/// undamped, possibly singular case.  With a @p workspace the symbolic analysis is
+/// redone only when the pattern changes.
+Eigen::VectorXd dampedStep(const SparseMatrix& J, const Eigen::VectorXd& F, double damping,
+                           SolverWorkspace* workspace) {
+    SparseMatrix JtJ = SparseMatrix(J.transpose()) * J;
+    Eigen::VectorXd JtF = J.transpose() * F;
+
+    if (damping > 0.0) {
+        SparseMatrix identity(J.cols(), J.cols());
+        identity.setIdentity();
+        JtJ += damping * identity;
+    }
+
+    // Constraints may leave entries out at degenerate configurations, so the pattern
+    // can change while its size does not; compare it index for index.
+    JtJ.makeCompressed();
+    const auto* outer = JtJ.outerIndexPtr();
+    const auto* inner = JtJ.innerIndexPtr();
+    const auto outerEnd = outer + JtJ.outerSize() + 1;
+    const auto innerEnd = inner + JtJ.nonZeros();
+
+    Eigen::SimplicialLDLT<SparseMatrix> local;
+    auto& ldlt = workspace ? workspace->ldlt : local;
+    if (!workspace ||
+        !std::equal(outer, outerEnd, workspace->patternOuter.begin(),
+                    workspace->patternOuter.end()) ||
+        !std::equal(inner, innerEnd, workspace->patternInner.begin(),
+                    workspace->patternInner.end())) {
+        ldlt.analyzePattern(JtJ);
+        if (workspace) {
+            workspace->patternOuter.assign(outer, outerEnd);
+            workspace->patternInner.assign(inner, innerEnd);
+        }
+    }
+    ldlt.factorize(JtJ);
+    if (ldlt.info() == Eigen::Success) {
+        Eigen::VectorXd dx = ldlt.solve(-JtF);
+        if (ldlt.info() == Eigen::Success && dx.allFinite()) return dx;
+    }
+
+    Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int>> qr(JtJ);
+    return qr.solve(-JtF);
+}
+
+/// Rank of @p J from a column-pivoted sparse QR.  Columns whose remaining norm falls
+/// below @p relativeThreshold times the largest column norm count as dependent; a
+/// threshold <= 0 keeps Eigen's default, comparable to ColPivHouseholderQR's.
+int sparseRank(const SparseMatrix& J, double relativeThreshold) {
+    // rank(J) == rank(J^T); factor whichever is tall.
+    SparseMatrix A = J.rows() >= J.cols() ? J : SparseMatrix(J.transpose());
+    A.makeCompressed();
+
+    Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int>> qr;
+    if (relativeThreshold > 0.0) {
+        double maxColumnNorm = 0.0;
+        for (int c = 0; c < A.outerSize(); ++c) {
+            maxColumnNorm = std::max(maxColumnNorm, A.col(c).norm());
+        }
+        qr.setPivotThreshold(relativeThreshold * maxColumnNorm);
+    }
+    qr.compute(A);
+    return qr.info() == Eigen::Success ? static_cast<int>(qr.rank()) : 0;
+}
+
+/// Rank of @p J for DOF analysis: singular values (dense) or QR pivots (sparse) below
+/// 1e-8 * max(rows, cols) relative to the largest count as zero.
+int numericRank(const SparseMatrix& J, bool sparse) {
+    if (J.rows() == 0 || J.cols() == 0) return 0;
+    const double cutoff = 1e-8 * static_cast<double>(std::max(J.rows(), J.cols()));
+    if (sparse) return sparseRank(J, cutoff);
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd{Eigen::MatrixXd(J)};
+    const double threshold = cutoff * svd.singularValues()(0);
+    int rank = 0;
+    for (int i = 0; i < svd.singularValues().size(); ++i) {
+        if (svd.singularValues()(i) > threshold) ++rank;
+    }
+    return rank;
+}
+
+/// Rank of @p J from its sparsity pattern and a cheap full-rank check, when those
+/// settle it.
+///
+/// A maximum matching of equations to parameters they involve gives the structural
+/// rank, an upper bound on the numeric one.  If the columns of the matched parameters
+/// are linearly independent, the rank is exactly the matching size.  When the matched
+/// equations can be ordered so that none involves the matched parameter of a later
+/// one, the matched entries form a triangular block whose diagonal (clear of
+/// @p relativeThreshold times the largest entry) shows that outright; open chains of
+/// fixed, coincident, horizontal/vertical and dimension constraints come out this way.
+/// Otherwise, with B those columns, a Cholesky factorization of B^T B must have every
+/// pivot above the square of @p relativeThreshold times the largest.  When neither test passes,
+/// nothing is returned and the caller needs a rank-revealing factorization.
+std::optional<int> structuralRank(const SparseMatrix& J, double relativeThreshold) {
+    const int m = static_cast<int>(J.rows());
+    const int n = static_cast<int>(J.cols());
+    if (m == 0 || n == 0) return 0;
+
+    double maxAbs = 0.0;
+    for (int c = 0; c < J.outerSize(); ++c) {
+        for (SparseMatrix::InnerIterator it(J, c); it; ++it) {
+            maxAbs = std::max(maxAbs, std::abs(it.value()));
+        }
+    }
+    if (maxAbs == 0.0) return 0;
+
+    // Row-wise pattern of the entries that are not round-off.
+    const double drop = 1e-12 * maxAbs;
+    std::vector<int> rowStart(m + 1, 0);
+    for (int c = 0; c < J.outerSize(); ++c) {
+        for (SparseMatrix::InnerIterator it(J, c); it; ++it) {
+            if (std::abs(it.value()) > drop) ++rowStart[it.row() + 1];
+        }
+    }
+    std::partial_sum(rowStart.begin(), rowStart.end(), rowStart.begin());
+    std::vector<int> cols(rowStart[m]);
+    std::vector<double> values(rowStart[m]);
+    std::vector<int> fill(rowStart.begin(), rowStart.end() - 1);
+    for (int c = 0; c < J.outerSize(); ++c) {
+        for (SparseMatrix::InnerIterator it(J, c); it; ++it) {
+            if (std::abs(it.value()) <= drop) continue;
+            const int k = fill[it.row()]++;
+            cols[k] = c;
+            values[k] = it.value();
+        }
+    }
+
+    // Maximum matching: greedy, then a breadth-first augmenting path per equation the
+    // greedy pass left unmatched.
+    std::vector<int> rowMatch(m, -1), colMatch(n, -1);
+    for (int r = 0; r < m; ++r) {
+        for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) {
+            if (colMatch[cols[k]] < 0) {
+                rowMatch[r] = cols[k];
+                colMatch[cols[k]] = r;
+                break;
+            }
+        }
+    }
+    std::vector<int> parent(n), seen(n, -1), queue;
+    queue.reserve(m);
+    for (int r = 0; r < m; ++r) {
+        if (rowMatch[r] >= 0) continue;
+        queue.assign(1, r);
+        bool found = false;
+        for (size_t q = 0; q < queue.size() && !found; ++q) {
+            const int u = queue[q];
+            for (int k = rowStart[u]; k < rowStart[u + 1]; ++k) {
+                int c = cols[k];
+                if (seen[c] == r) continue;
+                seen[c] = r;
+                parent[c] = u;
+                if (colMatch[c] >= 0) {
+                    queue.push_back(colMatch[c]);
+                    continue;
+                }
+                // Flip the path back to r.
+                for (;;) {
+                    const int v = parent[c];
+                    const int previous = rowMatch[v];
+                    rowMatch[v] = c;
+                    colMatch[c] = v;
+                    if (v == r) break;
+                    c = previous;
+                }
+                found = true;
+                break;
+            }
+        }
+    }
+
+    // Triangular: the graph "equation u involves the parameter matched to v" must be
+    // acyclic (Kahn's algorithm), and every matched entry large enough.
+    const double pivotFloor = relativeThreshold * maxAbs;
+    int rank = 0;
+    bool triangular = true;
+    std::vector<int> indegree(m, 0);
+    for (int u = 0; u < m; ++u) {
+        if (rowMatch[u] < 0) continue;
+        ++rank;
+        for (int k = rowStart[u]; k < rowStart[u + 1]; ++k) {
+            const int v = colMatch[cols[k]];
+            if (v == u && std::abs(values[k]) <= pivotFloor) triangular = false;
+            if (v >= 0 && v != u) ++indegree[v];
+        }
+    }
+    if (triangular) {
+        queue.clear();
+        for (int u = 0; u < m; ++u) {
+            if (rowMatch[u] >= 0 && indegree[u] == 0) queue.push_back(u);
+        }
+        for (size_t q = 0; q < queue.size(); ++q) {
+            const int u = queue[q];
+            for (int k = rowStart[u]; k < rowStart[u + 1]; ++k) {
+                const int v = colMatch[cols[k]];
+                if (v >= 0 && v != u && --indegree[v] == 0) queue.push_back(v);
+            }
+        }
+        if (static_cast<int>(queue.size()) == rank) return rank;
+    }
+
+    // B: the columns of the matched parameters, numbered in matching order.
+    std::vector<int> blockColumn(n, -1);
+    for (int c = 0, b = 0; c < n; ++c) {
+        if (colMatch[c] >= 0) blockColumn[c] = b++;
+    }
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(values.size());
+    for (int u = 0; u < m; ++u) {
+        for (int k = rowStart[u]; k < rowStart[u + 1]; ++k) {
+            const int b = blockColumn[cols[k]];
+            if (b >= 0) triplets.emplace_back(u, b, values[k]);
+        }
+    }
+    SparseMatrix B(m, rank);
+    B.setFromTriplets(triplets.begin(), triplets.end());
+    SparseMatrix BtB = SparseMatrix(B.transpose()) * B;
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt(BtB);
+    if (ldlt.info() != Eigen::Success) return std::nullopt;
+    const Eigen::VectorXd& d = ldlt.vectorD();
+    // B^T B squares B's scale, so its pivots are held to the squared threshold.
+    if (d.minCoeff() <= relativeThreshold * relativeThreshold * d.maxCoeff()) {
+        return std::nullopt;
+    }
+    return rank;
+}
+
+/// Cache key of a component: FNV-1a over its entities and Jacobian.
+uint64_t componentKey(const std::vector<uint64_t>& entityIds, const SparseMatrix& J) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(entityIds.data(), entityIds.size() * sizeof(uint64_t));
+    mix(J.outerIndexPtr(), static_cast<size_t>(J.outerSize() + 1) * sizeof(int));
+    mix(J.innerIndexPtr(), static_cast<size_t>(J.nonZeros()) * sizeof(int));
+    mix(J.valuePtr(), static_cast<size_t>(J.nonZeros()) * sizeof(double));
+    return hash;
+}
+
+/// Exact equality of two compressed matrices; a key match alone could be a collision.
+bool sameMatrix(const SparseMatrix& a, const SparseMatrix& b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols() || a.nonZeros() != b.nonZeros()) {
+        return false;
+    }
+    const auto nnz = static_cast<size_t>(a.nonZeros());
+    return std::equal(a.outerIndexPtr(), a.outerIndexPtr() + a.outerSize() + 1,
+                      b.outerIndexPtr()) &&
+           std::equal(a.innerIndexPtr(), a.innerIndexPtr() + nnz, b.innerIndexPtr()) &&
+           std::equal(a.valuePtr(), a.valuePtr() + nnz, b.valuePtr());
+}
+
+/// Ranking used to merge component results; higher is worse.
+int severity(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::NoConstraints:
+            return 0;
+        case SolveStatus::Success:
+        case SolveStatus::Converged:
+            return 1;
+        case SolveStatus::UnderConstrained:
+            return 2;
+        case SolveStatus::FailedToConverge:
+            return 3;
+        case SolveStatus::Inconsistent:
+            return 4;
+        case SolveStatus::OverConstrained:
+            return 5;
+    }
+    return 0;
+}
+
+}  // namespace
+
 SketchSolver::SketchSolver() = default;
 
+bool SketchSolver::usesSparse(int equations, int parameters) const {
+    switch (m_backend) {
+        case SolverBackend::Dense:
+            return false;
+        case SolverBackend::Sparse:
+            return true;
+        case SolverBackend::Automatic:
+            break;
+    }
+    return std::max(equations, parameters) >= kSparseThreshold;
+}
+
 Eigen::VectorXd SketchSolver::buildResiduals(const ParameterTable& params,
                                              const ConstraintSystem& constraints) const {
     int m = constraints.totalEquations();
@@ -28,15 +350,149 @@ Eigen::MatrixXd SketchSolver::buildJacobian(const ParameterTable& params,
     int m = constraints.totalEquations();
     int n = params.parameterCount();
     Eigen::MatrixXd J = Eigen::MatrixXd::Zero(m, n);
+    JacobianSink sink(J);
     int offset = 0;
     for (const auto& c : constraints.constraints()) {
-        c->jacobian(params, J, offset);
+        c->jacobian(params, sink, offset);
         offset += c->equationCount();
     }
     return J;
 }
 
+Eigen::SparseMatrix<double> SketchSolver::buildSparseJacobian(
+    const ParameterTable& params, const ConstraintSystem& constraints) const {
+    int m = constraints.totalEquations();
+    int n = params.parameterCount();
+
+    std::vector<JacobianSink::Entry> entries;
+    entries.reserve(static_cast<size_t>(m) * 4);
+    JacobianSink sink(entries);
+    int offset = 0;
+    for (const auto& c : constraints.constraints()) {
+        c->jacobian(params, sink, offset);
+        offset += c->equationCount();
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(entries.size());
+    for (const auto& e : entries) triplets.emplace_back(e.row, e.col, e.value);
+
+    // setFromTriplets sums duplicates, matching the dense `+=` accumulation.
+    SparseMatrix J(m, n);
+    J.setFromTriplets(triplets.begin(), triplets.end());
+    return J;
+}
+
+int SketchSolver::jacobianRank(const ParameterTable& params, const ConstraintSystem& constraints,
+                               bool sparse) const {
+    if (sparse) {
+        // The pattern usually settles the rank; sparse QR of a large mesh-like system
+        // fills in badly and can take minutes.
+        SparseMatrix J = buildSparseJacobian(params, constraints);
+        const double cutoff = 1e-8 * static_cast<double>(std::max(J.rows(), J.cols()));
+        if (auto rank = structuralRank(J, cutoff)) return *rank;
+        return sparseRank(J, 0.0);
+    }
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(buildJacobian(params, constraints));
+    return static_cast<int>(qr.rank());
+}
+
 SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem& constraints) {
+    const auto& components = constraints.components();
+    if (components.size() <= 1 || params.parameterCount() == 0) {
+        SolveResult result = solveComponent(params, constraints);
+        if (!components.empty()) result.componentStatus = {result.status};
+        return result;
+    }
+
+    // Solve each component on its own parameters.  Sub-systems share the constraint
+    // objects, which are only read while solving.
+    struct Part {
+        ConstraintSystem constraints;
+        ParameterTable params;
+        SolveResult result;
+    };
+    std::vector<Part> parts(components.size());
+    for (size_t i = 0; i < components.size(); ++i) {
+        for (size_t c : components[i].constraintIndices) {
+            parts[i].constraints.addConstraint(constraints.constraints()[c]);
+        }
+        parts[i].params = params.subset(components[i].entityIds);
+    }
+
+    // Largest first, handed out to whichever worker is free next.
+    std::vector<size_t> order(parts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return components[a].equationCount > components[b].equationCount;
+    });
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t k = next++; k < order.size(); k = next++) {
+            Part& part = parts[order[k]];
+            part.result = solveComponent(part.params, part.constraints);
+        }
+    };
+
+    unsigned threads = std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::clamp<size_t>(
+        threads, 1,
+        std::min(parts.size(),
+                 std::max<size_t>(1, constraints.totalEquations() / kParallelMinEquations))));
+    if (threads == 1) {
+        work();
+    } else {
+        std::vector<std::future<void>> futures;
+        futures.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            futures.push_back(std::async(std::launch::async, work));
+        }
+        for (auto& f : futures) f.get();
+    }
+
+    // Merge: the worst component decides the status.
+    SolveResult result;
+    result.status = SolveStatus::Success;
+    double residualSq = 0.0;
+    int componentParams = 0;
+    size_t worst = 0;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const SolveResult& r = parts[i].result;
+        params.assign(parts[i].params);
+        result.componentStatus.push_back(r.status);
+        result.iterations = std::max(result.iterations, r.iterations);
+        residualSq += r.residualNorm * r.residualNorm;
+        result.degreesOfFreedom += r.degreesOfFreedom;
+        componentParams += parts[i].params.parameterCount();
+        if (severity(r.status) > severity(parts[worst].result.status)) worst = i;
+    }
+    result.residualNorm = std::sqrt(residualSq);
+    // Registered parameters no constraint touches are free as well.
+    result.degreesOfFreedom += params.parameterCount() - componentParams;
+
+    const SolveResult& w = parts[worst].result;
+    if (severity(w.status) > severity(SolveStatus::UnderConstrained)) {
+        result.status = w.status;
+        result.message = "Component " + std::to_string(worst + 1) + " of " +
+                         std::to_string(parts.size()) + ": " + w.message;
+    } else if (result.degreesOfFreedom > 0) {
+        result.status = SolveStatus::UnderConstrained;
+        result.message = "Solved but " + std::to_string(result.degreesOfFreedom) +
+                         " degrees of freedom remain";
+    } else {
+        result.message = "All constraints satisfied";
+    }
+    return result;
+}
+
+SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem& constraints,
+                                SolverWorkspace& workspace) {
+    return solveComponent(params, constraints, &workspace);
+}
+
+SolveResult SketchSolver::solveComponent(ParameterTable& params,
+                                         const ConstraintSystem& constraints,
+                                         SolverWorkspace* workspace) const {
     SolveResult result;
 
     int m = constraints.totalEquations();
@@ -54,8 +510,14 @@ SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem&
         return result;
     }
 
-    // Use a local copy of damping so each solve() starts from the configured value.
+    const bool sparse = usesSparse(m, n);
+
+    // Use a local copy of damping so each solve() starts from the configured value,
+    // or from where the workspace's last solve ended.
     double damping = m_damping;
+    if (workspace && workspace->damping > 0.0) {
+        damping = std::max(workspace->damping, kMinWarmDamping);
+    }
 
     for (int iter = 0; iter < m_maxIterations; ++iter) {
         Eigen::VectorXd F = buildResiduals(params, constraints);
@@ -64,10 +526,15 @@ SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem&
         result.iterations = iter + 1;
 
         if (currentNorm < m_tolerance) {
+            if (workspace) workspace->damping = damping;
+            if (!m_rankAnalysis) {
+                result.status = SolveStatus::Converged;
+                result.message = "All constraints satisfied";
+                return result;
+            }
+
             // Check degrees of freedom
-            Eigen::MatrixXd J = buildJacobian(params, constraints);
-            Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(J);
-            int rank = qr.rank();
+            int rank = jacobianRank(params, constraints, sparse);
             result.degreesOfFreedom = n - rank;
 
             if (result.degreesOfFreedom > 0) {
@@ -81,18 +548,11 @@ SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem&
             return result;
         }
 
-        Eigen::MatrixXd J = buildJacobian(params, constraints);
-
         // Gauss-Newton with Levenberg-Marquardt damping:
         // (J^T J + lambda * I) * dx = -J^T F
-        Eigen::MatrixXd JtJ = J.transpose() * J;
-        Eigen::VectorXd JtF = J.transpose() * F;
-
-        if (damping > 0.0) {
-            JtJ.diagonal().array() += damping;
-        }
-
-        Eigen::VectorXd dx = JtJ.colPivHouseholderQr().solve(-JtF);
+        Eigen::VectorXd dx =
+            sparse ? dampedStep(buildSparseJacobian(params, constraints), F, damping, workspace)
+                   : dampedStep(buildJacobian(params, constraints), F, damping);
 
         // Save current state and try the step
         Eigen::VectorXd savedParams = params.values();
@@ -118,10 +578,10 @@ SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem&
         }
     }
 
+    if (workspace) workspace->damping = 0.0;
+
     // Did not converge — check if over-constrained
-    Eigen::MatrixXd J = buildJacobian(params, constraints);
-    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(J);
-    int rank = qr.rank();
+    int rank = m_rankAnalysis ? jacobianRank(params, constraints, sparse) : std::min(m, n);
     result.degreesOfFreedom = n - rank;
 
     if (m > rank) {
@@ -142,49 +602,76 @@ SolveResult SketchSolver::solve(ParameterTable& params, const ConstraintSystem&
 
 DOFAnalysis SketchSolver::analyzeDOF(const ParameterTable& params,
                                      const ConstraintSystem& constraints) const {
-    DOFAnalysis result;
+    DOFCache cache;
+    return analyzeDOF(params, constraints, cache);
+}
 
-    int m = constraints.totalEquations();
-    int n = params.parameterCount();
+DOFAnalysis SketchSolver::analyzeDOF(const ParameterTable& params,
+                                     const ConstraintSystem& constraints,
+                                     DOFCache& cache) const {
+    DOFAnalysis result;
+    cache.reused = cache.structural = cache.numeric = 0;
 
-    if (m == 0 || constraints.empty() || n == 0) {
+    if (constraints.totalEquations() == 0 || constraints.empty() ||
+        params.parameterCount() == 0) {
         // No constraints — all constrained entities are free (none exist).
+        cache.entries.clear();
         return result;
     }
 
-    // Build Jacobian and compute rank via SVD.
-    Eigen::MatrixXd J = buildJacobian(params, constraints);
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(J);
-
-    // Count singular values above threshold for rank determination.
-    double threshold = 1e-8 * std::max(m, n) * svd.singularValues()(0);
-    int rank = 0;
-    for (int i = 0; i < svd.singularValues().size(); ++i) {
-        if (svd.singularValues()(i) > threshold) ++rank;
-    }
-
-    result.totalDOF = n - rank;
-    bool overConstrained = (m > rank);
-
-    // Collect all entity IDs referenced by any constraint.
-    std::set<uint64_t> constrainedIds;
-    for (const auto& c : constraints.constraints()) {
-        for (uint64_t eid : c->referencedEntityIds()) {
-            constrainedIds.insert(eid);
+    std::unordered_map<uint64_t, DOFCache::Entry> entries;
+    int componentParams = 0;
+    for (const auto& component : constraints.components()) {
+        ConstraintSystem sub;
+        for (size_t c : component.constraintIndices) {
+            sub.addConstraint(constraints.constraints()[c]);
         }
-    }
-
-    // Assign status per entity based on global analysis.
-    for (uint64_t eid : constrainedIds) {
-        if (overConstrained) {
-            result.entityStatus[eid] = EntityDOFStatus::OverConstrained;
-        } else if (result.totalDOF == 0) {
-            result.entityStatus[eid] = EntityDOFStatus::FullyConstrained;
+        ParameterTable part = params.subset(component.entityIds);
+        const int m = component.equationCount;
+        const int n = part.parameterCount();
+        componentParams += n;
+
+        SparseMatrix J = buildSparseJacobian(part, sub);
+        J.makeCompressed();
+        const uint64_t key = componentKey(component.entityIds, J);
+
+        // Unchanged components keep their rank; the rest try the pattern before
+        // factoring.
+        DOFCache::Entry entry;
+        auto cached = cache.entries.find(key);
+        if (cached != cache.entries.end() && cached->second.entityIds == component.entityIds &&
+            sameMatrix(cached->second.jacobian, J)) {
+            entry = std::move(cached->second);
+            ++cache.reused;
         } else {
-            result.entityStatus[eid] = EntityDOFStatus::Free;
+            const double cutoff = 1e-8 * std::max(m, n);
+            if (auto rank = structuralRank(J, cutoff)) {
+                entry.rank = *rank;
+                ++cache.structural;
+            } else {
+                entry.rank = numericRank(J, usesSparse(m, n));
+                ++cache.numeric;
+            }
+            entry.entityIds = component.entityIds;
+            entry.jacobian = std::move(J);
+        }
+
+        const int dof = n - entry.rank;
+        result.totalDOF += dof;
+        EntityDOFStatus status = EntityDOFStatus::Free;
+        if (m > entry.rank) {
+            status = EntityDOFStatus::OverConstrained;
+        } else if (dof == 0) {
+            status = EntityDOFStatus::FullyConstrained;
         }
+        for (uint64_t eid : component.entityIds) result.entityStatus[eid] = status;
+
+        entries[key] = std::move(entry);
     }
+    // Registered parameters no constraint touches are free as well.
+    result.totalDOF += params.parameterCount() - componentParams;
 
+    cache.entries = std::move(entries);
     return result;
 }
 
@@ -48,6 +48,21 @@ private:
     uint64_t m_entityId;
 };
 
+/// Command to remove a batch of DraftEntities in one pass (see
+/// DraftDocument::removeEntities); undo adds them back the same way.
+class RemoveEntitiesCommand : public Command {
+public:
+    RemoveEntitiesCommand(draft::DraftDocument& doc, const std::vector<uint64_t>& entityIds);
+
+    void execute() override;
+    void undo() override;
+    std::string description() const override;
+
+private:
+    draft::DraftDocument& m_doc;
+    std::vector<std::shared_ptr<draft::DraftEntity>> m_entities;
+};
+
 /// Command to move (translate) one or more DraftEntities.
 class MoveEntityCommand : public Command {
 public:
@@ -179,8 +194,8 @@ public:
 private:
     draft::DraftDocument& m_doc;
     std::vector<uint64_t> m_entityIds;
-    std::string m_newLayer;
-    std::vector<std::pair<uint64_t, std::string>> m_oldLayers;
+    draft::LayerId m_newLayer;
+    std::vector<std::pair<uint64_t, draft::LayerId>> m_oldLayers;
 };
 
 /// Command to change the color of one or more entities.
@@ -278,10 +293,28 @@ private:
     draft::DraftDocument& m_doc;
     std::string m_name;
     draft::LayerProperties m_savedProps;
-    std::vector<std::pair<uint64_t, std::string>> m_movedEntities;
+    std::vector<uint64_t> m_movedEntities;
     bool m_wasCurrentLayer = false;
 };
 
+/// Command to rename a layer.  Entities on it are moved to the new name's handle.
+class RenameLayerCommand : public Command {
+public:
+    RenameLayerCommand(draft::LayerManager& mgr, draft::DraftDocument& doc,
+                       const std::string& oldName, const std::string& newName);
+    void execute() override;
+    void undo() override;
+    std::string description() const override;
+
+private:
+    draft::LayerManager& m_mgr;
+    draft::DraftDocument& m_doc;
+    std::string m_oldName;
+    std::string m_newName;
+    std::vector<uint64_t> m_movedEntities;
+    bool m_renamed = false;
+};
+
 /// Command to modify layer properties.
 class ModifyLayerCommand : public Command {
 public:
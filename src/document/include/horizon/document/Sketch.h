@@ -42,6 +42,8 @@ public:
 
     // Entity management — entities store local 2D coordinates.
     void addEntity(std::shared_ptr<draft::DraftEntity> entity);
+    /// Append a batch and bulk-rebuild the spatial index once.
+    void addEntities(std::vector<std::shared_ptr<draft::DraftEntity>> entities);
     void removeEntity(uint64_t entityId);
     const std::vector<std::shared_ptr<draft::DraftEntity>>& entities() const;
     std::vector<std::shared_ptr<draft::DraftEntity>>& entities();
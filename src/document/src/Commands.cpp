@@ -1,5 +1,8 @@
 #include "horizon/document/Commands.h"
 
+#include <algorithm>
+#include <future>
+#include <thread>
 #include <unordered_map>
 
 #include "horizon/document/ConstraintSolveHelper.h"
@@ -12,6 +15,66 @@
 
 namespace hz::doc {
 
+namespace {
+
+/// Smallest batch worth spreading over worker threads.
+constexpr size_t kParallelMinEntities = 4096;
+
+/// Call `fn(i)` for every i in [0, count), split into contiguous chunks across the
+/// hardware threads when the batch is large.  `fn` must only touch the i-th item.
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn) {
+    unsigned threads = std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(
+        std::clamp<size_t>(threads, 1, std::max<size_t>(1, count / kParallelMinEntities)));
+    if (threads == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        const size_t begin = count * t / threads;
+        const size_t end = count * (t + 1) / threads;
+        futures.push_back(std::async(std::launch::async, [&fn, begin, end]() {
+            for (size_t i = begin; i < end; ++i) fn(i);
+        }));
+    }
+    for (auto& f : futures) f.get();
+}
+
+/// The entities among `ids` that still exist, in the order given.
+std::vector<std::shared_ptr<draft::DraftEntity>> findEntities(const draft::DraftDocument& doc,
+                                                              const std::vector<uint64_t>& ids) {
+    std::vector<std::shared_ptr<draft::DraftEntity>> entities;
+    entities.reserve(ids.size());
+    for (uint64_t id : ids) {
+        if (auto e = doc.findEntity(id)) entities.push_back(std::move(e));
+    }
+    return entities;
+}
+
+/// Clones of the entities among `ids`, each passed through `transform`.  Cloning stays
+/// on this thread (new entity ids come from a plain counter); the transforms run in
+/// parallel.
+template <typename Transform>
+std::vector<std::shared_ptr<draft::DraftEntity>> transformedClones(
+    const draft::DraftDocument& doc, const std::vector<uint64_t>& ids, Transform&& transform) {
+    auto clones = findEntities(doc, ids);
+    for (auto& e : clones) e = e->clone();
+    parallelFor(clones.size(), [&](size_t i) { transform(*clones[i]); });
+    return clones;
+}
+
+std::vector<uint64_t> idsOf(const std::vector<std::shared_ptr<draft::DraftEntity>>& entities) {
+    std::vector<uint64_t> ids;
+    ids.reserve(entities.size());
+    for (const auto& e : entities) ids.push_back(e->id());
+    return ids;
+}
+
+}  // namespace
+
 // --- AddEntityCommand ---
 
 AddEntityCommand::AddEntityCommand(draft::DraftDocument& doc,
@@ -37,14 +100,7 @@ std::string AddEntityCommand::description() const {
 // --- RemoveEntityCommand ---
 
 RemoveEntityCommand::RemoveEntityCommand(draft::DraftDocument& doc, uint64_t entityId)
-    : m_doc(doc), m_entityId(entityId) {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == entityId) {
-            m_entity = e;
-            break;
-        }
-    }
-}
+    : m_doc(doc), m_entityId(entityId), m_entity(m_doc.findEntity(entityId)) {}
 
 void RemoveEntityCommand::execute() {
     m_doc.removeEntity(m_entityId);
@@ -60,6 +116,24 @@ std::string RemoveEntityCommand::description() const {
     return "Remove Entity";
 }
 
+// --- RemoveEntitiesCommand ---
+
+RemoveEntitiesCommand::RemoveEntitiesCommand(draft::DraftDocument& doc,
+                                             const std::vector<uint64_t>& entityIds)
+    : m_doc(doc), m_entities(findEntities(doc, entityIds)) {}
+
+void RemoveEntitiesCommand::execute() {
+    m_doc.removeEntities(idsOf(m_entities));
+}
+
+void RemoveEntitiesCommand::undo() {
+    m_doc.addEntities(m_entities);
+}
+
+std::string RemoveEntitiesCommand::description() const {
+    return "Remove Entities";
+}
+
 // --- MoveEntityCommand ---
 
 MoveEntityCommand::MoveEntityCommand(draft::DraftDocument& doc,
@@ -74,15 +148,9 @@ MoveEntityCommand::MoveEntityCommand(draft::DraftDocument& doc,
       m_variableResolver(std::move(variableResolver)) {}
 
 void MoveEntityCommand::execute() {
-    for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->translate(m_delta);
-                break;
-            }
-        }
-    }
-    m_doc.rebuildSpatialIndex();
+    auto entities = findEntities(m_doc, m_entityIds);
+    parallelFor(entities.size(), [&](size_t i) { entities[i]->translate(m_delta); });
+    m_doc.updateEntities(entities);
 
     // Auto-solve constraints after geometry change.
     if (!m_solveCmd) {
@@ -101,15 +169,9 @@ void MoveEntityCommand::undo() {
     }
 
     math::Vec2 neg{-m_delta.x, -m_delta.y};
-    for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->translate(neg);
-                break;
-            }
-        }
-    }
-    m_doc.rebuildSpatialIndex();
+    auto entities = findEntities(m_doc, m_entityIds);
+    parallelFor(entities.size(), [&](size_t i) { entities[i]->translate(neg); });
+    m_doc.updateEntities(entities);
 }
 
 std::string MoveEntityCommand::description() const {
@@ -149,27 +211,15 @@ DuplicateEntityCommand::DuplicateEntityCommand(draft::DraftDocument& doc,
 
 void DuplicateEntityCommand::execute() {
     if (m_clones.empty()) {
-        for (uint64_t id : m_sourceIds) {
-            for (const auto& e : m_doc.entities()) {
-                if (e->id() == id) {
-                    auto clone = e->clone();
-                    clone->translate(m_offset);
-                    m_clones.push_back(clone);
-                    break;
-                }
-            }
-        }
+        m_clones = transformedClones(m_doc, m_sourceIds,
+                                     [&](draft::DraftEntity& e) { e.translate(m_offset); });
         remapCloneGroupIds(m_doc, m_clones);
     }
-    for (const auto& clone : m_clones) {
-        m_doc.addEntity(clone);
-    }
+    m_doc.addEntities(m_clones);
 }
 
 void DuplicateEntityCommand::undo() {
-    for (const auto& clone : m_clones) {
-        m_doc.removeEntity(clone->id());
-    }
+    m_doc.removeEntities(idsOf(m_clones));
 }
 
 std::string DuplicateEntityCommand::description() const {
@@ -177,12 +227,7 @@ std::string DuplicateEntityCommand::description() const {
 }
 
 std::vector<uint64_t> DuplicateEntityCommand::clonedIds() const {
-    std::vector<uint64_t> ids;
-    ids.reserve(m_clones.size());
-    for (const auto& clone : m_clones) {
-        ids.push_back(clone->id());
-    }
-    return ids;
+    return idsOf(m_clones);
 }
 
 // --- MirrorEntityCommand ---
@@ -194,27 +239,15 @@ MirrorEntityCommand::MirrorEntityCommand(draft::DraftDocument& doc,
 
 void MirrorEntityCommand::execute() {
     if (m_mirroredEntities.empty()) {
-        for (uint64_t id : m_sourceIds) {
-            for (const auto& e : m_doc.entities()) {
-                if (e->id() == id) {
-                    auto mirrored = e->clone();
-                    mirrored->mirror(m_axisP1, m_axisP2);
-                    m_mirroredEntities.push_back(mirrored);
-                    break;
-                }
-            }
-        }
+        m_mirroredEntities = transformedClones(
+            m_doc, m_sourceIds, [&](draft::DraftEntity& e) { e.mirror(m_axisP1, m_axisP2); });
         remapCloneGroupIds(m_doc, m_mirroredEntities);
     }
-    for (const auto& e : m_mirroredEntities) {
-        m_doc.addEntity(e);
-    }
+    m_doc.addEntities(m_mirroredEntities);
 }
 
 void MirrorEntityCommand::undo() {
-    for (const auto& e : m_mirroredEntities) {
-        m_doc.removeEntity(e->id());
-    }
+    m_doc.removeEntities(idsOf(m_mirroredEntities));
 }
 
 std::string MirrorEntityCommand::description() const {
@@ -222,12 +255,7 @@ std::string MirrorEntityCommand::description() const {
 }
 
 std::vector<uint64_t> MirrorEntityCommand::mirroredIds() const {
-    std::vector<uint64_t> ids;
-    ids.reserve(m_mirroredEntities.size());
-    for (const auto& e : m_mirroredEntities) {
-        ids.push_back(e->id());
-    }
-    return ids;
+    return idsOf(m_mirroredEntities);
 }
 
 // --- RotateEntityCommand ---
@@ -239,27 +267,15 @@ RotateEntityCommand::RotateEntityCommand(draft::DraftDocument& doc,
 
 void RotateEntityCommand::execute() {
     if (m_rotatedEntities.empty()) {
-        for (uint64_t id : m_sourceIds) {
-            for (const auto& e : m_doc.entities()) {
-                if (e->id() == id) {
-                    auto rotated = e->clone();
-                    rotated->rotate(m_center, m_angle);
-                    m_rotatedEntities.push_back(rotated);
-                    break;
-                }
-            }
-        }
+        m_rotatedEntities = transformedClones(
+            m_doc, m_sourceIds, [&](draft::DraftEntity& e) { e.rotate(m_center, m_angle); });
         remapCloneGroupIds(m_doc, m_rotatedEntities);
     }
-    for (const auto& e : m_rotatedEntities) {
-        m_doc.addEntity(e);
-    }
+    m_doc.addEntities(m_rotatedEntities);
 }
 
 void RotateEntityCommand::undo() {
-    for (const auto& e : m_rotatedEntities) {
-        m_doc.removeEntity(e->id());
-    }
+    m_doc.removeEntities(idsOf(m_rotatedEntities));
 }
 
 std::string RotateEntityCommand::description() const {
@@ -267,12 +283,7 @@ std::string RotateEntityCommand::description() const {
 }
 
 std::vector<uint64_t> RotateEntityCommand::rotatedIds() const {
-    std::vector<uint64_t> ids;
-    ids.reserve(m_rotatedEntities.size());
-    for (const auto& e : m_rotatedEntities) {
-        ids.push_back(e->id());
-    }
-    return ids;
+    return idsOf(m_rotatedEntities);
 }
 
 // --- ScaleEntityCommand ---
@@ -284,27 +295,15 @@ ScaleEntityCommand::ScaleEntityCommand(draft::DraftDocument& doc,
 
 void ScaleEntityCommand::execute() {
     if (m_scaledEntities.empty()) {
-        for (uint64_t id : m_sourceIds) {
-            for (const auto& e : m_doc.entities()) {
-                if (e->id() == id) {
-                    auto scaled = e->clone();
-                    scaled->scale(m_basePoint, m_factor);
-                    m_scaledEntities.push_back(scaled);
-                    break;
-                }
-            }
-        }
+        m_scaledEntities = transformedClones(
+            m_doc, m_sourceIds, [&](draft::DraftEntity& e) { e.scale(m_basePoint, m_factor); });
         remapCloneGroupIds(m_doc, m_scaledEntities);
     }
-    for (const auto& e : m_scaledEntities) {
-        m_doc.addEntity(e);
-    }
+    m_doc.addEntities(m_scaledEntities);
 }
 
 void ScaleEntityCommand::undo() {
-    for (const auto& e : m_scaledEntities) {
-        m_doc.removeEntity(e->id());
-    }
+    m_doc.removeEntities(idsOf(m_scaledEntities));
 }
 
 std::string ScaleEntityCommand::description() const {
@@ -312,12 +311,7 @@ std::string ScaleEntityCommand::description() const {
 }
 
 std::vector<uint64_t> ScaleEntityCommand::scaledIds() const {
-    std::vector<uint64_t> ids;
-    ids.reserve(m_scaledEntities.size());
-    for (const auto& e : m_scaledEntities) {
-        ids.push_back(e->id());
-    }
-    return ids;
+    return idsOf(m_scaledEntities);
 }
 
 // --- ChangeEntityLayerCommand ---
@@ -325,28 +319,24 @@ std::vector<uint64_t> ScaleEntityCommand::scaledIds() const {
 ChangeEntityLayerCommand::ChangeEntityLayerCommand(draft::DraftDocument& doc,
                                                    const std::vector<uint64_t>& entityIds,
                                                    const std::string& newLayer)
-    : m_doc(doc), m_entityIds(entityIds), m_newLayer(newLayer) {}
+    : m_doc(doc), m_entityIds(entityIds), m_newLayer(draft::LayerNames::intern(newLayer)) {}
 
 void ChangeEntityLayerCommand::execute() {
     m_oldLayers.clear();
     for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_oldLayers.emplace_back(id, e->layer());
-                e->setLayer(m_newLayer);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            m_oldLayers.emplace_back(id, e->layerId());
+            e->setLayerId(m_newLayer);
+            m_doc.updateEntity(e);
         }
     }
 }
 
 void ChangeEntityLayerCommand::undo() {
     for (const auto& [id, oldLayer] : m_oldLayers) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setLayer(oldLayer);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setLayerId(oldLayer);
+            m_doc.updateEntity(e);
         }
     }
 }
@@ -365,23 +355,17 @@ ChangeEntityColorCommand::ChangeEntityColorCommand(draft::DraftDocument& doc,
 void ChangeEntityColorCommand::execute() {
     m_oldColors.clear();
     for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_oldColors.emplace_back(id, e->color());
-                e->setColor(m_newColor);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            m_oldColors.emplace_back(id, e->color());
+            e->setColor(m_newColor);
         }
     }
 }
 
 void ChangeEntityColorCommand::undo() {
     for (const auto& [id, oldColor] : m_oldColors) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setColor(oldColor);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setColor(oldColor);
         }
     }
 }
@@ -400,23 +384,17 @@ ChangeEntityLineWidthCommand::ChangeEntityLineWidthCommand(draft::DraftDocument&
 void ChangeEntityLineWidthCommand::execute() {
     m_oldWidths.clear();
     for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_oldWidths.emplace_back(id, e->lineWidth());
-                e->setLineWidth(m_newWidth);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            m_oldWidths.emplace_back(id, e->lineWidth());
+            e->setLineWidth(m_newWidth);
         }
     }
 }
 
 void ChangeEntityLineWidthCommand::undo() {
     for (const auto& [id, oldWidth] : m_oldWidths) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setLineWidth(oldWidth);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setLineWidth(oldWidth);
         }
     }
 }
@@ -435,23 +413,17 @@ ChangeEntityLineTypeCommand::ChangeEntityLineTypeCommand(draft::DraftDocument& d
 void ChangeEntityLineTypeCommand::execute() {
     m_oldLineTypes.clear();
     for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_oldLineTypes.emplace_back(id, e->lineType());
-                e->setLineType(m_newLineType);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            m_oldLineTypes.emplace_back(id, e->lineType());
+            e->setLineType(m_newLineType);
         }
     }
 }
 
 void ChangeEntityLineTypeCommand::undo() {
     for (const auto& [id, oldLt] : m_oldLineTypes) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setLineType(oldLt);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setLineType(oldLt);
         }
     }
 }
@@ -467,24 +439,18 @@ ChangeTextOverrideCommand::ChangeTextOverrideCommand(draft::DraftDocument& doc,
     : m_doc(doc), m_entityId(entityId), m_newText(newText) {}
 
 void ChangeTextOverrideCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* dim = dynamic_cast<draft::DraftDimension*>(e.get())) {
-                m_oldText = dim->textOverride();
-                dim->setTextOverride(m_newText);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* dim = dynamic_cast<draft::DraftDimension*>(e.get())) {
+            m_oldText = dim->textOverride();
+            dim->setTextOverride(m_newText);
         }
     }
 }
 
 void ChangeTextOverrideCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* dim = dynamic_cast<draft::DraftDimension*>(e.get())) {
-                dim->setTextOverride(m_oldText);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* dim = dynamic_cast<draft::DraftDimension*>(e.get())) {
+            dim->setTextOverride(m_oldText);
         }
     }
 }
@@ -517,46 +483,47 @@ RemoveLayerCommand::RemoveLayerCommand(draft::LayerManager& mgr, draft::DraftDoc
     : m_mgr(mgr), m_doc(doc), m_name(layerName) {}
 
 void RemoveLayerCommand::execute() {
-    if (m_name == "0") return;  // Never remove the default layer.
+    auto layer = draft::LayerNames::find(m_name);
+    if (!layer || *layer == draft::kDefaultLayerId) return;  // Never remove the default layer.
 
     // Save layer properties.
-    const auto* lp = m_mgr.getLayer(m_name);
+    const auto* lp = m_mgr.getLayer(*layer);
     if (lp) m_savedProps = *lp;
 
     // Move entities on this layer to "0".
     m_movedEntities.clear();
     for (const auto& e : m_doc.entities()) {
-        if (e->layer() == m_name) {
-            m_movedEntities.emplace_back(e->id(), e->layer());
-            e->setLayer("0");
+        if (e->layerId() == *layer) {
+            m_movedEntities.push_back(e->id());
+            e->setLayerId(draft::kDefaultLayerId);
+            m_doc.updateEntity(e);
         }
     }
 
     // If this is the current layer, switch to "0" first.
-    m_wasCurrentLayer = (m_mgr.currentLayer() == m_name);
+    m_wasCurrentLayer = (m_mgr.currentLayerId() == *layer);
     if (m_wasCurrentLayer) {
-        m_mgr.setCurrentLayer("0");
+        m_mgr.setCurrentLayer(draft::kDefaultLayerId);
     }
-    m_mgr.removeLayer(m_name);
+    m_mgr.removeLayer(*layer);
 }
 
 void RemoveLayerCommand::undo() {
-    if (m_name == "0") return;
+    auto layer = draft::LayerNames::find(m_name);
+    if (!layer || *layer == draft::kDefaultLayerId) return;
 
     m_mgr.addLayer(m_savedProps);
 
     // Restore current layer if it was current before removal.
     if (m_wasCurrentLayer) {
-        m_mgr.setCurrentLayer(m_name);
+        m_mgr.setCurrentLayer(*layer);
     }
 
     // Restore entity layers.
-    for (const auto& [id, oldLayer] : m_movedEntities) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setLayer(oldLayer);
-                break;
-            }
+    for (uint64_t id : m_movedEntities) {
+        if (auto e = m_doc.findEntity(id)) {
+            e->setLayerId(*layer);
+            m_doc.updateEntity(e);
         }
     }
 }
@@ -565,6 +532,46 @@ std::string RemoveLayerCommand::description() const {
     return "Remove Layer";
 }
 
+// --- RenameLayerCommand ---
+
+RenameLayerCommand::RenameLayerCommand(draft::LayerManager& mgr, draft::DraftDocument& doc,
+                                       const std::string& oldName, const std::string& newName)
+    : m_mgr(mgr), m_doc(doc), m_oldName(oldName), m_newName(newName) {}
+
+void RenameLayerCommand::execute() {
+    m_renamed = false;
+    auto oldId = draft::LayerNames::find(m_oldName);
+    if (!oldId) return;
+    auto newId = m_mgr.renameLayer(*oldId, m_newName);
+    if (!newId) return;
+    m_renamed = true;
+
+    m_movedEntities.clear();
+    for (const auto& e : m_doc.entities()) {
+        if (e->layerId() == *oldId) {
+            m_movedEntities.push_back(e->id());
+            e->setLayerId(*newId);
+            m_doc.updateEntity(e);
+        }
+    }
+}
+
+void RenameLayerCommand::undo() {
+    if (!m_renamed) return;
+    auto oldId = m_mgr.renameLayer(draft::LayerNames::intern(m_newName), m_oldName);
+    if (!oldId) return;
+    for (uint64_t id : m_movedEntities) {
+        if (auto e = m_doc.findEntity(id)) {
+            e->setLayerId(*oldId);
+            m_doc.updateEntity(e);
+        }
+    }
+}
+
+std::string RenameLayerCommand::description() const {
+    return "Rename Layer";
+}
+
 // --- ModifyLayerCommand ---
 
 ModifyLayerCommand::ModifyLayerCommand(draft::LayerManager& mgr, const std::string& layerName,
@@ -620,15 +627,12 @@ void CreateBlockCommand::execute() {
     m_savedEntities.clear();
     math::Vec2 centroid;
     for (uint64_t id : m_entityIds) {
-        for (const auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_savedEntities.push_back(e);
-                auto bb = e->boundingBox();
-                if (bb.isValid()) {
-                    auto c = bb.center();
-                    centroid += math::Vec2(c.x, c.y);
-                }
-                break;
+        if (auto e = m_doc.findEntity(id)) {
+            m_savedEntities.push_back(e);
+            auto bb = e->boundingBox();
+            if (bb.isValid()) {
+                auto c = bb.center();
+                centroid += math::Vec2(c.x, c.y);
             }
         }
     }
@@ -683,11 +687,8 @@ ExplodeBlockCommand::ExplodeBlockCommand(draft::DraftDocument& doc, uint64_t blo
 
 void ExplodeBlockCommand::execute() {
     // Find the block reference.
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_blockRefId) {
-            m_savedBlockRef = e;
-            break;
-        }
+    if (auto e = m_doc.findEntity(m_blockRefId)) {
+        m_savedBlockRef = e;
     }
     auto* ref = dynamic_cast<draft::DraftBlockRef*>(m_savedBlockRef.get());
     if (!ref) return;
@@ -701,8 +702,8 @@ void ExplodeBlockCommand::execute() {
         worldEnt->rotate(ref->definition()->basePoint, ref->rotation());
         worldEnt->translate(ref->insertPos() - ref->definition()->basePoint);
         // Inherit layer from block ref if entity is on default layer.
-        if (worldEnt->layer().empty() || worldEnt->layer() == "0") {
-            worldEnt->setLayer(ref->layer());
+        if (worldEnt->layerId() == draft::kDefaultLayerId || worldEnt->layer().empty()) {
+            worldEnt->setLayerId(ref->layerId());
         }
         // ByBlock color: if entity color is 0, inherit from block ref.
         if (worldEnt->color() == 0x00000000) {
@@ -752,28 +753,22 @@ ChangeBlockRefRotationCommand::ChangeBlockRefRotationCommand(draft::DraftDocumen
     : m_doc(doc), m_entityId(entityId), m_newRotation(newRotation) {}
 
 void ChangeBlockRefRotationCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
-                m_oldRotation = ref->rotation();
-                ref->setRotation(m_newRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
+            m_oldRotation = ref->rotation();
+            ref->setRotation(m_newRotation);
+            m_doc.updateEntity(e);
         }
     }
-    m_doc.rebuildSpatialIndex();
 }
 
 void ChangeBlockRefRotationCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
-                ref->setRotation(m_oldRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
+            ref->setRotation(m_oldRotation);
+            m_doc.updateEntity(e);
         }
     }
-    m_doc.rebuildSpatialIndex();
 }
 
 std::string ChangeBlockRefRotationCommand::description() const {
@@ -787,28 +782,22 @@ ChangeBlockRefScaleCommand::ChangeBlockRefScaleCommand(draft::DraftDocument& doc
     : m_doc(doc), m_entityId(entityId), m_newScale(newScale) {}
 
 void ChangeBlockRefScaleCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
-                m_oldScale = ref->uniformScale();
-                ref->setUniformScale(m_newScale);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
+            m_oldScale = ref->uniformScale();
+            ref->setUniformScale(m_newScale);
+            m_doc.updateEntity(e);
         }
     }
-    m_doc.rebuildSpatialIndex();
 }
 
 void ChangeBlockRefScaleCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
-                ref->setUniformScale(m_oldScale);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* ref = dynamic_cast<draft::DraftBlockRef*>(e.get())) {
+            ref->setUniformScale(m_oldScale);
+            m_doc.updateEntity(e);
         }
     }
-    m_doc.rebuildSpatialIndex();
 }
 
 std::string ChangeBlockRefScaleCommand::description() const {
@@ -822,24 +811,18 @@ ChangeTextContentCommand::ChangeTextContentCommand(draft::DraftDocument& doc, ui
     : m_doc(doc), m_entityId(entityId), m_newText(newText) {}
 
 void ChangeTextContentCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                m_oldText = txt->text();
-                txt->setText(m_newText);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            m_oldText = txt->text();
+            txt->setText(m_newText);
         }
     }
 }
 
 void ChangeTextContentCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                txt->setText(m_oldText);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            txt->setText(m_oldText);
         }
     }
 }
@@ -855,24 +838,18 @@ ChangeTextHeightCommand::ChangeTextHeightCommand(draft::DraftDocument& doc, uint
     : m_doc(doc), m_entityId(entityId), m_newHeight(newHeight) {}
 
 void ChangeTextHeightCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                m_oldHeight = txt->textHeight();
-                txt->setTextHeight(m_newHeight);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            m_oldHeight = txt->textHeight();
+            txt->setTextHeight(m_newHeight);
         }
     }
 }
 
 void ChangeTextHeightCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                txt->setTextHeight(m_oldHeight);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            txt->setTextHeight(m_oldHeight);
         }
     }
 }
@@ -888,24 +865,18 @@ ChangeTextRotationCommand::ChangeTextRotationCommand(draft::DraftDocument& doc,
     : m_doc(doc), m_entityId(entityId), m_newRotation(newRotation) {}
 
 void ChangeTextRotationCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                m_oldRotation = txt->rotation();
-                txt->setRotation(m_newRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            m_oldRotation = txt->rotation();
+            txt->setRotation(m_newRotation);
         }
     }
 }
 
 void ChangeTextRotationCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                txt->setRotation(m_oldRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            txt->setRotation(m_oldRotation);
         }
     }
 }
@@ -921,24 +892,18 @@ ChangeTextAlignmentCommand::ChangeTextAlignmentCommand(draft::DraftDocument& doc
     : m_doc(doc), m_entityId(entityId), m_newAlignment(newAlignment) {}
 
 void ChangeTextAlignmentCommand::execute() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                m_oldAlignment = static_cast<int>(txt->alignment());
-                txt->setAlignment(static_cast<draft::TextAlignment>(m_newAlignment));
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            m_oldAlignment = static_cast<int>(txt->alignment());
+            txt->setAlignment(static_cast<draft::TextAlignment>(m_newAlignment));
         }
     }
 }
 
 void ChangeTextAlignmentCommand::undo() {
-    for (const auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
-                txt->setAlignment(static_cast<draft::TextAlignment>(m_oldAlignment));
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* txt = dynamic_cast<draft::DraftText*>(e.get())) {
+            txt->setAlignment(static_cast<draft::TextAlignment>(m_oldAlignment));
         }
     }
 }
@@ -956,24 +921,18 @@ ChangeSplineClosedCommand::ChangeSplineClosedCommand(draft::DraftDocument& doc,
     : m_doc(doc), m_entityId(entityId), m_newClosed(newClosed) {}
 
 void ChangeSplineClosedCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* sp = dynamic_cast<draft::DraftSpline*>(e.get())) {
-                m_oldClosed = sp->closed();
-                sp->setClosed(m_newClosed);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* sp = dynamic_cast<draft::DraftSpline*>(e.get())) {
+            m_oldClosed = sp->closed();
+            sp->setClosed(m_newClosed);
         }
     }
 }
 
 void ChangeSplineClosedCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* sp = dynamic_cast<draft::DraftSpline*>(e.get())) {
-                sp->setClosed(m_oldClosed);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* sp = dynamic_cast<draft::DraftSpline*>(e.get())) {
+            sp->setClosed(m_oldClosed);
         }
     }
 }
@@ -991,24 +950,18 @@ ChangeHatchPatternCommand::ChangeHatchPatternCommand(draft::DraftDocument& doc,
     : m_doc(doc), m_entityId(entityId), m_newPattern(newPattern) {}
 
 void ChangeHatchPatternCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                m_oldPattern = static_cast<int>(h->pattern());
-                h->setPattern(static_cast<draft::HatchPattern>(m_newPattern));
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            m_oldPattern = static_cast<int>(h->pattern());
+            h->setPattern(static_cast<draft::HatchPattern>(m_newPattern));
         }
     }
 }
 
 void ChangeHatchPatternCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                h->setPattern(static_cast<draft::HatchPattern>(m_oldPattern));
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            h->setPattern(static_cast<draft::HatchPattern>(m_oldPattern));
         }
     }
 }
@@ -1026,24 +979,18 @@ ChangeHatchAngleCommand::ChangeHatchAngleCommand(draft::DraftDocument& doc, uint
     : m_doc(doc), m_entityId(entityId), m_newAngle(newAngle) {}
 
 void ChangeHatchAngleCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                m_oldAngle = h->angle();
-                h->setAngle(m_newAngle);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            m_oldAngle = h->angle();
+            h->setAngle(m_newAngle);
         }
     }
 }
 
 void ChangeHatchAngleCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                h->setAngle(m_oldAngle);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            h->setAngle(m_oldAngle);
         }
     }
 }
@@ -1061,24 +1008,18 @@ ChangeHatchSpacingCommand::ChangeHatchSpacingCommand(draft::DraftDocument& doc,
     : m_doc(doc), m_entityId(entityId), m_newSpacing(newSpacing) {}
 
 void ChangeHatchSpacingCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                m_oldSpacing = h->spacing();
-                h->setSpacing(m_newSpacing);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            m_oldSpacing = h->spacing();
+            h->setSpacing(m_newSpacing);
         }
     }
 }
 
 void ChangeHatchSpacingCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
-                h->setSpacing(m_oldSpacing);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* h = dynamic_cast<draft::DraftHatch*>(e.get())) {
+            h->setSpacing(m_oldSpacing);
         }
     }
 }
@@ -1096,24 +1037,18 @@ ChangeEllipseSemiMajorCommand::ChangeEllipseSemiMajorCommand(draft::DraftDocumen
     : m_doc(doc), m_entityId(entityId), m_newValue(newValue) {}
 
 void ChangeEllipseSemiMajorCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                m_oldValue = el->semiMajor();
-                el->setSemiMajor(m_newValue);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            m_oldValue = el->semiMajor();
+            el->setSemiMajor(m_newValue);
         }
     }
 }
 
 void ChangeEllipseSemiMajorCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                el->setSemiMajor(m_oldValue);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            el->setSemiMajor(m_oldValue);
         }
     }
 }
@@ -1131,24 +1066,18 @@ ChangeEllipseSemiMinorCommand::ChangeEllipseSemiMinorCommand(draft::DraftDocumen
     : m_doc(doc), m_entityId(entityId), m_newValue(newValue) {}
 
 void ChangeEllipseSemiMinorCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                m_oldValue = el->semiMinor();
-                el->setSemiMinor(m_newValue);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            m_oldValue = el->semiMinor();
+            el->setSemiMinor(m_newValue);
         }
     }
 }
 
 void ChangeEllipseSemiMinorCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                el->setSemiMinor(m_oldValue);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            el->setSemiMinor(m_oldValue);
         }
     }
 }
@@ -1166,24 +1095,18 @@ ChangeEllipseRotationCommand::ChangeEllipseRotationCommand(draft::DraftDocument&
     : m_doc(doc), m_entityId(entityId), m_newRotation(newRotation) {}
 
 void ChangeEllipseRotationCommand::execute() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                m_oldRotation = el->rotation();
-                el->setRotation(m_newRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            m_oldRotation = el->rotation();
+            el->setRotation(m_newRotation);
         }
     }
 }
 
 void ChangeEllipseRotationCommand::undo() {
-    for (auto& e : m_doc.entities()) {
-        if (e->id() == m_entityId) {
-            if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
-                el->setRotation(m_oldRotation);
-            }
-            break;
+    if (auto e = m_doc.findEntity(m_entityId)) {
+        if (auto* el = dynamic_cast<draft::DraftEllipse*>(e.get())) {
+            el->setRotation(m_oldRotation);
         }
     }
 }
@@ -1212,7 +1135,9 @@ void GripMoveCommand::execute() {
     if (m_firstExec) {
         // State is already applied by the caller (live grip drag).
         m_firstExec = false;
-        m_doc.rebuildSpatialIndex();
+        if (auto e = m_doc.findEntity(m_entityId)) {
+            m_doc.updateEntity(e);
+        }
 
         // Auto-solve constraints after geometry change.
         m_solveCmd = ConstraintSolveHelper::solveAndCreateCommand(m_doc, m_constraintSystem,
@@ -1243,21 +1168,15 @@ std::string GripMoveCommand::description() const {
 }
 
 void GripMoveCommand::applyState(const draft::DraftEntity& state) {
-    auto& entities = m_doc.entities();
-    for (auto& e : entities) {
-        if (e->id() == m_entityId) {
-            auto replacement = state.clone();
-            replacement->setId(m_entityId);
-            replacement->setLayer(state.layer());
-            replacement->setColor(state.color());
-            replacement->setLineWidth(state.lineWidth());
-            replacement->setLineType(state.lineType());
-            replacement->setGroupId(state.groupId());
-            e = replacement;
-            m_doc.rebuildSpatialIndex();
-            return;
-        }
-    }
+    if (!m_doc.findEntity(m_entityId)) return;
+    auto replacement = state.clone();
+    replacement->setId(m_entityId);
+    replacement->setLayerId(state.layerId());
+    replacement->setColor(state.color());
+    replacement->setLineWidth(state.lineWidth());
+    replacement->setLineType(state.lineType());
+    replacement->setGroupId(state.groupId());
+    m_doc.replaceEntity(replacement);
 }
 
 // ---------------------------------------------------------------------------
@@ -1274,23 +1193,17 @@ void GroupEntitiesCommand::execute() {
     }
     m_oldGroupIds.clear();
     for (uint64_t id : m_entityIds) {
-        for (auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                m_oldGroupIds.emplace_back(id, e->groupId());
-                e->setGroupId(m_newGroupId);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            m_oldGroupIds.emplace_back(id, e->groupId());
+            e->setGroupId(m_newGroupId);
         }
     }
 }
 
 void GroupEntitiesCommand::undo() {
     for (const auto& [id, oldGid] : m_oldGroupIds) {
-        for (auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setGroupId(oldGid);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setGroupId(oldGid);
         }
     }
 }
@@ -1324,11 +1237,8 @@ void UngroupEntitiesCommand::execute() {
 
 void UngroupEntitiesCommand::undo() {
     for (const auto& [id, gid] : m_savedGroupIds) {
-        for (auto& e : m_doc.entities()) {
-            if (e->id() == id) {
-                e->setGroupId(gid);
-                break;
-            }
+        if (auto e = m_doc.findEntity(id)) {
+            e->setGroupId(gid);
         }
     }
 }
@@ -124,23 +124,19 @@ ApplyConstraintSolveCommand::ApplyConstraintSolveCommand(draft::DraftDocument& d
 
 void ApplyConstraintSolveCommand::execute() {
     applyStates(true);  // Apply afterState
-    m_doc.rebuildSpatialIndex();
 }
 
 void ApplyConstraintSolveCommand::undo() {
     applyStates(false);  // Apply beforeState
-    m_doc.rebuildSpatialIndex();
 }
 
 void ApplyConstraintSolveCommand::applyStates(bool useAfter) {
     for (const auto& snap : m_snapshots) {
         const auto& src = useAfter ? snap.afterState : snap.beforeState;
         if (!src) continue;
-        for (auto& entity : m_doc.entities()) {
-            if (entity->id() == snap.entityId) {
-                copyEntityGeometry(*src, *entity);
-                break;
-            }
+        if (auto entity = m_doc.findEntity(snap.entityId)) {
+            copyEntityGeometry(*src, *entity);
+            m_doc.updateEntity(entity);
         }
     }
 }
@@ -59,6 +59,15 @@ void Sketch::addEntity(std::shared_ptr<draft::DraftEntity> entity) {
     m_spatialIndex.insert(entity);
 }
 
+void Sketch::addEntities(std::vector<std::shared_ptr<draft::DraftEntity>> entities) {
+    if (entities.empty()) return;
+    m_entities.reserve(m_entities.size() + entities.size());
+    for (auto& entity : entities) {
+        if (entity) m_entities.push_back(std::move(entity));
+    }
+    m_spatialIndex.rebuild(m_entities);
+}
+
 void Sketch::removeEntity(uint64_t entityId) {
     m_spatialIndex.remove(entityId);
     m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(),
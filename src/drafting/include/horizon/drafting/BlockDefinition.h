@@ -1,19 +1,79 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "DisplayList.h"
 #include "DraftEntity.h"
+#include "horizon/math/BoundingBox.h"
 #include "horizon/math/Vec2.h"
 
 namespace hz::draft {
 
+/// Data derived from a block's entities that every reference to it shares.  Coordinates
+/// are block-local -- relative to the base point -- so a reference only has to apply its
+/// rotation, scale and insert position.
+struct BlockGeometry {
+    uint64_t stamp = 0;  ///< BlockDefinition::contentStamp() this was built from.
+
+    /// Sub-entities tessellated once, one stroke per entity with its own (possibly
+    /// ByBlock) style.
+    DisplayList display;
+
+    std::vector<math::BoundingBox> entityBounds;  ///< Per sub-entity; invalid if empty.
+    math::BoundingBox bounds;                     ///< Union of entityBounds.
+
+    /// Convex hull of the corners of every entity box.  Transforming the hull bounds a
+    /// reference exactly as transforming every corner would, with far fewer points.
+    std::vector<math::Vec2> hull;
+
+    std::vector<math::Vec2> snapPoints;
+};
+
 /// A named block definition: a base point and a set of entity templates.
+///
+/// contentStamp() and geometry() are cached and may be called from several threads at
+/// once, as long as none edits the definition or its templates meanwhile.  Copies start
+/// with an empty cache.
 struct BlockDefinition {
     std::string name;
     math::Vec2 basePoint;
     std::vector<std::shared_ptr<DraftEntity>> entities;
+
+    /// Hash of everything geometry() depends on: the base point and the identity and
+    /// version of every entity.  Editing a template in place changes it.  The hash is
+    /// kept until an entity version changes anywhere (see DraftEntity::versionCounter())
+    /// or the base point or entity count does, so repeated calls do not walk the entities.
+    uint64_t contentStamp() const;
+
+    /// Block-local geometry, rebuilt on first use after the content stamp changes.  The
+    /// result is immutable and stays valid after a later rebuild replaces it.
+    std::shared_ptr<const BlockGeometry> geometry() const;
+
+    /// Drop the cached stamp.  Needed only after an edit that none of the above sees:
+    /// reordering the templates, or putting existing entities in place of others.
+    void markModified();
+
+private:
+    struct Cache {
+        Cache() = default;
+        Cache(const Cache&) {}
+        Cache& operator=(const Cache&);
+
+        std::mutex mutex;       ///< guards the fields below
+        std::mutex buildMutex;  ///< held while building geometry, so one thread builds it
+        bool stampValid = false;
+        uint64_t versionCounter = 0;  ///< DraftEntity::versionCounter() the stamp saw
+        math::Vec2 basePoint;
+        const void* entityData = nullptr;
+        size_t entityCount = 0;
+        uint64_t stamp = 0;
+        std::shared_ptr<const BlockGeometry> geometry;
+    };
+    mutable Cache m_cache;
 };
 
 }  // namespace hz::draft
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "horizon/math/BoundingBox.h"
+#include "horizon/math/Vec2.h"
+
+namespace hz::draft {
+
+/// A curve flattened to a polyline within a chordal tolerance, plus a bounding-volume
+/// hierarchy over its segments so proximity tests on long curves visit only the runs
+/// of segments near the query point.
+struct CurveFlattening {
+    uint64_t version = 0;    ///< DraftEntity::version() it was built from
+    int bucket = 0;          ///< tolerance bucket; see CurveCache::bucketOf()
+    std::vector<math::Vec2> points;
+
+    /// Hierarchy node over segments [begin, end) (segment i joins points i and i + 1).
+    /// An inner node's left child follows it directly; `right` indexes the other one.
+    struct Node {
+        double minX, minY, maxX, maxY;
+        uint32_t begin, end;
+        uint32_t right;  ///< 0 for leaves
+    };
+    std::vector<Node> nodes;
+
+    /// Build the segment hierarchy for `points`.
+    void buildHierarchy();
+
+    /// True when some segment passes within `tolerance` of `p`.
+    bool nearPoint(const math::Vec2& p, double tolerance) const;
+
+    /// Box of all points (empty when there are none).
+    math::BoundingBox bounds() const;
+};
+
+/// Per-entity cache of derived curve geometry for DraftSpline and DraftEllipse.
+///
+/// Flattenings are kept per tolerance bucket -- tolerances are rounded down to a power
+/// of two, so nearby requests share one polyline that is at least as fine as asked --
+/// with the few most recently used buckets retained.  Entries carry the entity version
+/// they were built from, so any mutation (which bumps the version) invalidates them
+/// without explicit bookkeeping.  Lookups are thread-safe; results are immutable and
+/// shared, so they stay valid after the entity changes.  Copies start empty.
+class CurveCache {
+public:
+    using Flattener = std::function<std::vector<math::Vec2>(double tolerance)>;
+
+    CurveCache() = default;
+    CurveCache(const CurveCache&) {}
+    CurveCache& operator=(const CurveCache&);
+
+    /// Flattening of the curve at `version` within `tolerance`; `flatten` is called
+    /// with the bucket's tolerance on a miss.
+    std::shared_ptr<const CurveFlattening> flattening(uint64_t version, double tolerance,
+                                                      const Flattener& flatten) const;
+
+    /// The entity's standard flattening at `version`, the one rendering, picking and
+    /// intersection share.  Kept in its own slot, and `tolerance` (which may itself
+    /// cost a pass over the curve) is only asked on a miss.
+    std::shared_ptr<const CurveFlattening> standardFlattening(
+        uint64_t version, const std::function<double()>& tolerance,
+        const Flattener& flatten) const;
+
+    /// Bounding box at `version`, computed by `compute` on a miss.
+    math::BoundingBox bounds(uint64_t version,
+                             const std::function<math::BoundingBox()>& compute) const;
+
+    /// Bucket of `tolerance`: floor(log2(tolerance)).
+    static int bucketOf(double tolerance);
+
+    /// Largest tolerance of a bucket, 2^bucket.
+    static double bucketTolerance(int bucket);
+
+private:
+    static constexpr size_t kSlots = 4;
+
+    mutable std::mutex m_mutex;
+    /// Most recently used first.
+    mutable std::array<std::shared_ptr<const CurveFlattening>, kSlots> m_slots;
+    mutable std::shared_ptr<const CurveFlattening> m_standard;
+    mutable uint64_t m_boundsVersion = 0;
+    mutable std::optional<math::BoundingBox> m_bounds;
+};
+
+}  // namespace hz::draft
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DimensionStyle.h"
+#include "horizon/math/Vec2.h"
+
+namespace hz::draft {
+
+class DraftEntity;
+struct BlockDefinition;
+
+/// Line-list vertices sharing one style, in the renderer's vertex format:
+/// 4 floats per vertex (x, y, z, distance-along-entity), two vertices per segment.
+struct DisplayStroke {
+    uint32_t color = 0;      ///< 0 = the owning entity's resolved color (ByBlock).
+    double lineWidth = 0.0;  ///< 0 = the owning entity's resolved width.
+    int lineType = 0;        ///< 0 = the owning entity's resolved line type.
+    std::vector<float> vertices;
+};
+
+/// A text label drawn by the overlay (text entities, dimension values).
+struct DisplayText {
+    math::Vec2 position;
+    std::string text;
+    double height = 0.0;  ///< 0 = dimension style default.
+    double rotation = 0.0;
+    int alignment = 1;  ///< 0=Left, 1=Center, 2=Right.
+};
+
+/// World-space display geometry of one entity.  Colors, widths and line types are left
+/// unresolved so layer, selection and DOF changes never require re-tessellation.
+struct DisplayList {
+    std::vector<DisplayStroke> strokes;
+    std::vector<DisplayText> texts;
+
+    /// Set by DisplayListCache to a new value on every rebuild, so holders of derived
+    /// data (e.g. GPU buffers) can detect stale copies with one comparison.
+    uint64_t revision = 0;
+};
+
+/// Tessellate an entity for display: lines, polylines, arcs, circles, splines, ellipses,
+/// hatch fills, dimensions and block references (expanded into world space).
+DisplayList buildDisplayList(const DraftEntity& entity, const DimensionStyle& style);
+
+/// Tessellate a block definition's entities in block-local coordinates (base point at the
+/// origin), one stroke per entity.  BlockDefinition::geometry() caches the result; a
+/// reference's world geometry is this list under the reference's transform.
+DisplayList buildBlockDisplayList(const BlockDefinition& def);
+
+/// Per-entity display lists, rebuilt only when the entity's version changes.
+///
+/// A block reference also depends on its definition's entities and a dimension on the
+/// document's dimension style; neither bumps the entity's version, so those inputs are
+/// folded into a content stamp that is checked alongside it.
+class DisplayListCache {
+public:
+    /// Cached display list for the entity.  The reference stays valid until the same
+    /// entity is looked up again or the cache is trimmed.
+    const DisplayList& get(const DraftEntity& entity, const DimensionStyle& style);
+
+    /// Start a new frame; entries looked up from now on count as in use.
+    void beginFrame() { ++m_frame; }
+
+    /// If more than `maxEntries` lists are cached, drop those not used this frame.
+    void trim(size_t maxEntries);
+
+    void clear() { m_entries.clear(); }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t version = 0;
+        uint64_t stamp = 0;
+        uint64_t frame = 0;
+        DisplayList list;
+    };
+
+    std::unordered_map<uint64_t, Entry> m_entries;
+    uint64_t m_nextRevision = 1;
+    uint64_t m_frame = 0;
+};
+
+}  // namespace hz::draft
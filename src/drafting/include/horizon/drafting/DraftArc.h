@@ -22,19 +22,20 @@ public:
     double startAngle() const { return m_startAngle; }
     double endAngle() const { return m_endAngle; }
 
-    void setCenter(const math::Vec2& center) { m_center = center; }
-    void setRadius(double radius) { m_radius = radius; }
-    void setStartAngle(double angle) { m_startAngle = angle; }
-    void setEndAngle(double angle) { m_endAngle = angle; }
+    void setCenter(const math::Vec2& center) { m_center = center; markModified(); }
+    void setRadius(double radius) { m_radius = radius; markModified(); }
+    void setStartAngle(double angle) { m_startAngle = angle; markModified(); }
+    void setEndAngle(double angle) { m_endAngle = angle; markModified(); }
 
     math::Vec2 startPoint() const;
     math::Vec2 endPoint() const;
     math::Vec2 midPoint() const;
     double sweepAngle() const;
 
-private:
+    /// True if the polar angle (radians, any range) lies on the arc's CCW sweep.
     bool containsAngle(double angle) const;
 
+private:
     math::Vec2 m_center;
     double m_radius;
     double m_startAngle;  // radians, normalized [0, 2pi)
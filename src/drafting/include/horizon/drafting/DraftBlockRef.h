@@ -10,6 +10,9 @@
 namespace hz::draft {
 
 /// A reference (instance) of a BlockDefinition with position, rotation, and uniform scale.
+///
+/// Bounds, picking and snapping read the definition's cached BlockGeometry and map it
+/// through this reference's transform, so they never re-derive the definition's entities.
 class DraftBlockRef : public DraftEntity {
 public:
     DraftBlockRef(std::shared_ptr<BlockDefinition> definition, const math::Vec2& insertPos,
@@ -32,9 +35,9 @@ public:
     double rotation() const { return m_rotation; }
     double uniformScale() const { return m_uniformScale; }
 
-    void setInsertPos(const math::Vec2& pos) { m_insertPos = pos; }
-    void setRotation(double radians) { m_rotation = radians; }
-    void setUniformScale(double s) { m_uniformScale = s; }
+    void setInsertPos(const math::Vec2& pos) { m_insertPos = pos; markModified(); }
+    void setRotation(double radians) { m_rotation = radians; markModified(); }
+    void setUniformScale(double s) { m_uniformScale = s; markModified(); }
 
     /// Transform a point from definition space to world space.
     math::Vec2 transformPoint(const math::Vec2& defPt) const;
@@ -42,6 +45,11 @@ public:
     /// Transform a point from world space to definition space.
     math::Vec2 inverseTransformPoint(const math::Vec2& worldPt) const;
 
+    /// Transform a block-local point (relative to the base point, as in BlockGeometry)
+    /// to world space, and back.
+    math::Vec2 localToWorld(const math::Vec2& local) const;
+    math::Vec2 worldToLocal(const math::Vec2& worldPt) const;
+
 private:
     std::shared_ptr<BlockDefinition> m_definition;
     math::Vec2 m_insertPos;
@@ -20,8 +20,8 @@ public:
     const math::Vec2& center() const { return m_center; }
     double radius() const { return m_radius; }
 
-    void setCenter(const math::Vec2& center) { m_center = center; }
-    void setRadius(double radius) { m_radius = radius; }
+    void setCenter(const math::Vec2& center) { m_center = center; markModified(); }
+    void setRadius(double radius) { m_radius = radius; markModified(); }
 
 private:
     math::Vec2 m_center;
@@ -18,7 +18,7 @@ public:
     // ---- Text override ----
 
     const std::string& textOverride() const { return m_textOverride; }
-    void setTextOverride(const std::string& text) { m_textOverride = text; }
+    void setTextOverride(const std::string& text) { m_textOverride = text; markModified(); }
     bool hasTextOverride() const { return !m_textOverride.empty(); }
 
     /// Returns the formatted display text (override or computed value).
@@ -2,11 +2,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "BlockTable.h"
 #include "DimensionStyle.h"
 #include "DraftEntity.h"
+#include "EntityStore.h"
 #include "SpatialIndex.h"
 
 namespace hz::draft {
@@ -15,10 +17,42 @@ class DraftDocument {
 public:
     DraftDocument() = default;
 
+    /// Append @p entity.  If an entity with its id is already present, @p entity
+    /// replaces it in its slot instead (see replaceEntity()), so ids stay unique.
     void addEntity(std::shared_ptr<DraftEntity> entity);
+    /// Append a batch of entities (file loaders, copy commands).  The spatial index is
+    /// bulk-rebuilt once when the batch is a large share of the document, and patched
+    /// entity by entity otherwise.  Repeated ids replace, as in addEntity().
+    void addEntities(std::vector<std::shared_ptr<DraftEntity>> entities);
+    /// Remove one entity, keeping the order of the rest.  Prefer removeEntities() for
+    /// many at once: it compacts the entity list once for the whole batch.
     void removeEntity(uint64_t id);
+    /// Remove a batch of entities in one pass over the entity list, keeping the order of
+    /// the rest and re-indexing the same way as addEntities().  Unknown ids are ignored.
+    void removeEntities(const std::vector<uint64_t>& ids);
     const std::vector<std::shared_ptr<DraftEntity>>& entities() const { return m_entities; }
+    /// Mutable access for editing entities in place. Callers may reassign a
+    /// slot to an entity with the same id, but must not add, remove, or
+    /// reorder slots: the id index maps ids to slots.
     std::vector<std::shared_ptr<DraftEntity>>& entities() { return m_entities; }
+
+    /// The entity with the given id, or nullptr. O(1) via the id -> slot index.
+    std::shared_ptr<DraftEntity> findEntity(uint64_t id) const;
+
+    /// Handle of the entity's record in entityStore(), or an invalid handle if the id
+    /// is unknown or its entity is not a type the store holds.
+    EntityHandle storeHandle(uint64_t id) const;
+
+    /// Swap the entity stored under `entity->id()` for `entity`, keeping its
+    /// slot (draw/file order) and re-indexing its bounds. Returns false if no
+    /// entity has that id.
+    bool replaceEntity(std::shared_ptr<DraftEntity> entity);
+
+    /// Re-index an entity that was edited in place: refresh its spatial-index bounds
+    /// and its entity-store record.  Must follow every in-place geometry or layer edit.
+    void updateEntity(const std::shared_ptr<DraftEntity>& entity);
+    /// updateEntity() for a batch edited together, re-indexing in one step.
+    void updateEntities(const std::vector<std::shared_ptr<DraftEntity>>& entities);
     void clear();
 
     /// Returns a unique group ID and increments the internal counter.
@@ -37,14 +71,32 @@ public:
 
     const SpatialIndex& spatialIndex() const { return m_spatialIndex; }
     SpatialIndex& spatialIndex() { return m_spatialIndex; }
+
+    /// Packed copies of the document's lines, circles, arcs and polylines.
+    const EntityStore& entityStore() const { return m_store; }
+
+    /// Rebuild the spatial index and the entity store from the entity list.
     void rebuildSpatialIndex();
 
 private:
+    /// Where an entity lives: its index into m_entities and its entity-store record.
+    struct IndexEntry {
+        size_t slot = 0;
+        EntityHandle stored;
+    };
+
+    /// Re-point the id index at slots [first, end) after they shifted.
+    void reindexFrom(size_t first);
+    /// Refresh the entity-store record of a document entity edited in place.
+    void syncStore(const DraftEntity& entity);
+
     std::vector<std::shared_ptr<DraftEntity>> m_entities;
+    std::unordered_map<uint64_t, IndexEntry> m_index;  // entity id -> where it lives
     DimensionStyle m_dimensionStyle;
     BlockTable m_blockTable;
     uint64_t m_nextGroupId = 1;
     SpatialIndex m_spatialIndex;
+    EntityStore m_store;
 };
 
 }  // namespace hz::draft
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+
+#include "CurveCache.h"
 #include "DraftEntity.h"
 
 namespace hz::draft {
@@ -24,25 +27,38 @@ public:
     void rotate(const math::Vec2& center, double angle) override;
     void scale(const math::Vec2& center, double factor) override;
 
-    /// Generate points on the ellipse curve for rendering / intersection.
+    /// Generate `segments` + 1 evenly spaced points on the ellipse.  Not cached;
+    /// rendering and intersection use flattened() instead.
     std::vector<math::Vec2> evaluate(int segments = 64) const;
 
+    /// Closed polyline within `tolerance` of the ellipse, cached per tolerance bucket
+    /// until the ellipse changes.
+    std::shared_ptr<const CurveFlattening> flatten(double tolerance) const;
+
+    /// The flattening at defaultTolerance(), shared by rendering and intersection.
+    std::shared_ptr<const CurveFlattening> flattened() const;
+
+    /// A thousandth of the semi-major axis (about 70 segments).
+    double defaultTolerance() const;
+
     // Accessors
     const math::Vec2& center() const { return m_center; }
     double semiMajor() const { return m_semiMajor; }
     double semiMinor() const { return m_semiMinor; }
     double rotation() const { return m_rotation; }
 
-    void setCenter(const math::Vec2& center) { m_center = center; }
-    void setSemiMajor(double v) { m_semiMajor = v; }
-    void setSemiMinor(double v) { m_semiMinor = v; }
-    void setRotation(double v) { m_rotation = v; }
+    void setCenter(const math::Vec2& center) { m_center = center; markModified(); }
+    void setSemiMajor(double v) { m_semiMajor = v; markModified(); }
+    void setSemiMinor(double v) { m_semiMinor = v; markModified(); }
+    void setRotation(double v) { m_rotation = v; markModified(); }
 
 private:
     math::Vec2 m_center;
     double m_semiMajor;
     double m_semiMinor;
     double m_rotation;  // radians
+
+    CurveCache m_cache;
 };
 
 }  // namespace hz::draft
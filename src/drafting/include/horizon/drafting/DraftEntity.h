@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "LayerId.h"
 #include "horizon/math/BoundingBox.h"
 #include "horizon/math/Vec2.h"
 
@@ -25,8 +27,20 @@ public:
         if (s_nextId <= minId) s_nextId = minId + 1;
     }
 
-    const std::string& layer() const { return m_layer; }
-    void setLayer(const std::string& layer) { m_layer = layer; }
+    /// Geometry revision stamp.  Every geometric mutation draws a fresh value from a
+    /// process-wide counter, so (id, version) names one exact shape even when a clone
+    /// is given the id of the entity it replaces.  Derived caches key on this pair.
+    uint64_t version() const { return m_version; }
+
+    /// The next version the process-wide counter hands out.  It moves whenever any
+    /// entity is created or changed, so while it stays put no version has changed.
+    static uint64_t versionCounter() { return s_nextVersion.load(std::memory_order_relaxed); }
+
+    /// Layer handle; see LayerNames.  The name accessors intern and resolve it.
+    LayerId layerId() const { return m_layer; }
+    void setLayerId(LayerId layer) { m_layer = layer; }
+    const std::string& layer() const { return LayerNames::name(m_layer); }
+    void setLayer(const std::string& layer) { m_layer = LayerNames::intern(layer); }
 
     uint32_t color() const { return m_color; }
     void setColor(uint32_t argb) { m_color = argb; }
@@ -51,15 +65,21 @@ public:
     virtual void rotate(const math::Vec2& center, double angle) = 0;
     virtual void scale(const math::Vec2& center, double factor) = 0;
 
+protected:
+    /// Called by every setter and transform that changes geometry.
+    void markModified() { m_version = s_nextVersion.fetch_add(1, std::memory_order_relaxed); }
+
 private:
     uint64_t m_id;
-    std::string m_layer;
+    uint64_t m_version;
+    LayerId m_layer;
     uint32_t m_color;
     double m_lineWidth;
     int m_lineType;
     uint64_t m_groupId;
 
     static uint64_t s_nextId;
+    static std::atomic<uint64_t> s_nextVersion;
 };
 
 }  // namespace hz::draft
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -13,12 +15,17 @@ enum class HatchPattern {
     CrossHatch  // 2 - two perpendicular sets of lines
 };
 
-/// A hatched region defined by a closed boundary polygon.
+/// A hatched region defined by a closed outer boundary polygon and optional inner loops
+/// (islands).  The fill uses the even-odd rule across all loops, so an island inside a
+/// hole is filled again.
 class DraftHatch : public DraftEntity {
 public:
+    using Segments = std::vector<std::pair<math::Vec2, math::Vec2>>;
+
     explicit DraftHatch(const std::vector<math::Vec2>& boundary,
                         HatchPattern pattern = HatchPattern::Lines, double angle = 0.0,
-                        double spacing = 1.0);
+                        double spacing = 1.0,
+                        const std::vector<std::vector<math::Vec2>>& holes = {});
 
     math::BoundingBox boundingBox() const override;
     bool hitTest(const math::Vec2& point, double tolerance) const override;
@@ -30,32 +37,58 @@ public:
     void scale(const math::Vec2& center, double factor) override;
 
     const std::vector<math::Vec2>& boundary() const { return m_boundary; }
-    void setBoundary(const std::vector<math::Vec2>& boundary) { m_boundary = boundary; }
+    void setBoundary(const std::vector<math::Vec2>& boundary) {
+        m_boundary = boundary;
+        markModified();
+    }
+
+    /// Inner loops cut out of the boundary.
+    const std::vector<std::vector<math::Vec2>>& holes() const { return m_holes; }
+    void setHoles(const std::vector<std::vector<math::Vec2>>& holes) {
+        m_holes = holes;
+        markModified();
+    }
 
     HatchPattern pattern() const { return m_pattern; }
-    void setPattern(HatchPattern pattern) { m_pattern = pattern; }
+    void setPattern(HatchPattern pattern) { m_pattern = pattern; markModified(); }
 
     double angle() const { return m_angle; }
-    void setAngle(double angle) { m_angle = angle; }
+    void setAngle(double angle) { m_angle = angle; markModified(); }
 
     double spacing() const { return m_spacing; }
-    void setSpacing(double spacing) { m_spacing = spacing; }
+    void setSpacing(double spacing) { m_spacing = spacing; markModified(); }
+
+    /// True if the point lies in the hatched area (even-odd over all loops).
+    bool contains(const math::Vec2& point) const;
 
-    /// Generate hatch fill lines clipped to the boundary polygon.
-    std::vector<std::pair<math::Vec2, math::Vec2>> generateHatchLines() const;
+    /// Hatch fill lines clipped to the boundary and holes.
+    ///
+    /// The result is cached, keyed on the boundary, holes, pattern, angle and spacing;
+    /// clones share the cache, so undo snapshots and copies do not regenerate it.  The
+    /// reference stays valid until the hatch is modified and this is called again.  Not
+    /// safe to call concurrently on the same hatch.
+    const Segments& generateHatchLines() const;
 
 private:
-    /// Test if a point is inside the boundary polygon (ray casting).
-    bool pointInPolygon(const math::Vec2& point) const;
+    struct FillCache {
+        uint64_t key = 0;
+        Segments lines;
+    };
 
-    /// Generate parallel scan lines at a given angle, clipped to the boundary.
-    std::vector<std::pair<math::Vec2, math::Vec2>> scanLines(double scanAngle,
-                                                             double scanSpacing) const;
+    /// Hash of everything the fill depends on.
+    uint64_t fillKey() const;
+
+    /// Parallel scan lines at `scanAngle`, clipped to all loops.
+    Segments scanLines(double scanAngle, double scanSpacing) const;
 
     std::vector<math::Vec2> m_boundary;
+    std::vector<std::vector<math::Vec2>> m_holes;
     HatchPattern m_pattern;
     double m_angle;    // radians
     double m_spacing;  // world units
+
+    mutable std::shared_ptr<const FillCache> m_fill;
+    mutable uint64_t m_fillVersion = 0;  // version() m_fill was last validated against
 };
 
 }  // namespace hz::draft
@@ -11,7 +11,7 @@ public:
 
     const std::vector<math::Vec2>& points() const { return m_points; }
     const std::string& text() const { return m_text; }
-    void setText(const std::string& text) { m_text = text; }
+    void setText(const std::string& text) { m_text = text; markModified(); }
 
     // DraftDimension overrides
     double computedValue() const override;  // always 0 (not a measurement)
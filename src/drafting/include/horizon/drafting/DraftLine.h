@@ -20,8 +20,8 @@ public:
     const math::Vec2& start() const { return m_start; }
     const math::Vec2& end() const { return m_end; }
 
-    void setStart(const math::Vec2& start) { m_start = start; }
-    void setEnd(const math::Vec2& end) { m_end = end; }
+    void setStart(const math::Vec2& start) { m_start = start; markModified(); }
+    void setEnd(const math::Vec2& end) { m_end = end; markModified(); }
 
 private:
     math::Vec2 m_start, m_end;
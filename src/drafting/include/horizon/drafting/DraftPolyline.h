@@ -20,10 +20,10 @@ public:
     void scale(const math::Vec2& center, double factor) override;
 
     const std::vector<math::Vec2>& points() const { return m_points; }
-    void setPoints(const std::vector<math::Vec2>& points) { m_points = points; }
+    void setPoints(const std::vector<math::Vec2>& points) { m_points = points; markModified(); }
 
     bool closed() const { return m_closed; }
-    void setClosed(bool closed) { m_closed = closed; }
+    void setClosed(bool closed) { m_closed = closed; markModified(); }
 
     void addPoint(const math::Vec2& point);
     size_t pointCount() const { return m_points.size(); }
@@ -22,8 +22,8 @@ public:
     const math::Vec2& corner1() const { return m_corner1; }
     const math::Vec2& corner2() const { return m_corner2; }
 
-    void setCorner1(const math::Vec2& c) { m_corner1 = c; }
-    void setCorner2(const math::Vec2& c) { m_corner2 = c; }
+    void setCorner1(const math::Vec2& c) { m_corner1 = c; markModified(); }
+    void setCorner2(const math::Vec2& c) { m_corner2 = c; markModified(); }
 
     /// Returns the 4 corners: bottom-left, bottom-right, top-right, top-left.
     std::array<math::Vec2, 4> corners() const;
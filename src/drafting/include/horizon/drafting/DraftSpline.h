@@ -1,7 +1,9 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "CurveCache.h"
 #include "DraftEntity.h"
 
 namespace hz::draft {
@@ -42,14 +44,28 @@ public:
     bool hasNonUniformWeights() const;
 
     bool closed() const { return m_closed; }
-    void setClosed(bool closed) { m_closed = closed; }
+    void setClosed(bool closed) { m_closed = closed; markModified(); }
 
     size_t controlPointCount() const { return m_controlPoints.size(); }
 
-    /// Evaluate the B-spline to a polyline.
+    /// Evaluate the B-spline to a polyline with a fixed number of segments per span.
+    /// Not cached; rendering, picking and intersection use flattened() instead.
     /// @param segmentsPerSpan  Number of line segments per B-spline span.
     std::vector<math::Vec2> evaluate(int segmentsPerSpan = 16) const;
 
+    /// Polyline within `tolerance` of the curve.  Each span gets as many segments as its
+    /// curvature needs; the result is cached per tolerance bucket until the spline
+    /// changes.
+    std::shared_ptr<const CurveFlattening> flatten(double tolerance) const;
+
+    /// The flattening at defaultTolerance(), shared by rendering, hit-testing, snapping
+    /// and intersection.
+    std::shared_ptr<const CurveFlattening> flattened() const;
+
+    /// A thousandth of the mean control-polygon leg, so every span is drawn about as
+    /// finely whatever the overall size of the curve.
+    double defaultTolerance() const;
+
 private:
     std::vector<math::Vec2> m_controlPoints;
     std::vector<double> m_weights;  ///< parallel to m_controlPoints, all 1.0 by default
@@ -57,6 +73,11 @@ private:
 
     /// Ensure m_weights is sized to match m_controlPoints, padding with 1.0.
     void syncWeights();
+
+    std::vector<math::Vec2> flattenUncached(double tolerance) const;
+    math::BoundingBox computeBounds() const;
+
+    CurveCache m_cache;
 };
 
 }  // namespace hz::draft
@@ -22,19 +22,19 @@ public:
     void scale(const math::Vec2& center, double factor) override;
 
     const math::Vec2& position() const { return m_position; }
-    void setPosition(const math::Vec2& pos) { m_position = pos; }
+    void setPosition(const math::Vec2& pos) { m_position = pos; markModified(); }
 
     const std::string& text() const { return m_text; }
-    void setText(const std::string& text) { m_text = text; }
+    void setText(const std::string& text) { m_text = text; markModified(); }
 
     double textHeight() const { return m_textHeight; }
-    void setTextHeight(double height) { m_textHeight = height; }
+    void setTextHeight(double height) { m_textHeight = height; markModified(); }
 
     double rotation() const { return m_rotation; }
-    void setRotation(double angle) { m_rotation = angle; }
+    void setRotation(double angle) { m_rotation = angle; markModified(); }
 
     TextAlignment alignment() const { return m_alignment; }
-    void setAlignment(TextAlignment align) { m_alignment = align; }
+    void setAlignment(TextAlignment align) { m_alignment = align; markModified(); }
 
 private:
     /// Approximate width of the text in world units.
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "LayerId.h"
+#include "horizon/math/BoundingBox.h"
+#include "horizon/math/Vec2.h"
+
+namespace hz::draft {
+
+class DraftEntity;
+
+/// Entity types the store keeps in packed tables.
+enum class PrimitiveKind : uint8_t { Line, Circle, Arc, Polyline };
+
+/// Stable reference to a stored primitive.  Rows move when others are removed; a handle
+/// names a slot that always points at the current row.  The generation makes handles to
+/// removed entities detectably stale instead of aliasing a later entity.
+struct EntityHandle {
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    uint32_t slot = kNone;
+    uint32_t generation = 0;
+
+    bool valid() const { return slot != kNone; }
+    bool operator==(const EntityHandle&) const = default;
+};
+
+/// Packed geometry of a document's lines, circles, arcs and polylines.
+///
+/// Each type lives in its own table of parallel arrays (ids, layers and the shape's
+/// coordinates), so passes over many entities -- picking, bounds, culling -- read
+/// contiguous memory and never dispatch through the entity vtable.  DraftDocument owns
+/// the DraftEntity objects and keeps this store in step with them.  The store has no
+/// id lookup of its own: records are named by the handles sync() returns, which the
+/// document keeps in its id index (see DraftDocument::storeHandle()).
+class EntityStore {
+public:
+    struct LineTable {
+        std::vector<uint64_t> ids;
+        std::vector<LayerId> layers;
+        std::vector<math::Vec2> start;
+        std::vector<math::Vec2> end;
+        std::vector<uint32_t> slots;
+        size_t size() const { return ids.size(); }
+    };
+
+    struct CircleTable {
+        std::vector<uint64_t> ids;
+        std::vector<LayerId> layers;
+        std::vector<math::Vec2> center;
+        std::vector<double> radius;
+        std::vector<uint32_t> slots;
+        size_t size() const { return ids.size(); }
+    };
+
+    struct ArcTable {
+        std::vector<uint64_t> ids;
+        std::vector<LayerId> layers;
+        std::vector<math::Vec2> center;
+        std::vector<double> radius;
+        std::vector<double> startAngle;
+        std::vector<double> endAngle;
+        std::vector<uint32_t> slots;
+        size_t size() const { return ids.size(); }
+    };
+
+    /// Polyline vertices live in one shared pool; each row owns the run
+    /// [first, first + count).
+    struct PolylineTable {
+        std::vector<uint64_t> ids;
+        std::vector<LayerId> layers;
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> count;
+        std::vector<uint8_t> closed;
+        std::vector<uint32_t> slots;
+        std::vector<math::Vec2> points;
+        size_t size() const { return ids.size(); }
+    };
+
+    /// Refresh the record `handle` names from `entity`, or add one for it if the handle
+    /// no longer refers to a record of its type.  Returns the record's handle; an
+    /// invalid one, after dropping the old record, if the entity is not a type the
+    /// store holds.
+    EntityHandle sync(const DraftEntity& entity, EntityHandle handle = {});
+
+    /// Drop the record `handle` names; stale or invalid handles are ignored.
+    void remove(EntityHandle handle);
+    void clear();
+
+    /// True if the handle still refers to a stored entity.
+    bool contains(EntityHandle handle) const;
+
+    // Per-entity queries.  The handle must satisfy contains().
+    PrimitiveKind kind(EntityHandle handle) const { return m_slots[handle.slot].kind; }
+    size_t row(EntityHandle handle) const { return m_slots[handle.slot].row; }
+    uint64_t id(EntityHandle handle) const;
+    LayerId layer(EntityHandle handle) const;
+    math::BoundingBox boundingBox(EntityHandle handle) const;
+    bool hitTest(EntityHandle handle, const math::Vec2& point, double tolerance) const;
+
+    /// Union of the bounds of every stored entity.
+    math::BoundingBox bounds() const;
+
+    size_t size() const {
+        return m_lines.size() + m_circles.size() + m_arcs.size() + m_polylines.size();
+    }
+
+    const LineTable& lines() const { return m_lines; }
+    const CircleTable& circles() const { return m_circles; }
+    const ArcTable& arcs() const { return m_arcs; }
+    const PolylineTable& polylines() const { return m_polylines; }
+
+    /// Vertices of the polyline in row `row`.
+    std::span<const math::Vec2> polylinePoints(size_t row) const {
+        return {m_polylines.points.data() + m_polylines.first[row], m_polylines.count[row]};
+    }
+
+private:
+    struct Slot {
+        PrimitiveKind kind = PrimitiveKind::Line;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        uint32_t nextFree = EntityHandle::kNone;
+    };
+
+    EntityHandle appendRow(PrimitiveKind kind, uint64_t id);
+    uint32_t allocSlot(PrimitiveKind kind, uint32_t row);
+    void eraseRow(PrimitiveKind kind, uint32_t row);
+    void writePolylinePoints(uint32_t row, std::span<const math::Vec2> pts);
+    void compactPolylinePoints();
+
+    LineTable m_lines;
+    CircleTable m_circles;
+    ArcTable m_arcs;
+    PolylineTable m_polylines;
+    size_t m_deadPoints = 0;  // pool entries no longer owned by any polyline
+
+    std::vector<Slot> m_slots;
+    uint32_t m_freeSlot = EntityHandle::kNone;
+};
+
+}  // namespace hz::draft
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -15,10 +16,18 @@ struct IntersectionResult {
     std::vector<math::Vec2> points;
 };
 
+/// A straight piece of an entity's outline, as produced by extractSegments().
+using Segment = std::pair<math::Vec2, math::Vec2>;
+
 /// Compute intersections between two entities.
 /// Supports all entity type combinations (line, circle, arc, rectangle, polyline).
 IntersectionResult intersect(const DraftEntity& a, const DraftEntity& b);
 
+/// Same as intersect(a, b), with each entity's extractSegments() result supplied by the
+/// caller so it can be reused across many pairs.
+IntersectionResult intersect(const DraftEntity& a, const std::vector<Segment>& segsA,
+                             const DraftEntity& b, const std::vector<Segment>& segsB);
+
 // Low-level intersection primitives:
 
 /// Line segment (p1->p2) vs line segment (p3->p4). Returns 0 or 1 points.
@@ -61,4 +70,50 @@ std::vector<math::Vec2> intersectRayArc(const math::Vec2& rayOrigin, const math:
 std::vector<math::Vec2> intersectRayEntity(const math::Vec2& rayOrigin, const math::Vec2& rayDir,
                                            const DraftEntity& entity);
 
+// Whole-drawing sweep (cleanup / overkill):
+
+/// A point where two or more entities cross or touch.
+struct IntersectionCluster {
+    math::Vec2 point;                 ///< Mean of the merged hit points.
+    std::vector<uint64_t> entityIds;  ///< Sorted, unique.
+};
+
+/// Entities connected by shared collinear or co-circular stretches of outline.
+struct OverlapCluster {
+    std::vector<uint64_t> entityIds;  ///< Sorted, unique.
+};
+
+struct SweepOptions {
+    /// Hit points closer than this merge into one cluster; outlines closer than this
+    /// count as overlapping.
+    double tolerance = 1e-9;
+    /// Report points where two entities merely meet end to end (connected geometry).
+    bool includeEndpointContacts = false;
+    /// Worker threads for the horizontal bands; 0 uses the hardware concurrency.
+    unsigned threads = 0;
+};
+
+struct SweepResult {
+    std::vector<IntersectionCluster> intersections;  ///< Ordered by x, then y.
+    std::vector<OverlapCluster> overlaps;            ///< Ordered by first id.
+    /// Entities lying entirely on another entity that is kept: exact duplicates and
+    /// shorter copies hidden under longer ones.  Of identical entities the first in
+    /// input order is kept.  Removing these leaves the drawing visually unchanged.
+    /// Only plain outlines take part: hatches, block references, text and dimensions
+    /// are never listed and never make another entity redundant.
+    std::vector<uint64_t> redundantIds;
+};
+
+/// Find every crossing and overlap between the given entities in one plane sweep.
+///
+/// Outlines come from extractSegments(); circles and arcs are split at quadrant angles
+/// into x/y-monotone pieces so each piece is tightly bounded by its endpoints.  Pieces
+/// are dealt into horizontal bands that are swept independently (in parallel) along x,
+/// testing only pieces whose extents overlap, so the work grows with the number of
+/// nearby pairs rather than with n^2.  A pair is only tested in the band holding the
+/// bottom of its shared y-range, so no hit is reported twice.  Pieces of the same
+/// entity are never tested against each other.
+SweepResult findAllIntersections(const std::vector<std::shared_ptr<DraftEntity>>& entities,
+                                 const SweepOptions& options = {});
+
 }  // namespace hz::draft
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Intersection.h"
+#include "horizon/math/Vec2.h"
+
+namespace hz::draft {
+
+class DraftDocument;
+class DraftEntity;
+
+/// Intersection queries for the editing tools (Trim, Extend, Break).
+///
+/// Candidate cutting edges and boundaries come from the document's spatial index instead
+/// of a scan over every entity, and each entity's extractSegments() result is cached by
+/// (id, version) so splines, ellipses and long polylines are flattened once rather than
+/// on every click.  One engine can serve several documents; the version stamp keeps
+/// entries from different documents apart.
+class IntersectionEngine {
+public:
+    /// Decides whether an entity may act as a cutting edge or boundary.
+    /// An empty filter accepts every entity.
+    using Filter = std::function<bool(const DraftEntity&)>;
+
+    /// All points where `target` meets another accepted entity.  Only entities whose
+    /// boxes overlap the target's box are tested.
+    std::vector<math::Vec2> intersections(const DraftDocument& doc, const DraftEntity& target,
+                                          const Filter& accept = {});
+
+    /// The hit on an accepted entity other than `excludeId` closest to `origin` along the
+    /// ray (origin, dir), ignoring hits within `minDist`.  The ray is swept through the
+    /// index in growing boxes, so a nearby boundary is found without visiting the rest
+    /// of the drawing.
+    std::optional<math::Vec2> nearestRayHit(const DraftDocument& doc, const math::Vec2& origin,
+                                            const math::Vec2& dir, uint64_t excludeId,
+                                            double minDist = 1e-6, const Filter& accept = {});
+
+    /// Points where the full circle (center, radius) meets an accepted entity other than
+    /// `excludeId`.  Points on arcs are limited to the arc's sweep; the circle itself
+    /// is not.  Used to extend arcs around their own circle.
+    std::vector<math::Vec2> circleIntersections(const DraftDocument& doc,
+                                                const math::Vec2& center, double radius,
+                                                uint64_t excludeId, const Filter& accept = {});
+
+    /// extractSegments(entity), cached until the entity's version changes.
+    const std::vector<Segment>& segments(const DraftEntity& entity);
+
+    /// Drop all cached segment lists.
+    void clear() { m_segments.clear(); }
+    size_t cachedEntityCount() const { return m_segments.size(); }
+
+private:
+    struct CachedSegments {
+        uint64_t version = 0;
+        std::vector<Segment> segments;
+    };
+
+    std::unordered_map<uint64_t, CachedSegments> m_segments;
+    std::vector<Segment> m_uncached;
+    std::vector<uint64_t> m_candidates;
+    std::unordered_set<uint64_t> m_tested;
+};
+
+}  // namespace hz::draft
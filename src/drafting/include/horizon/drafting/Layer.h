@@ -1,10 +1,13 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "LayerId.h"
+
 namespace hz::draft {
 
 struct LayerProperties {
@@ -16,24 +19,50 @@ struct LayerProperties {
     bool locked = false;
 };
 
+/// The layers of one document, indexed by LayerId.  Lookups by handle are a bounds
+/// check and an array access; the name-based overloads resolve the name first.
+/// A layer's `name` always matches its handle; use renameLayer() to change it.
 class LayerManager {
 public:
     LayerManager();
 
+    /// Add a layer, or replace the properties of the layer with the same name.
     void addLayer(const LayerProperties& props);
+
+    /// Remove a layer.  The default layer "0" and the current layer are never removed.
+    void removeLayer(LayerId id);
     void removeLayer(const std::string& name);
+
+    /// Give a layer a new name.  Returns the new handle, or nullopt if the layer is
+    /// missing, is the default layer, or `newName` is empty or already taken.  The
+    /// current layer follows the rename.  Entities keep the old handle until they
+    /// are reassigned (RenameLayerCommand does both).
+    std::optional<LayerId> renameLayer(LayerId id, const std::string& newName);
+
+    LayerProperties* getLayer(LayerId id) {
+        return id < m_layers.size() ? m_layers[id].get() : nullptr;
+    }
+    const LayerProperties* getLayer(LayerId id) const {
+        return id < m_layers.size() ? m_layers[id].get() : nullptr;
+    }
     LayerProperties* getLayer(const std::string& name);
     const LayerProperties* getLayer(const std::string& name) const;
+
+    /// Names of all layers (sorted alphabetically).
     std::vector<std::string> layerNames() const;
 
-    const std::string& currentLayer() const { return m_currentLayer; }
+    LayerId currentLayerId() const { return m_currentLayer; }
+    const std::string& currentLayer() const { return LayerNames::name(m_currentLayer); }
+    void setCurrentLayer(LayerId id);
     void setCurrentLayer(const std::string& name);
 
     void clear();
 
 private:
-    std::unordered_map<std::string, LayerProperties> m_layers;
-    std::string m_currentLayer;
+    // Slot per interned handle; null where this document has no such layer.  Held by
+    // pointer so property pointers stay valid when later layers are added.
+    std::vector<std::unique_ptr<LayerProperties>> m_layers;
+    LayerId m_currentLayer = kDefaultLayerId;
 };
 
 }  // namespace hz::draft
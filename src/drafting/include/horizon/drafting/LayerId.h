@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace hz::draft {
+
+/// Small integer handle for a layer name.  Entities store this instead of the name, and
+/// LayerManager indexes its properties by it, so a per-entity layer lookup is an array
+/// access rather than a string hash.
+using LayerId = uint32_t;
+
+/// Handle of the default layer "0".
+inline constexpr LayerId kDefaultLayerId = 0;
+
+/// Process-wide layer name interning.  One name always maps to the same handle, so
+/// handles stay meaningful when entities move between documents, the clipboard and
+/// block definitions.  Interned names are never released; a drawing has few layers.
+class LayerNames {
+public:
+    /// Handle for `name`, interning it on first use.
+    static LayerId intern(std::string_view name);
+
+    /// Handle for `name` if it was ever interned.  Never interns.
+    static std::optional<LayerId> find(std::string_view name);
+
+    /// The name behind a handle.  The reference stays valid for the process lifetime.
+    static const std::string& name(LayerId id);
+};
+
+}  // namespace hz::draft
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "horizon/math/BoundingBox.h"
+#include "horizon/math/Constants.h"
+#include "horizon/math/MathUtils.h"
+#include "horizon/math/Vec2.h"
+
+/// Shared hit-test and bounds math for lines, circles, arcs and polylines, used by both
+/// the entity classes and the packed EntityStore so the two always agree.
+
+namespace hz::draft {
+
+/// Distance from `p` to the segment [a, b] (to `a` if the segment is degenerate).
+inline double segmentDistance(const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) {
+    math::Vec2 ab = b - a;
+    math::Vec2 ap = p - a;
+    double lenSq = ab.lengthSquared();
+    if (lenSq < 1e-14) return p.distanceTo(a);
+    double t = math::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
+    return p.distanceTo(a + ab * t);
+}
+
+/// True if the polar angle (radians, any range) lies on the CCW sweep from
+/// `startAngle` to `endAngle`.
+inline bool arcContainsAngle(double startAngle, double endAngle, double angle) {
+    angle = math::normalizeAngle(angle);
+    if (startAngle <= endAngle) {
+        return angle >= startAngle && angle <= endAngle;
+    }
+    // Wraps around zero.
+    return angle >= startAngle || angle <= endAngle;
+}
+
+inline math::BoundingBox segmentBoundingBox(const math::Vec2& a, const math::Vec2& b) {
+    return math::BoundingBox(math::Vec3(std::min(a.x, b.x), std::min(a.y, b.y), 0.0),
+                             math::Vec3(std::max(a.x, b.x), std::max(a.y, b.y), 0.0));
+}
+
+inline math::BoundingBox circleBoundingBox(const math::Vec2& center, double radius) {
+    return math::BoundingBox(math::Vec3(center.x - radius, center.y - radius, 0.0),
+                             math::Vec3(center.x + radius, center.y + radius, 0.0));
+}
+
+inline math::BoundingBox arcBoundingBox(const math::Vec2& center, double radius,
+                                        double startAngle, double endAngle) {
+    math::Vec2 sp(center.x + radius * std::cos(startAngle),
+                  center.y + radius * std::sin(startAngle));
+    math::Vec2 ep(center.x + radius * std::cos(endAngle), center.y + radius * std::sin(endAngle));
+    double minX = std::min(sp.x, ep.x);
+    double minY = std::min(sp.y, ep.y);
+    double maxX = std::max(sp.x, ep.x);
+    double maxY = std::max(sp.y, ep.y);
+
+    // Expand if arc crosses a quadrant boundary.
+    if (arcContainsAngle(startAngle, endAngle, 0.0)) maxX = center.x + radius;
+    if (arcContainsAngle(startAngle, endAngle, math::kHalfPi)) maxY = center.y + radius;
+    if (arcContainsAngle(startAngle, endAngle, math::kPi)) minX = center.x - radius;
+    if (arcContainsAngle(startAngle, endAngle, math::kPi * 1.5)) minY = center.y - radius;
+    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+}
+
+/// Bounds of a point sequence; an invalid box if it is empty.
+inline math::BoundingBox pointsBoundingBox(std::span<const math::Vec2> points) {
+    if (points.empty()) return {};
+    double minX = points[0].x, maxX = points[0].x;
+    double minY = points[0].y, maxY = points[0].y;
+    for (size_t i = 1; i < points.size(); ++i) {
+        minX = std::min(minX, points[i].x);
+        minY = std::min(minY, points[i].y);
+        maxX = std::max(maxX, points[i].x);
+        maxY = std::max(maxY, points[i].y);
+    }
+    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+}
+
+inline bool circleHitTest(const math::Vec2& center, double radius, const math::Vec2& point,
+                          double tolerance) {
+    return std::abs(point.distanceTo(center) - radius) <= tolerance;
+}
+
+inline bool arcHitTest(const math::Vec2& center, double radius, double startAngle,
+                       double endAngle, const math::Vec2& point, double tolerance) {
+    if (!circleHitTest(center, radius, point, tolerance)) return false;
+    double angle = std::atan2(point.y - center.y, point.x - center.x);
+    return arcContainsAngle(startAngle, endAngle, angle);
+}
+
+inline bool polylineHitTest(std::span<const math::Vec2> points, bool closed,
+                            const math::Vec2& point, double tolerance) {
+    if (points.size() < 2) return false;
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        if (segmentDistance(point, points[i], points[i + 1]) <= tolerance) return true;
+    }
+    return closed && segmentDistance(point, points.back(), points[0]) <= tolerance;
+}
+
+}  // namespace hz::draft
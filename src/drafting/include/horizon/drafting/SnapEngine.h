@@ -1,15 +1,29 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "DraftEntity.h"
-#include "SpatialIndex.h"
 #include "horizon/math/Vec2.h"
 
 namespace hz::draft {
 
-enum class SnapType { None, Grid, Endpoint, Midpoint, Center };
+class DraftDocument;
+
+enum class SnapType {
+    None,
+    Grid,
+    Endpoint,
+    Midpoint,
+    Center,
+    Intersection,
+    Perpendicular,
+    Tangent,
+    Nearest
+};
 
 struct SnapResult {
     math::Vec2 point;
@@ -26,17 +40,63 @@ public:
     void setSnapTolerance(double tolerance);
     double snapTolerance() const { return m_snapTolerance; }
 
+    /// Enable or disable an object snap mode.  Endpoint, Intersection, Perpendicular and
+    /// Tangent are on by default; Nearest is off because it captures almost every click
+    /// that lands on a curve.  Endpoint covers all of an entity's snapPoints().
+    void setModeEnabled(SnapType type, bool enabled);
+    bool isModeEnabled(SnapType type) const;
+
+    /// Point the current operation started from (e.g. a line's first click).
+    /// Perpendicular and Tangent snaps are measured from it and are inactive without it.
+    void setReferencePoint(const math::Vec2& point) { m_referencePoint = point; }
+    void clearReferencePoint() { m_referencePoint.reset(); }
+    const std::optional<math::Vec2>& referencePoint() const { return m_referencePoint; }
+
     SnapResult snap(const math::Vec2& cursorWorld,
                     const std::vector<std::shared_ptr<DraftEntity>>& entities) const;
 
-    SnapResult snap(const math::Vec2& cursorWorld, const SpatialIndex& index,
-                    const std::vector<std::shared_ptr<DraftEntity>>& entities) const;
+    /// Snap using the document's spatial index: only entities near the cursor
+    /// are examined, and their ids are resolved through the document's id index.
+    /// Intersection, Perpendicular, Tangent and Nearest look only at the entities whose
+    /// curves pass within the snap tolerance, the closest ones when there are many.
+    SnapResult snap(const math::Vec2& cursorWorld, const DraftDocument& doc) const;
+
+    /// Drop all cached pairwise intersections.
+    void clearIntersectionCache() { m_intersectionCache.clear(); }
+    size_t intersectionCacheSize() const { return m_intersectionCache.size(); }
 
 private:
     math::Vec2 snapToGrid(const math::Vec2& point) const;
 
+    /// Intersections of a and b, reused while neither entity's version changes.
+    const std::vector<math::Vec2>& cachedIntersections(const DraftEntity& a,
+                                                       const DraftEntity& b) const;
+
+    /// Pairwise results keyed by the (lower id, higher id) pair.  Each entry records the
+    /// versions it was computed from, so an edited entity simply misses and overwrites.
+    struct PairKey {
+        uint64_t lo;
+        uint64_t hi;
+        bool operator==(const PairKey&) const = default;
+    };
+    struct PairKeyHash {
+        size_t operator()(const PairKey& k) const {
+            return std::hash<uint64_t>{}(k.lo * 0x9E3779B97F4A7C15ULL ^ k.hi);
+        }
+    };
+    struct CachedPair {
+        uint64_t loVersion = 0;
+        uint64_t hiVersion = 0;
+        std::vector<math::Vec2> points;
+    };
+
     double m_gridSpacing;
     double m_snapTolerance;
+    uint32_t m_enabledModes;
+    std::optional<math::Vec2> m_referencePoint;
+
+    mutable std::unordered_map<PairKey, CachedPair, PairKeyHash> m_intersectionCache;
+    mutable std::vector<std::shared_ptr<DraftEntity>> m_apertureEntities;
 };
 
 }  // namespace hz::draft
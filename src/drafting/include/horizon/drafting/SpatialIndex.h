@@ -1,30 +1,84 @@
 #pragma once
 
+#include <concepts>
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "DraftEntity.h"
 #include "horizon/math/BoundingBox.h"
 #include "horizon/math/RTree.h"
+#include "horizon/math/Vec2.h"
 
 namespace hz::draft {
 
 class SpatialIndex {
 public:
+    using Neighbor = math::RTree<uint64_t>::Neighbor;
+
     SpatialIndex() = default;
 
     void insert(const std::shared_ptr<DraftEntity>& entity);
     void remove(uint64_t entityId);
+    /// Re-index an entity after its geometry changed. Patches the owning leaf
+    /// in place when the new box still fits, so it is cheap per drag event.
     void update(const std::shared_ptr<DraftEntity>& entity);
 
     [[nodiscard]] std::vector<uint64_t> query(const math::BoundingBox& searchBox) const;
 
+    /// Query into a caller-owned buffer (cleared first) so repeated queries
+    /// reuse its capacity.
+    void query(const math::BoundingBox& searchBox, std::vector<uint64_t>& results) const;
+
+    /// Visit the ids of all entities whose boxes intersect `searchBox` without
+    /// allocating. `visit(id)` may return false to stop early; returns false
+    /// if it did.
+    template <typename Visitor>
+        requires std::invocable<Visitor&, const uint64_t&>
+    bool query(const math::BoundingBox& searchBox, Visitor&& visit) const {
+        return m_tree.query(searchBox, std::forward<Visitor>(visit));
+    }
+
+    /// The (up to) k entities nearest to `point` within `maxDist`, closest
+    /// first. `distanceFn(id, bbox)` gives the per-entity distance (e.g. to its
+    /// nearest snap point) and is only called for entities whose box could
+    /// still beat the current k-th best; it must not return less than the
+    /// point-to-box distance. Return infinity to reject an entity.
+    template <typename DistanceFn>
+    [[nodiscard]] std::vector<Neighbor> nearest(const math::Vec2& point, size_t k, double maxDist,
+                                                DistanceFn&& distanceFn) const {
+        return m_tree.nearest(point, k, maxDist, std::forward<DistanceFn>(distanceFn));
+    }
+
+    /// Report entities to `visitor(id, distance)` closest first, until it returns false
+    /// or none within `maxDist` remains; `distanceFn` as for nearest().
+    template <typename DistanceFn, typename Visitor>
+    void visitNearest(const math::Vec2& point, double maxDist, DistanceFn&& distanceFn,
+                      Visitor&& visitor) const {
+        m_tree.visitNearest(point, maxDist, std::forward<DistanceFn>(distanceFn),
+                            std::forward<Visitor>(visitor));
+    }
+
+    /// 2D point-to-box distance: the lower bound nearest() prunes with.
+    static double boxDistance(const math::Vec2& point, const math::BoundingBox& bbox) {
+        return math::RTree<uint64_t>::boxDistance(point, bbox);
+    }
+
+    /// Box enclosing every indexed entity (invalid when the index is empty).
+    [[nodiscard]] math::BoundingBox bounds() const { return m_tree.bounds(); }
+
+    /// Replace the index contents with the given entities (STR bulk load).
     void rebuild(const std::vector<std::shared_ptr<DraftEntity>>& entities);
     void clear();
 
+    /// Counter bumped by every insert, remove, update, rebuild and clear.  Results of
+    /// earlier queries may be reused for as long as it stays the same.
+    [[nodiscard]] uint64_t revision() const { return m_revision; }
+
 private:
     math::RTree<uint64_t> m_tree;
+    uint64_t m_revision = 0;
 };
 
 }  // namespace hz::draft
@@ -0,0 +1,132 @@
+#include "horizon/drafting/BlockDefinition.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace hz::draft {
+
+namespace {
+
+void hashCombine(uint64_t& seed, uint64_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2);
+}
+
+double cross(const math::Vec2& o, const math::Vec2& a, const math::Vec2& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/// Andrew's monotone chain.  Collinear points are dropped; fewer than three distinct
+/// points are returned as they are.
+std::vector<math::Vec2> convexHull(std::vector<math::Vec2> pts) {
+    std::sort(pts.begin(), pts.end(), [](const math::Vec2& a, const math::Vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    pts.erase(std::unique(pts.begin(), pts.end(),
+                          [](const math::Vec2& a, const math::Vec2& b) {
+                              return a.x == b.x && a.y == b.y;
+                          }),
+              pts.end());
+    if (pts.size() < 3) return pts;
+
+    std::vector<math::Vec2> hull(2 * pts.size());
+    size_t k = 0;
+    for (const auto& p : pts) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], p) <= 0.0) --k;
+        hull[k++] = p;
+    }
+    for (size_t i = pts.size() - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0.0) --k;
+        hull[k++] = pts[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+}  // namespace
+
+BlockDefinition::Cache& BlockDefinition::Cache::operator=(const Cache&) {
+    std::lock_guard lock(mutex);
+    stampValid = false;
+    geometry.reset();
+    return *this;
+}
+
+uint64_t BlockDefinition::contentStamp() const {
+    // Read the counter before the versions: an edit racing the walk moves it past the
+    // value stored, so the next call walks again.
+    const uint64_t counter = DraftEntity::versionCounter();
+    {
+        std::lock_guard lock(m_cache.mutex);
+        if (m_cache.stampValid && m_cache.versionCounter == counter &&
+            m_cache.basePoint.x == basePoint.x && m_cache.basePoint.y == basePoint.y &&
+            m_cache.entityData == entities.data() && m_cache.entityCount == entities.size()) {
+            return m_cache.stamp;
+        }
+    }
+
+    uint64_t stamp = 0;
+    hashCombine(stamp, std::hash<double>{}(basePoint.x));
+    hashCombine(stamp, std::hash<double>{}(basePoint.y));
+    hashCombine(stamp, entities.size());
+    for (const auto& ent : entities) hashCombine(stamp, ent->version());
+
+    std::lock_guard lock(m_cache.mutex);
+    m_cache.stampValid = true;
+    m_cache.versionCounter = counter;
+    m_cache.basePoint = basePoint;
+    m_cache.entityData = entities.data();
+    m_cache.entityCount = entities.size();
+    m_cache.stamp = stamp;
+    return stamp;
+}
+
+void BlockDefinition::markModified() {
+    std::lock_guard lock(m_cache.mutex);
+    m_cache.stampValid = false;
+}
+
+std::shared_ptr<const BlockGeometry> BlockDefinition::geometry() const {
+    const uint64_t stamp = contentStamp();
+    {
+        std::lock_guard lock(m_cache.mutex);
+        if (m_cache.geometry && m_cache.geometry->stamp == stamp) return m_cache.geometry;
+    }
+
+    // Build under a per-definition lock, not just the cache lock: building fills caches
+    // on the templates that are not thread-safe (DraftHatch::generateHatchLines()).  A
+    // caller that waited here finds the result ready.
+    std::lock_guard build(m_cache.buildMutex);
+    {
+        std::lock_guard lock(m_cache.mutex);
+        if (m_cache.geometry && m_cache.geometry->stamp == stamp) return m_cache.geometry;
+    }
+
+    auto geom = std::make_shared<BlockGeometry>();
+    geom->stamp = stamp;
+    geom->display = buildBlockDisplayList(*this);
+
+    std::vector<math::Vec2> corners;
+    geom->entityBounds.reserve(entities.size());
+    for (const auto& ent : entities) {
+        math::BoundingBox local;
+        auto bb = ent->boundingBox();
+        if (bb.isValid()) {
+            math::Vec3 base(basePoint.x, basePoint.y, 0.0);
+            local = math::BoundingBox(bb.min() - base, bb.max() - base);
+            geom->bounds.expand(local);
+            math::Vec3 lo = local.min();
+            math::Vec3 hi = local.max();
+            corners.insert(corners.end(), {{lo.x, lo.y}, {hi.x, lo.y}, {hi.x, hi.y}, {lo.x, hi.y}});
+        }
+        geom->entityBounds.push_back(local);
+
+        for (const auto& sp : ent->snapPoints()) geom->snapPoints.push_back(sp - basePoint);
+    }
+    geom->hull = convexHull(std::move(corners));
+
+    std::lock_guard lock(m_cache.mutex);
+    m_cache.geometry = geom;
+    return geom;
+}
+
+}  // namespace hz::draft
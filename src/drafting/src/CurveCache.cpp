@@ -0,0 +1,180 @@
+#include "horizon/drafting/CurveCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace hz::draft {
+
+namespace {
+
+/// Segments per hierarchy leaf.
+constexpr uint32_t kLeafSegments = 8;
+
+double segmentDistance(const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) {
+    math::Vec2 ab = b - a;
+    double lenSq = ab.lengthSquared();
+    if (lenSq < 1e-14) return p.distanceTo(a);
+    double t = std::clamp((p - a).dot(ab) / lenSq, 0.0, 1.0);
+    return p.distanceTo(a + ab * t);
+}
+
+std::shared_ptr<const CurveFlattening> build(uint64_t version, int bucket,
+                                             const CurveCache::Flattener& flatten) {
+    auto built = std::make_shared<CurveFlattening>();
+    built->version = version;
+    built->bucket = bucket;
+    built->points = flatten(CurveCache::bucketTolerance(bucket));
+    built->buildHierarchy();
+    return built;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// CurveFlattening
+// ---------------------------------------------------------------------------
+
+void CurveFlattening::buildHierarchy() {
+    nodes.clear();
+    if (points.size() < 2) return;
+    const auto segments = static_cast<uint32_t>(points.size() - 1);
+    nodes.reserve(2 * (segments / kLeafSegments + 1));
+
+    // Consecutive segments of a curve are spatially coherent, so halving the index
+    // range gives tight boxes without any sorting.
+    auto split = [&](auto& self, uint32_t begin, uint32_t end) -> void {
+        const auto index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({points[begin].x, points[begin].y, points[begin].x, points[begin].y,
+                         begin, end, 0});
+        if (end - begin <= kLeafSegments) {
+            Node& leaf = nodes[index];
+            for (uint32_t i = begin + 1; i <= end; ++i) {
+                leaf.minX = std::min(leaf.minX, points[i].x);
+                leaf.minY = std::min(leaf.minY, points[i].y);
+                leaf.maxX = std::max(leaf.maxX, points[i].x);
+                leaf.maxY = std::max(leaf.maxY, points[i].y);
+            }
+            return;
+        }
+        const uint32_t mid = begin + (end - begin) / 2;
+        self(self, begin, mid);
+        const auto right = static_cast<uint32_t>(nodes.size());
+        self(self, mid, end);
+
+        Node& node = nodes[index];
+        const Node& l = nodes[index + 1];
+        const Node& r = nodes[right];
+        node.minX = std::min(l.minX, r.minX);
+        node.minY = std::min(l.minY, r.minY);
+        node.maxX = std::max(l.maxX, r.maxX);
+        node.maxY = std::max(l.maxY, r.maxY);
+        node.right = right;
+    };
+    split(split, 0, segments);
+}
+
+bool CurveFlattening::nearPoint(const math::Vec2& p, double tolerance) const {
+    if (nodes.empty()) return false;
+
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (p.x < node.minX - tolerance || p.x > node.maxX + tolerance ||
+            p.y < node.minY - tolerance || p.y > node.maxY + tolerance) {
+            continue;
+        }
+        if (node.right == 0) {
+            for (uint32_t i = node.begin; i < node.end; ++i) {
+                if (segmentDistance(p, points[i], points[i + 1]) <= tolerance) return true;
+            }
+            continue;
+        }
+        stack[top++] = node.right;
+        stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+    }
+    return false;
+}
+
+math::BoundingBox CurveFlattening::bounds() const {
+    if (!nodes.empty()) {
+        const Node& root = nodes.front();
+        return math::BoundingBox(math::Vec3(root.minX, root.minY, 0.0),
+                                 math::Vec3(root.maxX, root.maxY, 0.0));
+    }
+    if (points.empty()) return {};
+    return math::BoundingBox(math::Vec3(points[0].x, points[0].y, 0.0),
+                             math::Vec3(points[0].x, points[0].y, 0.0));
+}
+
+// ---------------------------------------------------------------------------
+// CurveCache
+// ---------------------------------------------------------------------------
+
+CurveCache& CurveCache::operator=(const CurveCache& other) {
+    if (this != &other) {
+        std::lock_guard lock(m_mutex);
+        m_slots = {};
+        m_standard.reset();
+        m_bounds.reset();
+    }
+    return *this;
+}
+
+int CurveCache::bucketOf(double tolerance) {
+    return static_cast<int>(std::floor(std::log2(std::max(tolerance, 1e-12))));
+}
+
+double CurveCache::bucketTolerance(int bucket) { return std::ldexp(1.0, bucket); }
+
+std::shared_ptr<const CurveFlattening> CurveCache::flattening(uint64_t version,
+                                                              double tolerance,
+                                                              const Flattener& flatten) const {
+    const int bucket = bucketOf(tolerance);
+    {
+        std::lock_guard lock(m_mutex);
+        for (size_t i = 0; i < kSlots; ++i) {
+            const auto& slot = m_slots[i];
+            if (slot && slot->version == version && slot->bucket == bucket) {
+                std::rotate(m_slots.begin(), m_slots.begin() + i, m_slots.begin() + i + 1);
+                return m_slots.front();
+            }
+        }
+    }
+
+    // Build outside the lock: concurrent misses may both flatten, which is harmless.
+    auto built = build(version, bucket, flatten);
+    std::lock_guard lock(m_mutex);
+    std::move_backward(m_slots.begin(), m_slots.end() - 1, m_slots.end());
+    m_slots.front() = built;
+    return built;
+}
+
+std::shared_ptr<const CurveFlattening> CurveCache::standardFlattening(
+    uint64_t version, const std::function<double()>& tolerance, const Flattener& flatten) const {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_standard && m_standard->version == version) return m_standard;
+    }
+    auto built = build(version, bucketOf(tolerance()), flatten);
+    std::lock_guard lock(m_mutex);
+    m_standard = built;
+    return built;
+}
+
+math::BoundingBox CurveCache::bounds(uint64_t version,
+                                     const std::function<math::BoundingBox()>& compute) const {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_bounds && m_boundsVersion == version) return *m_bounds;
+    }
+    math::BoundingBox box = compute();
+    std::lock_guard lock(m_mutex);
+    m_bounds = box;
+    m_boundsVersion = version;
+    return box;
+}
+
+}  // namespace hz::draft
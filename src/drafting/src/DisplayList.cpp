@@ -0,0 +1,256 @@
+#include "horizon/drafting/DisplayList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftBlockRef.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDimension.h"
+#include "horizon/drafting/DraftEllipse.h"
+#include "horizon/drafting/DraftHatch.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/drafting/DraftRectangle.h"
+#include "horizon/drafting/DraftSpline.h"
+#include "horizon/drafting/DraftText.h"
+#include "horizon/math/Constants.h"
+
+namespace hz::draft {
+
+namespace {
+
+/// Segments used for a full circle (arcs get a proportional share, at least 4).
+constexpr int kCircleSegments = 64;
+
+void emitVert(std::vector<float>& v, double x, double y, double dist) {
+    v.push_back(static_cast<float>(x));
+    v.push_back(static_cast<float>(y));
+    v.push_back(0.0f);
+    v.push_back(static_cast<float>(dist));
+}
+
+/// Emit a point sequence as segments with cumulative distance.
+void emitPointSeq(std::vector<float>& v, const std::vector<math::Vec2>& pts, bool closed) {
+    double cumDist = 0.0;
+    for (size_t i = 0; i + 1 < pts.size(); ++i) {
+        emitVert(v, pts[i].x, pts[i].y, cumDist);
+        cumDist += pts[i].distanceTo(pts[i + 1]);
+        emitVert(v, pts[i + 1].x, pts[i + 1].y, cumDist);
+    }
+    if (closed && pts.size() >= 2) {
+        emitVert(v, pts.back().x, pts.back().y, cumDist);
+        cumDist += pts.back().distanceTo(pts[0]);
+        emitVert(v, pts[0].x, pts[0].y, cumDist);
+    }
+}
+
+/// Emit independent segments, each starting at distance 0.
+void emitSegments(std::vector<float>& v,
+                  const std::vector<std::pair<math::Vec2, math::Vec2>>& segs) {
+    for (const auto& [a, b] : segs) {
+        emitVert(v, a.x, a.y, 0.0);
+        emitVert(v, b.x, b.y, a.distanceTo(b));
+    }
+}
+
+void emitArc(std::vector<float>& v, const math::Vec2& center, double radius, double startAngle,
+             double sweep, int segments) {
+    const double step = sweep / static_cast<double>(segments);
+    const double arcStep = radius * step;  // Arc-length per segment.
+    for (int i = 0; i < segments; ++i) {
+        double a0 = startAngle + step * static_cast<double>(i);
+        double a1 = startAngle + step * static_cast<double>(i + 1);
+        emitVert(v, center.x + radius * std::cos(a0), center.y + radius * std::sin(a0),
+                 arcStep * static_cast<double>(i));
+        emitVert(v, center.x + radius * std::cos(a1), center.y + radius * std::sin(a1),
+                 arcStep * static_cast<double>(i + 1));
+    }
+}
+
+void emitCircle(std::vector<float>& v, const math::Vec2& center, double radius) {
+    emitArc(v, center, radius, 0.0, math::kTwoPi, kCircleSegments);
+}
+
+void emitArc(std::vector<float>& v, const math::Vec2& center, double radius, double startAngle,
+             double endAngle) {
+    double sweep = endAngle - startAngle;
+    if (sweep <= 0.0) sweep += math::kTwoPi;
+    int segments = std::max(4, static_cast<int>(kCircleSegments * sweep / math::kTwoPi));
+    emitArc(v, center, radius, startAngle, sweep, segments);
+}
+
+/// Emit the curve geometry of a plain entity into `v`, mapping every point through
+/// `xf`.  Circles and arcs are handled by the callers since they are not point-mapped.
+/// Returns false for entity types without curve geometry.
+bool emitMapped(std::vector<float>& v, const DraftEntity& entity,
+                const std::function<math::Vec2(const math::Vec2&)>& xf) {
+    auto mapAll = [&](const std::vector<math::Vec2>& pts) {
+        std::vector<math::Vec2> out;
+        out.reserve(pts.size());
+        for (const auto& p : pts) out.push_back(xf(p));
+        return out;
+    };
+
+    if (auto* line = dynamic_cast<const DraftLine*>(&entity)) {
+        emitPointSeq(v, {xf(line->start()), xf(line->end())}, false);
+    } else if (auto* rect = dynamic_cast<const DraftRectangle*>(&entity)) {
+        auto c = rect->corners();
+        emitPointSeq(v, mapAll({c.begin(), c.end()}), true);
+    } else if (auto* polyline = dynamic_cast<const DraftPolyline*>(&entity)) {
+        emitPointSeq(v, mapAll(polyline->points()), polyline->closed());
+    } else if (auto* spline = dynamic_cast<const DraftSpline*>(&entity)) {
+        emitPointSeq(v, mapAll(spline->flattened()->points), false);
+    } else if (auto* ellipse = dynamic_cast<const DraftEllipse*>(&entity)) {
+        emitPointSeq(v, mapAll(ellipse->flattened()->points), false);
+    } else if (auto* hatch = dynamic_cast<const DraftHatch*>(&entity)) {
+        // Boundary and hole outlines with cumulative distance, then fill lines from
+        // distance 0.
+        emitPointSeq(v, mapAll(hatch->boundary()), true);
+        for (const auto& hole : hatch->holes()) emitPointSeq(v, mapAll(hole), true);
+        auto fill = hatch->generateHatchLines();
+        for (auto& [a, b] : fill) {
+            a = xf(a);
+            b = xf(b);
+        }
+        emitSegments(v, fill);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// Map block-local vertices through a reference's transform.  Distances scale with the
+/// reference so dash patterns keep their proportions.
+void emitTransformed(std::vector<float>& v, const std::vector<float>& local,
+                     const DraftBlockRef& bref) {
+    const double scale = bref.uniformScale();
+    const double c = std::cos(bref.rotation()) * scale;
+    const double s = std::sin(bref.rotation()) * scale;
+    const math::Vec2& origin = bref.insertPos();
+    v.reserve(local.size());
+    for (size_t i = 0; i + 3 < local.size(); i += 4) {
+        double x = local[i], y = local[i + 1];
+        emitVert(v, origin.x + x * c - y * s, origin.y + x * s + y * c,
+                 local[i + 3] * std::abs(scale));
+    }
+}
+
+/// Expand a block reference into world space from its definition's cached tessellation.
+void buildBlockRef(DisplayList& list, const DraftBlockRef& bref) {
+    const auto geom = bref.definition()->geometry();
+    for (const auto& localStroke : geom->display.strokes) {
+        DisplayStroke stroke;
+        stroke.color = localStroke.color;
+        stroke.lineWidth = localStroke.lineWidth;
+        stroke.lineType = localStroke.lineType;
+        emitTransformed(stroke.vertices, localStroke.vertices, bref);
+        list.strokes.push_back(std::move(stroke));
+    }
+}
+
+void hashCombine(uint64_t& seed, uint64_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2);
+}
+
+/// Inputs to an entity's display list that its own version does not cover.
+uint64_t contentStamp(const DraftEntity& entity, const DimensionStyle& style) {
+    uint64_t stamp = 0;
+    if (auto* bref = dynamic_cast<const DraftBlockRef*>(&entity)) {
+        const auto& def = bref->definition();
+        hashCombine(stamp, reinterpret_cast<uintptr_t>(def.get()));
+        hashCombine(stamp, def->contentStamp());
+    } else if (dynamic_cast<const DraftDimension*>(&entity)) {
+        for (double d : {style.textHeight, style.arrowSize, style.arrowAngle,
+                         style.extensionGap, style.extensionOvershoot}) {
+            hashCombine(stamp, std::hash<double>{}(d));
+        }
+        hashCombine(stamp, static_cast<uint64_t>(style.precision));
+        hashCombine(stamp, style.showUnits ? 1u : 0u);
+    }
+    return stamp;
+}
+
+}  // namespace
+
+DisplayList buildDisplayList(const DraftEntity& entity, const DimensionStyle& style) {
+    DisplayList list;
+
+    if (auto* bref = dynamic_cast<const DraftBlockRef*>(&entity)) {
+        buildBlockRef(list, *bref);
+        return list;
+    }
+    if (auto* txt = dynamic_cast<const DraftText*>(&entity)) {
+        list.texts.push_back({txt->position(), txt->text(), txt->textHeight(), txt->rotation(),
+                              static_cast<int>(txt->alignment())});
+        return list;
+    }
+
+    DisplayStroke stroke;
+    if (auto* circle = dynamic_cast<const DraftCircle*>(&entity)) {
+        emitCircle(stroke.vertices, circle->center(), circle->radius());
+    } else if (auto* arc = dynamic_cast<const DraftArc*>(&entity)) {
+        emitArc(stroke.vertices, arc->center(), arc->radius(), arc->startAngle(),
+                arc->endAngle());
+    } else if (auto* dim = dynamic_cast<const DraftDimension*>(&entity)) {
+        emitSegments(stroke.vertices, dim->extensionLines(style));
+        emitSegments(stroke.vertices, dim->dimensionLines(style));
+        emitSegments(stroke.vertices, dim->arrowheadLines(style));
+        list.texts.push_back({dim->textPosition(), dim->displayText(style)});
+    } else {
+        emitMapped(stroke.vertices, entity, [](const math::Vec2& p) { return p; });
+    }
+    if (!stroke.vertices.empty()) list.strokes.push_back(std::move(stroke));
+    return list;
+}
+
+DisplayList buildBlockDisplayList(const BlockDefinition& def) {
+    DisplayList list;
+    auto xf = [&def](const math::Vec2& p) { return p - def.basePoint; };
+
+    for (const auto& sub : def.entities) {
+        DisplayStroke stroke;
+        stroke.color = sub->color();
+        stroke.lineWidth = sub->lineWidth();
+        stroke.lineType = sub->lineType();
+
+        if (auto* circle = dynamic_cast<const DraftCircle*>(sub.get())) {
+            emitCircle(stroke.vertices, xf(circle->center()), circle->radius());
+        } else if (auto* arc = dynamic_cast<const DraftArc*>(sub.get())) {
+            emitArc(stroke.vertices, xf(arc->center()), arc->radius(), arc->startAngle(),
+                    arc->endAngle());
+        } else if (!emitMapped(stroke.vertices, *sub, xf)) {
+            continue;
+        }
+        if (!stroke.vertices.empty()) list.strokes.push_back(std::move(stroke));
+    }
+    return list;
+}
+
+const DisplayList& DisplayListCache::get(const DraftEntity& entity, const DimensionStyle& style) {
+    const uint64_t stamp = contentStamp(entity, style);
+    auto [it, inserted] = m_entries.try_emplace(entity.id());
+    Entry& entry = it->second;
+    entry.frame = m_frame;
+    if (inserted || entry.version != entity.version() || entry.stamp != stamp) {
+        entry.version = entity.version();
+        entry.stamp = stamp;
+        entry.list = buildDisplayList(entity, style);
+        entry.list.revision = m_nextRevision++;
+    }
+    return entry.list;
+}
+
+void DisplayListCache::trim(size_t maxEntries) {
+    if (m_entries.size() <= maxEntries) return;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.frame != m_frame) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace hz::draft
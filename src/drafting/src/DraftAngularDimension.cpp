@@ -232,6 +232,7 @@ std::vector<math::Vec2> DraftAngularDimension::snapPoints() const {
 }
 
 void DraftAngularDimension::translate(const math::Vec2& delta) {
+    markModified();
     m_vertex += delta;
     m_line1Point += delta;
     m_line2Point += delta;
@@ -240,7 +241,7 @@ void DraftAngularDimension::translate(const math::Vec2& delta) {
 std::shared_ptr<DraftEntity> DraftAngularDimension::clone() const {
     auto copy =
         std::make_shared<DraftAngularDimension>(m_vertex, m_line1Point, m_line2Point, m_arcRadius);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -250,18 +251,21 @@ std::shared_ptr<DraftEntity> DraftAngularDimension::clone() const {
 }
 
 void DraftAngularDimension::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_vertex = mirrorPoint(m_vertex, axisP1, axisP2);
     m_line1Point = mirrorPoint(m_line1Point, axisP1, axisP2);
     m_line2Point = mirrorPoint(m_line2Point, axisP1, axisP2);
 }
 
 void DraftAngularDimension::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_vertex = rotatePoint(m_vertex, center, angle);
     m_line1Point = rotatePoint(m_line1Point, center, angle);
     m_line2Point = rotatePoint(m_line2Point, center, angle);
 }
 
 void DraftAngularDimension::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_vertex = scalePoint(m_vertex, center, factor);
     m_line1Point = scalePoint(m_line1Point, center, factor);
     m_line2Point = scalePoint(m_line2Point, center, factor);
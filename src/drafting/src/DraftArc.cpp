@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 
+#include "horizon/drafting/PrimitiveGeometry.h"
 #include "horizon/math/Constants.h"
 #include "horizon/math/MathUtils.h"
 
@@ -36,39 +37,15 @@ math::Vec2 DraftArc::midPoint() const {
 }
 
 bool DraftArc::containsAngle(double angle) const {
-    angle = math::normalizeAngle(angle);
-    if (m_startAngle <= m_endAngle) {
-        return angle >= m_startAngle && angle <= m_endAngle;
-    }
-    // Wraps around zero.
-    return angle >= m_startAngle || angle <= m_endAngle;
+    return arcContainsAngle(m_startAngle, m_endAngle, angle);
 }
 
 math::BoundingBox DraftArc::boundingBox() const {
-    math::Vec2 sp = startPoint();
-    math::Vec2 ep = endPoint();
-
-    double minX = std::min(sp.x, ep.x);
-    double minY = std::min(sp.y, ep.y);
-    double maxX = std::max(sp.x, ep.x);
-    double maxY = std::max(sp.y, ep.y);
-
-    // Expand if arc crosses a quadrant boundary.
-    if (containsAngle(0.0)) maxX = m_center.x + m_radius;
-    if (containsAngle(math::kHalfPi)) maxY = m_center.y + m_radius;
-    if (containsAngle(math::kPi)) minX = m_center.x - m_radius;
-    if (containsAngle(math::kPi * 1.5)) minY = m_center.y - m_radius;
-
-    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+    return arcBoundingBox(m_center, m_radius, m_startAngle, m_endAngle);
 }
 
 bool DraftArc::hitTest(const math::Vec2& point, double tolerance) const {
-    double distToCenter = point.distanceTo(m_center);
-    double distToEdge = std::abs(distToCenter - m_radius);
-    if (distToEdge > tolerance) return false;
-
-    double angle = std::atan2(point.y - m_center.y, point.x - m_center.x);
-    return containsAngle(angle);
+    return arcHitTest(m_center, m_radius, m_startAngle, m_endAngle, point, tolerance);
 }
 
 std::vector<math::Vec2> DraftArc::snapPoints() const {
@@ -76,6 +53,7 @@ std::vector<math::Vec2> DraftArc::snapPoints() const {
 }
 
 void DraftArc::translate(const math::Vec2& delta) {
+    markModified();
     m_center += delta;
 }
 
@@ -88,7 +66,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 
 std::shared_ptr<DraftEntity> DraftArc::clone() const {
     auto copy = std::make_shared<DraftArc>(m_center, m_radius, m_startAngle, m_endAngle);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -97,6 +75,7 @@ std::shared_ptr<DraftEntity> DraftArc::clone() const {
 }
 
 void DraftArc::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     // Mirror center.
     m_center = mirrorPoint(m_center, axisP1, axisP2);
 
@@ -121,12 +100,14 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftArc::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_center = rotatePoint(m_center, center, angle);
     m_startAngle = math::normalizeAngle(m_startAngle + angle);
     m_endAngle = math::normalizeAngle(m_endAngle + angle);
 }
 
 void DraftArc::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_center = scalePoint(m_center, center, factor);
     m_radius *= std::abs(factor);
 }
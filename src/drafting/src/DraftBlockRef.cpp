@@ -6,6 +6,17 @@
 
 namespace hz::draft {
 
+namespace {
+
+/// True if `p` lies within `tolerance` of the box.  Invalid boxes are never near.
+bool nearBox(const math::BoundingBox& box, const math::Vec2& p, double tolerance) {
+    if (!box.isValid()) return false;
+    return p.x >= box.min().x - tolerance && p.x <= box.max().x + tolerance &&
+           p.y >= box.min().y - tolerance && p.y <= box.max().y + tolerance;
+}
+
+}  // namespace
+
 DraftBlockRef::DraftBlockRef(std::shared_ptr<BlockDefinition> definition,
                              const math::Vec2& insertPos, double rotation, double uniformScale)
     : m_definition(std::move(definition)),
@@ -14,70 +25,86 @@ DraftBlockRef::DraftBlockRef(std::shared_ptr<BlockDefinition> definition,
       m_uniformScale(uniformScale) {}
 
 math::Vec2 DraftBlockRef::transformPoint(const math::Vec2& defPt) const {
-    // worldPt = insertPos + rotate((defPt - basePoint) * scale, rotation)
-    math::Vec2 local = (defPt - m_definition->basePoint) * m_uniformScale;
-    double c = std::cos(m_rotation), s = std::sin(m_rotation);
-    return {m_insertPos.x + local.x * c - local.y * s, m_insertPos.y + local.x * s + local.y * c};
+    return localToWorld(defPt - m_definition->basePoint);
 }
 
 math::Vec2 DraftBlockRef::inverseTransformPoint(const math::Vec2& worldPt) const {
-    // Reverse: defPt = rotate(worldPt - insertPos, -rotation) / scale + basePoint
+    return worldToLocal(worldPt) + m_definition->basePoint;
+}
+
+math::Vec2 DraftBlockRef::localToWorld(const math::Vec2& local) const {
+    // worldPt = insertPos + rotate(local * scale, rotation)
+    math::Vec2 scaled = local * m_uniformScale;
+    double c = std::cos(m_rotation), s = std::sin(m_rotation);
+    return {m_insertPos.x + scaled.x * c - scaled.y * s,
+            m_insertPos.y + scaled.x * s + scaled.y * c};
+}
+
+math::Vec2 DraftBlockRef::worldToLocal(const math::Vec2& worldPt) const {
+    // Reverse: local = rotate(worldPt - insertPos, -rotation) / scale
     math::Vec2 d = worldPt - m_insertPos;
     double c = std::cos(-m_rotation), s = std::sin(-m_rotation);
     math::Vec2 rotated = {d.x * c - d.y * s, d.x * s + d.y * c};
     double invScale = (std::abs(m_uniformScale) > 1e-12) ? (1.0 / m_uniformScale) : 0.0;
-    return rotated * invScale + m_definition->basePoint;
+    return rotated * invScale;
 }
 
 math::BoundingBox DraftBlockRef::boundingBox() const {
+    // The hull of the definition's entity-box corners transforms to the same bounds as
+    // the corners themselves.
+    const auto geom = m_definition->geometry();
     math::BoundingBox bbox;
-    for (const auto& ent : m_definition->entities) {
-        auto subBB = ent->boundingBox();
-        if (!subBB.isValid()) continue;
-        // Transform all 4 corners of the sub-entity bbox.
-        math::Vec3 lo = subBB.min();
-        math::Vec3 hi = subBB.max();
-        math::Vec2 corners[4] = {{lo.x, lo.y}, {hi.x, lo.y}, {hi.x, hi.y}, {lo.x, hi.y}};
-        for (const auto& corner : corners) {
-            math::Vec2 w = transformPoint(corner);
-            bbox.expand(math::Vec3(w.x, w.y, 0.0));
-        }
+    double c = std::cos(m_rotation) * m_uniformScale;
+    double s = std::sin(m_rotation) * m_uniformScale;
+    for (const auto& p : geom->hull) {
+        bbox.expand(math::Vec3(m_insertPos.x + p.x * c - p.y * s,
+                               m_insertPos.y + p.x * s + p.y * c, 0.0));
     }
     return bbox;
 }
 
 bool DraftBlockRef::hitTest(const math::Vec2& point, double tolerance) const {
-    // Inverse-transform point into definition space.
-    math::Vec2 defPt = inverseTransformPoint(point);
+    // Inverse-transform point into block-local space and only ask the entities whose
+    // cached bounds it falls near.
+    const auto geom = m_definition->geometry();
+    math::Vec2 local = worldToLocal(point);
     double defTolerance =
         (std::abs(m_uniformScale) > 1e-12) ? (tolerance / std::abs(m_uniformScale)) : tolerance;
-    for (const auto& ent : m_definition->entities) {
-        if (ent->hitTest(defPt, defTolerance)) return true;
+    if (!nearBox(geom->bounds, local, defTolerance)) return false;
+
+    math::Vec2 defPt = local + m_definition->basePoint;
+    const auto& entities = m_definition->entities;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (!nearBox(geom->entityBounds[i], local, defTolerance)) continue;
+        if (entities[i]->hitTest(defPt, defTolerance)) return true;
     }
     return false;
 }
 
 std::vector<math::Vec2> DraftBlockRef::snapPoints() const {
+    const auto geom = m_definition->geometry();
     std::vector<math::Vec2> points;
+    points.reserve(geom->snapPoints.size() + 1);
     // Insert point is always a snap point.
     points.push_back(m_insertPos);
     // Transformed snap points from sub-entities.
-    for (const auto& ent : m_definition->entities) {
-        for (const auto& sp : ent->snapPoints()) {
-            points.push_back(transformPoint(sp));
-        }
+    double c = std::cos(m_rotation) * m_uniformScale;
+    double s = std::sin(m_rotation) * m_uniformScale;
+    for (const auto& p : geom->snapPoints) {
+        points.push_back({m_insertPos.x + p.x * c - p.y * s, m_insertPos.y + p.x * s + p.y * c});
     }
     return points;
 }
 
 void DraftBlockRef::translate(const math::Vec2& delta) {
+    markModified();
     m_insertPos += delta;
 }
 
 std::shared_ptr<DraftEntity> DraftBlockRef::clone() const {
     auto copy =
         std::make_shared<DraftBlockRef>(m_definition, m_insertPos, m_rotation, m_uniformScale);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -86,6 +113,7 @@ std::shared_ptr<DraftEntity> DraftBlockRef::clone() const {
 }
 
 void DraftBlockRef::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     // Mirror the insert point.
     math::Vec2 d = (axisP2 - axisP1).normalized();
     math::Vec2 v = m_insertPos - axisP1;
@@ -101,6 +129,7 @@ void DraftBlockRef::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
 }
 
 void DraftBlockRef::rotate(const math::Vec2& center, double angle) {
+    markModified();
     // Rotate the insert point around center.
     double c = std::cos(angle), s = std::sin(angle);
     math::Vec2 v = m_insertPos - center;
@@ -109,6 +138,7 @@ void DraftBlockRef::rotate(const math::Vec2& center, double angle) {
 }
 
 void DraftBlockRef::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_insertPos = center + (m_insertPos - center) * factor;
     m_uniformScale *= factor;
 }
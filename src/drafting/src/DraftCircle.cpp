@@ -2,22 +2,19 @@
 
 #include <cmath>
 
+#include "horizon/drafting/PrimitiveGeometry.h"
+
 namespace hz::draft {
 
 DraftCircle::DraftCircle(const math::Vec2& center, double radius)
     : m_center(center), m_radius(radius) {}
 
 math::BoundingBox DraftCircle::boundingBox() const {
-    math::Vec3 lo(m_center.x - m_radius, m_center.y - m_radius, 0.0);
-    math::Vec3 hi(m_center.x + m_radius, m_center.y + m_radius, 0.0);
-    return math::BoundingBox(lo, hi);
+    return circleBoundingBox(m_center, m_radius);
 }
 
 bool DraftCircle::hitTest(const math::Vec2& point, double tolerance) const {
-    // Distance from point to circle edge
-    double distToCenter = point.distanceTo(m_center);
-    double distToEdge = std::abs(distToCenter - m_radius);
-    return distToEdge <= tolerance;
+    return circleHitTest(m_center, m_radius, point, tolerance);
 }
 
 std::vector<math::Vec2> DraftCircle::snapPoints() const {
@@ -31,6 +28,7 @@ std::vector<math::Vec2> DraftCircle::snapPoints() const {
 }
 
 void DraftCircle::translate(const math::Vec2& delta) {
+    markModified();
     m_center += delta;
 }
 
@@ -43,7 +41,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 
 std::shared_ptr<DraftEntity> DraftCircle::clone() const {
     auto copy = std::make_shared<DraftCircle>(m_center, m_radius);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -52,6 +50,7 @@ std::shared_ptr<DraftEntity> DraftCircle::clone() const {
 }
 
 void DraftCircle::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_center = mirrorPoint(m_center, axisP1, axisP2);
 }
 
@@ -66,10 +65,12 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftCircle::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_center = rotatePoint(m_center, center, angle);
 }
 
 void DraftCircle::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_center = scalePoint(m_center, center, factor);
     m_radius *= std::abs(factor);
 }
@@ -4,30 +4,152 @@
 
 namespace hz::draft {
 
+namespace {
+
+/// True if re-indexing `changed` of `total` entities is cheaper as one STR bulk load
+/// than as per-entity R-tree edits.  A bulk load costs about as much as inserting a
+/// quarter of its entries one at a time.
+bool preferRebuild(size_t changed, size_t total) {
+    return changed * 4 >= total;
+}
+
+}  // namespace
+
 void DraftDocument::addEntity(std::shared_ptr<DraftEntity> entity) {
-    if (entity) {
-        m_spatialIndex.insert(entity);
+    if (!entity || replaceEntity(entity)) return;
+    m_spatialIndex.insert(entity);
+    m_index.emplace(entity->id(), IndexEntry{m_entities.size(), m_store.sync(*entity)});
+    m_entities.push_back(std::move(entity));
+}
+
+void DraftDocument::addEntities(std::vector<std::shared_ptr<DraftEntity>> entities) {
+    if (entities.empty()) return;
+    const size_t first = m_entities.size();
+    m_entities.reserve(m_entities.size() + entities.size());
+    std::vector<size_t> replaced;  // slots before `first` taken over by a repeated id
+    for (auto& entity : entities) {
+        if (!entity) continue;
+        auto [it, inserted] = m_index.try_emplace(entity->id(), IndexEntry{m_entities.size(), {}});
+        it->second.stored = m_store.sync(*entity, it->second.stored);
+        if (!inserted) {
+            m_entities[it->second.slot] = std::move(entity);
+            if (it->second.slot < first) replaced.push_back(it->second.slot);
+            continue;
+        }
         m_entities.push_back(std::move(entity));
     }
+    const size_t added = m_entities.size() - first;
+    if (preferRebuild(added + replaced.size(), m_entities.size())) {
+        m_spatialIndex.rebuild(m_entities);
+        return;
+    }
+    for (size_t i = first; i < m_entities.size(); ++i) m_spatialIndex.insert(m_entities[i]);
+    for (size_t slot : replaced) m_spatialIndex.update(m_entities[slot]);
 }
 
 void DraftDocument::removeEntity(uint64_t id) {
     m_spatialIndex.remove(id);
-    m_entities.erase(
-        std::remove_if(m_entities.begin(), m_entities.end(),
-                       [id](const std::shared_ptr<DraftEntity>& e) { return e->id() == id; }),
-        m_entities.end());
+    auto it = m_index.find(id);
+    if (it == m_index.end()) return;
+    const size_t slot = it->second.slot;
+    m_store.remove(it->second.stored);
+    m_index.erase(it);
+    m_entities.erase(m_entities.begin() + static_cast<std::ptrdiff_t>(slot));
+    reindexFrom(slot);
+}
+
+void DraftDocument::removeEntities(const std::vector<uint64_t>& ids) {
+    const size_t total = m_entities.size();
+    size_t first = total;
+    std::vector<uint64_t> removed;
+    removed.reserve(ids.size());
+    for (uint64_t id : ids) {
+        auto it = m_index.find(id);
+        if (it == m_index.end()) continue;
+        first = std::min(first, it->second.slot);
+        m_entities[it->second.slot] = nullptr;
+        m_store.remove(it->second.stored);
+        m_index.erase(it);
+        removed.push_back(id);
+    }
+    if (removed.empty()) return;
+
+    m_entities.erase(std::remove(m_entities.begin() + static_cast<std::ptrdiff_t>(first),
+                                 m_entities.end(), nullptr),
+                     m_entities.end());
+    reindexFrom(first);
+
+    if (preferRebuild(removed.size(), total)) {
+        m_spatialIndex.rebuild(m_entities);
+    } else {
+        for (uint64_t id : removed) m_spatialIndex.remove(id);
+    }
+}
+
+std::shared_ptr<DraftEntity> DraftDocument::findEntity(uint64_t id) const {
+    auto it = m_index.find(id);
+    if (it == m_index.end()) return nullptr;
+    return m_entities[it->second.slot];
+}
+
+EntityHandle DraftDocument::storeHandle(uint64_t id) const {
+    auto it = m_index.find(id);
+    return it == m_index.end() ? EntityHandle{} : it->second.stored;
+}
+
+bool DraftDocument::replaceEntity(std::shared_ptr<DraftEntity> entity) {
+    if (!entity) return false;
+    auto it = m_index.find(entity->id());
+    if (it == m_index.end()) return false;
+    m_spatialIndex.update(entity);
+    it->second.stored = m_store.sync(*entity, it->second.stored);
+    m_entities[it->second.slot] = std::move(entity);
+    return true;
+}
+
+void DraftDocument::updateEntity(const std::shared_ptr<DraftEntity>& entity) {
+    if (!entity) return;
+    m_spatialIndex.update(entity);
+    syncStore(*entity);
+}
+
+void DraftDocument::updateEntities(const std::vector<std::shared_ptr<DraftEntity>>& entities) {
+    if (preferRebuild(entities.size(), m_entities.size())) {
+        m_spatialIndex.rebuild(m_entities);
+    } else {
+        for (const auto& entity : entities) {
+            if (entity) m_spatialIndex.update(entity);
+        }
+    }
+    for (const auto& entity : entities) {
+        if (entity) syncStore(*entity);
+    }
 }
 
 void DraftDocument::clear() {
     m_entities.clear();
+    m_index.clear();
     m_spatialIndex.clear();
+    m_store.clear();
     m_blockTable.clear();
     m_nextGroupId = 1;
 }
 
 void DraftDocument::rebuildSpatialIndex() {
     m_spatialIndex.rebuild(m_entities);
+    m_store.clear();
+    for (const auto& entity : m_entities) m_index[entity->id()].stored = m_store.sync(*entity);
+}
+
+void DraftDocument::syncStore(const DraftEntity& entity) {
+    auto it = m_index.find(entity.id());
+    if (it != m_index.end()) it->second.stored = m_store.sync(entity, it->second.stored);
+}
+
+void DraftDocument::reindexFrom(size_t first) {
+    for (size_t i = first; i < m_entities.size(); ++i) {
+        m_index[m_entities[i]->id()].slot = i;
+    }
 }
 
 }  // namespace hz::draft
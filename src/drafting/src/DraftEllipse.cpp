@@ -54,6 +54,28 @@ std::vector<math::Vec2> DraftEllipse::evaluate(int segments) const {
     return pts;
 }
 
+/// Default chordal tolerance as a fraction of the larger semi-axis.
+static constexpr double kRelativeTolerance = 1e-3;
+
+std::shared_ptr<const CurveFlattening> DraftEllipse::flatten(double tolerance) const {
+    return m_cache.flattening(version(), tolerance, [this](double tol) {
+        // |C''(t)| <= a for C(t) = (a cos t, b sin t) rotated, so a chord over a
+        // parameter step h deviates by at most a h^2 / 8.
+        const double a = std::max(std::abs(m_semiMajor), std::abs(m_semiMinor));
+        const double step = a > 0.0 ? std::sqrt(8.0 * tol / a) : math::kTwoPi;
+        return evaluate(std::clamp(static_cast<int>(std::ceil(math::kTwoPi / step)), 8, 65536));
+    });
+}
+
+std::shared_ptr<const CurveFlattening> DraftEllipse::flattened() const {
+    return flatten(defaultTolerance());
+}
+
+double DraftEllipse::defaultTolerance() const {
+    const double a = std::max(std::abs(m_semiMajor), std::abs(m_semiMinor));
+    return a > 0.0 ? kRelativeTolerance * a : 1e-9;
+}
+
 // ---------------------------------------------------------------------------
 // DraftEntity overrides
 // ---------------------------------------------------------------------------
@@ -112,12 +134,13 @@ std::vector<math::Vec2> DraftEllipse::snapPoints() const {
 }
 
 void DraftEllipse::translate(const math::Vec2& delta) {
+    markModified();
     m_center += delta;
 }
 
 std::shared_ptr<DraftEntity> DraftEllipse::clone() const {
     auto copy = std::make_shared<DraftEllipse>(m_center, m_semiMajor, m_semiMinor, m_rotation);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -126,6 +149,7 @@ std::shared_ptr<DraftEntity> DraftEllipse::clone() const {
 }
 
 void DraftEllipse::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_center = mirrorPoint(m_center, axisP1, axisP2);
     // Mirror flips the rotation: reflect across the axis.
     double axisAngle = std::atan2(axisP2.y - axisP1.y, axisP2.x - axisP1.x);
@@ -133,11 +157,13 @@ void DraftEllipse::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
 }
 
 void DraftEllipse::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_center = rotatePoint(m_center, center, angle);
     m_rotation += angle;
 }
 
 void DraftEllipse::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_center = scalePoint(m_center, center, factor);
     m_semiMajor *= std::abs(factor);
     m_semiMinor *= std::abs(factor);
@@ -3,10 +3,12 @@
 namespace hz::draft {
 
 uint64_t DraftEntity::s_nextId = 1;
+std::atomic<uint64_t> DraftEntity::s_nextVersion{1};
 
 DraftEntity::DraftEntity()
     : m_id(s_nextId++),
-      m_layer("0"),
+      m_version(s_nextVersion.fetch_add(1, std::memory_order_relaxed)),
+      m_layer(kDefaultLayerId),
       m_color(0x00000000),
       m_lineWidth(0.0),
       m_lineType(0),
@@ -2,12 +2,41 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#include "horizon/drafting/PrimitiveGeometry.h"
+#include "horizon/math/Constants.h"
 
 namespace hz::draft {
 
+namespace {
+
+/// Scan lines beyond this count are not generated (the hatch is left unfilled).
+constexpr int kMaxScanLines = 2000;
+
+/// A boundary edge in the scan frame: u runs across the scan lines, v along them.
+/// The edge covers u in [uMin, uMax) and v = v0 + slope * (u - uMin).
+struct ScanEdge {
+    double uMin, uMax;
+    double v0, slope;
+};
+
+void hashCombine(uint64_t& seed, uint64_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2);
+}
+
+void hashDouble(uint64_t& seed, double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof bits);
+    hashCombine(seed, bits);
+}
+
+}  // namespace
+
 DraftHatch::DraftHatch(const std::vector<math::Vec2>& boundary, HatchPattern pattern, double angle,
-                       double spacing)
+                       double spacing, const std::vector<std::vector<math::Vec2>>& holes)
     : m_boundary(boundary),
+      m_holes(holes),
       m_pattern(pattern),
       m_angle(angle),
       m_spacing(std::max(spacing, 0.01)) {}
@@ -17,65 +46,53 @@ DraftHatch::DraftHatch(const std::vector<math::Vec2>& boundary, HatchPattern pat
 // ---------------------------------------------------------------------------
 
 math::BoundingBox DraftHatch::boundingBox() const {
-    if (m_boundary.empty()) return {};
-
-    double minX = m_boundary[0].x, maxX = m_boundary[0].x;
-    double minY = m_boundary[0].y, maxY = m_boundary[0].y;
-    for (size_t i = 1; i < m_boundary.size(); ++i) {
-        minX = std::min(minX, m_boundary[i].x);
-        minY = std::min(minY, m_boundary[i].y);
-        maxX = std::max(maxX, m_boundary[i].x);
-        maxY = std::max(maxY, m_boundary[i].y);
-    }
-    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+    return pointsBoundingBox(m_boundary);
 }
 
 bool DraftHatch::hitTest(const math::Vec2& point, double tolerance) const {
     if (m_boundary.size() < 3) return false;
 
-    // Hit if inside polygon.
-    if (pointInPolygon(point)) return true;
-
-    // Hit if near any boundary edge.
-    auto segmentDist = [](const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) -> double {
-        math::Vec2 ab = b - a;
-        math::Vec2 ap = p - a;
-        double lenSq = ab.lengthSquared();
-        if (lenSq < 1e-14) return p.distanceTo(a);
-        double t = std::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
-        math::Vec2 closest = a + ab * t;
-        return p.distanceTo(closest);
-    };
+    // Hit if inside the hatched area.
+    if (contains(point)) return true;
 
-    for (size_t i = 0; i < m_boundary.size(); ++i) {
-        size_t j = (i + 1) % m_boundary.size();
-        if (segmentDist(point, m_boundary[i], m_boundary[j]) <= tolerance) return true;
+    // Hit if near any boundary or hole edge.
+    if (polylineHitTest(m_boundary, true, point, tolerance)) return true;
+    for (const auto& hole : m_holes) {
+        if (polylineHitTest(hole, true, point, tolerance)) return true;
     }
     return false;
 }
 
 std::vector<math::Vec2> DraftHatch::snapPoints() const {
     std::vector<math::Vec2> result;
-    result.reserve(m_boundary.size() * 2);
-    for (const auto& pt : m_boundary) {
-        result.push_back(pt);
-    }
-    for (size_t i = 0; i < m_boundary.size(); ++i) {
-        size_t j = (i + 1) % m_boundary.size();
-        result.push_back((m_boundary[i] + m_boundary[j]) * 0.5);
-    }
+    auto addLoop = [&result](const std::vector<math::Vec2>& loop) {
+        for (const auto& pt : loop) {
+            result.push_back(pt);
+        }
+        for (size_t i = 0; i < loop.size(); ++i) {
+            size_t j = (i + 1) % loop.size();
+            result.push_back((loop[i] + loop[j]) * 0.5);
+        }
+    };
+    addLoop(m_boundary);
+    for (const auto& hole : m_holes) addLoop(hole);
     return result;
 }
 
 void DraftHatch::translate(const math::Vec2& delta) {
+    markModified();
     for (auto& pt : m_boundary) {
         pt += delta;
     }
+    for (auto& hole : m_holes) {
+        for (auto& pt : hole) pt += delta;
+    }
 }
 
 std::shared_ptr<DraftEntity> DraftHatch::clone() const {
-    auto copy = std::make_shared<DraftHatch>(m_boundary, m_pattern, m_angle, m_spacing);
-    copy->setLayer(layer());
+    auto copy = std::make_shared<DraftHatch>(m_boundary, m_pattern, m_angle, m_spacing, m_holes);
+    copy->m_fill = m_fill;
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -91,9 +108,13 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 }
 
 void DraftHatch::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     for (auto& pt : m_boundary) {
         pt = mirrorPoint(pt, axisP1, axisP2);
     }
+    for (auto& hole : m_holes) {
+        for (auto& pt : hole) pt = mirrorPoint(pt, axisP1, axisP2);
+    }
     double axisAngle = std::atan2((axisP2 - axisP1).y, (axisP2 - axisP1).x);
     m_angle = 2.0 * axisAngle - m_angle;
 }
@@ -109,16 +130,24 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftHatch::rotate(const math::Vec2& center, double angle) {
+    markModified();
     for (auto& pt : m_boundary) {
         pt = rotatePoint(pt, center, angle);
     }
+    for (auto& hole : m_holes) {
+        for (auto& pt : hole) pt = rotatePoint(pt, center, angle);
+    }
     m_angle += angle;
 }
 
 void DraftHatch::scale(const math::Vec2& center, double factor) {
+    markModified();
     for (auto& pt : m_boundary) {
         pt = scalePoint(pt, center, factor);
     }
+    for (auto& hole : m_holes) {
+        for (auto& pt : hole) pt = scalePoint(pt, center, factor);
+    }
     m_spacing *= std::abs(factor);
 }
 
@@ -126,114 +155,136 @@ void DraftHatch::scale(const math::Vec2& center, double factor) {
 // Hatch line generation
 // ---------------------------------------------------------------------------
 
-bool DraftHatch::pointInPolygon(const math::Vec2& point) const {
-    // Ray-casting algorithm.
+bool DraftHatch::contains(const math::Vec2& point) const {
+    if (m_boundary.size() < 3) return false;
+
+    // Ray casting, toggling across the edges of every loop (even-odd rule).
     bool inside = false;
-    size_t n = m_boundary.size();
-    for (size_t i = 0, j = n - 1; i < n; j = i++) {
-        double yi = m_boundary[i].y, yj = m_boundary[j].y;
-        double xi = m_boundary[i].x, xj = m_boundary[j].x;
-        if (((yi > point.y) != (yj > point.y)) &&
-            (point.x < (xj - xi) * (point.y - yi) / (yj - yi) + xi)) {
-            inside = !inside;
+    auto crossLoop = [&](const std::vector<math::Vec2>& loop) {
+        size_t n = loop.size();
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            double yi = loop[i].y, yj = loop[j].y;
+            double xi = loop[i].x, xj = loop[j].x;
+            if (((yi > point.y) != (yj > point.y)) &&
+                (point.x < (xj - xi) * (point.y - yi) / (yj - yi) + xi)) {
+                inside = !inside;
+            }
         }
+    };
+    crossLoop(m_boundary);
+    for (const auto& hole : m_holes) {
+        if (hole.size() >= 3) crossLoop(hole);
     }
     return inside;
 }
 
-std::vector<std::pair<math::Vec2, math::Vec2>> DraftHatch::scanLines(double scanAngle,
-                                                                     double scanSpacing) const {
+DraftHatch::Segments DraftHatch::scanLines(double scanAngle, double scanSpacing) const {
     if (m_boundary.size() < 3 || scanSpacing < 0.001) return {};
 
     // Direction along the hatch lines and perpendicular (scan direction).
-    math::Vec2 dir = {std::cos(scanAngle), std::sin(scanAngle)};
-    math::Vec2 perp = {-dir.y, dir.x};
+    const math::Vec2 dir = {std::cos(scanAngle), std::sin(scanAngle)};
+    const math::Vec2 perp = {-dir.y, dir.x};
 
-    // Project all boundary points onto the perpendicular to find scan range.
+    // Edge table: every non-degenerate edge of every loop, in scan coordinates, sorted
+    // by the first scan line that can cross it.
+    std::vector<ScanEdge> edges;
     double minProj = perp.dot(m_boundary[0]);
     double maxProj = minProj;
-    for (size_t i = 1; i < m_boundary.size(); ++i) {
-        double proj = perp.dot(m_boundary[i]);
-        minProj = std::min(minProj, proj);
-        maxProj = std::max(maxProj, proj);
-    }
-
-    // Also find extent along the direction for scan line length.
-    double minDir = dir.dot(m_boundary[0]);
-    double maxDir = minDir;
-    for (size_t i = 1; i < m_boundary.size(); ++i) {
-        double d = dir.dot(m_boundary[i]);
-        minDir = std::min(minDir, d);
-        maxDir = std::max(maxDir, d);
-    }
+    auto addLoop = [&](const std::vector<math::Vec2>& loop) {
+        if (loop.size() < 3) return;
+        for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++) {
+            double ua = perp.dot(loop[j]), va = dir.dot(loop[j]);
+            double ub = perp.dot(loop[i]), vb = dir.dot(loop[i]);
+            minProj = std::min(minProj, ub);
+            maxProj = std::max(maxProj, ub);
+            if (std::abs(ub - ua) < 1e-14) continue;  // Parallel to the scan lines.
+            if (ua > ub) {
+                std::swap(ua, ub);
+                std::swap(va, vb);
+            }
+            edges.push_back({ua, ub, va, (vb - va) / (ub - ua)});
+        }
+    };
+    addLoop(m_boundary);
+    for (const auto& hole : m_holes) addLoop(hole);
 
     // Limit number of scan lines to prevent performance issues.
-    double range = maxProj - minProj;
-    int maxLines = 2000;
-    if (range / scanSpacing > maxLines) return {};
-
-    std::vector<std::pair<math::Vec2, math::Vec2>> result;
-    size_t n = m_boundary.size();
-
+    if ((maxProj - minProj) / scanSpacing > kMaxScanLines) return {};
+
+    std::sort(edges.begin(), edges.end(),
+              [](const ScanEdge& a, const ScanEdge& b) { return a.uMin < b.uMin; });
+
+    // Sweep the scan lines upward, keeping the active edge table: edges enter when the
+    // sweep reaches uMin and leave at uMax.  Half-open spans count a vertex shared by
+    // two edges once, so lines through vertices still pair up correctly.
+    Segments result;
+    std::vector<size_t> active;
+    std::vector<double> crossings;
+    size_t nextEdge = 0;
     for (double offset = minProj + scanSpacing * 0.5; offset < maxProj; offset += scanSpacing) {
-        // Origin of the scan line: a point at distance 'offset' along perp.
-        // The scan line runs in direction 'dir'.
-        // lineP = perp * offset (relative to origin)
-        // Points on line: lineP + t * dir
-
-        // Find intersections of this scan line with all boundary edges.
-        std::vector<double> intersections;
-        for (size_t i = 0; i < n; ++i) {
-            size_t j = (i + 1) % n;
-            const auto& a = m_boundary[i];
-            const auto& b = m_boundary[j];
-
-            // Projection of edge endpoints onto perp.
-            double pa = perp.dot(a);
-            double pb = perp.dot(b);
-
-            // Check if scan line crosses this edge.
-            if ((pa - offset) * (pb - offset) > 0.0) continue;  // both on same side
-            if (std::abs(pb - pa) < 1e-14) continue;            // edge parallel to scan line
-
-            // Parameter along edge where intersection occurs.
-            double t = (offset - pa) / (pb - pa);
-            // Intersection point projected onto dir.
-            math::Vec2 pt = a + (b - a) * t;
-            double d = dir.dot(pt);
-            intersections.push_back(d);
+        while (nextEdge < edges.size() && edges[nextEdge].uMin <= offset) {
+            active.push_back(nextEdge++);
         }
+        std::erase_if(active, [&](size_t e) { return edges[e].uMax <= offset; });
 
-        // Sort intersections and pair them up.
-        std::sort(intersections.begin(), intersections.end());
-        for (size_t k = 0; k + 1 < intersections.size(); k += 2) {
-            math::Vec2 p1 = perp * offset + dir * intersections[k];
-            math::Vec2 p2 = perp * offset + dir * intersections[k + 1];
-            result.emplace_back(p1, p2);
+        crossings.clear();
+        for (size_t e : active) {
+            const auto& edge = edges[e];
+            crossings.push_back(edge.v0 + edge.slope * (offset - edge.uMin));
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+            result.emplace_back(perp * offset + dir * crossings[k],
+                                perp * offset + dir * crossings[k + 1]);
         }
     }
 
     return result;
 }
 
-std::vector<std::pair<math::Vec2, math::Vec2>> DraftHatch::generateHatchLines() const {
-    if (m_boundary.size() < 3) return {};
+uint64_t DraftHatch::fillKey() const {
+    uint64_t key = static_cast<uint64_t>(m_pattern);
+    hashDouble(key, m_angle);
+    hashDouble(key, m_spacing);
+    auto hashLoop = [&key](const std::vector<math::Vec2>& loop) {
+        hashCombine(key, loop.size());
+        for (const auto& pt : loop) {
+            hashDouble(key, pt.x);
+            hashDouble(key, pt.y);
+        }
+    };
+    hashLoop(m_boundary);
+    for (const auto& hole : m_holes) hashLoop(hole);
+    return key;
+}
 
-    double effectiveSpacing = m_spacing;
-    if (m_pattern == HatchPattern::Solid) {
-        // Dense lines for solid fill.
-        effectiveSpacing = std::max(m_spacing * 0.1, 0.05);
-    }
+const DraftHatch::Segments& DraftHatch::generateHatchLines() const {
+    // Unchanged since the last call: no need to even rehash the inputs.
+    if (m_fill && m_fillVersion == version()) return m_fill->lines;
+
+    const uint64_t key = fillKey();
+    m_fillVersion = version();
+    if (m_fill && m_fill->key == key) return m_fill->lines;
+
+    auto fill = std::make_shared<FillCache>();
+    fill->key = key;
+    if (m_boundary.size() >= 3) {
+        double effectiveSpacing = m_spacing;
+        if (m_pattern == HatchPattern::Solid) {
+            // Dense lines for solid fill.
+            effectiveSpacing = std::max(m_spacing * 0.1, 0.05);
+        }
 
-    auto lines = scanLines(m_angle, effectiveSpacing);
+        fill->lines = scanLines(m_angle, effectiveSpacing);
 
-    if (m_pattern == HatchPattern::CrossHatch) {
-        // Add perpendicular set.
-        auto cross = scanLines(m_angle + 3.14159265358979323846 * 0.5, effectiveSpacing);
-        lines.insert(lines.end(), cross.begin(), cross.end());
+        if (m_pattern == HatchPattern::CrossHatch) {
+            // Add perpendicular set.
+            auto cross = scanLines(m_angle + math::kHalfPi, effectiveSpacing);
+            fill->lines.insert(fill->lines.end(), cross.begin(), cross.end());
+        }
     }
-
-    return lines;
+    m_fill = std::move(fill);
+    return m_fill->lines;
 }
 
 }  // namespace hz::draft
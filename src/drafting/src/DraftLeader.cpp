@@ -103,12 +103,13 @@ std::vector<math::Vec2> DraftLeader::snapPoints() const {
 }
 
 void DraftLeader::translate(const math::Vec2& delta) {
+    markModified();
     for (auto& p : m_points) p += delta;
 }
 
 std::shared_ptr<DraftEntity> DraftLeader::clone() const {
     auto copy = std::make_shared<DraftLeader>(m_points, m_text);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -118,14 +119,17 @@ std::shared_ptr<DraftEntity> DraftLeader::clone() const {
 }
 
 void DraftLeader::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     for (auto& p : m_points) p = mirrorPoint(p, axisP1, axisP2);
 }
 
 void DraftLeader::rotate(const math::Vec2& center, double angle) {
+    markModified();
     for (auto& p : m_points) p = rotatePoint(p, center, angle);
 }
 
 void DraftLeader::scale(const math::Vec2& center, double factor) {
+    markModified();
     for (auto& p : m_points) p = scalePoint(p, center, factor);
 }
 
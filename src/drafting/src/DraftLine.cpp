@@ -3,33 +3,18 @@
 #include <algorithm>
 #include <cmath>
 
-#include "horizon/math/MathUtils.h"
+#include "horizon/drafting/PrimitiveGeometry.h"
 
 namespace hz::draft {
 
 DraftLine::DraftLine(const math::Vec2& start, const math::Vec2& end) : m_start(start), m_end(end) {}
 
 math::BoundingBox DraftLine::boundingBox() const {
-    math::Vec3 lo(std::min(m_start.x, m_end.x), std::min(m_start.y, m_end.y), 0.0);
-    math::Vec3 hi(std::max(m_start.x, m_end.x), std::max(m_start.y, m_end.y), 0.0);
-    return math::BoundingBox(lo, hi);
+    return segmentBoundingBox(m_start, m_end);
 }
 
 bool DraftLine::hitTest(const math::Vec2& point, double tolerance) const {
-    // Distance from point to line segment [m_start, m_end]
-    math::Vec2 ab = m_end - m_start;
-    math::Vec2 ap = point - m_start;
-
-    double lenSq = ab.lengthSquared();
-    if (lenSq < 1e-14) {
-        // Degenerate line (start == end)
-        return point.distanceTo(m_start) <= tolerance;
-    }
-
-    // Parameter t clamped to [0,1] for segment projection
-    double t = math::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
-    math::Vec2 closest = m_start + ab * t;
-    return point.distanceTo(closest) <= tolerance;
+    return segmentDistance(point, m_start, m_end) <= tolerance;
 }
 
 std::vector<math::Vec2> DraftLine::snapPoints() const {
@@ -37,6 +22,7 @@ std::vector<math::Vec2> DraftLine::snapPoints() const {
 }
 
 void DraftLine::translate(const math::Vec2& delta) {
+    markModified();
     m_start += delta;
     m_end += delta;
 }
@@ -50,7 +36,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 
 std::shared_ptr<DraftEntity> DraftLine::clone() const {
     auto copy = std::make_shared<DraftLine>(m_start, m_end);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -59,6 +45,7 @@ std::shared_ptr<DraftEntity> DraftLine::clone() const {
 }
 
 void DraftLine::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_start = mirrorPoint(m_start, axisP1, axisP2);
     m_end = mirrorPoint(m_end, axisP1, axisP2);
 }
@@ -74,11 +61,13 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftLine::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_start = rotatePoint(m_start, center, angle);
     m_end = rotatePoint(m_end, center, angle);
 }
 
 void DraftLine::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_start = scalePoint(m_start, center, factor);
     m_end = scalePoint(m_end, center, factor);
 }
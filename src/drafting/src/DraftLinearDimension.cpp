@@ -171,6 +171,7 @@ std::vector<math::Vec2> DraftLinearDimension::snapPoints() const {
 }
 
 void DraftLinearDimension::translate(const math::Vec2& delta) {
+    markModified();
     m_defPoint1 += delta;
     m_defPoint2 += delta;
     m_dimLinePoint += delta;
@@ -179,7 +180,7 @@ void DraftLinearDimension::translate(const math::Vec2& delta) {
 std::shared_ptr<DraftEntity> DraftLinearDimension::clone() const {
     auto copy = std::make_shared<DraftLinearDimension>(m_defPoint1, m_defPoint2, m_dimLinePoint,
                                                        m_orientation);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -189,18 +190,21 @@ std::shared_ptr<DraftEntity> DraftLinearDimension::clone() const {
 }
 
 void DraftLinearDimension::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_defPoint1 = mirrorPoint(m_defPoint1, axisP1, axisP2);
     m_defPoint2 = mirrorPoint(m_defPoint2, axisP1, axisP2);
     m_dimLinePoint = mirrorPoint(m_dimLinePoint, axisP1, axisP2);
 }
 
 void DraftLinearDimension::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_defPoint1 = rotatePoint(m_defPoint1, center, angle);
     m_defPoint2 = rotatePoint(m_defPoint2, center, angle);
     m_dimLinePoint = rotatePoint(m_dimLinePoint, center, angle);
 }
 
 void DraftLinearDimension::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_defPoint1 = scalePoint(m_defPoint1, center, factor);
     m_defPoint2 = scalePoint(m_defPoint2, center, factor);
     m_dimLinePoint = scalePoint(m_dimLinePoint, center, factor);
@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <cmath>
 
-#include "horizon/math/MathUtils.h"
+#include "horizon/drafting/PrimitiveGeometry.h"
 
 namespace hz::draft {
 
@@ -11,43 +11,16 @@ DraftPolyline::DraftPolyline(const std::vector<math::Vec2>& points, bool closed)
     : m_points(points), m_closed(closed) {}
 
 void DraftPolyline::addPoint(const math::Vec2& point) {
+    markModified();
     m_points.push_back(point);
 }
 
 math::BoundingBox DraftPolyline::boundingBox() const {
-    if (m_points.empty()) return {};
-
-    double minX = m_points[0].x, maxX = m_points[0].x;
-    double minY = m_points[0].y, maxY = m_points[0].y;
-    for (size_t i = 1; i < m_points.size(); ++i) {
-        minX = std::min(minX, m_points[i].x);
-        minY = std::min(minY, m_points[i].y);
-        maxX = std::max(maxX, m_points[i].x);
-        maxY = std::max(maxY, m_points[i].y);
-    }
-    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+    return pointsBoundingBox(m_points);
 }
 
 bool DraftPolyline::hitTest(const math::Vec2& point, double tolerance) const {
-    if (m_points.size() < 2) return false;
-
-    auto segmentDist = [](const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) -> double {
-        math::Vec2 ab = b - a;
-        math::Vec2 ap = p - a;
-        double lenSq = ab.lengthSquared();
-        if (lenSq < 1e-14) return p.distanceTo(a);
-        double t = math::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
-        math::Vec2 closest = a + ab * t;
-        return p.distanceTo(closest);
-    };
-
-    for (size_t i = 0; i + 1 < m_points.size(); ++i) {
-        if (segmentDist(point, m_points[i], m_points[i + 1]) <= tolerance) return true;
-    }
-    if (m_closed && m_points.size() >= 2) {
-        if (segmentDist(point, m_points.back(), m_points[0]) <= tolerance) return true;
-    }
-    return false;
+    return polylineHitTest(m_points, m_closed, point, tolerance);
 }
 
 std::vector<math::Vec2> DraftPolyline::snapPoints() const {
@@ -69,6 +42,7 @@ std::vector<math::Vec2> DraftPolyline::snapPoints() const {
 }
 
 void DraftPolyline::translate(const math::Vec2& delta) {
+    markModified();
     for (auto& pt : m_points) {
         pt += delta;
     }
@@ -83,7 +57,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 
 std::shared_ptr<DraftEntity> DraftPolyline::clone() const {
     auto copy = std::make_shared<DraftPolyline>(m_points, m_closed);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -92,6 +66,7 @@ std::shared_ptr<DraftEntity> DraftPolyline::clone() const {
 }
 
 void DraftPolyline::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     for (auto& pt : m_points) {
         pt = mirrorPoint(pt, axisP1, axisP2);
     }
@@ -108,12 +83,14 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftPolyline::rotate(const math::Vec2& center, double angle) {
+    markModified();
     for (auto& pt : m_points) {
         pt = rotatePoint(pt, center, angle);
     }
 }
 
 void DraftPolyline::scale(const math::Vec2& center, double factor) {
+    markModified();
     for (auto& pt : m_points) {
         pt = scalePoint(pt, center, factor);
     }
@@ -141,6 +141,7 @@ std::vector<math::Vec2> DraftRadialDimension::snapPoints() const {
 }
 
 void DraftRadialDimension::translate(const math::Vec2& delta) {
+    markModified();
     m_center += delta;
     m_textPoint += delta;
 }
@@ -148,7 +149,7 @@ void DraftRadialDimension::translate(const math::Vec2& delta) {
 std::shared_ptr<DraftEntity> DraftRadialDimension::clone() const {
     auto copy =
         std::make_shared<DraftRadialDimension>(m_center, m_radius, m_textPoint, m_isDiameter);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -158,16 +159,19 @@ std::shared_ptr<DraftEntity> DraftRadialDimension::clone() const {
 }
 
 void DraftRadialDimension::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_center = mirrorPoint(m_center, axisP1, axisP2);
     m_textPoint = mirrorPoint(m_textPoint, axisP1, axisP2);
 }
 
 void DraftRadialDimension::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_center = rotatePoint(m_center, center, angle);
     m_textPoint = rotatePoint(m_textPoint, center, angle);
 }
 
 void DraftRadialDimension::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_center = scalePoint(m_center, center, factor);
     m_textPoint = scalePoint(m_textPoint, center, factor);
     m_radius *= std::abs(factor);
@@ -62,6 +62,7 @@ std::vector<math::Vec2> DraftRectangle::snapPoints() const {
 }
 
 void DraftRectangle::translate(const math::Vec2& delta) {
+    markModified();
     m_corner1 += delta;
     m_corner2 += delta;
 }
@@ -75,7 +76,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 
 std::shared_ptr<DraftEntity> DraftRectangle::clone() const {
     auto copy = std::make_shared<DraftRectangle>(m_corner1, m_corner2);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -84,6 +85,7 @@ std::shared_ptr<DraftEntity> DraftRectangle::clone() const {
 }
 
 void DraftRectangle::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_corner1 = mirrorPoint(m_corner1, axisP1, axisP2);
     m_corner2 = mirrorPoint(m_corner2, axisP1, axisP2);
 }
@@ -99,11 +101,13 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftRectangle::rotate(const math::Vec2& center, double angle) {
+    markModified();
     m_corner1 = rotatePoint(m_corner1, center, angle);
     m_corner2 = rotatePoint(m_corner2, center, angle);
 }
 
 void DraftRectangle::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_corner1 = scalePoint(m_corner1, center, factor);
     m_corner2 = scalePoint(m_corner2, center, factor);
 }
@@ -15,11 +15,13 @@ void DraftSpline::syncWeights() {
 }
 
 void DraftSpline::setControlPoints(const std::vector<math::Vec2>& points) {
+    markModified();
     m_controlPoints = points;
     syncWeights();
 }
 
 void DraftSpline::setWeights(const std::vector<double>& weights) {
+    markModified();
     m_weights = weights;
     // Ensure same size as control points; pad or truncate as needed.
     m_weights.resize(m_controlPoints.size(), 1.0);
@@ -145,42 +147,168 @@ std::vector<math::Vec2> DraftSpline::evaluate(int segmentsPerSpan) const {
 }
 
 // ---------------------------------------------------------------------------
-// DraftEntity virtuals
+// Adaptive, cached flattening
 // ---------------------------------------------------------------------------
 
-math::BoundingBox DraftSpline::boundingBox() const {
-    auto pts = evaluate();
-    if (pts.empty()) return {};
+/// Default chordal tolerance as a fraction of the mean control-polygon leg.
+static constexpr double kRelativeTolerance = 1e-3;
+static constexpr int kMaxSegmentsPerSpan = 4096;
+static constexpr int kMaxRationalDepth = 12;
+
+static double segmentDist(const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) {
+    math::Vec2 ab = b - a;
+    double lenSq = ab.lengthSquared();
+    if (lenSq < 1e-14) return p.distanceTo(a);
+    double t = std::clamp((p - a).dot(ab) / lenSq, 0.0, 1.0);
+    return p.distanceTo(a + ab * t);
+}
 
-    double minX = pts[0].x, maxX = pts[0].x;
-    double minY = pts[0].y, maxY = pts[0].y;
-    for (size_t i = 1; i < pts.size(); ++i) {
-        minX = std::min(minX, pts[i].x);
-        minY = std::min(minY, pts[i].y);
-        maxX = std::max(maxX, pts[i].x);
-        maxY = std::max(maxY, pts[i].y);
+/// Append the points after `p0` of a rational span piece [t0, t1], halving the piece
+/// while its midpoint or quarter points stray more than `tol` from the chord.
+template <typename Eval>
+static void subdivideRational(const Eval& at, double t0, const math::Vec2& p0, double t1,
+                              const math::Vec2& p1, double tol, int depth,
+                              std::vector<math::Vec2>& out) {
+    const double tm = 0.5 * (t0 + t1);
+    const math::Vec2 pm = at(tm);
+    if (depth < kMaxRationalDepth &&
+        (segmentDist(pm, p0, p1) > tol || segmentDist(at(0.5 * (t0 + tm)), p0, p1) > tol ||
+         segmentDist(at(0.5 * (tm + t1)), p0, p1) > tol)) {
+        subdivideRational(at, t0, p0, tm, pm, tol, depth + 1, out);
+        subdivideRational(at, tm, pm, t1, p1, tol, depth + 1, out);
+        return;
     }
-    return math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0));
+    out.push_back(p1);
 }
 
-bool DraftSpline::hitTest(const math::Vec2& point, double tolerance) const {
-    auto pts = evaluate();
-    if (pts.size() < 2) return false;
-
-    auto segmentDist = [](const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) -> double {
-        math::Vec2 ab = b - a;
-        math::Vec2 ap = p - a;
-        double lenSq = ab.lengthSquared();
-        if (lenSq < 1e-14) return p.distanceTo(a);
-        double t = std::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
-        math::Vec2 closest = a + ab * t;
-        return p.distanceTo(closest);
-    };
-
-    for (size_t i = 0; i + 1 < pts.size(); ++i) {
-        if (segmentDist(point, pts[i], pts[i + 1]) <= tolerance) return true;
+std::vector<math::Vec2> DraftSpline::flattenUncached(double tolerance) const {
+    const size_t n = m_controlPoints.size();
+    // Same degenerate cases as evaluate(): straight segments through the points.
+    if (n < (m_closed ? 3u : 4u)) return m_controlPoints;
+
+    auto w = [this](size_t i) -> double { return (i < m_weights.size()) ? m_weights[i] : 1.0; };
+    const bool rational = hasNonUniformWeights();
+    const size_t spans = m_closed ? n : n - 3;
+
+    std::vector<math::Vec2> pts;
+    pts.reserve(spans * 4 + 1);
+    for (size_t span = 0; span < spans; ++span) {
+        const size_t i0 = span % n, i1 = (span + 1) % n, i2 = (span + 2) % n, i3 = (span + 3) % n;
+        const auto& cp0 = m_controlPoints[i0];
+        const auto& cp1 = m_controlPoints[i1];
+        const auto& cp2 = m_controlPoints[i2];
+        const auto& cp3 = m_controlPoints[i3];
+        auto at = [&](double t) {
+            return rational ? bsplinePtRational(cp0, w(i0), cp1, w(i1), cp2, w(i2), cp3, w(i3), t)
+                            : bsplinePt(cp0, cp1, cp2, cp3, t);
+        };
+        if (span == 0) pts.push_back(at(0.0));
+
+        if (rational) {
+            subdivideRational(at, 0.0, pts.back(), 1.0, at(1.0), tolerance, 0, pts);
+            continue;
+        }
+        // The span's second derivative is linear in t, so it peaks at an end; a chord
+        // over a parameter step h then deviates by at most max|C''| h^2 / 8.
+        const double curvature =
+            std::max((cp0 - cp1 * 2.0 + cp2).length(), (cp1 - cp2 * 2.0 + cp3).length());
+        const int segments = std::clamp(
+            static_cast<int>(std::ceil(std::sqrt(curvature / (8.0 * tolerance)))), 1,
+            kMaxSegmentsPerSpan);
+        for (int j = 1; j <= segments; ++j) {
+            pts.push_back(at(static_cast<double>(j) / segments));
+        }
     }
-    return false;
+    return pts;
+}
+
+double DraftSpline::defaultTolerance() const {
+    const size_t n = m_controlPoints.size();
+    double length = 0.0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        length += m_controlPoints[i].distanceTo(m_controlPoints[i + 1]);
+    }
+    size_t legs = n > 0 ? n - 1 : 0;
+    if (m_closed && n > 1) {
+        length += m_controlPoints.back().distanceTo(m_controlPoints.front());
+        ++legs;
+    }
+    if (legs == 0 || !(length > 0.0)) return 1e-9;
+    return kRelativeTolerance * length / static_cast<double>(legs);
+}
+
+std::shared_ptr<const CurveFlattening> DraftSpline::flatten(double tolerance) const {
+    return m_cache.flattening(version(), tolerance,
+                              [this](double tol) { return flattenUncached(tol); });
+}
+
+std::shared_ptr<const CurveFlattening> DraftSpline::flattened() const {
+    return m_cache.standardFlattening(
+        version(), [this] { return defaultTolerance(); },
+        [this](double tol) { return flattenUncached(tol); });
+}
+
+math::BoundingBox DraftSpline::computeBounds() const {
+    const size_t n = m_controlPoints.size();
+    math::BoundingBox box;
+    auto add = [&box](const math::Vec2& p) { box.expand(math::Vec3(p.x, p.y, 0.0)); };
+
+    if (n < (m_closed ? 3u : 4u)) {
+        for (const auto& cp : m_controlPoints) add(cp);
+        return n == 0 ? math::BoundingBox() : box;
+    }
+    // Rational spans have no closed-form extrema; bound the standard flattening.
+    if (hasNonUniformWeights()) return flattened()->bounds();
+
+    // Each span is a cubic per axis: its extremes are at the ends or where the
+    // quadratic derivative vanishes.
+    const size_t spans = m_closed ? n : n - 3;
+    for (size_t span = 0; span < spans; ++span) {
+        const auto& p0 = m_controlPoints[span % n];
+        const auto& p1 = m_controlPoints[(span + 1) % n];
+        const auto& p2 = m_controlPoints[(span + 2) % n];
+        const auto& p3 = m_controlPoints[(span + 3) % n];
+        add(bsplinePt(p0, p1, p2, p3, 0.0));
+        add(bsplinePt(p0, p1, p2, p3, 1.0));
+
+        // Power-basis derivative coefficients: C'(t) = d0 + d1 t + d2 t^2.
+        const math::Vec2 d0 = (p2 - p0) * 0.5;
+        const math::Vec2 d1 = p0 - p1 * 2.0 + p2;
+        const math::Vec2 d2 = (p3 - p0 + (p1 - p2) * 3.0) * 0.5;
+        for (int axis = 0; axis < 2; ++axis) {
+            const double a = axis == 0 ? d2.x : d2.y;
+            const double b = axis == 0 ? d1.x : d1.y;
+            const double c = axis == 0 ? d0.x : d0.y;
+            double roots[2];
+            int count = 0;
+            if (std::abs(a) < 1e-14) {
+                if (std::abs(b) > 1e-14) roots[count++] = -c / b;
+            } else {
+                const double disc = b * b - 4.0 * a * c;
+                if (disc >= 0.0) {
+                    const double sq = std::sqrt(disc);
+                    roots[count++] = (-b - sq) / (2.0 * a);
+                    roots[count++] = (-b + sq) / (2.0 * a);
+                }
+            }
+            for (int r = 0; r < count; ++r) {
+                if (roots[r] > 0.0 && roots[r] < 1.0) add(bsplinePt(p0, p1, p2, p3, roots[r]));
+            }
+        }
+    }
+    return box;
+}
+
+// ---------------------------------------------------------------------------
+// DraftEntity virtuals
+// ---------------------------------------------------------------------------
+
+math::BoundingBox DraftSpline::boundingBox() const {
+    return m_cache.bounds(version(), [this] { return computeBounds(); });
+}
+
+bool DraftSpline::hitTest(const math::Vec2& point, double tolerance) const {
+    return flattened()->nearPoint(point, tolerance);
 }
 
 std::vector<math::Vec2> DraftSpline::snapPoints() const {
@@ -190,7 +318,8 @@ std::vector<math::Vec2> DraftSpline::snapPoints() const {
     for (const auto& cp : m_controlPoints) {
         result.push_back(cp);
     }
-    auto pts = evaluate();
+    auto flat = flattened();
+    const auto& pts = flat->points;
     if (!pts.empty()) {
         result.push_back(pts.front());
         if (pts.size() > 1) {
@@ -201,6 +330,7 @@ std::vector<math::Vec2> DraftSpline::snapPoints() const {
 }
 
 void DraftSpline::translate(const math::Vec2& delta) {
+    markModified();
     for (auto& cp : m_controlPoints) {
         cp += delta;
     }
@@ -209,7 +339,7 @@ void DraftSpline::translate(const math::Vec2& delta) {
 std::shared_ptr<DraftEntity> DraftSpline::clone() const {
     auto copy = std::make_shared<DraftSpline>(m_controlPoints, m_closed);
     copy->setWeights(m_weights);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -225,6 +355,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 }
 
 void DraftSpline::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     for (auto& cp : m_controlPoints) {
         cp = mirrorPoint(cp, axisP1, axisP2);
     }
@@ -241,12 +372,14 @@ static math::Vec2 scalePoint(const math::Vec2& p, const math::Vec2& center, doub
 }
 
 void DraftSpline::rotate(const math::Vec2& center, double angle) {
+    markModified();
     for (auto& cp : m_controlPoints) {
         cp = rotatePoint(cp, center, angle);
     }
 }
 
 void DraftSpline::scale(const math::Vec2& center, double factor) {
+    markModified();
     for (auto& cp : m_controlPoints) {
         cp = scalePoint(cp, center, factor);
     }
@@ -85,6 +85,7 @@ std::vector<math::Vec2> DraftText::snapPoints() const {
 }
 
 void DraftText::translate(const math::Vec2& delta) {
+    markModified();
     m_position += delta;
 }
 
@@ -92,7 +93,7 @@ std::shared_ptr<DraftEntity> DraftText::clone() const {
     auto copy = std::make_shared<DraftText>(m_position, m_text, m_textHeight);
     copy->setRotation(m_rotation);
     copy->setAlignment(m_alignment);
-    copy->setLayer(layer());
+    copy->setLayerId(layerId());
     copy->setColor(color());
     copy->setLineWidth(lineWidth());
     copy->setLineType(lineType());
@@ -108,6 +109,7 @@ static math::Vec2 mirrorPoint(const math::Vec2& p, const math::Vec2& axisP1,
 }
 
 void DraftText::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
+    markModified();
     m_position = mirrorPoint(m_position, axisP1, axisP2);
 
     // Reflect rotation about the axis.
@@ -123,6 +125,7 @@ void DraftText::mirror(const math::Vec2& axisP1, const math::Vec2& axisP2) {
 }
 
 void DraftText::rotate(const math::Vec2& center, double angle) {
+    markModified();
     double c = std::cos(angle), s = std::sin(angle);
     math::Vec2 v = m_position - center;
     m_position = {center.x + v.x * c - v.y * s, center.y + v.x * s + v.y * c};
@@ -130,6 +133,7 @@ void DraftText::rotate(const math::Vec2& center, double angle) {
 }
 
 void DraftText::scale(const math::Vec2& center, double factor) {
+    markModified();
     m_position = center + (m_position - center) * factor;
     m_textHeight *= std::abs(factor);
 }
@@ -0,0 +1,308 @@
+#include "horizon/drafting/EntityStore.h"
+
+#include <algorithm>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/drafting/PrimitiveGeometry.h"
+
+namespace hz::draft {
+
+namespace {
+
+/// Remove `row` from parallel columns by moving the last row into it.
+template <typename... Columns>
+void swapRemove(size_t row, Columns&... columns) {
+    ((columns[row] = std::move(columns.back()), columns.pop_back()), ...);
+}
+
+}  // namespace
+
+EntityHandle EntityStore::sync(const DraftEntity& entity, EntityHandle handle) {
+    PrimitiveKind kind;
+    if (dynamic_cast<const DraftLine*>(&entity)) {
+        kind = PrimitiveKind::Line;
+    } else if (dynamic_cast<const DraftCircle*>(&entity)) {
+        kind = PrimitiveKind::Circle;
+    } else if (dynamic_cast<const DraftArc*>(&entity)) {
+        kind = PrimitiveKind::Arc;
+    } else if (dynamic_cast<const DraftPolyline*>(&entity)) {
+        kind = PrimitiveKind::Polyline;
+    } else {
+        remove(handle);
+        return {};
+    }
+
+    // An id can change type when replaceEntity() swaps in a different entity.
+    if (contains(handle) && m_slots[handle.slot].kind != kind) remove(handle);
+    if (!contains(handle)) handle = appendRow(kind, entity.id());
+
+    const uint32_t row = m_slots[handle.slot].row;
+    switch (kind) {
+        case PrimitiveKind::Line: {
+            const auto& line = static_cast<const DraftLine&>(entity);
+            m_lines.layers[row] = entity.layerId();
+            m_lines.start[row] = line.start();
+            m_lines.end[row] = line.end();
+            break;
+        }
+        case PrimitiveKind::Circle: {
+            const auto& circle = static_cast<const DraftCircle&>(entity);
+            m_circles.layers[row] = entity.layerId();
+            m_circles.center[row] = circle.center();
+            m_circles.radius[row] = circle.radius();
+            break;
+        }
+        case PrimitiveKind::Arc: {
+            const auto& arc = static_cast<const DraftArc&>(entity);
+            m_arcs.layers[row] = entity.layerId();
+            m_arcs.center[row] = arc.center();
+            m_arcs.radius[row] = arc.radius();
+            m_arcs.startAngle[row] = arc.startAngle();
+            m_arcs.endAngle[row] = arc.endAngle();
+            break;
+        }
+        case PrimitiveKind::Polyline: {
+            const auto& polyline = static_cast<const DraftPolyline&>(entity);
+            m_polylines.layers[row] = entity.layerId();
+            m_polylines.closed[row] = polyline.closed() ? 1 : 0;
+            writePolylinePoints(row, polyline.points());
+            break;
+        }
+    }
+    return handle;
+}
+
+void EntityStore::remove(EntityHandle handle) {
+    if (!contains(handle)) return;
+    const uint32_t slot = handle.slot;
+    eraseRow(m_slots[slot].kind, m_slots[slot].row);
+    ++m_slots[slot].generation;
+    m_slots[slot].nextFree = m_freeSlot;
+    m_freeSlot = slot;
+}
+
+void EntityStore::clear() {
+    m_lines = {};
+    m_circles = {};
+    m_arcs = {};
+    m_polylines = {};
+    m_deadPoints = 0;
+    m_slots.clear();
+    m_freeSlot = EntityHandle::kNone;
+}
+
+bool EntityStore::contains(EntityHandle handle) const {
+    // Freeing a slot bumps its generation, so only handles issued while live match.
+    return handle.valid() && handle.slot < m_slots.size() &&
+           m_slots[handle.slot].generation == handle.generation;
+}
+
+uint64_t EntityStore::id(EntityHandle handle) const {
+    const Slot& s = m_slots[handle.slot];
+    switch (s.kind) {
+        case PrimitiveKind::Line: return m_lines.ids[s.row];
+        case PrimitiveKind::Circle: return m_circles.ids[s.row];
+        case PrimitiveKind::Arc: return m_arcs.ids[s.row];
+        case PrimitiveKind::Polyline: return m_polylines.ids[s.row];
+    }
+    return 0;
+}
+
+LayerId EntityStore::layer(EntityHandle handle) const {
+    const Slot& s = m_slots[handle.slot];
+    switch (s.kind) {
+        case PrimitiveKind::Line: return m_lines.layers[s.row];
+        case PrimitiveKind::Circle: return m_circles.layers[s.row];
+        case PrimitiveKind::Arc: return m_arcs.layers[s.row];
+        case PrimitiveKind::Polyline: return m_polylines.layers[s.row];
+    }
+    return kDefaultLayerId;
+}
+
+math::BoundingBox EntityStore::boundingBox(EntityHandle handle) const {
+    const Slot& s = m_slots[handle.slot];
+    const size_t r = s.row;
+    switch (s.kind) {
+        case PrimitiveKind::Line: return segmentBoundingBox(m_lines.start[r], m_lines.end[r]);
+        case PrimitiveKind::Circle:
+            return circleBoundingBox(m_circles.center[r], m_circles.radius[r]);
+        case PrimitiveKind::Arc:
+            return arcBoundingBox(m_arcs.center[r], m_arcs.radius[r], m_arcs.startAngle[r],
+                                  m_arcs.endAngle[r]);
+        case PrimitiveKind::Polyline: return pointsBoundingBox(polylinePoints(r));
+    }
+    return {};
+}
+
+bool EntityStore::hitTest(EntityHandle handle, const math::Vec2& point, double tolerance) const {
+    const Slot& s = m_slots[handle.slot];
+    const size_t r = s.row;
+    switch (s.kind) {
+        case PrimitiveKind::Line:
+            return segmentDistance(point, m_lines.start[r], m_lines.end[r]) <= tolerance;
+        case PrimitiveKind::Circle:
+            return circleHitTest(m_circles.center[r], m_circles.radius[r], point, tolerance);
+        case PrimitiveKind::Arc:
+            return arcHitTest(m_arcs.center[r], m_arcs.radius[r], m_arcs.startAngle[r],
+                              m_arcs.endAngle[r], point, tolerance);
+        case PrimitiveKind::Polyline:
+            return polylineHitTest(polylinePoints(r), m_polylines.closed[r] != 0, point,
+                                   tolerance);
+    }
+    return false;
+}
+
+math::BoundingBox EntityStore::bounds() const {
+    math::BoundingBox box;
+    if (m_lines.size() > 0) {
+        double minX = m_lines.start[0].x, minY = m_lines.start[0].y;
+        double maxX = minX, maxY = minY;
+        for (size_t i = 0; i < m_lines.size(); ++i) {
+            for (const auto& p : {m_lines.start[i], m_lines.end[i]}) {
+                minX = std::min(minX, p.x);
+                minY = std::min(minY, p.y);
+                maxX = std::max(maxX, p.x);
+                maxY = std::max(maxY, p.y);
+            }
+        }
+        box.expand(math::BoundingBox(math::Vec3(minX, minY, 0.0), math::Vec3(maxX, maxY, 0.0)));
+    }
+    for (size_t i = 0; i < m_circles.size(); ++i) {
+        box.expand(circleBoundingBox(m_circles.center[i], m_circles.radius[i]));
+    }
+    for (size_t i = 0; i < m_arcs.size(); ++i) {
+        box.expand(arcBoundingBox(m_arcs.center[i], m_arcs.radius[i], m_arcs.startAngle[i],
+                                  m_arcs.endAngle[i]));
+    }
+    for (size_t i = 0; i < m_polylines.size(); ++i) {
+        auto pb = pointsBoundingBox(polylinePoints(i));
+        if (pb.isValid()) box.expand(pb);
+    }
+    return box;
+}
+
+EntityHandle EntityStore::appendRow(PrimitiveKind kind, uint64_t id) {
+    uint32_t row = 0;
+    switch (kind) {
+        case PrimitiveKind::Line: row = static_cast<uint32_t>(m_lines.size()); break;
+        case PrimitiveKind::Circle: row = static_cast<uint32_t>(m_circles.size()); break;
+        case PrimitiveKind::Arc: row = static_cast<uint32_t>(m_arcs.size()); break;
+        case PrimitiveKind::Polyline: row = static_cast<uint32_t>(m_polylines.size()); break;
+    }
+    const uint32_t slot = allocSlot(kind, row);
+
+    // Zeroed columns; sync() writes the shape.
+    switch (kind) {
+        case PrimitiveKind::Line:
+            m_lines.ids.push_back(id);
+            m_lines.layers.push_back(kDefaultLayerId);
+            m_lines.start.emplace_back();
+            m_lines.end.emplace_back();
+            m_lines.slots.push_back(slot);
+            break;
+        case PrimitiveKind::Circle:
+            m_circles.ids.push_back(id);
+            m_circles.layers.push_back(kDefaultLayerId);
+            m_circles.center.emplace_back();
+            m_circles.radius.push_back(0.0);
+            m_circles.slots.push_back(slot);
+            break;
+        case PrimitiveKind::Arc:
+            m_arcs.ids.push_back(id);
+            m_arcs.layers.push_back(kDefaultLayerId);
+            m_arcs.center.emplace_back();
+            m_arcs.radius.push_back(0.0);
+            m_arcs.startAngle.push_back(0.0);
+            m_arcs.endAngle.push_back(0.0);
+            m_arcs.slots.push_back(slot);
+            break;
+        case PrimitiveKind::Polyline:
+            m_polylines.ids.push_back(id);
+            m_polylines.layers.push_back(kDefaultLayerId);
+            m_polylines.first.push_back(static_cast<uint32_t>(m_polylines.points.size()));
+            m_polylines.count.push_back(0);
+            m_polylines.closed.push_back(0);
+            m_polylines.slots.push_back(slot);
+            break;
+    }
+    return {slot, m_slots[slot].generation};
+}
+
+uint32_t EntityStore::allocSlot(PrimitiveKind kind, uint32_t row) {
+    uint32_t slot;
+    if (m_freeSlot != EntityHandle::kNone) {
+        slot = m_freeSlot;
+        m_freeSlot = m_slots[slot].nextFree;
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot].kind = kind;
+    m_slots[slot].row = row;
+    m_slots[slot].nextFree = EntityHandle::kNone;
+    return slot;
+}
+
+void EntityStore::eraseRow(PrimitiveKind kind, uint32_t row) {
+    const std::vector<uint32_t>* slots = nullptr;
+    switch (kind) {
+        case PrimitiveKind::Line:
+            swapRemove(row, m_lines.ids, m_lines.layers, m_lines.start, m_lines.end,
+                       m_lines.slots);
+            slots = &m_lines.slots;
+            break;
+        case PrimitiveKind::Circle:
+            swapRemove(row, m_circles.ids, m_circles.layers, m_circles.center, m_circles.radius,
+                       m_circles.slots);
+            slots = &m_circles.slots;
+            break;
+        case PrimitiveKind::Arc:
+            swapRemove(row, m_arcs.ids, m_arcs.layers, m_arcs.center, m_arcs.radius,
+                       m_arcs.startAngle, m_arcs.endAngle, m_arcs.slots);
+            slots = &m_arcs.slots;
+            break;
+        case PrimitiveKind::Polyline:
+            m_deadPoints += m_polylines.count[row];
+            swapRemove(row, m_polylines.ids, m_polylines.layers, m_polylines.first,
+                       m_polylines.count, m_polylines.closed, m_polylines.slots);
+            slots = &m_polylines.slots;
+            if (m_deadPoints > m_polylines.points.size() / 2) compactPolylinePoints();
+            break;
+    }
+    // Re-point the slot of the row that was moved into the hole.
+    if (row < slots->size()) m_slots[(*slots)[row]].row = row;
+}
+
+void EntityStore::writePolylinePoints(uint32_t row, std::span<const math::Vec2> pts) {
+    auto& t = m_polylines;
+    const auto n = static_cast<uint32_t>(pts.size());
+    if (n > t.count[row]) {
+        // Does not fit in the old run: abandon it and append a new one.
+        m_deadPoints += t.count[row];
+        t.first[row] = static_cast<uint32_t>(t.points.size());
+        t.points.insert(t.points.end(), pts.begin(), pts.end());
+    } else {
+        m_deadPoints += t.count[row] - n;
+        std::copy(pts.begin(), pts.end(), t.points.begin() + t.first[row]);
+    }
+    t.count[row] = n;
+    if (m_deadPoints > t.points.size() / 2) compactPolylinePoints();
+}
+
+void EntityStore::compactPolylinePoints() {
+    auto& t = m_polylines;
+    std::vector<math::Vec2> packed;
+    packed.reserve(t.points.size() - m_deadPoints);
+    for (size_t i = 0; i < t.size(); ++i) {
+        auto run = polylinePoints(i);
+        t.first[i] = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), run.begin(), run.end());
+    }
+    t.points = std::move(packed);
+    m_deadPoints = 0;
+}
+
+}  // namespace hz::draft
@@ -2,6 +2,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
 
 #include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftBlockRef.h"
@@ -164,20 +168,25 @@ std::vector<std::pair<math::Vec2, math::Vec2>> extractSegments(const DraftEntity
             segs.emplace_back(pts.back(), pts.front());
         }
     } else if (auto* spline = dynamic_cast<const DraftSpline*>(&entity)) {
-        auto pts = spline->evaluate();
+        auto flat = spline->flattened();
+        const auto& pts = flat->points;
         for (size_t i = 0; i + 1 < pts.size(); ++i) {
             segs.emplace_back(pts[i], pts[i + 1]);
         }
     } else if (auto* hatch = dynamic_cast<const DraftHatch*>(&entity)) {
-        const auto& boundary = hatch->boundary();
-        for (size_t i = 0; i + 1 < boundary.size(); ++i) {
-            segs.emplace_back(boundary[i], boundary[i + 1]);
-        }
-        if (boundary.size() >= 2) {
-            segs.emplace_back(boundary.back(), boundary.front());
-        }
+        auto addLoop = [&segs](const std::vector<math::Vec2>& loop) {
+            for (size_t i = 0; i + 1 < loop.size(); ++i) {
+                segs.emplace_back(loop[i], loop[i + 1]);
+            }
+            if (loop.size() >= 2) {
+                segs.emplace_back(loop.back(), loop.front());
+            }
+        };
+        addLoop(hatch->boundary());
+        for (const auto& hole : hatch->holes()) addLoop(hole);
     } else if (auto* ellipse = dynamic_cast<const DraftEllipse*>(&entity)) {
-        auto pts = ellipse->evaluate();
+        auto flat = ellipse->flattened();
+        const auto& pts = flat->points;
         for (size_t i = 0; i + 1 < pts.size(); ++i) {
             segs.emplace_back(pts[i], pts[i + 1]);
         }
@@ -252,6 +261,11 @@ static void intersectCircularVsCircular(const math::Vec2& cA, double rA, double
 }
 
 IntersectionResult intersect(const DraftEntity& a, const DraftEntity& b) {
+    return intersect(a, extractSegments(a), b, extractSegments(b));
+}
+
+IntersectionResult intersect(const DraftEntity& a, const std::vector<Segment>& segsA,
+                             const DraftEntity& b, const std::vector<Segment>& segsB) {
     IntersectionResult result;
 
     // Classify each entity.
@@ -263,9 +277,6 @@ IntersectionResult intersect(const DraftEntity& a, const DraftEntity& b) {
     bool aIsCircular = (circA || arcA);
     bool bIsCircular = (circB || arcB);
 
-    auto segsA = extractSegments(a);
-    auto segsB = extractSegments(b);
-
     // Case 1: Both have segments (line, rect, polyline vs line, rect, polyline).
     if (!segsA.empty() && !segsB.empty()) {
         intersectSegmentsVsSegments(segsA, segsB, result.points);
@@ -405,4 +416,426 @@ std::vector<math::Vec2> intersectRayEntity(const math::Vec2& rayOrigin, const ma
     return result;
 }
 
+// ---------------------------------------------------------------------------
+// Whole-drawing sweep
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/// Whether an entity is drawn by its outline alone (lines, rectangles, polylines,
+/// splines, circles, arcs, ellipses), so a copy of it lying on another adds nothing.
+/// A hatch's boundary carries its fill, and block references, text and dimensions
+/// carry more than their outline, so those are never redundant nor make others so.
+bool isPlainOutline(const DraftEntity& entity) {
+    return dynamic_cast<const DraftLine*>(&entity) ||
+           dynamic_cast<const DraftRectangle*>(&entity) ||
+           dynamic_cast<const DraftPolyline*>(&entity) ||
+           dynamic_cast<const DraftSpline*>(&entity) ||
+           dynamic_cast<const DraftCircle*>(&entity) || dynamic_cast<const DraftArc*>(&entity) ||
+           dynamic_cast<const DraftEllipse*>(&entity);
+}
+
+/// A straight segment, or an x/y-monotone piece of a circle or arc, of one entity.
+struct SweepPiece {
+    uint32_t owner = 0;  ///< Index of the entity in the input.
+    uint32_t index = 0;  ///< Ordinal of the piece within its entity.
+    bool isArc = false;
+    bool aIsEnd = true;  ///< Whether `a` / `b` are real ends of the outline (not arc splits).
+    bool bIsEnd = true;
+    math::Vec2 a;  ///< Segment ends, or the arc points at startAngle / endAngle.
+    math::Vec2 b;
+    math::Vec2 center;
+    double radius = 0.0;
+    double startAngle = 0.0;  ///< Arc pieces: start < end, both inside one quadrant.
+    double endAngle = 0.0;
+    double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+};
+
+struct SweepHit {
+    math::Vec2 point;
+    uint32_t ownerA;
+    uint32_t ownerB;
+};
+
+/// Piece `index` of entity `covered` lies entirely on a piece of entity `covering`.
+struct SweepContainment {
+    uint32_t covered;
+    uint32_t covering;
+    uint32_t index;
+};
+
+struct SweepBandOutput {
+    std::vector<SweepHit> hits;
+    std::vector<std::pair<uint32_t, uint32_t>> overlaps;
+    std::vector<SweepContainment> containments;
+};
+
+struct DisjointSets {
+    std::vector<uint32_t> parent;
+
+    explicit DisjointSets(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), 0u); }
+
+    uint32_t find(uint32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+    void unite(uint32_t a, uint32_t b) { parent[find(a)] = find(b); }
+};
+
+void addSegmentPiece(std::vector<SweepPiece>& pieces, uint32_t owner, uint32_t& index,
+                     const math::Vec2& a, const math::Vec2& b, double tol) {
+    if (a.distanceTo(b) <= tol) return;
+    SweepPiece p;
+    p.owner = owner;
+    p.index = index++;
+    p.a = a;
+    p.b = b;
+    p.minX = std::min(a.x, b.x);
+    p.maxX = std::max(a.x, b.x);
+    p.minY = std::min(a.y, b.y);
+    p.maxY = std::max(a.y, b.y);
+    pieces.push_back(p);
+}
+
+/// Split the CCW arc [start, start + sweep] at quadrant angles.  Within a quadrant an arc
+/// is monotone in x and y, so its endpoints bound it exactly.
+void addArcPieces(std::vector<SweepPiece>& pieces, uint32_t owner, uint32_t& index,
+                  const math::Vec2& center, double radius, double start, double sweep,
+                  bool closed) {
+    if (radius <= 0.0 || sweep <= 0.0) return;
+    start = math::normalizeAngle(start);
+    const double end = start + sweep;
+    double quadrant = std::floor(start / math::kHalfPi);
+    double from = start;
+    while (from < end - 1e-12) {
+        double to = std::min((quadrant + 1.0) * math::kHalfPi, end);
+        quadrant += 1.0;
+        if (to <= from + 1e-12) continue;
+
+        SweepPiece p;
+        p.owner = owner;
+        p.index = index++;
+        p.isArc = true;
+        p.aIsEnd = !closed && from == start;
+        p.bIsEnd = !closed && to == end;
+        p.center = center;
+        p.radius = radius;
+        double shift = from >= math::kTwoPi - 1e-12 ? math::kTwoPi : 0.0;
+        p.startAngle = from - shift;
+        p.endAngle = to - shift;
+        p.a = center + math::Vec2(std::cos(from), std::sin(from)) * radius;
+        p.b = center + math::Vec2(std::cos(to), std::sin(to)) * radius;
+        p.minX = std::min(p.a.x, p.b.x);
+        p.maxX = std::max(p.a.x, p.b.x);
+        p.minY = std::min(p.a.y, p.b.y);
+        p.maxY = std::max(p.a.y, p.b.y);
+        pieces.push_back(p);
+        from = to;
+    }
+}
+
+bool angleInPiece(double angle, const SweepPiece& p, double tolAngle) {
+    angle = math::normalizeAngle(angle);
+    for (double a : {angle, angle + math::kTwoPi, angle - math::kTwoPi}) {
+        if (a >= p.startAngle - tolAngle && a <= p.endAngle + tolAngle) return true;
+    }
+    return false;
+}
+
+bool isOutlineEnd(const SweepPiece& p, const math::Vec2& pt, double tol) {
+    return (p.aIsEnd && p.a.distanceTo(pt) <= tol) || (p.bIsEnd && p.b.distanceTo(pt) <= tol);
+}
+
+class PairTester {
+public:
+    PairTester(double tol, bool includeContacts, SweepBandOutput& out)
+        : m_tol(tol), m_includeContacts(includeContacts), m_out(out) {}
+
+    void test(const SweepPiece& p, const SweepPiece& q) {
+        if (!p.isArc && !q.isArc) {
+            segmentSegment(p, q);
+        } else if (p.isArc && q.isArc) {
+            arcArc(p, q);
+        } else if (p.isArc) {
+            segmentArc(q, p);
+        } else {
+            segmentArc(p, q);
+        }
+    }
+
+private:
+    void emit(const SweepPiece& p, const SweepPiece& q, const math::Vec2& pt) {
+        if (!m_includeContacts && isOutlineEnd(p, pt, m_tol) && isOutlineEnd(q, pt, m_tol)) {
+            return;
+        }
+        m_out.hits.push_back({pt, p.owner, q.owner});
+    }
+
+    void overlap(const SweepPiece& p, const SweepPiece& q, bool qInP, bool pInQ) {
+        m_out.overlaps.emplace_back(p.owner, q.owner);
+        if (qInP) m_out.containments.push_back({q.owner, p.owner, q.index});
+        if (pInQ) m_out.containments.push_back({p.owner, q.owner, p.index});
+    }
+
+    void segmentSegment(const SweepPiece& p, const SweepPiece& q) {
+        math::Vec2 d = p.b - p.a;
+        double len = d.length();
+        math::Vec2 u = d / len;
+        bool collinear = std::abs(u.cross(q.a - p.a)) <= m_tol &&
+                         std::abs(u.cross(q.b - p.a)) <= m_tol;
+        if (!collinear) {
+            for (const auto& pt : intersectLineLine(p.a, p.b, q.a, q.b)) emit(p, q, pt);
+            return;
+        }
+
+        double t1 = u.dot(q.a - p.a);
+        double t2 = u.dot(q.b - p.a);
+        double lo = std::min(t1, t2);
+        double hi = std::max(t1, t2);
+        double shared = std::min(len, hi) - std::max(0.0, lo);
+        if (shared > m_tol) {
+            overlap(p, q, lo >= -m_tol && hi <= len + m_tol, lo <= m_tol && hi >= len - m_tol);
+        } else if (shared >= -m_tol) {
+            emit(p, q, p.a + u * math::clamp(lo, 0.0, len));  // End to end.
+        }
+    }
+
+    void segmentArc(const SweepPiece& seg, const SweepPiece& arc) {
+        double tolAngle = m_tol / arc.radius;
+        for (const auto& pt : intersectLineCircle(seg.a, seg.b, arc.center, arc.radius)) {
+            double angle = std::atan2(pt.y - arc.center.y, pt.x - arc.center.x);
+            if (angleInPiece(angle, arc, tolAngle)) emit(seg, arc, pt);
+        }
+    }
+
+    void arcArc(const SweepPiece& p, const SweepPiece& q) {
+        bool coCircular = p.center.distanceTo(q.center) <= m_tol &&
+                          std::abs(p.radius - q.radius) <= m_tol;
+        if (!coCircular) {
+            for (const auto& pt : intersectCircleCircle(p.center, p.radius, q.center, q.radius)) {
+                double angleP = std::atan2(pt.y - p.center.y, pt.x - p.center.x);
+                double angleQ = std::atan2(pt.y - q.center.y, pt.x - q.center.x);
+                if (angleInPiece(angleP, p, m_tol / p.radius) &&
+                    angleInPiece(angleQ, q, m_tol / q.radius)) {
+                    emit(p, q, pt);
+                }
+            }
+            return;
+        }
+
+        // Same circle: compare angle ranges, allowing for the wrap at 2pi.
+        double tolAngle = m_tol / p.radius;
+        for (double shift : {0.0, math::kTwoPi, -math::kTwoPi}) {
+            double qs = q.startAngle + shift;
+            double qe = q.endAngle + shift;
+            double shared = std::min(p.endAngle, qe) - std::max(p.startAngle, qs);
+            if (shared > tolAngle) {
+                overlap(p, q, qs >= p.startAngle - tolAngle && qe <= p.endAngle + tolAngle,
+                        qs <= p.startAngle + tolAngle && qe >= p.endAngle - tolAngle);
+                return;
+            }
+            if (shared >= -tolAngle) {
+                double angle = std::max(p.startAngle, qs);
+                emit(p, q, p.center + math::Vec2(std::cos(angle), std::sin(angle)) * p.radius);
+                return;
+            }
+        }
+    }
+
+    double m_tol;
+    bool m_includeContacts;
+    SweepBandOutput& m_out;
+};
+
+}  // namespace
+
+SweepResult findAllIntersections(const std::vector<std::shared_ptr<DraftEntity>>& entities,
+                                 const SweepOptions& options) {
+    const double tol = options.tolerance;
+    SweepResult result;
+
+    // --- Decompose every entity into pieces. ---
+    std::vector<SweepPiece> pieces;
+    std::vector<uint32_t> pieceCount(entities.size(), 0);
+    for (uint32_t owner = 0; owner < entities.size(); ++owner) {
+        const auto& entity = entities[owner];
+        if (!entity) continue;
+        uint32_t index = 0;
+        if (auto* circle = dynamic_cast<const DraftCircle*>(entity.get())) {
+            addArcPieces(pieces, owner, index, circle->center(), circle->radius(), 0.0,
+                         math::kTwoPi, true);
+        } else if (auto* arc = dynamic_cast<const DraftArc*>(entity.get())) {
+            addArcPieces(pieces, owner, index, arc->center(), arc->radius(), arc->startAngle(),
+                         arc->sweepAngle(), false);
+        }
+        for (const auto& [a, b] : extractSegments(*entity)) {
+            addSegmentPiece(pieces, owner, index, a, b, tol);
+        }
+        pieceCount[owner] = index;
+    }
+    if (pieces.empty()) return result;
+
+    // --- Deal pieces into horizontal bands. ---
+    double minY = pieces.front().minY;
+    double maxY = pieces.front().maxY;
+    for (const auto& p : pieces) {
+        minY = std::min(minY, p.minY);
+        maxY = std::max(maxY, p.maxY);
+    }
+    size_t bandCount = std::clamp<size_t>(pieces.size() / 256, 1, 1024);
+    double bandHeight = (maxY - minY) / static_cast<double>(bandCount);
+    if (!(bandHeight > 0.0)) bandCount = 1;
+    auto bandOf = [&](double y) -> size_t {
+        if (bandCount == 1) return 0;
+        double b = std::floor((y - minY) / bandHeight);
+        return static_cast<size_t>(std::clamp(b, 0.0, static_cast<double>(bandCount - 1)));
+    };
+
+    std::vector<std::vector<uint32_t>> bands(bandCount);
+    for (uint32_t i = 0; i < pieces.size(); ++i) {
+        size_t first = bandOf(pieces[i].minY - tol);
+        size_t last = bandOf(pieces[i].maxY + tol);
+        for (size_t b = first; b <= last; ++b) bands[b].push_back(i);
+    }
+
+    // --- Sweep each band along x. ---
+    std::vector<SweepBandOutput> outputs(bandCount);
+    auto sweepBand = [&](size_t band) {
+        auto& members = bands[band];
+        std::sort(members.begin(), members.end(),
+                  [&](uint32_t l, uint32_t r) { return pieces[l].minX < pieces[r].minX; });
+        PairTester tester(tol, options.includeEndpointContacts, outputs[band]);
+        std::vector<uint32_t> active;
+        for (uint32_t m : members) {
+            const SweepPiece& p = pieces[m];
+            std::erase_if(active, [&](uint32_t i) { return pieces[i].maxX < p.minX - tol; });
+            for (uint32_t i : active) {
+                const SweepPiece& q = pieces[i];
+                if (q.owner == p.owner) continue;
+                double bottom = std::max(p.minY, q.minY);
+                if (bottom > std::min(p.maxY, q.maxY) + tol) continue;
+                if (bandOf(bottom) != band) continue;  // Tested in the band that owns it.
+                tester.test(q, p);
+            }
+            active.push_back(m);
+        }
+    };
+
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = std::clamp<unsigned>(threads, 1, static_cast<unsigned>(bandCount));
+    if (threads == 1) {
+        for (size_t b = 0; b < bandCount; ++b) sweepBand(b);
+    } else {
+        std::vector<std::future<void>> futures;
+        futures.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            futures.push_back(std::async(std::launch::async, [&, t]() {
+                for (size_t b = t; b < bandCount; b += threads) sweepBand(b);
+            }));
+        }
+        for (auto& f : futures) f.get();
+    }
+
+    // --- Merge hits closer than the tolerance into clusters. ---
+    std::vector<SweepHit> hits;
+    for (auto& out : outputs) hits.insert(hits.end(), out.hits.begin(), out.hits.end());
+    std::sort(hits.begin(), hits.end(), [](const SweepHit& l, const SweepHit& r) {
+        return l.point.x < r.point.x || (l.point.x == r.point.x && l.point.y < r.point.y);
+    });
+    DisjointSets hitSets(hits.size());
+    for (uint32_t i = 0; i < hits.size(); ++i) {
+        for (uint32_t j = i + 1; j < hits.size() && hits[j].point.x - hits[i].point.x <= tol;
+             ++j) {
+            if (hits[i].point.distanceTo(hits[j].point) <= tol) hitSets.unite(i, j);
+        }
+    }
+    std::unordered_map<uint32_t, size_t> clusterOf;
+    std::vector<size_t> clusterSize;
+    for (uint32_t i = 0; i < hits.size(); ++i) {
+        auto [it, inserted] = clusterOf.try_emplace(hitSets.find(i), result.intersections.size());
+        if (inserted) {
+            result.intersections.push_back({math::Vec2(0.0, 0.0), {}});
+            clusterSize.push_back(0);
+        }
+        auto& cluster = result.intersections[it->second];
+        cluster.point += hits[i].point;
+        cluster.entityIds.push_back(entities[hits[i].ownerA]->id());
+        cluster.entityIds.push_back(entities[hits[i].ownerB]->id());
+        ++clusterSize[it->second];
+    }
+    for (size_t c = 0; c < result.intersections.size(); ++c) {
+        auto& cluster = result.intersections[c];
+        cluster.point = cluster.point / static_cast<double>(clusterSize[c]);
+        std::sort(cluster.entityIds.begin(), cluster.entityIds.end());
+        cluster.entityIds.erase(std::unique(cluster.entityIds.begin(), cluster.entityIds.end()),
+                                cluster.entityIds.end());
+    }
+    std::sort(result.intersections.begin(), result.intersections.end(),
+              [](const IntersectionCluster& l, const IntersectionCluster& r) {
+                  return l.point.x < r.point.x || (l.point.x == r.point.x && l.point.y < r.point.y);
+              });
+
+    // --- Group overlapping entities. ---
+    DisjointSets ownerSets(entities.size());
+    std::vector<bool> overlapping(entities.size(), false);
+    for (const auto& out : outputs) {
+        for (const auto& [a, b] : out.overlaps) {
+            ownerSets.unite(a, b);
+            overlapping[a] = overlapping[b] = true;
+        }
+    }
+    std::unordered_map<uint32_t, size_t> groupOf;
+    for (uint32_t i = 0; i < entities.size(); ++i) {
+        if (!overlapping[i]) continue;
+        auto [it, inserted] = groupOf.try_emplace(ownerSets.find(i), result.overlaps.size());
+        if (inserted) result.overlaps.emplace_back();
+        result.overlaps[it->second].entityIds.push_back(entities[i]->id());
+    }
+    for (auto& group : result.overlaps) {
+        std::sort(group.entityIds.begin(), group.entityIds.end());
+    }
+    std::sort(result.overlaps.begin(), result.overlaps.end(),
+              [](const OverlapCluster& l, const OverlapCluster& r) {
+                  return l.entityIds.front() < r.entityIds.front();
+              });
+
+    // --- Entities entirely covered by another: every piece lies on one of its pieces. ---
+    std::vector<bool> plain(entities.size(), false);
+    for (uint32_t i = 0; i < entities.size(); ++i) {
+        plain[i] = entities[i] && isPlainOutline(*entities[i]);
+    }
+    std::unordered_map<uint64_t, std::vector<uint32_t>> coveredPieces;
+    for (const auto& out : outputs) {
+        for (const auto& c : out.containments) {
+            if (!plain[c.covered] || !plain[c.covering]) continue;
+            coveredPieces[(uint64_t{c.covered} << 32) | c.covering].push_back(c.index);
+        }
+    }
+    auto fullyCovers = [&](uint32_t covering, uint32_t covered) {
+        auto it = coveredPieces.find((uint64_t{covered} << 32) | covering);
+        if (it == coveredPieces.end()) return false;
+        auto& idx = it->second;
+        std::sort(idx.begin(), idx.end());
+        idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+        return idx.size() == pieceCount[covered];
+    };
+    std::vector<bool> redundant(entities.size(), false);
+    for (const auto& [key, idx] : coveredPieces) {
+        auto covered = static_cast<uint32_t>(key >> 32);
+        auto covering = static_cast<uint32_t>(key & 0xFFFFFFFFu);
+        if (redundant[covered] || !fullyCovers(covering, covered)) continue;
+        // Keep the earliest of entities that cover each other.
+        if (!fullyCovers(covered, covering) || covering < covered) redundant[covered] = true;
+    }
+    for (uint32_t i = 0; i < entities.size(); ++i) {
+        if (redundant[i]) result.redundantIds.push_back(entities[i]->id());
+    }
+    std::sort(result.redundantIds.begin(), result.redundantIds.end());
+
+    return result;
+}
+
 }  // namespace hz::draft
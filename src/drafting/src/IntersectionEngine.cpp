@@ -0,0 +1,167 @@
+#include "horizon/drafting/IntersectionEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftBlockRef.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/math/BoundingBox.h"
+
+namespace hz::draft {
+
+namespace {
+
+/// Cached entities kept before the segment cache is flushed.
+constexpr size_t kMaxCachedEntities = size_t{1} << 16;
+
+/// Padding for index queries so zero-width boxes (axis-aligned lines) still overlap.
+constexpr double kQueryPad = 1e-9;
+
+math::BoundingBox paddedBox(const math::Vec2& a, const math::Vec2& b) {
+    return math::BoundingBox(
+        math::Vec3(std::min(a.x, b.x) - kQueryPad, std::min(a.y, b.y) - kQueryPad, 0.0),
+        math::Vec3(std::max(a.x, b.x) + kQueryPad, std::max(a.y, b.y) + kQueryPad, 0.0));
+}
+
+bool accepted(const IntersectionEngine::Filter& accept, const DraftEntity& entity) {
+    return !accept || accept(entity);
+}
+
+}  // namespace
+
+const std::vector<Segment>& IntersectionEngine::segments(const DraftEntity& entity) {
+    // A block reference's outline also depends on its definition, which carries no
+    // version of its own, so it is never cached.
+    if (dynamic_cast<const DraftBlockRef*>(&entity)) {
+        m_uncached = extractSegments(entity);
+        return m_uncached;
+    }
+
+    auto it = m_segments.find(entity.id());
+    if (it != m_segments.end() && it->second.version == entity.version()) {
+        return it->second.segments;
+    }
+    if (it == m_segments.end()) {
+        if (m_segments.size() >= kMaxCachedEntities) m_segments.clear();
+        it = m_segments.try_emplace(entity.id()).first;
+    }
+    it->second.version = entity.version();
+    it->second.segments = extractSegments(entity);
+    return it->second.segments;
+}
+
+std::vector<math::Vec2> IntersectionEngine::intersections(const DraftDocument& doc,
+                                                          const DraftEntity& target,
+                                                          const Filter& accept) {
+    std::vector<math::Vec2> result;
+    math::BoundingBox box = target.boundingBox();
+    if (!box.isValid()) return result;
+
+    // Copied: segments() may hand back a shared scratch buffer for the other entity.
+    const std::vector<Segment> targetSegs = segments(target);
+
+    box = paddedBox(math::Vec2(box.min().x, box.min().y), math::Vec2(box.max().x, box.max().y));
+    doc.spatialIndex().query(box, m_candidates);
+    for (uint64_t id : m_candidates) {
+        if (id == target.id()) continue;
+        auto other = doc.findEntity(id);
+        if (!other || !accepted(accept, *other)) continue;
+        auto hits = intersect(target, targetSegs, *other, segments(*other)).points;
+        result.insert(result.end(), hits.begin(), hits.end());
+    }
+    return result;
+}
+
+std::optional<math::Vec2> IntersectionEngine::nearestRayHit(const DraftDocument& doc,
+                                                            const math::Vec2& origin,
+                                                            const math::Vec2& dir,
+                                                            uint64_t excludeId, double minDist,
+                                                            const Filter& accept) {
+    if (dir.lengthSquared() < 1e-14) return std::nullopt;
+    const math::Vec2 unit = dir.normalized();
+
+    const math::BoundingBox world = doc.spatialIndex().bounds();
+    if (!world.isValid()) return std::nullopt;
+
+    // No hit can lie further away than the farthest corner of the drawing.
+    double reach = 0.0;
+    for (double x : {world.min().x, world.max().x}) {
+        for (double y : {world.min().y, world.max().y}) {
+            reach = std::max(reach, origin.distanceTo(math::Vec2(x, y)));
+        }
+    }
+
+    // Sweep boxes over [0, len] of the ray, growing len geometrically.  A hit at distance
+    // d <= len is final: every entity the ray meets before d overlaps that swept box, and
+    // all of them have been tested.
+    std::optional<math::Vec2> best;
+    double bestDist = reach + 1.0;
+    double len = std::max(reach / 64.0, minDist * 2.0);
+    m_tested.clear();
+    while (true) {
+        len = std::min(len, reach);
+        doc.spatialIndex().query(paddedBox(origin, origin + unit * len), m_candidates);
+        for (uint64_t id : m_candidates) {
+            if (id == excludeId || !m_tested.insert(id).second) continue;
+            auto other = doc.findEntity(id);
+            if (!other || !accepted(accept, *other)) continue;
+
+            auto consider = [&](const std::vector<math::Vec2>& pts) {
+                for (const auto& pt : pts) {
+                    double d = origin.distanceTo(pt);
+                    if (d > minDist && d < bestDist) {
+                        bestDist = d;
+                        best = pt;
+                    }
+                }
+            };
+            if (auto* circle = dynamic_cast<const DraftCircle*>(other.get())) {
+                consider(intersectRayCircle(origin, unit, circle->center(), circle->radius()));
+            } else if (auto* arc = dynamic_cast<const DraftArc*>(other.get())) {
+                consider(intersectRayArc(origin, unit, arc->center(), arc->radius(),
+                                         arc->startAngle(), arc->endAngle()));
+            }
+            for (const auto& [s, e] : segments(*other)) {
+                consider(intersectRaySegment(origin, unit, s, e));
+            }
+        }
+        if (best && bestDist <= len) break;
+        if (len >= reach) break;
+        len *= 4.0;
+    }
+    return best;
+}
+
+std::vector<math::Vec2> IntersectionEngine::circleIntersections(const DraftDocument& doc,
+                                                                const math::Vec2& center,
+                                                                double radius, uint64_t excludeId,
+                                                                const Filter& accept) {
+    std::vector<math::Vec2> result;
+    math::Vec2 reach(radius, radius);
+    doc.spatialIndex().query(paddedBox(center - reach, center + reach), m_candidates);
+    for (uint64_t id : m_candidates) {
+        if (id == excludeId) continue;
+        auto other = doc.findEntity(id);
+        if (!other || !accepted(accept, *other)) continue;
+
+        for (const auto& [s, e] : segments(*other)) {
+            auto pts = intersectLineCircle(s, e, center, radius);
+            result.insert(result.end(), pts.begin(), pts.end());
+        }
+        if (auto* circle = dynamic_cast<const DraftCircle*>(other.get())) {
+            auto pts = intersectCircleCircle(center, radius, circle->center(), circle->radius());
+            result.insert(result.end(), pts.begin(), pts.end());
+        } else if (auto* arc = dynamic_cast<const DraftArc*>(other.get())) {
+            for (const auto& pt :
+                 intersectCircleCircle(center, radius, arc->center(), arc->radius())) {
+                double angle = std::atan2(pt.y - arc->center().y, pt.x - arc->center().x);
+                if (arc->containsAngle(angle)) result.push_back(pt);
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace hz::draft
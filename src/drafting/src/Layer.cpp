@@ -1,65 +1,142 @@
 #include "horizon/drafting/Layer.h"
 
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace hz::draft {
 
+// ---------------------------------------------------------------------------
+// LayerNames
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+struct NameTable {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, LayerId, NameHash, std::equal_to<>> ids;
+    std::deque<std::string> names;  // deque: references survive growth
+
+    NameTable() {
+        ids.emplace("0", kDefaultLayerId);
+        names.emplace_back("0");
+    }
+};
+
+NameTable& nameTable() {
+    static NameTable table;
+    return table;
+}
+
+}  // namespace
+
+LayerId LayerNames::intern(std::string_view name) {
+    auto& table = nameTable();
+    {
+        std::shared_lock lock(table.mutex);
+        auto it = table.ids.find(name);
+        if (it != table.ids.end()) return it->second;
+    }
+    std::unique_lock lock(table.mutex);
+    auto [it, inserted] =
+        table.ids.try_emplace(std::string(name), static_cast<LayerId>(table.names.size()));
+    if (inserted) table.names.emplace_back(name);
+    return it->second;
+}
+
+std::optional<LayerId> LayerNames::find(std::string_view name) {
+    auto& table = nameTable();
+    std::shared_lock lock(table.mutex);
+    auto it = table.ids.find(name);
+    if (it == table.ids.end()) return std::nullopt;
+    return it->second;
+}
+
+const std::string& LayerNames::name(LayerId id) {
+    auto& table = nameTable();
+    std::shared_lock lock(table.mutex);
+    return id < table.names.size() ? table.names[id] : table.names[kDefaultLayerId];
+}
+
+// ---------------------------------------------------------------------------
+// LayerManager
+// ---------------------------------------------------------------------------
+
 LayerManager::LayerManager() {
-    // Create default layer "0"
-    LayerProperties defaultLayer;
-    defaultLayer.name = "0";
-    defaultLayer.color = 0xFFFFFFFF;
-    defaultLayer.lineWidth = 1.0;
-    defaultLayer.visible = true;
-    defaultLayer.locked = false;
-    m_layers["0"] = defaultLayer;
-    m_currentLayer = "0";
+    clear();
 }
 
 void LayerManager::addLayer(const LayerProperties& props) {
-    m_layers[props.name] = props;
+    LayerId id = LayerNames::intern(props.name);
+    if (id >= m_layers.size()) m_layers.resize(id + 1);
+    if (m_layers[id]) {
+        *m_layers[id] = props;
+    } else {
+        m_layers[id] = std::make_unique<LayerProperties>(props);
+    }
 }
 
-void LayerManager::removeLayer(const std::string& name) {
+void LayerManager::removeLayer(LayerId id) {
     // Prevent removing the current layer or the default layer
-    if (name == m_currentLayer || name == "0") {
+    if (id == m_currentLayer || id == kDefaultLayerId || id >= m_layers.size()) {
         return;
     }
-    m_layers.erase(name);
+    m_layers[id].reset();
+}
+
+void LayerManager::removeLayer(const std::string& name) {
+    if (auto id = LayerNames::find(name)) removeLayer(*id);
+}
+
+std::optional<LayerId> LayerManager::renameLayer(LayerId id, const std::string& newName) {
+    if (id == kDefaultLayerId || !getLayer(id) || newName.empty()) return std::nullopt;
+    LayerId newId = LayerNames::intern(newName);
+    if (getLayer(newId)) return std::nullopt;
+
+    if (newId >= m_layers.size()) m_layers.resize(newId + 1);
+    m_layers[newId] = std::move(m_layers[id]);
+    m_layers[newId]->name = newName;
+    if (m_currentLayer == id) m_currentLayer = newId;
+    return newId;
 }
 
 LayerProperties* LayerManager::getLayer(const std::string& name) {
-    auto it = m_layers.find(name);
-    if (it != m_layers.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    auto id = LayerNames::find(name);
+    return id ? getLayer(*id) : nullptr;
 }
 
 const LayerProperties* LayerManager::getLayer(const std::string& name) const {
-    auto it = m_layers.find(name);
-    if (it != m_layers.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    auto id = LayerNames::find(name);
+    return id ? getLayer(*id) : nullptr;
 }
 
 std::vector<std::string> LayerManager::layerNames() const {
     std::vector<std::string> names;
-    names.reserve(m_layers.size());
-    for (const auto& [name, _] : m_layers) {
-        names.push_back(name);
+    for (const auto& layer : m_layers) {
+        if (layer) names.push_back(layer->name);
     }
     std::sort(names.begin(), names.end());
     return names;
 }
 
-void LayerManager::setCurrentLayer(const std::string& name) {
-    if (m_layers.find(name) != m_layers.end()) {
-        m_currentLayer = name;
+void LayerManager::setCurrentLayer(LayerId id) {
+    if (getLayer(id)) {
+        m_currentLayer = id;
     }
 }
 
+void LayerManager::setCurrentLayer(const std::string& name) {
+    if (auto id = LayerNames::find(name)) setCurrentLayer(*id);
+}
+
 void LayerManager::clear() {
     m_layers.clear();
     LayerProperties defaultLayer;
@@ -68,8 +145,8 @@ void LayerManager::clear() {
     defaultLayer.lineWidth = 1.0;
     defaultLayer.visible = true;
     defaultLayer.locked = false;
-    m_layers["0"] = defaultLayer;
-    m_currentLayer = "0";
+    addLayer(defaultLayer);
+    m_currentLayer = kDefaultLayerId;
 }
 
 }  // namespace hz::draft
@@ -1,13 +1,146 @@
 #include "horizon/drafting/SnapEngine.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/Intersection.h"
 #include "horizon/math/BoundingBox.h"
+#include "horizon/math/MathUtils.h"
 
 namespace hz::draft {
 
-SnapEngine::SnapEngine() : m_gridSpacing(1.0), m_snapTolerance(0.5) {}
+namespace {
+
+/// Entities examined per snap for the aperture-based modes.  Intersection work is
+/// quadratic in this, so a cursor over a very dense cluster looks at the closest only.
+constexpr size_t kMaxApertureEntities = 64;
+
+/// Cached pairs kept before the intersection cache is flushed.
+constexpr size_t kMaxCachedPairs = size_t{1} << 16;
+
+constexpr uint32_t modeBit(SnapType type) {
+    return uint32_t{1} << static_cast<uint32_t>(type);
+}
+
+math::Vec2 closestOnSegment(const math::Vec2& p, const math::Vec2& a, const math::Vec2& b) {
+    math::Vec2 ab = b - a;
+    double lenSq = ab.lengthSquared();
+    if (lenSq < 1e-14) return a;
+    double t = math::clamp((p - a).dot(ab) / lenSq, 0.0, 1.0);
+    return a + ab * t;
+}
+
+/// Circle or arc geometry of an entity, if it has any.
+struct RoundCurve {
+    math::Vec2 center;
+    double radius = 0.0;
+    const DraftArc* arc = nullptr;  ///< Non-null restricts the circle to the arc's sweep.
+
+    bool contains(const math::Vec2& p) const {
+        return !arc || arc->containsAngle(std::atan2(p.y - center.y, p.x - center.x));
+    }
+};
+
+std::optional<RoundCurve> roundCurveOf(const DraftEntity& entity) {
+    if (auto* circle = dynamic_cast<const DraftCircle*>(&entity)) {
+        return RoundCurve{circle->center(), circle->radius(), nullptr};
+    }
+    if (auto* arc = dynamic_cast<const DraftArc*>(&entity)) {
+        return RoundCurve{arc->center(), arc->radius(), arc};
+    }
+    return std::nullopt;
+}
+
+/// Closest point on the entity's segments or circle/arc to p, if it has such geometry.
+std::optional<math::Vec2> nearestOnEntity(const DraftEntity& entity, const math::Vec2& p) {
+    std::optional<math::Vec2> best;
+    double bestDist = std::numeric_limits<double>::max();
+    auto consider = [&](const math::Vec2& q) {
+        double d = p.distanceTo(q);
+        if (d < bestDist) {
+            bestDist = d;
+            best = q;
+        }
+    };
+
+    for (const auto& [a, b] : extractSegments(entity)) {
+        consider(closestOnSegment(p, a, b));
+    }
+    if (auto curve = roundCurveOf(entity)) {
+        math::Vec2 dir = p - curve->center;
+        if (dir.length() > 1e-12) {
+            math::Vec2 onCircle = curve->center + dir.normalized() * curve->radius;
+            if (curve->contains(onCircle)) consider(onCircle);
+        }
+        if (curve->arc) {
+            consider(curve->arc->startPoint());
+            consider(curve->arc->endPoint());
+        }
+    }
+    return best;
+}
+
+/// Points on the entity where a line from `from` meets it at a right angle.
+void perpendicularPoints(const DraftEntity& entity, const math::Vec2& from,
+                         std::vector<math::Vec2>& out) {
+    for (const auto& [a, b] : extractSegments(entity)) {
+        math::Vec2 ab = b - a;
+        double lenSq = ab.lengthSquared();
+        if (lenSq < 1e-14) continue;
+        double t = (from - a).dot(ab) / lenSq;
+        if (t >= 0.0 && t <= 1.0) out.push_back(a + ab * t);
+    }
+    if (auto curve = roundCurveOf(entity)) {
+        // Perpendiculars to a circle run through its center.
+        math::Vec2 dir = from - curve->center;
+        if (dir.length() < 1e-12) return;
+        math::Vec2 offset = dir.normalized() * curve->radius;
+        for (const math::Vec2& q : {curve->center + offset, curve->center - offset}) {
+            if (curve->contains(q)) out.push_back(q);
+        }
+    }
+}
+
+/// Points on a circle/arc entity where a line from `from` touches it tangentially.
+void tangentPoints(const DraftEntity& entity, const math::Vec2& from,
+                   std::vector<math::Vec2>& out) {
+    auto curve = roundCurveOf(entity);
+    if (!curve) return;
+    math::Vec2 dir = from - curve->center;
+    double dist = dir.length();
+    if (dist <= curve->radius) return;
+    double base = std::atan2(dir.y, dir.x);
+    double spread = std::acos(curve->radius / dist);
+    for (double angle : {base + spread, base - spread}) {
+        math::Vec2 q = curve->center +
+                       math::Vec2(std::cos(angle), std::sin(angle)) * curve->radius;
+        if (curve->contains(q)) out.push_back(q);
+    }
+}
+
+}  // namespace
+
+SnapEngine::SnapEngine()
+    : m_gridSpacing(1.0),
+      m_snapTolerance(0.5),
+      m_enabledModes(modeBit(SnapType::Endpoint) | modeBit(SnapType::Intersection) |
+                     modeBit(SnapType::Perpendicular) | modeBit(SnapType::Tangent)) {}
+
+void SnapEngine::setModeEnabled(SnapType type, bool enabled) {
+    if (enabled) {
+        m_enabledModes |= modeBit(type);
+    } else {
+        m_enabledModes &= ~modeBit(type);
+    }
+}
+
+bool SnapEngine::isModeEnabled(SnapType type) const {
+    return (m_enabledModes & modeBit(type)) != 0;
+}
 
 void SnapEngine::setGridSpacing(double spacing) {
     if (spacing > 0.0) {
@@ -27,6 +160,28 @@ math::Vec2 SnapEngine::snapToGrid(const math::Vec2& point) const {
     return math::Vec2(x, y);
 }
 
+const std::vector<math::Vec2>& SnapEngine::cachedIntersections(const DraftEntity& a,
+                                                               const DraftEntity& b) const {
+    const DraftEntity& lo = a.id() < b.id() ? a : b;
+    const DraftEntity& hi = a.id() < b.id() ? b : a;
+    PairKey key{lo.id(), hi.id()};
+
+    auto it = m_intersectionCache.find(key);
+    if (it != m_intersectionCache.end() && it->second.loVersion == lo.version() &&
+        it->second.hiVersion == hi.version()) {
+        return it->second.points;
+    }
+
+    if (it == m_intersectionCache.end()) {
+        if (m_intersectionCache.size() >= kMaxCachedPairs) m_intersectionCache.clear();
+        it = m_intersectionCache.try_emplace(key).first;
+    }
+    it->second.loVersion = lo.version();
+    it->second.hiVersion = hi.version();
+    it->second.points = intersect(lo, hi).points;
+    return it->second.points;
+}
+
 SnapResult SnapEngine::snap(const math::Vec2& cursorWorld,
                             const std::vector<std::shared_ptr<DraftEntity>>& entities) const {
     SnapResult best;
@@ -60,34 +215,107 @@ SnapResult SnapEngine::snap(const math::Vec2& cursorWorld,
     return best;
 }
 
-SnapResult SnapEngine::snap(const math::Vec2& cursorWorld, const SpatialIndex& index,
-                            const std::vector<std::shared_ptr<DraftEntity>>& entities) const {
+SnapResult SnapEngine::snap(const math::Vec2& cursorWorld, const DraftDocument& doc) const {
     SnapResult best;
     best.point = cursorWorld;
     best.type = SnapType::None;
     double bestDist = std::numeric_limits<double>::max();
 
-    // Build a search box around cursor at snap tolerance.
-    math::BoundingBox searchBox(
-        math::Vec3(cursorWorld.x - m_snapTolerance, cursorWorld.y - m_snapTolerance, -1e9),
-        math::Vec3(cursorWorld.x + m_snapTolerance, cursorWorld.y + m_snapTolerance, 1e9));
-
-    auto candidateIds = index.query(searchBox);
-
-    // Only check snap points of entities near cursor.
-    for (uint64_t id : candidateIds) {
-        for (const auto& entity : entities) {
-            if (entity->id() != id) continue;
-            std::vector<math::Vec2> pts = entity->snapPoints();
-            for (const auto& pt : pts) {
-                double dist = cursorWorld.distanceTo(pt);
-                if (dist < m_snapTolerance && dist < bestDist) {
+    // Best-first search: entities are visited in order of their box distance
+    // from the cursor, and the search stops as soon as no remaining box can
+    // hold a snap point closer than the best one found. Snap points lie
+    // inside their entity's box, so the box distance is a valid lower bound.
+    constexpr double kRejected = std::numeric_limits<double>::infinity();
+    math::Vec2 bestPoint = cursorWorld;
+    auto closestSnapPoint = [&](uint64_t id, const math::BoundingBox&) {
+        auto entity = doc.findEntity(id);
+        if (!entity) return kRejected;
+        double entityBest = kRejected;
+        for (const auto& pt : entity->snapPoints()) {
+            double dist = cursorWorld.distanceTo(pt);
+            if (dist < m_snapTolerance && dist < entityBest) {
+                entityBest = dist;
+                if (dist < bestDist) {
                     bestDist = dist;
-                    best.point = pt;
-                    best.type = SnapType::Endpoint;
+                    bestPoint = pt;
                 }
             }
-            break;
+        }
+        return entityBest;
+    };
+
+    if (isModeEnabled(SnapType::Endpoint)) {
+        auto nearest =
+            doc.spatialIndex().nearest(cursorWorld, 1, m_snapTolerance, closestSnapPoint);
+        if (!nearest.empty()) {
+            best.point = bestPoint;
+            best.type = SnapType::Endpoint;
+        }
+    }
+
+    auto consider = [&](const math::Vec2& pt, SnapType type) {
+        double dist = cursorWorld.distanceTo(pt);
+        if (dist < m_snapTolerance && dist < bestDist) {
+            bestDist = dist;
+            best.point = pt;
+            best.type = type;
+        }
+    };
+
+    // The remaining object snaps only look at entities whose boxes touch the aperture.
+    const bool fromReference = m_referencePoint.has_value();
+    const bool wantIntersection = isModeEnabled(SnapType::Intersection);
+    const bool wantPerpendicular = fromReference && isModeEnabled(SnapType::Perpendicular);
+    const bool wantTangent = fromReference && isModeEnabled(SnapType::Tangent);
+    const bool wantNearest = isModeEnabled(SnapType::Nearest);
+
+    m_apertureEntities.clear();
+    if (wantIntersection || wantPerpendicular || wantTangent || wantNearest) {
+        // Every snap point these modes produce lies on its entity, within the tolerance
+        // of the cursor, so the candidates are the entities whose curves come that close,
+        // visited closest first so that the cap drops the farthest.
+        auto curveDistance = [&](uint64_t id, const math::BoundingBox& box) {
+            const double boxDist = SpatialIndex::boxDistance(cursorWorld, box);
+            auto entity = doc.findEntity(id);
+            if (!entity) return std::numeric_limits<double>::infinity();
+            auto pt = nearestOnEntity(*entity, cursorWorld);
+            return pt ? std::max(boxDist, cursorWorld.distanceTo(*pt)) : boxDist;
+        };
+        doc.spatialIndex().visitNearest(cursorWorld, m_snapTolerance, curveDistance,
+                                        [&](uint64_t id, double) {
+                                            m_apertureEntities.push_back(doc.findEntity(id));
+                                            return m_apertureEntities.size() <
+                                                   kMaxApertureEntities;
+                                        });
+    }
+
+    if (wantIntersection) {
+        for (size_t i = 0; i < m_apertureEntities.size(); ++i) {
+            const DraftEntity& a = *m_apertureEntities[i];
+            math::BoundingBox boxA = a.boundingBox();
+            for (size_t j = i + 1; j < m_apertureEntities.size(); ++j) {
+                const DraftEntity& b = *m_apertureEntities[j];
+                if (!boxA.intersects(b.boundingBox())) continue;
+                for (const auto& pt : cachedIntersections(a, b)) {
+                    consider(pt, SnapType::Intersection);
+                }
+            }
+        }
+    }
+
+    if (wantPerpendicular || wantTangent) {
+        std::vector<math::Vec2> candidates;
+        for (const auto& entity : m_apertureEntities) {
+            if (wantPerpendicular) {
+                candidates.clear();
+                perpendicularPoints(*entity, *m_referencePoint, candidates);
+                for (const auto& pt : candidates) consider(pt, SnapType::Perpendicular);
+            }
+            if (wantTangent) {
+                candidates.clear();
+                tangentPoints(*entity, *m_referencePoint, candidates);
+                for (const auto& pt : candidates) consider(pt, SnapType::Tangent);
+            }
         }
     }
 
@@ -99,6 +327,23 @@ SnapResult SnapEngine::snap(const math::Vec2& cursorWorld, const SpatialIndex& i
         best.type = SnapType::Grid;
     }
 
+    // Nearest is the fallback: it only applies when no object snap point was found, and
+    // then takes precedence over the grid since the cursor is actually over a curve.
+    if (wantNearest && (best.type == SnapType::None || best.type == SnapType::Grid)) {
+        double nearestDist = m_snapTolerance;
+        for (const auto& entity : m_apertureEntities) {
+            auto pt = nearestOnEntity(*entity, cursorWorld);
+            if (!pt) continue;
+            double dist = cursorWorld.distanceTo(*pt);
+            if (dist < nearestDist) {
+                nearestDist = dist;
+                best.point = *pt;
+                best.type = SnapType::Nearest;
+            }
+        }
+    }
+
+    m_apertureEntities.clear();
     return best;
 }
 
@@ -6,32 +6,57 @@ void SpatialIndex::insert(const std::shared_ptr<DraftEntity>& entity) {
     if (!entity) return;
     auto bbox = entity->boundingBox();
     if (!bbox.isValid()) return;
-    m_tree.insert(entity->id(), bbox);
+    ++m_revision;
+    // The tree stores each id once; re-inserting an indexed entity moves it.
+    if (!m_tree.update(entity->id(), bbox)) {
+        m_tree.insert(entity->id(), bbox);
+    }
 }
 
 void SpatialIndex::remove(uint64_t entityId) {
+    ++m_revision;
     m_tree.remove(entityId);
 }
 
 void SpatialIndex::update(const std::shared_ptr<DraftEntity>& entity) {
     if (!entity) return;
-    remove(entity->id());
-    insert(entity);
+    ++m_revision;
+    auto bbox = entity->boundingBox();
+    if (!bbox.isValid()) {
+        m_tree.remove(entity->id());
+        return;
+    }
+    if (!m_tree.update(entity->id(), bbox)) {
+        m_tree.insert(entity->id(), bbox);
+    }
 }
 
 std::vector<uint64_t> SpatialIndex::query(const math::BoundingBox& searchBox) const {
     return m_tree.query(searchBox);
 }
 
+void SpatialIndex::query(const math::BoundingBox& searchBox, std::vector<uint64_t>& results) const {
+    m_tree.query(searchBox, results);
+}
+
 void SpatialIndex::rebuild(const std::vector<std::shared_ptr<DraftEntity>>& entities) {
-    m_tree.clear();
+    // Pack the whole set at once (STR bulk load) rather than inserting one by
+    // one: no node splits, and the resulting tree has tighter, fuller nodes.
+    std::vector<std::pair<uint64_t, math::BoundingBox>> items;
+    items.reserve(entities.size());
     for (const auto& entity : entities) {
-        insert(entity);
+        if (!entity) continue;
+        auto bbox = entity->boundingBox();
+        if (!bbox.isValid()) continue;
+        items.emplace_back(entity->id(), bbox);
     }
+    m_tree.bulkLoad(std::move(items));
+    ++m_revision;
 }
 
 void SpatialIndex::clear() {
     m_tree.clear();
+    ++m_revision;
 }
 
 }  // namespace hz::draft
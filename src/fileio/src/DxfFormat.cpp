@@ -296,18 +296,21 @@ void writeHatch(std::ostream& out, const draft::DraftHatch& hatch) {
     writeGroup(out, 70, isSolid ? 1 : 0);
     writeGroup(out, 71, 0);  // Non-associative.
 
-    // Boundary path.
-    const auto& boundary = hatch.boundary();
-    writeGroup(out, 91, 1);  // 1 boundary path.
-    writeGroup(out, 92, 2);  // Polyline boundary type.
-    writeGroup(out, 72, 0);  // No bulge.
-    writeGroup(out, 73, 1);  // Closed.
-    writeGroup(out, 93, static_cast<int>(boundary.size()));
-    for (const auto& pt : boundary) {
-        writeGroup(out, 10, pt.x);
-        writeGroup(out, 20, pt.y);
-    }
-    writeGroup(out, 97, 0);  // No source boundary objects.
+    // Boundary paths: the outer boundary, then one per hole.
+    auto writePath = [&out](const std::vector<math::Vec2>& loop, int flags) {
+        writeGroup(out, 92, flags);
+        writeGroup(out, 72, 0);  // No bulge.
+        writeGroup(out, 73, 1);  // Closed.
+        writeGroup(out, 93, static_cast<int>(loop.size()));
+        for (const auto& pt : loop) {
+            writeGroup(out, 10, pt.x);
+            writeGroup(out, 20, pt.y);
+        }
+        writeGroup(out, 97, 0);  // No source boundary objects.
+    };
+    writeGroup(out, 91, static_cast<int>(1 + hatch.holes().size()));
+    writePath(hatch.boundary(), 2 | 1);  // Polyline | external.
+    for (const auto& hole : hatch.holes()) writePath(hole, 2);
 
     // Hatch style and pattern definition.
     writeGroup(out, 75, 0);  // Normal hatch style.
@@ -664,25 +667,43 @@ std::shared_ptr<draft::DraftEntity> parseHatch(const std::vector<DxfPair>& group
     double angle = toDouble(findGroup(groups, 52, "0")) * math::kDegToRad;
     double spacing = toDouble(findGroup(groups, 41, "1.0"));
 
-    // Parse boundary vertices (first polyline boundary path).
-    // Look for group 93 (vertex count), then subsequent 10/20 pairs.
-    // In a hatch, boundary vertex 10/20 groups appear after the boundary header.
-    auto xs = findAllDoubles(groups, 10);
-    auto ys = findAllDoubles(groups, 20);
-
-    // Skip the first 10/20 (elevation point) — boundary vertices start after.
-    if (xs.size() > 1 && ys.size() > 1) {
-        xs.erase(xs.begin());
-        ys.erase(ys.begin());
+    // Parse boundary paths.  Group 91 gives the path count; each path starts at a 92
+    // (path type) and ends at its 97 (source object count).  The 10/20 pairs inside a
+    // path are its vertices (or, for edge paths, the edge start points).  The first
+    // path is the outer boundary and the rest become holes.
+    std::vector<std::vector<math::Vec2>> loops;
+    auto pathsAt = std::find_if(groups.begin(), groups.end(),
+                                [](const DxfPair& g) { return g.code == 91; });
+    if (pathsAt != groups.end()) {
+        std::vector<math::Vec2>* loop = nullptr;
+        double x = 0.0;
+        for (auto it = pathsAt + 1; it != groups.end(); ++it) {
+            if (it->code == 92) {
+                loop = &loops.emplace_back();
+            } else if (it->code == 97 || it->code == 75) {
+                loop = nullptr;
+                if (it->code == 75) break;  // Pattern data follows the paths.
+            } else if (loop && it->code == 10) {
+                x = toDouble(it->value);
+            } else if (loop && it->code == 20) {
+                loop->emplace_back(x, toDouble(it->value));
+            }
+        }
+    } else {
+        // No path header: every 10/20 after the elevation point is a boundary vertex.
+        auto xs = findAllDoubles(groups, 10);
+        auto ys = findAllDoubles(groups, 20);
+        auto& loop = loops.emplace_back();
+        for (size_t i = 1; i < std::min(xs.size(), ys.size()); ++i) {
+            loop.emplace_back(xs[i], ys[i]);
+        }
     }
 
-    size_t count = std::min(xs.size(), ys.size());
-    if (count < 3) return nullptr;
-
-    std::vector<math::Vec2> boundary;
-    boundary.reserve(count);
-    for (size_t i = 0; i < count; ++i) {
-        boundary.emplace_back(xs[i], ys[i]);
+    if (loops.empty() || loops.front().size() < 3) return nullptr;
+    std::vector<math::Vec2> boundary = std::move(loops.front());
+    std::vector<std::vector<math::Vec2>> holes;
+    for (size_t i = 1; i < loops.size(); ++i) {
+        if (loops[i].size() >= 3) holes.push_back(std::move(loops[i]));
     }
 
     draft::HatchPattern pattern = draft::HatchPattern::Lines;
@@ -692,7 +713,7 @@ std::shared_ptr<draft::DraftEntity> parseHatch(const std::vector<DxfPair>& group
         pattern = draft::HatchPattern::CrossHatch;
 
     if (spacing <= 0.0) spacing = 1.0;
-    return std::make_shared<draft::DraftHatch>(boundary, pattern, angle, spacing);
+    return std::make_shared<draft::DraftHatch>(boundary, pattern, angle, spacing, holes);
 }
 
 std::shared_ptr<draft::DraftEntity> parseEllipse(const std::vector<DxfPair>& groups) {
@@ -887,9 +908,13 @@ void parseEntitiesSection(std::istream& in, doc::Document& doc) {
         if (pair.code == 0) break;
     }
 
+    // Entities are collected and handed to the document in one batch so the
+    // spatial index is bulk-loaded once rather than grown insert by insert.
+    std::vector<std::shared_ptr<draft::DraftEntity>> loaded;
+
     while (true) {
-        if (pair.code == 0 && pair.value == "ENDSEC") return;
-        if (pair.code == 0 && pair.value == "EOF") return;
+        if (pair.code == 0 && pair.value == "ENDSEC") break;
+        if (pair.code == 0 && pair.value == "EOF") break;
 
         std::string entityType = pair.value;
         std::vector<DxfPair> groups;
@@ -926,9 +951,11 @@ void parseEntitiesSection(std::istream& in, doc::Document& doc) {
 
         if (entity) {
             applyCommonProps(entity, groups);
-            doc.draftDocument().addEntity(entity);
+            loaded.push_back(std::move(entity));
         }
     }
+
+    doc.draftDocument().addEntities(std::move(loaded));
 }
 
 }  // anonymous namespace
@@ -1170,9 +1197,6 @@ bool DxfFormat::load(const std::string& filePath, doc::Document& doc) {
         }
     }
 
-    // Rebuild spatial index after loading all entities.
-    doc.draftDocument().rebuildSpatialIndex();
-
     return foundSection;
 }
 
@@ -96,6 +96,26 @@ static std::string constraintTypeToString(cstr::ConstraintType ct) {
     return "unknown";
 }
 
+static json serializeHatchHoles(const draft::DraftHatch& hatch) {
+    json holes = json::array();
+    for (const auto& hole : hatch.holes()) {
+        json loop = json::array();
+        for (const auto& pt : hole) loop.push_back({{"x", pt.x}, {"y", pt.y}});
+        holes.push_back(loop);
+    }
+    return holes;
+}
+
+static std::vector<std::vector<math::Vec2>> deserializeHatchHoles(const json& obj) {
+    std::vector<std::vector<math::Vec2>> holes;
+    if (!obj.contains("holes")) return holes;
+    for (const auto& loop : obj["holes"]) {
+        auto& hole = holes.emplace_back();
+        for (const auto& pt : loop) hole.emplace_back(pt["x"].get<double>(), pt["y"].get<double>());
+    }
+    return holes;
+}
+
 // ---------------------------------------------------------------------------
 // Entity serialization helper (shared by top-level and per-sketch writes)
 // ---------------------------------------------------------------------------
@@ -204,6 +224,7 @@ static json serializeEntity(const draft::DraftEntity& entity) {
             bndArray.push_back({{"x", pt.x}, {"y", pt.y}});
         }
         obj["boundary"] = bndArray;
+        if (!hatch->holes().empty()) obj["holes"] = serializeHatchHoles(*hatch);
     } else if (auto* ellipse = dynamic_cast<const draft::DraftEllipse*>(&entity)) {
         obj["type"] = "ellipse";
         obj["center"] = {{"x", ellipse->center().x}, {"y", ellipse->center().y}};
@@ -316,6 +337,7 @@ static json buildDocumentRoot(const doc::Document& doc, bool includeTessellation
                 json bnd = json::array();
                 for (const auto& pt : hatch->boundary()) bnd.push_back({{"x", pt.x}, {"y", pt.y}});
                 se["boundary"] = bnd;
+                if (!hatch->holes().empty()) se["holes"] = serializeHatchHoles(*hatch);
             } else if (auto* el = dynamic_cast<const draft::DraftEllipse*>(subEnt.get())) {
                 se["type"] = "ellipse";
                 se["center"] = {{"x", el->center().x}, {"y", el->center().y}};
@@ -742,8 +764,8 @@ static std::shared_ptr<draft::DraftEntity> deserializeEntity(const json& obj,
         auto hatchPattern = static_cast<draft::HatchPattern>(obj.value("pattern", 1));
         double hatchAngle = obj.value("angle", 0.0);
         double hatchSpacing = obj.value("spacing", 1.0);
-        entity =
-            std::make_shared<draft::DraftHatch>(boundary, hatchPattern, hatchAngle, hatchSpacing);
+        entity = std::make_shared<draft::DraftHatch>(boundary, hatchPattern, hatchAngle,
+                                                     hatchSpacing, deserializeHatchHoles(obj));
     } else if (type == "ellipse") {
         auto center =
             math::Vec2(obj["center"]["x"].get<double>(), obj["center"]["y"].get<double>());
@@ -896,7 +918,8 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
                                 boundary.emplace_back(pt["x"].get<double>(), pt["y"].get<double>());
                             subEnt = std::make_shared<draft::DraftHatch>(
                                 boundary, static_cast<draft::HatchPattern>(se.value("pattern", 1)),
-                                se.value("angle", 0.0), se.value("spacing", 1.0));
+                                se.value("angle", 0.0), se.value("spacing", 1.0),
+                                deserializeHatchHoles(se));
                         } else if (stype == "ellipse") {
                             auto ctr = math::Vec2(se["center"]["x"].get<double>(),
                                                   se["center"]["y"].get<double>());
@@ -921,7 +944,11 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
     }
 
     // --- Load entities ---
+    // Collected first and added as one batch so the spatial index is
+    // bulk-loaded once instead of being grown insert by insert.
     const auto* blockTablePtr = &doc.draftDocument().blockTable();
+    std::vector<std::shared_ptr<draft::DraftEntity>> loadedEntities;
+    loadedEntities.reserve(root["entities"].size());
     for (const auto& obj : root["entities"]) {
         try {
             auto entity = deserializeEntity(obj, blockTablePtr);
@@ -930,12 +957,13 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
                 if (gid != 0) {
                     doc.draftDocument().advanceGroupIdCounter(gid);
                 }
-                doc.draftDocument().addEntity(entity);
+                loadedEntities.push_back(std::move(entity));
             }
         } catch (const nlohmann::json::exception&) {
             continue;  // Skip malformed entities.
         }
     }
+    doc.draftDocument().addEntities(std::move(loadedEntities));
 
     // --- Load constraints (v5+) ---
     if (root.contains("constraints")) {
@@ -1032,9 +1060,6 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
         }
     }
 
-    // Rebuild spatial index after loading all entities.
-    doc.draftDocument().rebuildSpatialIndex();
-
     // --- Load sketches ---
     if (root.contains("sketches")) {
         // Clear the default sketch collection — we'll rebuild from file data.
@@ -1067,16 +1092,18 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
 
                 // Load per-sketch entities
                 if (skObj.contains("entities")) {
+                    std::vector<std::shared_ptr<draft::DraftEntity>> sketchEntities;
                     for (const auto& eObj : skObj["entities"]) {
                         try {
                             auto entity = deserializeEntity(eObj, blockTablePtr);
                             if (entity) {
-                                sketch->addEntity(entity);
+                                sketchEntities.push_back(std::move(entity));
                             }
                         } catch (const nlohmann::json::exception&) {
                             continue;
                         }
                     }
+                    sketch->addEntities(std::move(sketchEntities));
                 }
 
                 doc.sketches().push_back(sketch);
@@ -1102,9 +1129,7 @@ static bool loadDocumentRoot(const json& root, doc::Document& doc) {
     } else {
         // Pre-sketch file (v14 and earlier): load top-level entities into the
         // default sketch as well so that defaultSketch() contains them.
-        for (const auto& entity : doc.draftDocument().entities()) {
-            doc.defaultSketch().addEntity(entity);
-        }
+        doc.defaultSketch().addEntities(doc.draftDocument().entities());
     }
 
     // --- Load feature tree (v15+; v16 stores real sketch IDs) ---
@@ -17,14 +17,31 @@ struct TessellationResult {
     std::vector<uint32_t> indices;  ///< Triangle list (3 indices per triangle).
 };
 
+/// Surface point and partial derivatives at one (u, v), see
+/// NurbsSurface::evaluateWithDerivatives().  Derivatives above the requested order are zero.
+struct SurfaceDerivatives {
+    math::Vec3 point;
+    math::Vec3 du;   ///< dS/du
+    math::Vec3 dv;   ///< dS/dv
+    math::Vec3 duu;  ///< d2S/du2
+    math::Vec3 duv;  ///< d2S/dudv
+    math::Vec3 dvv;  ///< d2S/dv2
+};
+
 /// Non-uniform rational B-spline (NURBS) tensor-product surface.
 ///
 /// Stores a 2D grid of control points with per-point weights, knot vectors in
 /// U and V directions, and polynomial degrees in U and V.  Evaluation uses a
-/// two-pass De Boor algorithm: evaluate each row in V, then combine the results
-/// in U.
+/// two-pass scheme: each row is evaluated as a rational curve in V, then the rows
+/// are combined through the U basis with unit weights (the GPU tessellator's
+/// nurbs_eval.comp follows the same semantics).  Only the (degreeU+1) x (degreeV+1)
+/// control points of the knot span are touched, using stack buffers.
 class NurbsSurface {
 public:
+    /// Degrees up to this evaluate without heap allocation; higher ones fall back to
+    /// a heap buffer.
+    static constexpr int kMaxStackDegree = 15;
+
     /// Construct a NURBS surface.
     /// @param controlPoints  2D grid [row_u][col_v] of control points.
     /// @param weights        2D grid of weights matching the control point layout.
@@ -62,15 +79,20 @@ public:
 
     // -- Evaluation ----------------------------------------------------------
 
-    /// Evaluate the surface at parameters (u, v) using tensor-product De Boor.
+    /// Evaluate the surface at parameters (u, v).  Parameters are clamped to the domain.
     math::Vec3 evaluate(double u, double v) const;
 
+    /// Evaluate the point and its analytic partial derivatives at (u, v) in one pass.
+    /// @param order  0 for the point only, 1 to add du and dv, 2 to add duu, duv and dvv.
+    /// At an interior knot the derivatives are those of the span starting there.
+    SurfaceDerivatives evaluateWithDerivatives(double u, double v, int order = 1) const;
+
     // -- Derivatives & Normal (Task 2) ----------------------------------------
 
-    /// Partial derivative with respect to U at (u, v) via numerical differentiation.
+    /// Partial derivative with respect to U at (u, v).
     math::Vec3 derivativeU(double u, double v) const;
 
-    /// Partial derivative with respect to V at (u, v) via numerical differentiation.
+    /// Partial derivative with respect to V at (u, v).
     math::Vec3 derivativeV(double u, double v) const;
 
     /// Unit surface normal at (u, v): normalize(dS/du x dS/dv).
@@ -79,7 +101,8 @@ public:
     // -- Closest-Point & Iso-Curves (Task 3) ----------------------------------
 
     /// Find the parameter pair (u, v) of the closest point on the surface to @p point.
-    /// Uses 2D Newton iteration on the gradient of distance-squared after an 8x8 grid search.
+    /// Uses 2D Newton iteration on the gradient of distance-squared after an 8x8 grid search,
+    /// falling back to Gauss-Newton steps where the Hessian is not positive definite.
     std::pair<double, double> closestPoint(const math::Vec3& point, double tol = 1e-8) const;
 
     /// Extract an iso-parametric curve at constant U (returns a curve along V).
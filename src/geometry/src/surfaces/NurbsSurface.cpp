@@ -1,7 +1,9 @@
 #include "horizon/geometry/surfaces/NurbsSurface.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <span>
 #include <stdexcept>
 
 #include "horizon/geometry/curves/NurbsCurve.h"
@@ -113,50 +115,175 @@ double NurbsSurface::vMax() const {
 }
 
 // ---------------------------------------------------------------------------
-// evaluate — tensor-product De Boor (two-pass)
+// Span and basis helpers
 // ---------------------------------------------------------------------------
 
-math::Vec3 NurbsSurface::evaluate(double u, double v) const {
-    const int numU = controlPointCountU();
+namespace {
+
+/// Index i of the knot span [knots[i], knots[i+1]) containing @p t, for @p n control
+/// points of degree @p p; t at the end of the domain maps to the last span.
+int findSpan(const std::vector<double>& knots, int n, int p, double t) {
+    if (t >= knots[n]) {
+        return n - 1;
+    }
+    const auto it = std::upper_bound(knots.begin() + p + 1, knots.begin() + n, t);
+    return static_cast<int>(it - knots.begin()) - 1;
+}
 
-    // Pass 1: For each row (U index), evaluate the V-direction NURBS curve at v.
-    std::vector<math::Vec3> tempPts(numU);
-    std::vector<double> tempWeights(numU, 1.0);
+/// Scratch doubles basisDerivatives() needs for degree @p p.
+constexpr int basisScratchSize(int p) {
+    return (p + 1) * (p + 5);
+}
 
-    for (int i = 0; i < numU; ++i) {
-        NurbsCurve rowCurve(m_controlPoints[i], m_weights[i], m_knotsV, m_degreeV);
-        tempPts[i] = rowCurve.evaluate(v);
+/// The p+1 non-zero basis functions at @p t in @p span and their derivatives up to
+/// order @p n (The NURBS Book, A2.3).  ders[k * (p + 1) + j] receives the k-th
+/// derivative of N_{span-p+j}; orders above p are zero.
+void basisDerivatives(const std::vector<double>& knots, int span, double t, int p, int n,
+                      std::span<double> ders, std::span<double> scratch) {
+    const int order = p + 1;
+    double* ndu = scratch.data();  // upper triangle: basis values, lower: knot differences
+    double* a = ndu + order * order;
+    double* left = a + 2 * order;
+    double* right = left + order;
+
+    ndu[0] = 1.0;
+    for (int j = 1; j <= p; ++j) {
+        left[j] = t - knots[span + 1 - j];
+        right[j] = knots[span + j] - t;
+        double saved = 0.0;
+        for (int r = 0; r < j; ++r) {
+            ndu[j * order + r] = right[r + 1] + left[j - r];
+            const double temp = ndu[r * order + j - 1] / ndu[j * order + r];
+            ndu[r * order + j] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+        ndu[j * order + j] = saved;
+    }
+    for (int j = 0; j <= p; ++j) {
+        ders[j] = ndu[j * order + p];
+    }
+
+    const int nd = std::min(n, p);
+    for (int r = 0; r <= p; ++r) {
+        double* a1 = a;
+        double* a2 = a + order;
+        a1[0] = 1.0;
+        for (int k = 1; k <= nd; ++k) {
+            const int rk = r - k;
+            const int pk = p - k;
+            double d = 0.0;
+            if (r >= k) {
+                a2[0] = a1[0] / ndu[(pk + 1) * order + rk];
+                d = a2[0] * ndu[rk * order + pk];
+            }
+            const int j1 = rk >= -1 ? 1 : -rk;
+            const int j2 = r - 1 <= pk ? k - 1 : p - r;
+            for (int j = j1; j <= j2; ++j) {
+                a2[j] = (a1[j] - a1[j - 1]) / ndu[(pk + 1) * order + rk + j];
+                d += a2[j] * ndu[(rk + j) * order + pk];
+            }
+            if (r <= pk) {
+                a2[k] = -a1[k - 1] / ndu[(pk + 1) * order + r];
+                d += a2[k] * ndu[r * order + pk];
+            }
+            ders[k * order + r] = d;
+            std::swap(a1, a2);
+        }
+    }
+
+    // Scale by p! / (p-k)!.
+    double factor = p;
+    for (int k = 1; k <= nd; ++k) {
+        for (int j = 0; j <= p; ++j) ders[k * order + j] *= factor;
+        factor *= p - k;
+    }
+    for (int k = nd + 1; k <= n; ++k) {
+        for (int j = 0; j <= p; ++j) ders[k * order + j] = 0.0;
     }
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// evaluate / evaluateWithDerivatives — two-pass, span-local, analytic
+// ---------------------------------------------------------------------------
 
-    // Pass 2: Evaluate the U-direction NURBS curve using the temporary points.
-    NurbsCurve uCurve(tempPts, tempWeights, m_knotsU, m_degreeU);
-    return uCurve.evaluate(u);
+math::Vec3 NurbsSurface::evaluate(double u, double v) const {
+    return evaluateWithDerivatives(u, v, 0).point;
+}
+
+SurfaceDerivatives NurbsSurface::evaluateWithDerivatives(double u, double v, int order) const {
+    order = std::clamp(order, 0, 2);
+    u = std::clamp(u, uMin(), uMax());
+    v = std::clamp(v, vMin(), vMax());
+
+    const int p = m_degreeU;
+    const int q = m_degreeV;
+    const int orderU = p + 1;
+    const int orderV = q + 1;
+    const int spanU = findSpan(m_knotsU, controlPointCountU(), p, u);
+    const int spanV = findSpan(m_knotsV, controlPointCountV(), q, v);
+
+    // Basis derivative tables for U and V, then shared scratch.
+    constexpr int kStackOrder = kMaxStackDegree + 1;
+    constexpr int kStackSize = 6 * kStackOrder + basisScratchSize(kMaxStackDegree);
+    std::array<double, kStackSize> stackBuf;
+    std::vector<double> heapBuf;
+    std::span<double> buf(stackBuf);
+    const int needed =
+        3 * (orderU + orderV) + std::max(basisScratchSize(p), basisScratchSize(q));
+    if (needed > kStackSize) {
+        heapBuf.resize(needed);
+        buf = heapBuf;
+    }
+    const std::span<double> Nu = buf.subspan(0, 3 * orderU);
+    const std::span<double> Nv = buf.subspan(3 * orderU, 3 * orderV);
+    const std::span<double> scratch = buf.subspan(3 * (orderU + orderV));
+    basisDerivatives(m_knotsU, spanU, u, p, order, Nu, scratch);
+    basisDerivatives(m_knotsV, spanV, v, q, order, Nv, scratch);
+
+    SurfaceDerivatives out;
+    for (int r = 0; r <= p; ++r) {
+        const auto& rowPts = m_controlPoints[spanU - p + r];
+        const auto& rowWts = m_weights[spanU - p + r];
+
+        // Homogeneous row curve and its V derivatives: A(k) = sum N(k) w P, W(k) = sum N(k) w.
+        math::Vec3 A[3];
+        double W[3] = {0.0, 0.0, 0.0};
+        for (int k = 0; k <= order; ++k) {
+            for (int s = 0; s <= q; ++s) {
+                const double nw = Nv[k * orderV + s] * rowWts[spanV - q + s];
+                A[k] += rowPts[spanV - q + s] * nw;
+                W[k] += nw;
+            }
+        }
+
+        // Rational row point C(v) and its derivatives by the quotient rule.
+        const math::Vec3 C = A[0] / W[0];
+        out.point += C * Nu[r];
+        if (order < 1) continue;
+        const math::Vec3 C1 = (A[1] - C * W[1]) / W[0];
+        out.du += C * Nu[orderU + r];
+        out.dv += C1 * Nu[r];
+        if (order < 2) continue;
+        const math::Vec3 C2 = (A[2] - C1 * (2.0 * W[1]) - C * W[2]) / W[0];
+        out.duu += C * Nu[2 * orderU + r];
+        out.duv += C1 * Nu[orderU + r];
+        out.dvv += C2 * Nu[r];
+    }
+    return out;
 }
 
 // ---------------------------------------------------------------------------
-// Derivatives — numerical differentiation
+// Derivatives — analytic
 // ---------------------------------------------------------------------------
 
 math::Vec3 NurbsSurface::derivativeU(double u, double v) const {
-    const double h = 1e-7;
-    const double u0 = std::max(u - h, uMin());
-    const double u1 = std::min(u + h, uMax());
-    const double actualH = u1 - u0;
-    if (actualH < 1e-15) {
-        return {0.0, 0.0, 0.0};
-    }
-    return (evaluate(u1, v) - evaluate(u0, v)) * (1.0 / actualH);
+    return evaluateWithDerivatives(u, v).du;
 }
 
 math::Vec3 NurbsSurface::derivativeV(double u, double v) const {
-    const double h = 1e-7;
-    const double v0 = std::max(v - h, vMin());
-    const double v1 = std::min(v + h, vMax());
-    const double actualH = v1 - v0;
-    if (actualH < 1e-15) {
-        return {0.0, 0.0, 0.0};
-    }
-    return (evaluate(u, v1) - evaluate(u, v0)) * (1.0 / actualH);
+    return evaluateWithDerivatives(u, v).dv;
 }
 
 // ---------------------------------------------------------------------------
@@ -164,9 +291,8 @@ math::Vec3 NurbsSurface::derivativeV(double u, double v) const {
 // ---------------------------------------------------------------------------
 
 math::Vec3 NurbsSurface::normal(double u, double v) const {
-    const math::Vec3 du = derivativeU(u, v);
-    const math::Vec3 dv = derivativeV(u, v);
-    const math::Vec3 n = du.cross(dv);
+    const SurfaceDerivatives d = evaluateWithDerivatives(u, v);
+    const math::Vec3 n = d.du.cross(d.dv);
     const double len = n.length();
     if (len < 1e-12) {
         return math::Vec3::UnitZ;
@@ -208,21 +334,25 @@ std::pair<double, double> NurbsSurface::closestPoint(const math::Vec3& point, do
     double v = bestV;
 
     for (int iter = 0; iter < 50; ++iter) {
-        const math::Vec3 S = evaluate(u, v);
-        const math::Vec3 diff = S - point;
-        const math::Vec3 Su = derivativeU(u, v);
-        const math::Vec3 Sv = derivativeV(u, v);
+        const SurfaceDerivatives d = evaluateWithDerivatives(u, v, 2);
+        const math::Vec3 diff = d.point - point;
 
         // Gradient of distance-squared.
-        const double fu = diff.dot(Su);
-        const double fv = diff.dot(Sv);
-
-        // Approximate Hessian (Gauss-Newton: ignore second derivatives).
-        const double J00 = Su.dot(Su);
-        const double J01 = Su.dot(Sv);
-        const double J11 = Sv.dot(Sv);
-
-        const double det = J00 * J11 - J01 * J01;
+        const double fu = diff.dot(d.du);
+        const double fv = diff.dot(d.dv);
+
+        // Newton Hessian; where it is not positive definite (near a local maximum or a
+        // saddle) drop the curvature terms and take a Gauss-Newton step instead.
+        double J00 = d.du.dot(d.du) + diff.dot(d.duu);
+        double J01 = d.du.dot(d.dv) + diff.dot(d.duv);
+        double J11 = d.dv.dot(d.dv) + diff.dot(d.dvv);
+        double det = J00 * J11 - J01 * J01;
+        if (J00 <= 0.0 || det <= 0.0) {
+            J00 = d.du.dot(d.du);
+            J01 = d.du.dot(d.dv);
+            J11 = d.dv.dot(d.dv);
+            det = J00 * J11 - J01 * J01;
+        }
         if (std::abs(det) < 1e-15) {
             break;
         }
@@ -328,12 +458,16 @@ TessellationResult NurbsSurface::tessellate(double tolerance) const {
         for (int j = 0; j <= res; ++j) {
             const double v = v0 + (v1 - v0) * static_cast<double>(j) / res;
 
-            const math::Vec3 pt = evaluate(u, v);
+            // One pass gives both the point and the tangents for the normal.
+            const SurfaceDerivatives d = evaluateWithDerivatives(u, v);
+            const math::Vec3& pt = d.point;
             result.positions.push_back(static_cast<float>(pt.x));
             result.positions.push_back(static_cast<float>(pt.y));
             result.positions.push_back(static_cast<float>(pt.z));
 
-            const math::Vec3 n = normal(u, v);
+            math::Vec3 n = d.du.cross(d.dv);
+            const double len = n.length();
+            n = len < 1e-12 ? math::Vec3::UnitZ : n * (1.0 / len);
             result.normals.push_back(static_cast<float>(n.x));
             result.normals.push_back(static_cast<float>(n.y));
             result.normals.push_back(static_cast<float>(n.z));
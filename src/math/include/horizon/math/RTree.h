@@ -1,485 +1,813 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <queue>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "horizon/math/BoundingBox.h"
+#include "horizon/math/Vec2.h"
 
 namespace hz::math {
 
 /// Header-only R*-tree spatial index for 2D CAD entities.
 ///
-/// Stores nodes in a flat std::vector for cache-friendly traversal.
-/// Uses quadratic split when a node overflows MaxChildren.
+/// Nodes are fixed-capacity and stored in a flat std::vector. Each node keeps
+/// the boxes of its slots (child nodes or leaf entries) as structure-of-arrays,
+/// one lo/hi array per axis, so a query tests all of a node's boxes in a single
+/// branch-free pass that the compiler can vectorise, and no node owns heap
+/// memory. Uses quadratic split when a node overflows MaxChildren; bulkLoad()
+/// packs a whole batch with Sort-Tile-Recursive instead.
+///
+/// Values act as keys: each value may be stored at most once, and a
+/// value -> leaf back-pointer map lets remove() and update() go straight to
+/// the owning leaf instead of searching the tree. ValueT must be hashable and
+/// default-constructible.
 ///
 /// Template parameters:
 ///   ValueT       - stored value type (e.g. uint64_t for entity IDs)
 ///   MaxChildren  - maximum entries per node before split
 ///   MinChildren  - minimum entries per node after split
-template <typename ValueT, int MaxChildren = 16, int MinChildren = MaxChildren / 3>
+///   Dims         - indexed axes: 2 (x, y; z is ignored) or 3 (x, y, z)
+template <typename ValueT, int MaxChildren = 16, int MinChildren = MaxChildren / 3,
+          int Dims = 2>
 class RTree {
+    static_assert(Dims == 2 || Dims == 3, "RTree indexes either 2 or 3 axes");
+    static_assert(MaxChildren >= 2 && MaxChildren < 64, "slot masks are 64-bit");
+
 public:
     RTree() { clear(); }
 
-    /// Insert a value with its bounding box.
-    void insert(const ValueT& value, const BoundingBox& bbox) {
-        Entry entry{value, bbox};
+    /// Build a tree from a batch of (value, bbox) pairs via bulkLoad().
+    explicit RTree(std::vector<std::pair<ValueT, BoundingBox>> items) {
+        bulkLoad(std::move(items));
+    }
 
-        if (m_size == 0) {
-            // First insert: root is a leaf, add directly
-            m_nodes[m_root].entries.push_back(entry);
-            m_nodes[m_root].bbox = bbox;
-        } else {
-            // Choose the best leaf and insert
-            int leafIdx = chooseLeaf(m_root, bbox);
-            m_nodes[leafIdx].entries.push_back(entry);
-            m_nodes[leafIdx].bbox.expand(bbox);
-
-            // Handle overflow by splitting up the tree.
-            // Step 1: if the leaf overflows, split it to produce a newSibling.
-            int current = leafIdx;
-            int newSibling = -1;
-            if (static_cast<int>(m_nodes[current].entries.size()) > MaxChildren) {
-                newSibling = splitNode(current);
+    /// Replace the tree contents with a batch of (value, bbox) pairs using
+    /// Sort-Tile-Recursive packing.
+    ///
+    /// Entries are sorted by x-center into vertical slices, each slice is
+    /// sorted by y-center and cut into full nodes; the same tiling is then
+    /// applied to the node boxes level by level until a single root remains.
+    /// O(n log n), no splits, and nodes are filled to MaxChildren, so the
+    /// result is both faster to build and shallower/less overlapping than a
+    /// tree produced by n successive insert() calls.
+    void bulkLoad(std::vector<std::pair<ValueT, BoundingBox>> items) {
+        clear();
+        if (items.empty()) return;
+
+        const size_t n = items.size();
+        m_nodes.clear();
+        m_nodes.reserve(estimatePackedNodeCount(n));
+        m_leafOf.reserve(n);
+
+        // Leaf level.
+        std::vector<std::pair<ValueT, Box>> entries;
+        entries.reserve(n);
+        for (auto& [value, bbox] : items) {
+            entries.emplace_back(std::move(value), toBox(bbox));
+        }
+        tileSort(entries, [](const auto& e) -> const Box& { return e.second; });
+
+        std::vector<std::pair<int, Box>> level;
+        level.reserve((n + MaxChildren - 1) / MaxChildren);
+        for (size_t i = 0; i < n; i += MaxChildren) {
+            const size_t end = std::min(n, i + static_cast<size_t>(MaxChildren));
+            const int leafIdx = allocateNode();
+            for (size_t j = i; j < end; ++j) {
+                appendEntry(leafIdx, entries[j].first, entries[j].second);
             }
+            level.emplace_back(leafIdx, nodeBox(leafIdx));
+        }
 
-            // Step 2: walk upward while we have a split to propagate.
-            while (newSibling >= 0) {
-                int parent = m_nodes[current].parent;
-                if (parent < 0) {
-                    // current is root -- create new root containing current and newSibling
-                    int newRoot = allocateNode();
-                    m_nodes[newRoot].isLeaf = false;
-                    m_nodes[newRoot].bbox = m_nodes[current].bbox;
-                    m_nodes[newRoot].bbox.expand(m_nodes[newSibling].bbox);
-                    m_nodes[newRoot].children.push_back(current);
-                    m_nodes[newRoot].children.push_back(newSibling);
-                    m_nodes[current].parent = newRoot;
-                    m_nodes[newSibling].parent = newRoot;
-                    m_root = newRoot;
-                    newSibling = -1;  // done
-                } else {
-                    // Insert newSibling into parent
-                    m_nodes[parent].children.push_back(newSibling);
-                    m_nodes[newSibling].parent = parent;
-                    recomputeBBox(parent);
-                    current = parent;
-                    newSibling = -1;
-                    // If parent overflows, split it and continue upward
-                    if (static_cast<int>(m_nodes[current].children.size()) > MaxChildren) {
-                        newSibling = splitInternalNode(current);
-                    }
+        // Internal levels.
+        while (level.size() > 1) {
+            tileSort(level, [](const auto& e) -> const Box& { return e.second; });
+
+            std::vector<std::pair<int, Box>> next;
+            next.reserve((level.size() + MaxChildren - 1) / MaxChildren);
+            for (size_t i = 0; i < level.size(); i += MaxChildren) {
+                const size_t end = std::min(level.size(), i + static_cast<size_t>(MaxChildren));
+                const int nodeIdx = allocateNode();
+                m_nodes[nodeIdx].isLeaf = false;
+                for (size_t j = i; j < end; ++j) {
+                    appendChild(nodeIdx, level[j].first, level[j].second);
                 }
+                next.emplace_back(nodeIdx, nodeBox(nodeIdx));
             }
-
-            // Propagate bbox enlargement up to root
-            propagateBBox(leafIdx);
+            level.swap(next);
         }
-        ++m_size;
+
+        m_root = level.front().first;
+        m_nodes[m_root].parent = -1;
+        m_size = n;
+    }
+
+    /// Insert a value with its bounding box.
+    void insert(const ValueT& value, const BoundingBox& bbox) { insertBox(value, toBox(bbox)); }
+
+    /// Visit every value whose bounding box intersects the search box, without
+    /// allocating. `visit(value)` may return bool; returning false stops the
+    /// traversal early. Returns false if the visitor stopped it.
+    template <typename Visitor>
+        requires std::invocable<Visitor&, const ValueT&>
+    bool query(const BoundingBox& searchBox, Visitor&& visit) const {
+        if (m_size == 0 || !searchBox.isValid()) return true;
+        return queryNode(m_root, toBox(searchBox), visit);
+    }
+
+    /// Query into a caller-owned buffer, which is cleared first. Reusing the
+    /// same buffer across queries (e.g. per frame) avoids reallocating it.
+    void query(const BoundingBox& searchBox, std::vector<ValueT>& results) const {
+        results.clear();
+        query(searchBox, [&results](const ValueT& value) { results.push_back(value); });
     }
 
     /// Query all values whose bounding boxes intersect the search box.
     [[nodiscard]] std::vector<ValueT> query(const BoundingBox& searchBox) const {
         std::vector<ValueT> results;
-        if (m_size == 0) return results;
-        queryNode(m_root, searchBox, results);
+        query(searchBox, results);
         return results;
     }
 
+    /// One result of a nearest-neighbour query.
+    struct Neighbor {
+        ValueT value;
+        double distance;
+    };
+
+    /// 2D distance from a point to a box (0 if the point lies inside it).
+    static double boxDistance(const Vec2& point, const BoundingBox& bb) {
+        return boxDistance(point, toBox(bb));
+    }
+
+    /// Best-first incremental nearest-neighbour traversal (Hjaltason & Samet).
+    ///
+    /// Nodes and entries are expanded in order of their box distance from
+    /// `point`; an entry's exact distance is only computed, via
+    /// `distanceFn(value, bbox)`, once it reaches the front of the queue.
+    /// Values are then reported to `visitor(value, distance)` in ascending
+    /// exact distance until the visitor returns false or nothing within
+    /// `maxDist` remains.
+    ///
+    /// `distanceFn` must never return less than boxDistance(point, bbox) (true
+    /// for any distance to geometry contained in the box); returning a value
+    /// above `maxDist` (e.g. infinity) rejects the entry.
+    template <typename DistanceFn, typename Visitor>
+    void visitNearest(const Vec2& point, double maxDist, DistanceFn&& distanceFn,
+                      Visitor&& visitor) const {
+        if (m_size == 0) return;
+
+        // slot < 0: a node; slot >= 0 with !exact: a leaf entry keyed by its
+        // box distance; exact: a leaf entry keyed by distanceFn.
+        struct Item {
+            double dist;
+            int node;
+            int slot;
+            bool exact;
+        };
+        auto farther = [](const Item& a, const Item& b) { return a.dist > b.dist; };
+        std::priority_queue<Item, std::vector<Item>, decltype(farther)> queue(farther);
+
+        const double rootDist = boxDistance(point, nodeBox(m_root));
+        if (rootDist <= maxDist) queue.push(Item{rootDist, m_root, -1, false});
+
+        while (!queue.empty()) {
+            const Item item = queue.top();
+            queue.pop();
+            const Node& node = m_nodes[item.node];
+
+            if (item.slot < 0) {
+                for (int i = 0; i < node.count; ++i) {
+                    const double d = boxDistance(point, slotBox(node, i));
+                    if (d > maxDist) continue;
+                    if (node.isLeaf) {
+                        queue.push(Item{d, item.node, i, false});
+                    } else {
+                        queue.push(Item{d, node.child[i], -1, false});
+                    }
+                }
+            } else if (!item.exact) {
+                const double d = distanceFn(node.value[item.slot],
+                                            toBoundingBox(slotBox(node, item.slot)));
+                if (d <= maxDist) {
+                    queue.push(Item{std::max(d, item.dist), item.node, item.slot, true});
+                }
+            } else {
+                if (!visitor(node.value[item.slot], item.dist)) return;
+            }
+        }
+    }
+
+    /// The (up to) k values nearest to `point` within `maxDist`, sorted by
+    /// ascending distance as measured by `distanceFn(value, bbox)`.
+    /// See visitNearest() for the contract on `distanceFn`.
+    template <typename DistanceFn>
+    [[nodiscard]] std::vector<Neighbor> nearest(const Vec2& point, size_t k, double maxDist,
+                                                DistanceFn&& distanceFn) const {
+        std::vector<Neighbor> results;
+        if (k == 0) return results;
+        visitNearest(point, maxDist, distanceFn, [&results, k](const ValueT& v, double d) {
+            results.push_back(Neighbor{v, d});
+            return results.size() < k;
+        });
+        return results;
+    }
+
+    /// The (up to) k values whose boxes are nearest to `point`.
+    [[nodiscard]] std::vector<Neighbor> nearest(
+        const Vec2& point, size_t k,
+        double maxDist = std::numeric_limits<double>::infinity()) const {
+        return nearest(point, k, maxDist, [&point](const ValueT&, const BoundingBox& bb) {
+            return boxDistance(point, bb);
+        });
+    }
+
     /// Number of entries in the tree.
     [[nodiscard]] size_t size() const { return m_size; }
 
     /// Whether the tree is empty.
     [[nodiscard]] bool empty() const { return m_size == 0; }
 
+    /// Box enclosing every entry (invalid when the tree is empty).
+    [[nodiscard]] BoundingBox bounds() const { return toBoundingBox(nodeBox(m_root)); }
+
+    /// Whether the value is stored in the tree.
+    [[nodiscard]] bool contains(const ValueT& value) const {
+        return m_leafOf.find(value) != m_leafOf.end();
+    }
+
     /// Remove all entries and reset the tree.
     void clear() {
         m_nodes.clear();
+        m_freeNodes.clear();
+        m_leafOf.clear();
         m_size = 0;
         m_root = allocateNode();
-        m_nodes[m_root].isLeaf = true;
-        m_nodes[m_root].parent = -1;
     }
 
     /// Remove a value from the tree.
-    /// Uses collect-all / clear / re-insert strategy — O(n log n) but correct.
-    /// If the value is not present this is a no-op.
-    void remove(const ValueT& value) {
-        // Collect every (value, bbox) pair except the one being removed.
-        std::vector<std::pair<ValueT, BoundingBox>> entries;
-        entries.reserve(m_size);
-        bool found = collectEntries(m_root, value, entries);
-        if (!found) return;  // nothing to do
-
-        // Rebuild from scratch.
-        clear();
-        for (auto& [v, bb] : entries) {
-            insert(v, bb);
+    /// Locates the leaf through the back-pointer map, then condenses the tree
+    /// (Guttman/R*): underfull nodes on the path to the root are detached and
+    /// their entries re-inserted, ancestor boxes are tightened, and a root
+    /// left with a single child is collapsed. O(log n) amortised.
+    /// Returns false (no-op) if the value is not present.
+    bool remove(const ValueT& value) {
+        auto it = m_leafOf.find(value);
+        if (it == m_leafOf.end()) return false;
+        const int leafIdx = it->second;
+        m_leafOf.erase(it);
+
+        Node& leaf = m_nodes[leafIdx];
+        const int slot = slotOfValue(leaf, value);
+        if (slot >= 0) removeSlot(leaf, slot);
+        --m_size;
+
+        condenseTree(leafIdx);
+        return true;
+    }
+
+    /// Move a stored value to a new bounding box.
+    /// If the new box still fits inside the owning leaf's box the entry is
+    /// patched in place and only the boxes on the leaf-to-root path are
+    /// re-tightened; otherwise the value is removed and re-inserted.
+    /// Returns false (no-op) if the value is not present.
+    bool update(const ValueT& value, const BoundingBox& newBox) {
+        auto it = m_leafOf.find(value);
+        if (it == m_leafOf.end()) return false;
+        const int leafIdx = it->second;
+
+        const Box box = toBox(newBox);
+        Node& leaf = m_nodes[leafIdx];
+        const int slot = slotOfValue(leaf, value);
+        if (slot >= 0 && newBox.isValid() && containsBox(nodeBox(leafIdx), box)) {
+            setSlot(leaf, slot, box);
+            refreshAncestors(leafIdx);
+            return true;
         }
+
+        remove(value);
+        insertBox(value, box);
+        return true;
     }
 
 private:
-    struct Entry {
-        ValueT value;
-        BoundingBox bbox;
+    /// One spare slot lets a node overflow by one entry before it is split.
+    static constexpr int kCapacity = MaxChildren + 1;
+    static constexpr double kEmptyLo = std::numeric_limits<double>::max();
+    static constexpr double kEmptyHi = -std::numeric_limits<double>::max();
+
+    /// Axis-aligned box over the indexed axes; lo > hi on axis 0 means empty.
+    struct Box {
+        std::array<double, Dims> lo;
+        std::array<double, Dims> hi;
     };
 
+    /// Fixed-capacity node. Slot i holds either a child node index (internal)
+    /// or a value (leaf), with its box split across the per-axis lo/hi arrays.
+    /// Unused slots hold an empty box so they never pass an overlap test.
     struct Node {
-        bool isLeaf = true;
+        std::array<std::array<double, kCapacity>, Dims> lo;
+        std::array<std::array<double, kCapacity>, Dims> hi;
+        std::array<int, kCapacity> child;
+        std::array<ValueT, kCapacity> value{};
+        int count = 0;
         int parent = -1;
-        BoundingBox bbox;
-        std::vector<Entry> entries;  // only used if isLeaf
-        std::vector<int> children;   // only used if !isLeaf
+        bool isLeaf = true;
+
+        Node() {
+            for (int axis = 0; axis < Dims; ++axis) {
+                lo[axis].fill(kEmptyLo);
+                hi[axis].fill(kEmptyHi);
+            }
+            child.fill(-1);
+        }
     };
 
     std::vector<Node> m_nodes;
+    std::vector<int> m_freeNodes;             // detached nodes available for reuse
+    std::unordered_map<ValueT, int> m_leafOf;  // value -> index of owning leaf
     int m_root = 0;
     size_t m_size = 0;
 
-    /// Allocate a new node in the flat vector, return its index.
+    // --- Box helpers ---
+
+    static Box emptyBox() {
+        Box b;
+        b.lo.fill(kEmptyLo);
+        b.hi.fill(kEmptyHi);
+        return b;
+    }
+
+    static bool isEmpty(const Box& b) { return b.lo[0] > b.hi[0]; }
+
+    static Box toBox(const BoundingBox& bb) {
+        if (!bb.isValid()) return emptyBox();
+        Box b;
+        b.lo[0] = bb.min().x;
+        b.lo[1] = bb.min().y;
+        b.hi[0] = bb.max().x;
+        b.hi[1] = bb.max().y;
+        if constexpr (Dims == 3) {
+            b.lo[2] = bb.min().z;
+            b.hi[2] = bb.max().z;
+        }
+        return b;
+    }
+
+    /// Inverse of toBox(); a 2D box maps to the z = 0 plane.
+    static BoundingBox toBoundingBox(const Box& b) {
+        if (isEmpty(b)) return BoundingBox{};
+        if constexpr (Dims == 3) {
+            return BoundingBox(Vec3(b.lo[0], b.lo[1], b.lo[2]), Vec3(b.hi[0], b.hi[1], b.hi[2]));
+        } else {
+            return BoundingBox(Vec3(b.lo[0], b.lo[1], 0.0), Vec3(b.hi[0], b.hi[1], 0.0));
+        }
+    }
+
+    static void expandBox(Box& base, const Box& addition) {
+        for (int axis = 0; axis < Dims; ++axis) {
+            base.lo[axis] = std::min(base.lo[axis], addition.lo[axis]);
+            base.hi[axis] = std::max(base.hi[axis], addition.hi[axis]);
+        }
+    }
+
+    static bool containsBox(const Box& outer, const Box& inner) {
+        if (isEmpty(outer) || isEmpty(inner)) return false;
+        for (int axis = 0; axis < Dims; ++axis) {
+            if (inner.lo[axis] < outer.lo[axis] || inner.hi[axis] > outer.hi[axis]) return false;
+        }
+        return true;
+    }
+
+    /// 2D area of a box (x * y, ignoring z), used by the split heuristics.
+    static double boxArea(const Box& b) {
+        if (isEmpty(b)) return 0.0;
+        return (b.hi[0] - b.lo[0]) * (b.hi[1] - b.lo[1]);
+    }
+
+    /// The 2D area enlargement needed to include `addition` in `base`.
+    static double areaEnlargement(const Box& base, const Box& addition) {
+        Box merged = base;
+        expandBox(merged, addition);
+        return boxArea(merged) - boxArea(base);
+    }
+
+    static double boxDistance(const Vec2& point, const Box& b) {
+        if (isEmpty(b)) return std::numeric_limits<double>::infinity();
+        const double dx = std::max({b.lo[0] - point.x, 0.0, point.x - b.hi[0]});
+        const double dy = std::max({b.lo[1] - point.y, 0.0, point.y - b.hi[1]});
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // --- Slot helpers ---
+
+    static Box slotBox(const Node& node, int slot) {
+        Box b;
+        for (int axis = 0; axis < Dims; ++axis) {
+            b.lo[axis] = node.lo[axis][slot];
+            b.hi[axis] = node.hi[axis][slot];
+        }
+        return b;
+    }
+
+    static void setSlot(Node& node, int slot, const Box& b) {
+        for (int axis = 0; axis < Dims; ++axis) {
+            node.lo[axis][slot] = b.lo[axis];
+            node.hi[axis][slot] = b.hi[axis];
+        }
+    }
+
+    /// Union of a node's slot boxes.
+    Box nodeBox(int nodeIdx) const {
+        const Node& node = m_nodes[nodeIdx];
+        Box b = emptyBox();
+        for (int i = 0; i < node.count; ++i) {
+            expandBox(b, slotBox(node, i));
+        }
+        return b;
+    }
+
+    /// Bitmask of the node's slots whose boxes intersect `q`. Runs over every
+    /// slot with a fixed trip count and no branches so it vectorises; unused
+    /// slots hold empty boxes and are masked off by count anyway.
+    static uint64_t overlapMask(const Node& node, const Box& q) {
+        uint64_t mask = 0;
+        for (int i = 0; i < kCapacity; ++i) {
+            unsigned hit = 1u;
+            for (int axis = 0; axis < Dims; ++axis) {
+                hit &= static_cast<unsigned>(node.lo[axis][i] <= q.hi[axis]) &
+                       static_cast<unsigned>(node.hi[axis][i] >= q.lo[axis]);
+            }
+            mask |= static_cast<uint64_t>(hit) << i;
+        }
+        return mask & ((uint64_t{1} << node.count) - 1);
+    }
+
+    void appendEntry(int leafIdx, const ValueT& value, const Box& b) {
+        Node& leaf = m_nodes[leafIdx];
+        const int slot = leaf.count++;
+        leaf.value[slot] = value;
+        setSlot(leaf, slot, b);
+        m_leafOf[value] = leafIdx;
+    }
+
+    void appendChild(int nodeIdx, int childIdx, const Box& b) {
+        Node& node = m_nodes[nodeIdx];
+        const int slot = node.count++;
+        node.child[slot] = childIdx;
+        setSlot(node, slot, b);
+        m_nodes[childIdx].parent = nodeIdx;
+    }
+
+    /// Remove a slot by moving the last slot into its place.
+    static void removeSlot(Node& node, int slot) {
+        const int last = --node.count;
+        if (slot != last) {
+            setSlot(node, slot, slotBox(node, last));
+            node.child[slot] = node.child[last];
+            node.value[slot] = std::move(node.value[last]);
+        }
+        setSlot(node, last, emptyBox());
+        node.child[last] = -1;
+        node.value[last] = ValueT{};
+    }
+
+    static int slotOfChild(const Node& node, int childIdx) {
+        for (int i = 0; i < node.count; ++i) {
+            if (node.child[i] == childIdx) return i;
+        }
+        return -1;
+    }
+
+    static int slotOfValue(const Node& node, const ValueT& value) {
+        for (int i = 0; i < node.count; ++i) {
+            if (node.value[i] == value) return i;
+        }
+        return -1;
+    }
+
+    // --- Node management ---
+
+    /// Allocate a new node in the flat vector (reusing a freed slot if any),
+    /// return its index.
     int allocateNode() {
+        if (!m_freeNodes.empty()) {
+            int idx = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            return idx;
+        }
         m_nodes.emplace_back();
         return static_cast<int>(m_nodes.size()) - 1;
     }
 
-    /// Compute 2D area of a bounding box (x * y, ignoring z).
-    static double bboxArea(const BoundingBox& bb) {
-        if (!bb.isValid()) return 0.0;
-        Vec3 s = bb.size();
-        return s.x * s.y;
+    /// Return a detached node to the free list.
+    void freeNode(int nodeIdx) {
+        m_nodes[nodeIdx] = Node{};
+        m_freeNodes.push_back(nodeIdx);
     }
 
-    /// Compute the 2D area enlargement needed to include `addition` in `base`.
-    static double areaEnlargement(const BoundingBox& base, const BoundingBox& addition) {
-        BoundingBox merged = base;
-        merged.expand(addition);
-        return bboxArea(merged) - bboxArea(base);
+    void insertBox(const ValueT& value, const Box& b) {
+        const int leafIdx = chooseLeaf(b);
+        appendEntry(leafIdx, value, b);
+        ++m_size;
+        adjustTree(leafIdx, m_nodes[leafIdx].count > MaxChildren ? splitNode(leafIdx) : -1);
     }
 
-    /// Choose the best leaf node to insert a new entry with the given bbox.
-    int chooseLeaf(int nodeIdx, const BoundingBox& bbox) const {
+    /// Walk from `nodeIdx` to the root refreshing each parent's slot box and
+    /// propagating a split: `siblingIdx` (if >= 0) is the node split off from
+    /// `nodeIdx` and still needs a parent slot.
+    void adjustTree(int nodeIdx, int siblingIdx) {
         int current = nodeIdx;
-        while (!m_nodes[current].isLeaf) {
-            const auto& children = m_nodes[current].children;
-            int bestChild = children[0];
-            double bestEnlargement = areaEnlargement(m_nodes[children[0]].bbox, bbox);
-            double bestArea = bboxArea(m_nodes[children[0]].bbox);
-
-            for (size_t i = 1; i < children.size(); ++i) {
-                double enlargement = areaEnlargement(m_nodes[children[i]].bbox, bbox);
-                double area = bboxArea(m_nodes[children[i]].bbox);
-                if (enlargement < bestEnlargement ||
-                    (enlargement == bestEnlargement && area < bestArea)) {
-                    bestChild = children[i];
-                    bestEnlargement = enlargement;
-                    bestArea = area;
+        int sibling = siblingIdx;
+        while (true) {
+            const int parent = m_nodes[current].parent;
+            if (parent < 0) {
+                if (sibling >= 0) {
+                    // current is root -- grow a new root holding current and sibling
+                    const int newRoot = allocateNode();
+                    m_nodes[newRoot].isLeaf = false;
+                    appendChild(newRoot, current, nodeBox(current));
+                    appendChild(newRoot, sibling, nodeBox(sibling));
+                    m_root = newRoot;
                 }
+                return;
             }
-            current = bestChild;
+            setSlot(m_nodes[parent], slotOfChild(m_nodes[parent], current), nodeBox(current));
+            if (sibling >= 0) appendChild(parent, sibling, nodeBox(sibling));
+            sibling = m_nodes[parent].count > MaxChildren ? splitNode(parent) : -1;
+            current = parent;
         }
-        return current;
     }
 
-    /// Quadratic split for a leaf node that has overflowed.
-    /// Distributes entries between existing node and a new sibling.
-    /// Returns the index of the new sibling node.
-    int splitNode(int nodeIdx) {
-        auto& node = m_nodes[nodeIdx];
-        auto entries = std::move(node.entries);
-        node.entries.clear();
-
-        int newIdx = allocateNode();
-        // IMPORTANT: after allocateNode, references to m_nodes elements are
-        // potentially invalidated. Re-acquire references.
-        auto& left = m_nodes[nodeIdx];
-        auto& right = m_nodes[newIdx];
-        right.isLeaf = true;
-        right.parent = left.parent;
+    /// Re-tighten the parent slot boxes on the path from a node to the root.
+    void refreshAncestors(int nodeIdx) {
+        int current = nodeIdx;
+        int parent = m_nodes[current].parent;
+        while (parent >= 0) {
+            Node& p = m_nodes[parent];
+            setSlot(p, slotOfChild(p, current), nodeBox(current));
+            current = parent;
+            parent = p.parent;
+        }
+    }
 
-        // Pick seeds: the pair with the largest waste (area of combined bbox
-        // minus individual areas).
-        int seed1 = 0, seed2 = 1;
-        double worstWaste = -std::numeric_limits<double>::max();
-        for (size_t i = 0; i < entries.size(); ++i) {
-            for (size_t j = i + 1; j < entries.size(); ++j) {
-                BoundingBox merged = entries[i].bbox;
-                merged.expand(entries[j].bbox);
-                double waste =
-                    bboxArea(merged) - bboxArea(entries[i].bbox) - bboxArea(entries[j].bbox);
-                if (waste > worstWaste) {
-                    worstWaste = waste;
-                    seed1 = static_cast<int>(i);
-                    seed2 = static_cast<int>(j);
-                }
+    /// Condense the tree after an entry was removed from `leafIdx`.
+    void condenseTree(int leafIdx) {
+        std::vector<std::pair<ValueT, Box>> orphans;
+        int current = leafIdx;
+        while (current != m_root) {
+            const int parent = m_nodes[current].parent;
+            Node& p = m_nodes[parent];
+            const int slot = slotOfChild(p, current);
+            if (m_nodes[current].count < MinChildren) {
+                removeSlot(p, slot);
+                releaseSubtree(current, orphans);
+            } else {
+                setSlot(p, slot, nodeBox(current));
             }
+            current = parent;
         }
 
-        left.entries.push_back(entries[seed1]);
-        left.bbox = entries[seed1].bbox;
-        right.entries.push_back(entries[seed2]);
-        right.bbox = entries[seed2].bbox;
-
-        // Mark seeds as assigned
-        std::vector<bool> assigned(entries.size(), false);
-        assigned[seed1] = true;
-        assigned[seed2] = true;
-
-        // Distribute remaining entries
-        for (size_t round = 0; round < entries.size(); ++round) {
-            // Check if all assigned
-            bool allDone = true;
-            for (size_t i = 0; i < entries.size(); ++i) {
-                if (!assigned[i]) {
-                    allDone = false;
-                    break;
-                }
-            }
-            if (allDone) break;
+        // Collapse single-child roots.
+        while (!m_nodes[m_root].isLeaf && m_nodes[m_root].count == 1) {
+            const int child = m_nodes[m_root].child[0];
+            freeNode(m_root);
+            m_root = child;
+            m_nodes[m_root].parent = -1;
+        }
 
-            // If one group needs all remaining to reach MinChildren, assign them
-            int remaining = 0;
-            for (size_t i = 0; i < entries.size(); ++i) {
-                if (!assigned[i]) ++remaining;
-            }
-            if (static_cast<int>(m_nodes[nodeIdx].entries.size()) + remaining <= MinChildren) {
-                for (size_t i = 0; i < entries.size(); ++i) {
-                    if (!assigned[i]) {
-                        m_nodes[nodeIdx].entries.push_back(entries[i]);
-                        m_nodes[nodeIdx].bbox.expand(entries[i].bbox);
-                        assigned[i] = true;
-                    }
-                }
-                break;
-            }
-            if (static_cast<int>(m_nodes[newIdx].entries.size()) + remaining <= MinChildren) {
-                for (size_t i = 0; i < entries.size(); ++i) {
-                    if (!assigned[i]) {
-                        m_nodes[newIdx].entries.push_back(entries[i]);
-                        m_nodes[newIdx].bbox.expand(entries[i].bbox);
-                        assigned[i] = true;
-                    }
-                }
-                break;
-            }
+        m_size -= orphans.size();
+        if (m_size == 0) clear();
+        for (const auto& [value, box] : orphans) {
+            insertBox(value, box);
+        }
+    }
 
-            // Pick the entry with maximum preference difference
-            int bestEntry = -1;
-            double bestDiff = -std::numeric_limits<double>::max();
-            for (size_t i = 0; i < entries.size(); ++i) {
-                if (assigned[i]) continue;
-                double d1 = areaEnlargement(m_nodes[nodeIdx].bbox, entries[i].bbox);
-                double d2 = areaEnlargement(m_nodes[newIdx].bbox, entries[i].bbox);
-                double diff = std::abs(d1 - d2);
-                if (diff > bestDiff) {
-                    bestDiff = diff;
-                    bestEntry = static_cast<int>(i);
-                }
+    /// Free every node of a detached subtree, moving its leaf entries to `out`.
+    void releaseSubtree(int nodeIdx, std::vector<std::pair<ValueT, Box>>& out) {
+        Node& node = m_nodes[nodeIdx];
+        for (int i = 0; i < node.count; ++i) {
+            if (node.isLeaf) {
+                m_leafOf.erase(node.value[i]);
+                out.emplace_back(std::move(node.value[i]), slotBox(node, i));
+            } else {
+                releaseSubtree(node.child[i], out);
             }
+        }
+        freeNode(nodeIdx);
+    }
 
-            if (bestEntry < 0) break;
+    /// Upper bound on the node count of an STR-packed tree holding n entries.
+    static size_t estimatePackedNodeCount(size_t n) {
+        size_t total = 0;
+        size_t levelCount = n;
+        do {
+            levelCount = (levelCount + MaxChildren - 1) / MaxChildren;
+            total += levelCount;
+        } while (levelCount > 1);
+        return total;
+    }
 
-            double enlLeft = areaEnlargement(m_nodes[nodeIdx].bbox, entries[bestEntry].bbox);
-            double enlRight = areaEnlargement(m_nodes[newIdx].bbox, entries[bestEntry].bbox);
-            if (enlLeft < enlRight || (enlLeft == enlRight && bboxArea(m_nodes[nodeIdx].bbox) <=
-                                                                  bboxArea(m_nodes[newIdx].bbox))) {
-                m_nodes[nodeIdx].entries.push_back(entries[bestEntry]);
-                m_nodes[nodeIdx].bbox.expand(entries[bestEntry].bbox);
-            } else {
-                m_nodes[newIdx].entries.push_back(entries[bestEntry]);
-                m_nodes[newIdx].bbox.expand(entries[bestEntry].bbox);
-            }
-            assigned[bestEntry] = true;
+    /// Sort-Tile-Recursive ordering of one tree level: sort by x-center, then
+    /// sort each vertical slice of sliceCount * MaxChildren items by y-center,
+    /// so consecutive runs of MaxChildren items form compact tiles.
+    template <typename T, typename BoxOf>
+    static void tileSort(std::vector<T>& items, BoxOf boxOf) {
+        const size_t n = items.size();
+        if (n <= static_cast<size_t>(MaxChildren)) return;
+
+        // Centers are compared doubled (lo + hi) to avoid the division. Ties
+        // are broken on the other axis: CAD data is often grid-aligned, and an
+        // arbitrary order among equal x-centers would scatter a partial column
+        // across a slice's leaves and inflate their boxes.
+        auto byX = [&boxOf](const T& a, const T& b) {
+            const Box& ba = boxOf(a);
+            const Box& bb = boxOf(b);
+            const double ax = ba.lo[0] + ba.hi[0];
+            const double bx = bb.lo[0] + bb.hi[0];
+            if (ax != bx) return ax < bx;
+            return ba.lo[1] + ba.hi[1] < bb.lo[1] + bb.hi[1];
+        };
+        auto byY = [&boxOf](const T& a, const T& b) {
+            const Box& ba = boxOf(a);
+            const Box& bb = boxOf(b);
+            const double ay = ba.lo[1] + ba.hi[1];
+            const double by = bb.lo[1] + bb.hi[1];
+            if (ay != by) return ay < by;
+            return ba.lo[0] + ba.hi[0] < bb.lo[0] + bb.hi[0];
+        };
+
+        const size_t nodeCount = (n + MaxChildren - 1) / MaxChildren;
+        const auto sliceCount =
+            static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+        const size_t sliceSize = sliceCount * static_cast<size_t>(MaxChildren);
+
+        std::sort(items.begin(), items.end(), byX);
+        for (size_t i = 0; i < n; i += sliceSize) {
+            const size_t end = std::min(n, i + sliceSize);
+            std::sort(items.begin() + static_cast<std::ptrdiff_t>(i),
+                      items.begin() + static_cast<std::ptrdiff_t>(end), byY);
         }
+    }
 
-        return newIdx;
+    /// Choose the best leaf node to insert a new entry with the given box.
+    int chooseLeaf(const Box& b) const {
+        int current = m_root;
+        while (!m_nodes[current].isLeaf) {
+            const Node& node = m_nodes[current];
+            int best = 0;
+            double bestEnlargement = areaEnlargement(slotBox(node, 0), b);
+            double bestArea = boxArea(slotBox(node, 0));
+
+            for (int i = 1; i < node.count; ++i) {
+                const Box childBox = slotBox(node, i);
+                const double enlargement = areaEnlargement(childBox, b);
+                const double area = boxArea(childBox);
+                if (enlargement < bestEnlargement ||
+                    (enlargement == bestEnlargement && area < bestArea)) {
+                    best = i;
+                    bestEnlargement = enlargement;
+                    bestArea = area;
+                }
+            }
+            current = node.child[best];
+        }
+        return current;
     }
 
-    /// Quadratic split for an internal node that has overflowed.
-    /// Distributes children between existing node and a new sibling.
+    /// Quadratic split for a node (leaf or internal) that has overflowed.
+    /// Distributes its slots between the existing node and a new sibling.
     /// Returns the index of the new sibling node.
-    int splitInternalNode(int nodeIdx) {
-        auto children = std::move(m_nodes[nodeIdx].children);
-        m_nodes[nodeIdx].children.clear();
-
-        int newIdx = allocateNode();
-        // Re-acquire references after potential reallocation
-        auto& left = m_nodes[nodeIdx];
-        auto& right = m_nodes[newIdx];
-        right.isLeaf = false;
+    int splitNode(int nodeIdx) {
+        const int newIdx = allocateNode();
+        // allocateNode may reallocate m_nodes: take references only now.
+        Node& left = m_nodes[nodeIdx];
+        Node& right = m_nodes[newIdx];
+        right.isLeaf = left.isLeaf;
         right.parent = left.parent;
 
-        // Pick seeds
+        const int total = left.count;
+        std::array<Box, kCapacity> boxes;
+        std::array<int, kCapacity> children;
+        std::array<ValueT, kCapacity> values;
+        for (int i = 0; i < total; ++i) {
+            boxes[i] = slotBox(left, i);
+            children[i] = left.child[i];
+            values[i] = std::move(left.value[i]);
+        }
+        const bool isLeaf = left.isLeaf;
+        const int parent = left.parent;
+        left = Node{};
+        left.isLeaf = isLeaf;
+        left.parent = parent;
+
+        std::array<bool, kCapacity> assigned{};
+        auto assign = [&](int i, int target) {
+            if (isLeaf) {
+                appendEntry(target, values[i], boxes[i]);
+            } else {
+                appendChild(target, children[i], boxes[i]);
+            }
+            assigned[i] = true;
+        };
+
+        // Pick seeds: the pair with the largest waste (area of combined box
+        // minus individual areas).
         int seed1 = 0, seed2 = 1;
         double worstWaste = -std::numeric_limits<double>::max();
-        for (size_t i = 0; i < children.size(); ++i) {
-            for (size_t j = i + 1; j < children.size(); ++j) {
-                BoundingBox merged = m_nodes[children[i]].bbox;
-                merged.expand(m_nodes[children[j]].bbox);
-                double waste = bboxArea(merged) - bboxArea(m_nodes[children[i]].bbox) -
-                               bboxArea(m_nodes[children[j]].bbox);
+        for (int i = 0; i < total; ++i) {
+            for (int j = i + 1; j < total; ++j) {
+                Box merged = boxes[i];
+                expandBox(merged, boxes[j]);
+                const double waste = boxArea(merged) - boxArea(boxes[i]) - boxArea(boxes[j]);
                 if (waste > worstWaste) {
                     worstWaste = waste;
-                    seed1 = static_cast<int>(i);
-                    seed2 = static_cast<int>(j);
+                    seed1 = i;
+                    seed2 = j;
                 }
             }
         }
 
-        left.children.push_back(children[seed1]);
-        left.bbox = m_nodes[children[seed1]].bbox;
-        right.children.push_back(children[seed2]);
-        right.bbox = m_nodes[children[seed2]].bbox;
-
-        std::vector<bool> assigned(children.size(), false);
-        assigned[seed1] = true;
-        assigned[seed2] = true;
-
-        for (size_t round = 0; round < children.size(); ++round) {
-            bool allDone = true;
-            for (size_t i = 0; i < children.size(); ++i) {
-                if (!assigned[i]) {
-                    allDone = false;
-                    break;
-                }
-            }
-            if (allDone) break;
-
-            int remaining = 0;
-            for (size_t i = 0; i < children.size(); ++i) {
-                if (!assigned[i]) ++remaining;
-            }
-            if (static_cast<int>(m_nodes[nodeIdx].children.size()) + remaining <= MinChildren) {
-                for (size_t i = 0; i < children.size(); ++i) {
-                    if (!assigned[i]) {
-                        m_nodes[nodeIdx].children.push_back(children[i]);
-                        m_nodes[children[i]].parent = nodeIdx;
-                        m_nodes[nodeIdx].bbox.expand(m_nodes[children[i]].bbox);
-                        assigned[i] = true;
-                    }
-                }
-                break;
-            }
-            if (static_cast<int>(m_nodes[newIdx].children.size()) + remaining <= MinChildren) {
-                for (size_t i = 0; i < children.size(); ++i) {
-                    if (!assigned[i]) {
-                        m_nodes[newIdx].children.push_back(children[i]);
-                        m_nodes[children[i]].parent = newIdx;
-                        m_nodes[newIdx].bbox.expand(m_nodes[children[i]].bbox);
-                        assigned[i] = true;
-                    }
+        Box leftBox = boxes[seed1];
+        Box rightBox = boxes[seed2];
+        assign(seed1, nodeIdx);
+        assign(seed2, newIdx);
+
+        for (int remaining = total - 2; remaining > 0; --remaining) {
+            // If one group needs all remaining slots to reach MinChildren,
+            // assign them.
+            const int fillTarget = left.count + remaining <= MinChildren    ? nodeIdx
+                                   : right.count + remaining <= MinChildren ? newIdx
+                                                                            : -1;
+            if (fillTarget >= 0) {
+                for (int i = 0; i < total; ++i) {
+                    if (!assigned[i]) assign(i, fillTarget);
                 }
                 break;
             }
 
-            int bestEntry = -1;
+            // Pick the slot with maximum preference difference.
+            int best = -1;
             double bestDiff = -std::numeric_limits<double>::max();
-            for (size_t i = 0; i < children.size(); ++i) {
+            for (int i = 0; i < total; ++i) {
                 if (assigned[i]) continue;
-                double d1 = areaEnlargement(m_nodes[nodeIdx].bbox, m_nodes[children[i]].bbox);
-                double d2 = areaEnlargement(m_nodes[newIdx].bbox, m_nodes[children[i]].bbox);
-                double diff = std::abs(d1 - d2);
+                const double diff = std::abs(areaEnlargement(leftBox, boxes[i]) -
+                                             areaEnlargement(rightBox, boxes[i]));
                 if (diff > bestDiff) {
                     bestDiff = diff;
-                    bestEntry = static_cast<int>(i);
+                    best = i;
                 }
             }
 
-            if (bestEntry < 0) break;
-
-            double enlLeft =
-                areaEnlargement(m_nodes[nodeIdx].bbox, m_nodes[children[bestEntry]].bbox);
-            double enlRight =
-                areaEnlargement(m_nodes[newIdx].bbox, m_nodes[children[bestEntry]].bbox);
-            if (enlLeft < enlRight || (enlLeft == enlRight && bboxArea(m_nodes[nodeIdx].bbox) <=
-                                                                  bboxArea(m_nodes[newIdx].bbox))) {
-                m_nodes[nodeIdx].children.push_back(children[bestEntry]);
-                m_nodes[children[bestEntry]].parent = nodeIdx;
-                m_nodes[nodeIdx].bbox.expand(m_nodes[children[bestEntry]].bbox);
+            const double enlLeft = areaEnlargement(leftBox, boxes[best]);
+            const double enlRight = areaEnlargement(rightBox, boxes[best]);
+            if (enlLeft < enlRight ||
+                (enlLeft == enlRight && boxArea(leftBox) <= boxArea(rightBox))) {
+                expandBox(leftBox, boxes[best]);
+                assign(best, nodeIdx);
             } else {
-                m_nodes[newIdx].children.push_back(children[bestEntry]);
-                m_nodes[children[bestEntry]].parent = newIdx;
-                m_nodes[newIdx].bbox.expand(m_nodes[children[bestEntry]].bbox);
+                expandBox(rightBox, boxes[best]);
+                assign(best, newIdx);
             }
-            assigned[bestEntry] = true;
-        }
-
-        // Update parent pointers for children that ended up in right
-        for (int childIdx : m_nodes[newIdx].children) {
-            m_nodes[childIdx].parent = newIdx;
-        }
-        // Update parent pointers for children that stayed in left
-        for (int childIdx : m_nodes[nodeIdx].children) {
-            m_nodes[childIdx].parent = nodeIdx;
         }
 
         return newIdx;
     }
 
-    /// Recompute a node's bounding box from its children (internal) or entries (leaf).
-    void recomputeBBox(int nodeIdx) {
-        auto& node = m_nodes[nodeIdx];
-        node.bbox.reset();
-        if (node.isLeaf) {
-            for (const auto& entry : node.entries) {
-                node.bbox.expand(entry.bbox);
-            }
-        } else {
-            for (int childIdx : node.children) {
-                node.bbox.expand(m_nodes[childIdx].bbox);
-            }
-        }
-    }
-
-    /// Propagate bounding box enlargement from a node up to the root.
-    void propagateBBox(int nodeIdx) {
-        int current = m_nodes[nodeIdx].parent;
-        while (current >= 0) {
-            recomputeBBox(current);
-            current = m_nodes[current].parent;
-        }
-    }
-
-    /// Recursively collect all (value, bbox) entries, excluding one specific value.
-    /// Returns true if the excluded value was found at least once.
-    bool collectEntries(int nodeIdx, const ValueT& exclude,
-                        std::vector<std::pair<ValueT, BoundingBox>>& out) const {
-        const auto& node = m_nodes[nodeIdx];
-        bool found = false;
-        if (node.isLeaf) {
-            for (const auto& entry : node.entries) {
-                if (entry.value == exclude) {
-                    found = true;
-                } else {
-                    out.emplace_back(entry.value, entry.bbox);
-                }
-            }
-        } else {
-            for (int childIdx : node.children) {
-                if (collectEntries(childIdx, exclude, out)) found = true;
-            }
-        }
-        return found;
-    }
-
-    /// Recursively query a node for entries intersecting the search box.
-    void queryNode(int nodeIdx, const BoundingBox& searchBox, std::vector<ValueT>& results) const {
-        const auto& node = m_nodes[nodeIdx];
-        if (!node.bbox.isValid() || !node.bbox.intersects(searchBox)) return;
-
-        if (node.isLeaf) {
-            for (const auto& entry : node.entries) {
-                if (entry.bbox.intersects(searchBox)) {
-                    results.push_back(entry.value);
+    /// Recursively visit the entries under a node that intersect `q`.
+    /// Returns false once the visitor asks to stop.
+    template <typename Visitor>
+    bool queryNode(int nodeIdx, const Box& q, Visitor& visit) const {
+        const Node& node = m_nodes[nodeIdx];
+        for (uint64_t mask = overlapMask(node, q); mask != 0; mask &= mask - 1) {
+            const int i = std::countr_zero(mask);
+            if (node.isLeaf) {
+                if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, const ValueT&>>) {
+                    visit(node.value[i]);
+                } else if (!visit(node.value[i])) {
+                    return false;
                 }
-            }
-        } else {
-            for (int childIdx : node.children) {
-                queryNode(childIdx, searchBox, results);
+            } else if (!queryNode(node.child[i], q, visit)) {
+                return false;
             }
         }
+        return true;
     }
 };
 
+/// RTree over full 3D boxes, for broad phases where z-overlap matters
+/// (solid interference, surface/surface intersection).
+template <typename ValueT>
+using RTree3D = RTree<ValueT, 16, 16 / 3, 3>;
+
 }  // namespace hz::math
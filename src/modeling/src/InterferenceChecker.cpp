@@ -62,7 +62,7 @@ std::vector<InterferencePair> InterferenceChecker::check(
 
     // Broad phase: index every valid solid's AABB in an R*-tree.
     std::vector<BoundingBox> bounds(solids.size());
-    math::RTree<size_t> tree;
+    math::RTree3D<size_t> tree;
     for (size_t i = 0; i < solids.size(); ++i) {
         if (!solids[i]) continue;
         bounds[i] = solidBounds(*solids[i]);
@@ -70,9 +70,11 @@ std::vector<InterferencePair> InterferenceChecker::check(
     }
 
     std::set<std::pair<size_t, size_t>> tested;
+    std::vector<size_t> candidates;
     for (size_t i = 0; i < solids.size(); ++i) {
         if (!solids[i] || !bounds[i].isValid()) continue;
-        for (size_t j : tree.query(bounds[i])) {
+        tree.query(bounds[i], candidates);
+        for (size_t j : candidates) {
             if (j == i || !solids[j]) continue;
             const auto key = std::minmax(i, j);
             if (!tested.insert({key.first, key.second}).second) continue;  // dedup
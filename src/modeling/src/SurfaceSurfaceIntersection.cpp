@@ -162,7 +162,7 @@ SSIResult SurfaceSurfaceIntersection::compute(const topo::Solid& solidA, const t
     }
 
     std::vector<FaceTess> tessB;
-    math::RTree<size_t> treeB;
+    math::RTree3D<size_t> treeB;
     for (size_t i = 0; i < solidB.faces().size(); ++i) {
         const auto& face = solidB.faces()[i];
         if (!face.surface) continue;
@@ -177,8 +177,9 @@ SSIResult SurfaceSurfaceIntersection::compute(const topo::Solid& solidA, const t
     // For each face pair, collect intersection points and build curves.
     std::unordered_map<FacePairKey, std::vector<math::Vec3>, FacePairHash> pairPoints;
 
+    std::vector<size_t> candidates;
     for (const auto& fA : tessA) {
-        auto candidates = treeB.query(fA.bbox);
+        treeB.query(fA.bbox, candidates);
         for (size_t bIdx : candidates) {
             const auto& fB = tessB[bIdx];
 
@@ -61,6 +61,71 @@ public:
     void drawFilledQuad(QOpenGLExtraFunctions* gl, const Camera& camera, const math::Vec2& corner1,
                         const math::Vec2& corner2, const math::Vec4& color);
 
+    // ---- Persistent line buffers ----
+
+    /// A caller-owned GPU line buffer in the drawLines() vertex format.  Its contents
+    /// persist across frames, so static geometry is uploaded once and then only drawn.
+    struct LineBuffer {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        size_t capacityBytes = 0;
+        size_t vertexCount = 0;
+    };
+
+    /// Replace the buffer's contents, creating or growing the GPU storage as needed.
+    void uploadLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer,
+                          const std::vector<float>& lineVertices);
+
+    /// Overwrite `floatCount` floats in place, starting at float `floatOffset`.
+    /// The range must lie within the last upload.
+    void patchLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer, size_t floatOffset,
+                         const float* data, size_t floatCount);
+
+    /// Draw a line buffer's contents (same styling parameters as drawLines()).
+    void drawLineBuffer(QOpenGLExtraFunctions* gl, const Camera& camera,
+                        const LineBuffer& buffer, const math::Vec3& color,
+                        float lineWidth = 1.5f, int lineType = 1, float patternScale = 1.0f);
+
+    /// Release a line buffer's GPU resources.
+    static void destroyLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer);
+
+    // ---- Instanced line buffers ----
+
+    /// Placement of one instance of a shared line buffer: a vertex (x, y) lands at
+    /// offset + (axisX*x - axisY*y, axisY*x + axisX*y), i.e. rotated and uniformly scaled
+    /// by the axis vector.  Pattern distances scale with the axis length.
+    struct LineInstance {
+        float offsetX = 0.0f, offsetY = 0.0f;
+        float axisX = 1.0f, axisY = 0.0f;
+        float r = 1.0f, g = 1.0f, b = 1.0f;  ///< Used by draws without an explicit color.
+
+        bool operator==(const LineInstance&) const = default;
+    };
+
+    /// Per-instance data drawn over the vertices of a LineBuffer, so geometry shared by
+    /// many placements (block definitions) is stored once.
+    struct InstancedLineBuffer {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint geometryVbo = 0;  ///< LineBuffer the VAO reads vertices from.
+        size_t capacityBytes = 0;
+        size_t instanceCount = 0;
+    };
+
+    /// Replace the instances drawn over `geometry`, creating or growing GPU storage.
+    void uploadLineInstances(QOpenGLExtraFunctions* gl, InstancedLineBuffer& instances,
+                             const LineBuffer& geometry, const std::vector<LineInstance>& data);
+
+    /// Draw vertices [firstVertex, firstVertex + vertexCount) of the geometry once per
+    /// instance.  A null `color` takes each instance's own color.
+    void drawLineInstances(QOpenGLExtraFunctions* gl, const Camera& camera,
+                           const InstancedLineBuffer& instances, size_t firstVertex,
+                           size_t vertexCount, const math::Vec3* color, float lineWidth = 1.5f,
+                           int lineType = 1, float patternScale = 1.0f);
+
+    /// Release an instance buffer's GPU resources (not the geometry it draws).
+    static void destroyLineInstances(QOpenGLExtraFunctions* gl, InstancedLineBuffer& instances);
+
     // ---- Section Plane ----
 
     /// Set a clip plane for section-plane rendering (xyz=normal, w=offset).
@@ -95,6 +160,7 @@ private:
 
     ShaderProgram m_phongShader;
     ShaderProgram m_lineShader;
+    ShaderProgram m_instancedLineShader;
     ShaderProgram m_fillShader;
     ShaderProgram m_pickShader;
     ShaderProgram m_edgeShader;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace hz::render {
+
+/// Coverage bitmap of one glyph as produced by a font rasterizer.
+struct GlyphBitmap {
+    int width = 0;   ///< bitmap size in pixels (0 for blank glyphs such as space)
+    int height = 0;
+    float left = 0.0f;     ///< bitmap left edge relative to the pen position
+    float top = 0.0f;      ///< bitmap top edge above the baseline (y up)
+    float advance = 0.0f;  ///< pen advance
+    std::vector<uint8_t> coverage;  ///< width * height, row-major, top row first
+};
+
+/// Produces the coverage bitmap of a code point at the atlas pixel size.
+using GlyphRasterizer = std::function<GlyphBitmap(char32_t)>;
+
+/// A glyph as stored in the atlas: its quad relative to the pen position on the
+/// baseline (y up, atlas pixel units) and its texel rectangle in the atlas.
+struct Glyph {
+    float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;  ///< atlas texels, v down
+    float advance = 0.0f;
+};
+
+/// Single-channel signed-distance-field glyph atlas.
+///
+/// Glyphs are rasterized once, on first use, by the supplied rasterizer, converted to a
+/// distance field and shelf-packed into one texture, so a single atlas renders crisp
+/// text at any screen size.  Texel 128 is the glyph outline; values fall off by 127 over
+/// kSpread pixels on either side.  Glyph rectangles are kept in texels rather than
+/// normalized coordinates, so growing the atlas (it doubles in height when a glyph no
+/// longer fits) never invalidates glyphs handed out earlier.  Contains no GL; the owner
+/// uploads pixels() whenever revision() changes.
+class GlyphAtlas {
+public:
+    /// Distance-field range in pixels; also the padding around every glyph.
+    static constexpr int kSpread = 6;
+
+    /// @param pixelSize  em size the rasterizer renders at
+    /// @param ascent     font ascent at that size
+    GlyphAtlas(GlyphRasterizer rasterizer, float pixelSize, float ascent, int width = 1024,
+               int maxHeight = 4096);
+
+    /// The glyph for @p codePoint, rasterizing it if needed.  References stay valid until
+    /// clear() (or until the atlas overflows its maximum height and starts over).
+    const Glyph& glyph(char32_t codePoint);
+
+    float pixelSize() const { return m_pixelSize; }
+    float ascent() const { return m_ascent; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    const std::vector<uint8_t>& pixels() const { return m_pixels; }
+    size_t glyphCount() const { return m_glyphs.size(); }
+
+    /// Advances whenever pixels() change (a glyph was added or the atlas grew).
+    uint64_t revision() const { return m_revision; }
+
+    /// Advances whenever previously returned glyphs become invalid.
+    uint64_t generation() const { return m_generation; }
+
+    /// Drop every glyph.
+    void clear();
+
+private:
+    GlyphRasterizer m_rasterizer;
+    float m_pixelSize;
+    float m_ascent;
+    int m_width;
+    int m_maxHeight;
+    int m_height = 0;
+    std::vector<uint8_t> m_pixels;
+    std::unordered_map<char32_t, Glyph> m_glyphs;
+
+    // Shelf packer state.
+    int m_shelfX = 0;
+    int m_shelfY = 0;
+    int m_shelfHeight = 0;
+
+    uint64_t m_revision = 0;
+    uint64_t m_generation = 0;
+};
+
+/// Convert a coverage bitmap to an unsigned-byte signed distance field padded by
+/// @p spread pixels on every side.  Exposed for tests.
+std::vector<uint8_t> coverageToDistanceField(const std::vector<uint8_t>& coverage, int width,
+                                             int height, int spread);
+
+}  // namespace hz::render
@@ -2,12 +2,17 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <set>
+#include <span>
 #include <vector>
 
 namespace hz::render {
 
 /// Tracks the set of currently selected object IDs.
+///
+/// Ids live in a flat open-addressing hash table (linear probing, backward-shift
+/// deletion), so isSelected() -- asked once per entity on every render and tool pass --
+/// is a probe into one contiguous array.  Every change bumps generation(), so consumers
+/// can cache work derived from the selection and skip it while the selection holds.
 class SelectionManager {
 public:
     SelectionManager();
@@ -18,14 +23,40 @@ public:
     void toggle(uint64_t id);
     void clearSelection();
 
+    /// Add or remove many ids at once (e.g. a window selection).  The table is sized
+    /// once up front and the generation advances at most once.
+    void select(std::span<const uint64_t> ids);
+    void deselect(std::span<const uint64_t> ids);
+
     bool isSelected(uint64_t id) const;
 
-    std::vector<uint64_t> selectedIds() const;
-    size_t count() const { return m_selected.size(); }
-    bool empty() const { return m_selected.empty(); }
+    /// Selected ids in ascending order.  Built on first request after a change; the
+    /// reference stays valid until the selection next changes.
+    const std::vector<uint64_t>& selectedIds() const;
+
+    size_t count() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+    /// Advances whenever the set of selected ids changes.
+    uint64_t generation() const { return m_generation; }
 
 private:
-    std::set<uint64_t> m_selected;
+    /// Slot value of an empty table entry; id 0 is tracked by m_zeroSelected instead.
+    static constexpr uint64_t kEmpty = 0;
+
+    size_t home(uint64_t id) const;
+    bool insert(uint64_t id);
+    bool erase(uint64_t id);
+    void reserve(size_t count);
+    void changed();
+
+    std::vector<uint64_t> m_slots;  // capacity is a power of two, at most half full
+    size_t m_count = 0;
+    bool m_zeroSelected = false;
+    uint64_t m_generation = 0;
+
+    mutable std::vector<uint64_t> m_sortedIds;
+    mutable bool m_sortedValid = true;
 };
 
 }  // namespace hz::render
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "horizon/render/GlyphAtlas.h"
+
+namespace hz::render {
+
+/// A string laid out at the atlas pixel size: one quad per inked glyph, positioned
+/// relative to the start of the baseline (y up), plus the total advance.
+struct TextLayout {
+    std::vector<Glyph> glyphs;
+    float width = 0.0f;
+    uint64_t atlasGeneration = 0;  ///< atlas generation the texel rectangles belong to
+};
+
+/// Caches the layout of every string drawn, so a label costs one hash lookup per frame
+/// instead of shaping and rasterizing it again.  Identical strings (repeated dimension
+/// values, say) share one layout.  Layouts are independent of size, rotation and
+/// colour, which are applied when the quads are emitted.
+class TextLayoutCache {
+public:
+    explicit TextLayoutCache(GlyphAtlas& atlas) : m_atlas(atlas) {}
+
+    /// Layout of the UTF-8 string @p text.  Invalid sequences lay out as U+FFFD.  The
+    /// reference stays valid until trim() or clear().
+    const TextLayout& layout(std::string_view text);
+
+    /// End a frame: once more than @p maxEntries layouts are cached, drop those not
+    /// used since the previous trim().
+    void trim(size_t maxEntries);
+
+    void clear() { m_entries.clear(); }
+    size_t size() const { return m_entries.size(); }
+    GlyphAtlas& atlas() { return m_atlas; }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    struct Entry {
+        TextLayout layout;
+        uint64_t lastUse = 0;
+        bool built = false;
+    };
+
+    void build(std::string_view text, TextLayout& out);
+
+    GlyphAtlas& m_atlas;
+    std::unordered_map<std::string, Entry, Hash, std::equal_to<>> m_entries;
+    uint64_t m_tick = 0;
+};
+
+/// Where and how to draw one laid-out string on screen.
+struct TextPlacement {
+    float x = 0.0f;  ///< anchor in pixels, y down
+    float y = 0.0f;
+    float pixelSize = 0.0f;  ///< em size on screen
+    float rotation = 0.0f;   ///< counter-clockwise, radians
+    int alignment = 1;       ///< 0=Left, 1=Center, 2=Right of the anchor
+    float r = 1.0f, g = 1.0f, b = 1.0f;
+    float weight = 0.0f;  ///< outline offset in distance-field units; > 0 emboldens
+};
+
+/// Floats per emitted vertex: screen x, y; atlas texel u, v; r, g, b; weight.
+constexpr size_t kTextVertexFloats = 8;
+
+/// Append two triangles per glyph of @p layout to @p out.  The baseline sits a quarter
+/// of the ascent below the anchor, so labels sit roughly centred on their anchor.
+void appendTextVertices(const TextLayout& layout, const GlyphAtlas& atlas,
+                        const TextPlacement& placement, std::vector<float>& out);
+
+}  // namespace hz::render
@@ -3,6 +3,7 @@
 #include <QOpenGLContext>
 #include <QOpenGLExtraFunctions>
 #include <algorithm>
+#include <cstddef>
 
 #include "horizon/math/Constants.h"
 #include "horizon/math/Mat4.h"
@@ -145,12 +146,42 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in float aDistance;
 
 uniform mat4 uMVP;
+uniform vec3 uLineColor;
 
 out float vDistance;
+flat out vec3 vLineColor;
 
 void main() {
     gl_Position = uMVP * vec4(aPos, 1.0);
     vDistance = aDistance;
+    vLineColor = uLineColor;
+}
+)glsl";
+
+// Same fragment stage as the line shader; each instance places the shared block-local
+// vertices with a rotation-and-uniform-scale axis and an offset, and may supply the color.
+static const char* kInstancedLineVertSrc = R"glsl(
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in float aDistance;
+layout(location = 2) in vec2 aOffset;
+layout(location = 3) in vec2 aAxis;
+layout(location = 4) in vec3 aColor;
+
+uniform mat4 uMVP;
+uniform vec3 uLineColor;
+uniform int uInstanceColor;  // 1 = use the per-instance color instead of uLineColor
+
+out float vDistance;
+flat out vec3 vLineColor;
+
+void main() {
+    vec2 p = aOffset + vec2(aAxis.x * aPos.x - aAxis.y * aPos.y,
+                            aAxis.y * aPos.x + aAxis.x * aPos.y);
+    gl_Position = uMVP * vec4(p, aPos.z, 1.0);
+    vDistance = aDistance * length(aAxis);
+    vLineColor = uInstanceColor != 0 ? aColor : uLineColor;
 }
 )glsl";
 
@@ -158,17 +189,17 @@ static const char* kLineFragSrc = R"glsl(
 #version 330 core
 
 in float vDistance;
+flat in vec3 vLineColor;
 
 out vec4 FragColor;
 
-uniform vec3 uLineColor;
 uniform int uLineType;        // 0=ByLayer(unused), 1=Continuous, 2=Dashed, etc.
 uniform float uPatternScale;  // Scale factor for pattern lengths.
 
 void main() {
     // Continuous (1) or ByLayer fallback (0) — no discarding.
     if (uLineType <= 1) {
-        FragColor = vec4(uLineColor, 1.0);
+        FragColor = vec4(vLineColor, 1.0);
         return;
     }
 
@@ -204,7 +235,7 @@ void main() {
 
     if (inGap) discard;
 
-    FragColor = vec4(uLineColor, 1.0);
+    FragColor = vec4(vLineColor, 1.0);
 }
 )glsl";
 
@@ -307,6 +338,11 @@ void GLRenderer::initialize(QOpenGLExtraFunctions* gl) {
         return;
     }
 
+    if (!m_instancedLineShader.create(kInstancedLineVertSrc, kLineFragSrc)) {
+        qWarning("GLRenderer: failed to create instanced line shader");
+        return;
+    }
+
     if (!m_fillShader.create(kFillVertSrc, kFillFragSrc)) {
         qWarning("GLRenderer: failed to create fill shader");
         return;
@@ -560,6 +596,159 @@ void GLRenderer::drawCircle(QOpenGLExtraFunctions* gl, const Camera& camera,
     drawLines(gl, camera, circleVertices, color, lineWidth, lineType, patternScale);
 }
 
+void GLRenderer::uploadLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer,
+                                  const std::vector<float>& lineVertices) {
+    if (!buffer.vao) {
+        gl->glGenVertexArrays(1, &buffer.vao);
+        gl->glGenBuffers(1, &buffer.vbo);
+        gl->glBindVertexArray(buffer.vao);
+        gl->glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        // Vertex format: 4 floats per vertex (x, y, z, distance).
+        gl->glEnableVertexAttribArray(0);
+        gl->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+        gl->glEnableVertexAttribArray(1);
+        gl->glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                                  reinterpret_cast<void*>(3 * sizeof(float)));
+        gl->glBindVertexArray(0);
+    }
+
+    const size_t sizeBytes = lineVertices.size() * sizeof(float);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    if (sizeBytes > buffer.capacityBytes) {
+        buffer.capacityBytes = std::max(sizeBytes, buffer.capacityBytes * 2);
+        gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(buffer.capacityBytes), nullptr,
+                         GL_STATIC_DRAW);
+    }
+    if (sizeBytes > 0) {
+        gl->glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeBytes),
+                            lineVertices.data());
+    }
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffer.vertexCount = lineVertices.size() / 4;
+}
+
+void GLRenderer::patchLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer,
+                                 size_t floatOffset, const float* data, size_t floatCount) {
+    if (!buffer.vbo || floatCount == 0) return;
+    gl->glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    gl->glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(floatOffset * sizeof(float)),
+                        static_cast<GLsizeiptr>(floatCount * sizeof(float)), data);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GLRenderer::drawLineBuffer(QOpenGLExtraFunctions* gl, const Camera& camera,
+                                const LineBuffer& buffer, const math::Vec3& color,
+                                float lineWidth, int lineType, float patternScale) {
+    if (!m_initialized || !buffer.vao || buffer.vertexCount == 0) return;
+
+    math::Mat4 vp = camera.projectionMatrix() * camera.viewMatrix();
+
+    m_lineShader.bind();
+    m_lineShader.setUniform("uMVP", vp);
+    m_lineShader.setUniform("uLineColor", color);
+    m_lineShader.setUniform("uLineType", lineType);
+    m_lineShader.setUniform("uPatternScale", patternScale);
+
+    gl->glBindVertexArray(buffer.vao);
+    gl->glLineWidth(lineWidth);
+    gl->glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(buffer.vertexCount));
+    gl->glBindVertexArray(0);
+
+    m_lineShader.release();
+}
+
+void GLRenderer::destroyLineBuffer(QOpenGLExtraFunctions* gl, LineBuffer& buffer) {
+    if (buffer.vbo) gl->glDeleteBuffers(1, &buffer.vbo);
+    if (buffer.vao) gl->glDeleteVertexArrays(1, &buffer.vao);
+    buffer = {};
+}
+
+void GLRenderer::uploadLineInstances(QOpenGLExtraFunctions* gl, InstancedLineBuffer& instances,
+                                     const LineBuffer& geometry,
+                                     const std::vector<LineInstance>& data) {
+    if (!geometry.vbo) return;
+    if (!instances.vao) {
+        gl->glGenVertexArrays(1, &instances.vao);
+        gl->glGenBuffers(1, &instances.vbo);
+    }
+
+    // (Re)attach the shared vertices if this is a new geometry buffer.
+    if (instances.geometryVbo != geometry.vbo) {
+        instances.geometryVbo = geometry.vbo;
+        gl->glBindVertexArray(instances.vao);
+        gl->glBindBuffer(GL_ARRAY_BUFFER, geometry.vbo);
+        gl->glEnableVertexAttribArray(0);
+        gl->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+        gl->glEnableVertexAttribArray(1);
+        gl->glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                                  reinterpret_cast<void*>(3 * sizeof(float)));
+
+        // Per-instance format: offset (2), axis (2), color (3).
+        gl->glBindBuffer(GL_ARRAY_BUFFER, instances.vbo);
+        constexpr GLsizei stride = sizeof(LineInstance);
+        gl->glEnableVertexAttribArray(2);
+        gl->glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<void*>(offsetof(LineInstance, offsetX)));
+        gl->glVertexAttribDivisor(2, 1);
+        gl->glEnableVertexAttribArray(3);
+        gl->glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<void*>(offsetof(LineInstance, axisX)));
+        gl->glVertexAttribDivisor(3, 1);
+        gl->glEnableVertexAttribArray(4);
+        gl->glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<void*>(offsetof(LineInstance, r)));
+        gl->glVertexAttribDivisor(4, 1);
+        gl->glBindVertexArray(0);
+    }
+
+    const size_t sizeBytes = data.size() * sizeof(LineInstance);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, instances.vbo);
+    if (sizeBytes > instances.capacityBytes) {
+        instances.capacityBytes = std::max(sizeBytes, instances.capacityBytes * 2);
+        gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.capacityBytes),
+                         nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (sizeBytes > 0) {
+        gl->glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeBytes), data.data());
+    }
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instances.instanceCount = data.size();
+}
+
+void GLRenderer::drawLineInstances(QOpenGLExtraFunctions* gl, const Camera& camera,
+                                   const InstancedLineBuffer& instances, size_t firstVertex,
+                                   size_t vertexCount, const math::Vec3* color,
+                                   float lineWidth, int lineType, float patternScale) {
+    if (!m_initialized || !instances.vao || instances.instanceCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    math::Mat4 vp = camera.projectionMatrix() * camera.viewMatrix();
+
+    m_instancedLineShader.bind();
+    m_instancedLineShader.setUniform("uMVP", vp);
+    m_instancedLineShader.setUniform("uLineColor", color ? *color : math::Vec3{});
+    m_instancedLineShader.setUniform("uInstanceColor", color ? 0 : 1);
+    m_instancedLineShader.setUniform("uLineType", lineType);
+    m_instancedLineShader.setUniform("uPatternScale", patternScale);
+
+    gl->glBindVertexArray(instances.vao);
+    gl->glLineWidth(lineWidth);
+    gl->glDrawArraysInstanced(GL_LINES, static_cast<GLint>(firstVertex),
+                              static_cast<GLsizei>(vertexCount),
+                              static_cast<GLsizei>(instances.instanceCount));
+    gl->glBindVertexArray(0);
+
+    m_instancedLineShader.release();
+}
+
+void GLRenderer::destroyLineInstances(QOpenGLExtraFunctions* gl,
+                                      InstancedLineBuffer& instances) {
+    if (instances.vbo) gl->glDeleteBuffers(1, &instances.vbo);
+    if (instances.vao) gl->glDeleteVertexArrays(1, &instances.vao);
+    instances = {};
+}
+
 void GLRenderer::drawFilledQuad(QOpenGLExtraFunctions* gl, const Camera& camera,
                                 const math::Vec2& corner1, const math::Vec2& corner2,
                                 const math::Vec4& color) {
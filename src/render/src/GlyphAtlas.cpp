@@ -0,0 +1,176 @@
+#include "horizon/render/GlyphAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace hz::render {
+
+namespace {
+
+constexpr int kInitialHeight = 256;
+constexpr float kFar = 1e20f;  // "no feature"; finite so the parabola maths stays finite
+
+/// Felzenszwalb-Huttenlocher 1D squared distance transform of @p f (n samples) into
+/// @p d.  @p v and @p z are scratch buffers of n and n + 1 entries.
+void distanceTransform1D(const float* f, float* d, int n, int* v, float* z) {
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    auto intersect = [&](int q, int p) {
+        return ((f[q] + static_cast<float>(q * q)) - (f[p] + static_cast<float>(p * p))) /
+               static_cast<float>(2 * (q - p));
+    };
+
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kInf;
+    z[1] = kInf;
+    for (int q = 1; q < n; ++q) {
+        float s = intersect(q, v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = intersect(q, v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kInf;
+    }
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < static_cast<float>(q)) ++k;
+        const float dq = static_cast<float>(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+/// Exact squared Euclidean distance from every cell to the nearest cell whose
+/// @p grid value is 0 (the others hold kFar).  Transforms @p grid in place.
+void distanceTransform2D(std::vector<float>& grid, int width, int height) {
+    const int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) f[y] = grid[y * width + x];
+        distanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; ++y) grid[y * width + x] = d[y];
+    }
+    for (int y = 0; y < height; ++y) {
+        float* row = grid.data() + static_cast<size_t>(y) * width;
+        std::copy(row, row + width, f.begin());
+        distanceTransform1D(f.data(), d.data(), width, v.data(), z.data());
+        std::copy(d.begin(), d.begin() + width, row);
+    }
+}
+
+}  // namespace
+
+std::vector<uint8_t> coverageToDistanceField(const std::vector<uint8_t>& coverage, int width,
+                                             int height, int spread) {
+    const int pw = width + 2 * spread;
+    const int ph = height + 2 * spread;
+    const size_t cells = static_cast<size_t>(pw) * ph;
+
+    std::vector<bool> inside(cells, false);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            inside[static_cast<size_t>(y + spread) * pw + (x + spread)] =
+                coverage[static_cast<size_t>(y) * width + x] >= 128;
+        }
+    }
+
+    // Distance to the nearest outside cell (for inside cells) and vice versa.
+    std::vector<float> toOutside(cells), toInside(cells);
+    for (size_t i = 0; i < cells; ++i) {
+        toOutside[i] = inside[i] ? kFar : 0.0f;
+        toInside[i] = inside[i] ? 0.0f : kFar;
+    }
+    distanceTransform2D(toOutside, pw, ph);
+    distanceTransform2D(toInside, pw, ph);
+
+    std::vector<uint8_t> field(cells);
+    const float scale = 127.0f / static_cast<float>(spread);
+    for (size_t i = 0; i < cells; ++i) {
+        // Cell centres are half a pixel from the outline between neighbouring cells.
+        const float sd = inside[i] ? std::sqrt(toOutside[i]) - 0.5f
+                                   : -(std::sqrt(toInside[i]) - 0.5f);
+        field[i] = static_cast<uint8_t>(std::clamp(128.0f + sd * scale, 0.0f, 255.0f));
+    }
+    return field;
+}
+
+GlyphAtlas::GlyphAtlas(GlyphRasterizer rasterizer, float pixelSize, float ascent, int width,
+                       int maxHeight)
+    : m_rasterizer(std::move(rasterizer)),
+      m_pixelSize(pixelSize),
+      m_ascent(ascent),
+      m_width(width),
+      m_maxHeight(maxHeight),
+      m_height(std::min(kInitialHeight, maxHeight)),
+      m_pixels(static_cast<size_t>(m_width) * m_height, 0) {}
+
+void GlyphAtlas::clear() {
+    m_glyphs.clear();
+    m_height = std::min(kInitialHeight, m_maxHeight);
+    m_pixels.assign(static_cast<size_t>(m_width) * m_height, 0);
+    m_shelfX = 0;
+    m_shelfY = 0;
+    m_shelfHeight = 0;
+    ++m_revision;
+    ++m_generation;
+}
+
+const Glyph& GlyphAtlas::glyph(char32_t codePoint) {
+    if (auto it = m_glyphs.find(codePoint); it != m_glyphs.end()) return it->second;
+
+    GlyphBitmap bitmap = m_rasterizer(codePoint);
+    Glyph g;
+    g.advance = bitmap.advance;
+
+    const int pw = bitmap.width + 2 * kSpread;
+    const int ph = bitmap.height + 2 * kSpread;
+    const bool blank = bitmap.width <= 0 || bitmap.height <= 0 ||
+                       bitmap.coverage.size() <
+                           static_cast<size_t>(bitmap.width) * bitmap.height;
+    if (blank || pw > m_width || ph > m_maxHeight) {
+        return m_glyphs.emplace(codePoint, g).first->second;
+    }
+
+    // Shelf packing: start a new shelf when the current one is full, grow the atlas
+    // downwards when the shelves run out, and start over past the maximum height.
+    if (m_shelfX + pw > m_width) {
+        m_shelfY += m_shelfHeight;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+    if (m_shelfY + ph > m_maxHeight) clear();
+    if (m_shelfY + ph > m_height) {
+        while (m_shelfY + ph > m_height) m_height = std::min(m_height * 2, m_maxHeight);
+        m_pixels.resize(static_cast<size_t>(m_width) * m_height, 0);
+    }
+
+    const std::vector<uint8_t> field =
+        coverageToDistanceField(bitmap.coverage, bitmap.width, bitmap.height, kSpread);
+    for (int y = 0; y < ph; ++y) {
+        const uint8_t* src = field.data() + static_cast<size_t>(y) * pw;
+        uint8_t* dst = m_pixels.data() + static_cast<size_t>(m_shelfY + y) * m_width + m_shelfX;
+        std::copy_n(src, pw, dst);
+    }
+
+    g.x0 = bitmap.left - kSpread;
+    g.x1 = bitmap.left + static_cast<float>(bitmap.width + kSpread);
+    g.y0 = bitmap.top - static_cast<float>(bitmap.height + kSpread);
+    g.y1 = bitmap.top + kSpread;
+    g.u0 = static_cast<float>(m_shelfX);
+    g.u1 = static_cast<float>(m_shelfX + pw);
+    g.v0 = static_cast<float>(m_shelfY);
+    g.v1 = static_cast<float>(m_shelfY + ph);
+
+    m_shelfX += pw;
+    m_shelfHeight = std::max(m_shelfHeight, ph);
+    ++m_revision;
+    return m_glyphs.emplace(codePoint, g).first->second;
+}
+
+}  // namespace hz::render
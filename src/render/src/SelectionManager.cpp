@@ -1,37 +1,152 @@
 #include "horizon/render/SelectionManager.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace hz::render {
 
-SelectionManager::SelectionManager() = default;
+namespace {
+
+constexpr size_t kMinCapacity = 16;
+
+}  // namespace
+
+SelectionManager::SelectionManager() : m_slots(kMinCapacity, kEmpty) {}
 SelectionManager::~SelectionManager() = default;
 
+size_t SelectionManager::home(uint64_t id) const {
+    // Fibonacci hashing: sequential ids spread over the whole table.
+    const int shift = 64 - std::countr_zero(m_slots.size());
+    return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+void SelectionManager::reserve(size_t count) {
+    size_t capacity = m_slots.size();
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity == m_slots.size()) return;
+
+    std::vector<uint64_t> old(capacity, kEmpty);
+    old.swap(m_slots);
+    const size_t mask = m_slots.size() - 1;
+    for (uint64_t id : old) {
+        if (id == kEmpty) continue;
+        size_t i = home(id);
+        while (m_slots[i] != kEmpty) i = (i + 1) & mask;
+        m_slots[i] = id;
+    }
+}
+
+bool SelectionManager::insert(uint64_t id) {
+    if (id == kEmpty) {
+        if (m_zeroSelected) return false;
+        m_zeroSelected = true;
+        ++m_count;
+        return true;
+    }
+    reserve(m_count + 1);
+    const size_t mask = m_slots.size() - 1;
+    size_t i = home(id);
+    while (m_slots[i] != kEmpty) {
+        if (m_slots[i] == id) return false;
+        i = (i + 1) & mask;
+    }
+    m_slots[i] = id;
+    ++m_count;
+    return true;
+}
+
+bool SelectionManager::erase(uint64_t id) {
+    if (id == kEmpty) {
+        if (!m_zeroSelected) return false;
+        m_zeroSelected = false;
+        --m_count;
+        return true;
+    }
+    const size_t mask = m_slots.size() - 1;
+    size_t i = home(id);
+    while (m_slots[i] != id) {
+        if (m_slots[i] == kEmpty) return false;
+        i = (i + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole so
+    // lookups never need tombstones.
+    for (size_t j = (i + 1) & mask; m_slots[j] != kEmpty; j = (j + 1) & mask) {
+        const size_t k = home(m_slots[j]);
+        // The entry at j may move to i only if its home is not cyclically in (i, j].
+        const bool stays = (i < j) ? (k > i && k <= j) : (k > i || k <= j);
+        if (stays) continue;
+        m_slots[i] = m_slots[j];
+        i = j;
+    }
+    m_slots[i] = kEmpty;
+    --m_count;
+    return true;
+}
+
+void SelectionManager::changed() {
+    ++m_generation;
+    m_sortedValid = false;
+}
+
 void SelectionManager::select(uint64_t id) {
-    m_selected.insert(id);
+    if (insert(id)) changed();
 }
 
 void SelectionManager::deselect(uint64_t id) {
-    m_selected.erase(id);
+    if (erase(id)) changed();
 }
 
 void SelectionManager::toggle(uint64_t id) {
-    auto it = m_selected.find(id);
-    if (it != m_selected.end()) {
-        m_selected.erase(it);
-    } else {
-        m_selected.insert(id);
-    }
+    if (!erase(id)) insert(id);
+    changed();
 }
 
 void SelectionManager::clearSelection() {
-    m_selected.clear();
+    if (m_count == 0) return;
+    // Drop back to a small table so clearing a huge selection does not leave every
+    // later clear and rehash paying for its size.
+    m_slots.assign(kMinCapacity, kEmpty);
+    m_count = 0;
+    m_zeroSelected = false;
+    changed();
+}
+
+void SelectionManager::select(std::span<const uint64_t> ids) {
+    reserve(m_count + ids.size());
+    bool any = false;
+    for (uint64_t id : ids) any |= insert(id);
+    if (any) changed();
+}
+
+void SelectionManager::deselect(std::span<const uint64_t> ids) {
+    bool any = false;
+    for (uint64_t id : ids) any |= erase(id);
+    if (any) changed();
 }
 
 bool SelectionManager::isSelected(uint64_t id) const {
-    return m_selected.find(id) != m_selected.end();
+    if (m_count == 0) return false;
+    if (id == kEmpty) return m_zeroSelected;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        if (m_slots[i] == id) return true;
+        if (m_slots[i] == kEmpty) return false;
+    }
 }
 
-std::vector<uint64_t> SelectionManager::selectedIds() const {
-    return {m_selected.begin(), m_selected.end()};
+const std::vector<uint64_t>& SelectionManager::selectedIds() const {
+    if (!m_sortedValid) {
+        m_sortedIds.clear();
+        m_sortedIds.reserve(m_count);
+        if (m_zeroSelected) m_sortedIds.push_back(kEmpty);
+        for (uint64_t id : m_slots) {
+            if (id != kEmpty) m_sortedIds.push_back(id);
+        }
+        std::sort(m_sortedIds.begin(), m_sortedIds.end());
+        m_sortedValid = true;
+    }
+    return m_sortedIds;
 }
 
 }  // namespace hz::render
@@ -0,0 +1,111 @@
+#include "horizon/render/TextLayout.h"
+
+#include <cmath>
+
+namespace hz::render {
+
+namespace {
+
+constexpr char32_t kReplacement = 0xFFFD;
+
+/// Decode the code point starting at @p i and advance @p i past it.
+char32_t nextCodePoint(std::string_view s, size_t& i) {
+    const auto lead = static_cast<unsigned char>(s[i++]);
+    if (lead < 0x80) return lead;
+
+    int extra = 0;
+    char32_t cp = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = lead & 0x07;
+    } else {
+        return kReplacement;
+    }
+    for (int k = 0; k < extra; ++k) {
+        if (i >= s.size() || (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) {
+            return kReplacement;
+        }
+        cp = (cp << 6) | (static_cast<unsigned char>(s[i++]) & 0x3F);
+    }
+    return cp;
+}
+
+}  // namespace
+
+void TextLayoutCache::build(std::string_view text, TextLayout& out) {
+    out.glyphs.clear();
+    out.width = 0.0f;
+    out.atlasGeneration = m_atlas.generation();
+
+    float pen = 0.0f;
+    for (size_t i = 0; i < text.size();) {
+        Glyph g = m_atlas.glyph(nextCodePoint(text, i));
+        if (g.x1 > g.x0) {
+            g.x0 += pen;
+            g.x1 += pen;
+            out.glyphs.push_back(g);
+        }
+        pen += g.advance;
+    }
+    out.width = pen;
+}
+
+const TextLayout& TextLayoutCache::layout(std::string_view text) {
+    auto it = m_entries.find(text);
+    if (it == m_entries.end()) it = m_entries.emplace(std::string(text), Entry{}).first;
+    Entry& entry = it->second;
+    entry.lastUse = m_tick;
+
+    if (!entry.built || entry.layout.atlasGeneration != m_atlas.generation()) {
+        build(text, entry.layout);
+        // The atlas started over part-way through this string; the earlier glyphs'
+        // texels are gone, so lay it out again into the fresh atlas.
+        if (entry.layout.atlasGeneration != m_atlas.generation()) build(text, entry.layout);
+        entry.built = true;
+    }
+    return entry.layout;
+}
+
+void TextLayoutCache::trim(size_t maxEntries) {
+    if (m_entries.size() > maxEntries) {
+        std::erase_if(m_entries, [&](const auto& kv) { return kv.second.lastUse < m_tick; });
+    }
+    ++m_tick;
+}
+
+void appendTextVertices(const TextLayout& layout, const GlyphAtlas& atlas,
+                        const TextPlacement& placement, std::vector<float>& out) {
+    if (layout.glyphs.empty() || atlas.pixelSize() <= 0.0f) return;
+
+    const float scale = placement.pixelSize / atlas.pixelSize();
+    const float c = std::cos(placement.rotation) * scale;
+    const float s = std::sin(placement.rotation) * scale;
+    const float dx = -0.5f * static_cast<float>(placement.alignment) * layout.width;
+    const float dy = -0.25f * atlas.ascent();
+
+    auto vertex = [&](float lx, float ly, float u, float v) {
+        lx += dx;
+        ly += dy;
+        out.insert(out.end(), {placement.x + lx * c - ly * s, placement.y - (lx * s + ly * c), u,
+                               v, placement.r, placement.g, placement.b, placement.weight});
+    };
+
+    out.reserve(out.size() + layout.glyphs.size() * 6 * kTextVertexFloats);
+    for (const Glyph& g : layout.glyphs) {
+        // v0 is the top texel row, i.e. the quad's y1 edge.
+        vertex(g.x0, g.y0, g.u0, g.v1);
+        vertex(g.x1, g.y0, g.u1, g.v1);
+        vertex(g.x1, g.y1, g.u1, g.v0);
+        vertex(g.x0, g.y0, g.u0, g.v1);
+        vertex(g.x1, g.y1, g.u1, g.v0);
+        vertex(g.x0, g.y1, g.u0, g.v0);
+    }
+}
+
+}  // namespace hz::render
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 
+#include "horizon/constraint/GeometryRef.h"
 #include "horizon/math/Vec2.h"
 
 namespace hz::draft {
@@ -21,6 +23,11 @@ public:
     /// Move grip at the given index to a new position.
     /// Returns true if the move was applied.
     static bool moveGrip(draft::DraftEntity& entity, int gripIndex, const math::Vec2& newPos);
+
+    /// The constraint Point feature a grip sits on, when dragging it amounts to moving
+    /// that point (line ends, circle and arc centres, polyline vertices).
+    static std::optional<cstr::GeometryRef> gripFeature(const draft::DraftEntity& entity,
+                                                        int gripIndex);
 };
 
 }  // namespace hz::ui
@@ -21,6 +21,7 @@ public:
 private slots:
     void onAddLayer();
     void onDeleteLayer();
+    void onRenameLayer();
     void onItemDoubleClicked(QTreeWidgetItem* item, int column);
     void onItemChanged(QTreeWidgetItem* item, int column);
     void onColorClicked();
@@ -32,6 +33,7 @@ private:
     QTreeWidget* m_tree = nullptr;
     QPushButton* m_addBtn = nullptr;
     QPushButton* m_deleteBtn = nullptr;
+    QPushButton* m_renameBtn = nullptr;
     bool m_refreshing = false;
 };
 
@@ -76,6 +76,7 @@ private slots:
     void onPolylineEditTool();
     void onRectangularArray();
     void onPolarArray();
+    void onRemoveDuplicates();
 
     void onLinearDimTool();
     void onRadialDimTool();
@@ -3,6 +3,7 @@
 #include <QPoint>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "horizon/math/Vec2.h"
 #include "horizon/ui/Tool.h"
@@ -11,12 +12,22 @@ namespace hz::draft {
 class DraftEntity;
 }
 
+namespace hz::cstr {
+class DragSession;
+}
+
+namespace hz::doc {
+class ApplyConstraintSolveCommand;
+}
+
 namespace hz::ui {
 
 /// Selection tool with grip editing: click to select entities, Shift+click for
 /// multi-select, drag grips to reshape, Delete/Backspace to remove.
 class SelectTool : public Tool {
 public:
+    ~SelectTool() override;
+
     std::string name() const override { return "Select"; }
 
     bool mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) override;
@@ -50,6 +61,9 @@ private:
     /// Returns true if the user confirmed a change.
     bool editConstraintDimension(uint64_t constraintId, double currentValue, bool isAngle);
 
+    /// Snapshots of the constrained grip drag's component: before the drag and now.
+    std::unique_ptr<doc::ApplyConstraintSolveCommand> constrainedDragCommand() const;
+
     // Grip dragging state.
     bool m_draggingGrip = false;
     uint64_t m_gripEntityId = 0;
@@ -58,6 +72,11 @@ private:
     math::Vec2 m_gripCurrentPos;
     std::shared_ptr<draft::DraftEntity> m_gripBeforeClone;
 
+    // Constrained grip drag: the live solver session and the dragged component's
+    // entities as they were when the drag started.  Null for unconstrained grips.
+    std::unique_ptr<cstr::DragSession> m_dragSession;
+    std::vector<std::shared_ptr<draft::DraftEntity>> m_dragBefore;
+
     // Box selection state.
     bool m_leftButtonDown = false;
     bool m_draggingBox = false;
@@ -19,8 +19,9 @@ namespace hz::ui {
 ///
 /// Rendering and hit-testing share the same projection: paint() caches the
 /// screen-space polygon of every visible region, and hitTest() consults that
-/// cache. paint() runs each frame before any click is dispatched, so the cache
-/// is always current.
+/// cache. The viewport repaints the gizmo whenever the camera orientation or
+/// viewport size changes, before any click is dispatched, so the cache is
+/// always current.
 class ViewCube {
 public:
     enum class Region { None, Front, Back, Left, Right, Top, Bottom, Iso };
@@ -33,6 +34,10 @@ public:
     /// Region::None if the point misses the gizmo.
     Region hitTest(const QPoint& pos) const;
 
+    /// Height in pixels of the strip along the viewport's top edge that paint() draws
+    /// in, whatever the orientation.
+    static int paintedHeight();
+
     /// Human-readable name of the current camera orientation ("Front", "Top",
     /// "Isometric", ...) for the view-mode badge.
     static QString orientationLabel(const render::Camera& camera);
@@ -43,7 +48,7 @@ private:
         QPolygonF poly;
         double depth;  ///< face-centre view depth; smaller = nearer the viewer
     };
-    std::vector<Hit> m_hits;  ///< rebuilt every paint(); consulted by hitTest()
+    std::vector<Hit> m_hits;  ///< rebuilt by paint(); consulted by hitTest()
 };
 
 }  // namespace hz::ui
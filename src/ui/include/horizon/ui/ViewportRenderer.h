@@ -1,12 +1,22 @@
 #pragma once
 
 #include <QPointF>
+#include <QString>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "horizon/constraint/SketchSolver.h"
+#include "horizon/drafting/DisplayList.h"
+#include "horizon/math/BoundingBox.h"
 #include "horizon/math/Vec2.h"
+#include "horizon/render/GLRenderer.h"
+#include "horizon/render/GlyphAtlas.h"
+#include "horizon/render/TextLayout.h"
 #include "horizon/ui/ViewCube.h"
 
 class QOpenGLExtraFunctions;
@@ -14,7 +24,6 @@ class QImage;
 
 namespace hz::render {
 class Camera;
-class GLRenderer;
 class SelectionManager;
 }  // namespace hz::render
 
@@ -22,27 +31,43 @@ namespace hz::doc {
 class Document;
 }  // namespace hz::doc
 
+namespace hz::draft {
+class DraftDocument;
+struct BlockDefinition;
+}  // namespace hz::draft
+
 namespace hz::ui {
 
 class Tool;
 
 /// Handles all rendering logic for the viewport: entity batching, GL draw calls,
-/// text overlay, constraint annotations, DOF visualization, grips, and tool preview.
+/// glyph-atlas text, constraint annotations, DOF visualization, grips, and tool preview.
 /// Extracted from ViewportWidget to keep the widget class focused on coordination.
 class ViewportRenderer {
 public:
     ViewportRenderer() = default;
 
-    /// Initialize GL resources for text overlay (shader, VAO, VBO, texture).
+    /// Initialize GL resources for text: the glyph-atlas shader, buffers and texture, and
+    /// the overlay image used for the orientation gizmo and view badge.
     void initTextOverlayGL(QOpenGLExtraFunctions* gl);
 
     /// Clean up GL resources.
     void destroyGL(QOpenGLExtraFunctions* gl);
 
-    /// Render document entities (collects dimension text info for overlay).
+    /// Render document entities (collects dimension and text-entity labels).
+    /// Entity geometry comes from a per-entity display-list cache and is kept in
+    /// persistent per-style GPU buffers; only entities whose version or style changed
+    /// since the last frame are re-tessellated and re-uploaded.  Block references are
+    /// drawn as GPU instances of their definition's geometry, which is uploaded once.
+    ///
+    /// Only entities whose boxes overlap the visible part of the ground plane are
+    /// processed (found through the document's spatial index), and entities smaller than
+    /// half a pixel are drawn as dots.  When the view shows the horizon every entity is
+    /// drawn.
     void renderEntities(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
                         const render::Camera& camera, doc::Document& doc,
-                        const render::SelectionManager& selection);
+                        const render::SelectionManager& selection, int viewportWidth,
+                        int viewportHeight);
 
     /// Render tool preview (rubber-band lines, circles, arcs, selection rectangle).
     void renderToolPreview(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
@@ -53,12 +78,18 @@ public:
                      const render::Camera& camera, doc::Document& doc,
                      const render::SelectionManager& selection, double pixelToWorldScale);
 
-    /// Render text to a QImage then blit via GL texture as fullscreen quad.
+    /// Draw entity, dimension and constraint-annotation text as glyph-atlas quads in one
+    /// draw call, then blit the gizmo/badge overlay (painted with QPainter into a QImage
+    /// of the strip they occupy along the top edge).  String layouts are cached across
+    /// frames and glyphs are rasterized once, so the per-frame text cost is one quad per
+    /// glyph; the overlay is repainted and re-uploaded only when the viewport size or
+    /// camera orientation changes.
     void blitTextOverlay(QOpenGLExtraFunctions* gl, const render::Camera& camera,
                          doc::Document* doc, const render::SelectionManager& selection,
                          int viewportWidth, int viewportHeight, double pixelToWorldScale);
 
-    /// Recompute DOF analysis from the document's constraint system.
+    /// Recompute DOF analysis from the document's constraint system.  Components
+    /// unchanged since the last call reuse their cached result.
     void recomputeDOF(doc::Document* doc);
 
     /// Access current DOF analysis.
@@ -68,7 +99,7 @@ public:
     ViewCube& viewCube() { return m_viewCube; }
 
 private:
-    /// Text data collected during renderEntities() for overlay.
+    /// Text data collected during renderEntities() for the glyph-atlas text pass.
     struct DimTextInfo {
         math::Vec2 worldPos;
         std::string text;
@@ -79,6 +110,101 @@ private:
     };
     std::vector<DimTextInfo> m_dimTexts;
 
+    /// Entity strokes sharing one resolved style, packed into a persistent GPU buffer.
+    struct EntityBatch {
+        uint32_t colorARGB = 0;
+        float lineWidth = 1.0f;
+        int lineType = 1;
+
+        /// One display-list stroke and where its vertices live in the buffer.
+        struct Member {
+            uint64_t entityId = 0;
+            size_t stroke = 0;
+            uint64_t revision = 0;
+            size_t offset = 0;  // in floats
+            size_t count = 0;   // in floats
+            const std::vector<float>* vertices = nullptr;  // valid during a frame only
+        };
+        std::vector<Member> members;       // as uploaded
+        std::vector<Member> frameMembers;  // collected by the current frame
+        std::vector<float> vertices;       // CPU copy of the GPU buffer
+        render::GLRenderer::LineBuffer gpu;
+    };
+
+    /// Bring a batch's GPU buffer in line with the strokes collected this frame:
+    /// untouched when nothing changed, patched in place when only some strokes were
+    /// re-tessellated at the same size, repacked otherwise.
+    void syncBatch(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer, EntityBatch& batch);
+
+    std::vector<EntityBatch> m_batches;
+    draft::DisplayListCache m_displayLists;
+
+    /// A block definition's cached local geometry on the GPU, shared by all its references.
+    struct BlockBuffer {
+        uint64_t stamp = 0;  // BlockGeometry::stamp of the upload
+        uint64_t frame = 0;  // last frame a reference used it
+        struct Stroke {
+            uint32_t color = 0;  // 0 = the reference's resolved color
+            double lineWidth = 0.0;
+            int lineType = 0;
+            size_t firstVertex = 0;
+            size_t vertexCount = 0;
+        };
+        std::vector<Stroke> strokes;
+        render::GLRenderer::LineBuffer gpu;
+    };
+
+    /// References to one definition sharing a resolved width and line type, drawn with
+    /// one instanced call per definition stroke.  Colors vary per instance.
+    struct BlockInstanceGroup {
+        const draft::BlockDefinition* definition = nullptr;
+        float lineWidth = 1.0f;
+        int lineType = 1;
+        std::vector<render::GLRenderer::LineInstance> instances;  // collected this frame
+        std::vector<render::GLRenderer::LineInstance> uploaded;   // CPU copy of the GPU data
+        render::GLRenderer::InstancedLineBuffer gpu;
+    };
+
+    /// Upload the definition's geometry if it is new or changed since the last upload.
+    BlockBuffer& syncBlockBuffer(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
+                                 const draft::BlockDefinition& definition);
+
+    std::unordered_map<const draft::BlockDefinition*, BlockBuffer> m_blockBuffers;
+    std::vector<BlockInstanceGroup> m_blockGroups;
+    uint64_t m_frame = 0;
+
+    /// Entities near the view.  The index is queried with the visible rectangle padded
+    /// on every side, and the result is reused until the view leaves that region, the
+    /// zoom changes by more than 2x or the index changes, so panning does not reshuffle
+    /// the GPU batches on every frame.
+    struct VisibleSet {
+        const draft::DraftDocument* document = nullptr;
+        uint64_t indexRevision = 0;
+        math::BoundingBox region;   // padded query box
+        double pixelSize = 0.0;     // world size of one pixel at query time
+        uint64_t generation = 0;    // bumped on every re-query
+        std::vector<uint64_t> ids;  // sorted
+        std::unordered_map<uint64_t, std::vector<float>> dots;  // sub-pixel entities
+        bool bounded = false;       // false while the view reaches the horizon
+    };
+
+    /// Refresh m_visible for the current view if needed.  Returns false when the view
+    /// cannot be bounded on the ground plane (the horizon is visible).
+    bool updateVisibleSet(const render::Camera& camera, doc::Document& doc, int viewportWidth,
+                          int viewportHeight);
+
+    VisibleSet m_visible;
+
+    /// Grip squares of the last renderGrips() call and the inputs they were built from.
+    struct GripCache {
+        const draft::DraftDocument* document = nullptr;
+        uint64_t selectionGeneration = 0;
+        uint64_t indexRevision = 0;
+        double pixelSize = 0.0;
+        std::vector<float> vertices;
+    };
+    GripCache m_gripCache;
+
     /// Generate vertices for a circle approximation.
     std::vector<float> circleVertices(const math::Vec2& center, double radius,
                                       int segments = 64) const;
@@ -87,10 +213,18 @@ private:
     std::vector<float> arcVertices(const math::Vec2& center, double radius, double startAngle,
                                    double endAngle, int segments = 64) const;
 
-    /// Render text to a QImage using QPainter.
-    void renderTextToImage(QImage& image, const render::Camera& camera, doc::Document* doc,
-                           const render::SelectionManager& selection, int viewportWidth,
-                           int viewportHeight, double pixelToWorldScale);
+    /// Fill m_glyphVertices with the quads of every text item in view.
+    void collectTextVertices(const render::Camera& camera, doc::Document* doc,
+                             const render::SelectionManager& selection, int viewportWidth,
+                             int viewportHeight, double pixelToWorldScale);
+
+    /// Upload the atlas if it changed and draw m_glyphVertices.
+    void drawGlyphText(QOpenGLExtraFunctions* gl, int viewportWidth, int viewportHeight);
+
+    /// Paint the orientation gizmo and the view-mode badge showing @p label into a QImage
+    /// whose top edge is the viewport's.
+    void paintOverlayToImage(QImage& image, const render::Camera& camera, const QString& label,
+                             int viewportWidth, int viewportHeight);
 
     /// Project a world-space 2D point to screen coordinates.
     static QPointF worldToScreen(const render::Camera& camera, const math::Vec2& wp,
@@ -98,12 +232,36 @@ private:
 
     // DOF visualization
     cstr::DOFAnalysis m_dofAnalysis;
+    cstr::DOFCache m_dofCache;
     bool m_dofDirty = true;
 
-    // Top-right orientation gizmo, drawn in the text-overlay QImage.
+    // Top-right orientation gizmo, drawn in the overlay QImage.
     ViewCube m_viewCube;
 
-    // Text overlay GL resources (renders to QImage, uploads as texture)
+    // Glyph-atlas text.  The atlas and layout cache outlive GL context loss; only the
+    // texture is re-created and re-uploaded.
+    static constexpr uint64_t kNeverUploaded = ~uint64_t{0};
+    std::unique_ptr<render::GlyphAtlas> m_glyphAtlas;
+    std::unique_ptr<render::TextLayoutCache> m_textLayouts;
+    std::vector<float> m_glyphVertices;
+    uint64_t m_glyphTexRevision = kNeverUploaded;
+    size_t m_glyphVBOCapacity = 0;
+    unsigned int m_glyphTex = 0;
+    unsigned int m_glyphVAO = 0;
+    unsigned int m_glyphVBO = 0;
+    unsigned int m_glyphShader = 0;
+
+    /// What the uploaded gizmo/badge overlay was painted for.
+    struct OverlayKey {
+        int width = 0;
+        int height = 0;
+        std::array<double, 6> orientation{};  ///< view direction, then camera up
+        QString label;
+        bool operator==(const OverlayKey&) const = default;
+    };
+
+    // Gizmo/badge overlay GL resources (renders to QImage, uploads as texture)
+    OverlayKey m_overlayKey;  ///< width 0 until the first upload
     unsigned int m_textOverlayTex = 0;
     unsigned int m_textOverlayVAO = 0;
     unsigned int m_textOverlayVBO = 0;
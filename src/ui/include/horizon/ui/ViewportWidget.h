@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "horizon/document/Sketch.h"
+#include "horizon/drafting/IntersectionEngine.h"
 #include "horizon/drafting/SnapEngine.h"
 #include "horizon/math/Vec2.h"
 #include "horizon/math/Vec3.h"
@@ -76,6 +77,8 @@ public:
     // ---- Snapping ----
 
     draft::SnapEngine& snapEngine() { return m_snapEngine; }
+    /// Shared by Trim, Extend and Break so cached segment lists survive tool switches.
+    draft::IntersectionEngine& intersectionEngine() { return m_intersectionEngine; }
     void setLastSnapResult(const draft::SnapResult& result) { m_lastSnapResult = result; }
 
     // ---- Tools ----
@@ -155,6 +158,7 @@ private:
 
     // Snapping
     draft::SnapEngine m_snapEngine;
+    draft::IntersectionEngine m_intersectionEngine;
     draft::SnapResult m_lastSnapResult;
 
     // 3D scene graph
@@ -49,7 +49,7 @@ bool AngularDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
     if (m_state == State::WaitingForLine1 || m_state == State::WaitingForLine2) {
         // Find a line entity under the click.
         for (const auto& entity : entities) {
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
 
             auto* line = dynamic_cast<const draft::DraftLine*>(entity.get());
@@ -103,7 +103,7 @@ bool AngularDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
 
         auto dim =
             std::make_shared<draft::DraftAngularDimension>(m_vertex, line1Pt, line2Pt, arcRadius);
-        dim->setLayer(m_viewport->document()->layerManager().currentLayer());
+        dim->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
         auto cmd =
             std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), dim);
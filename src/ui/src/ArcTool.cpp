@@ -31,8 +31,7 @@ bool ArcTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -57,7 +56,7 @@ bool ArcTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
             if (m_viewport && m_viewport->document()) {
                 auto arc =
                     std::make_shared<draft::DraftArc>(m_center, m_radius, m_startAngle, endAngle);
-                arc->setLayer(m_viewport->document()->layerManager().currentLayer());
+                arc->setLayerId(m_viewport->document()->layerManager().currentLayerId());
                 auto cmd = std::make_unique<doc::AddEntityCommand>(
                     m_viewport->document()->draftDocument(), arc);
                 m_viewport->document()->undoStack().push(std::move(cmd));
@@ -75,8 +74,7 @@ bool ArcTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPos)
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
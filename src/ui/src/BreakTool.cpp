@@ -11,7 +11,7 @@
 #include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftCircle.h"
 #include "horizon/drafting/DraftLine.h"
-#include "horizon/drafting/Intersection.h"
+#include "horizon/drafting/IntersectionEngine.h"
 #include "horizon/math/Constants.h"
 #include "horizon/math/MathUtils.h"
 #include "horizon/ui/ViewportWidget.h"
@@ -20,7 +20,7 @@ namespace hz::ui {
 
 // Helper: copy visual properties from source entity to target.
 static void copyProps(const draft::DraftEntity* src, draft::DraftEntity* dst) {
-    dst->setLayer(src->layer());
+    dst->setLayerId(src->layerId());
     dst->setColor(src->color());
     dst->setLineWidth(src->lineWidth());
     dst->setLineType(src->lineType());
@@ -185,7 +185,7 @@ bool BreakTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     const auto& layerMgr = m_viewport->document()->layerManager();
     std::shared_ptr<draft::DraftEntity> target;
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         if (entity->hitTest(worldPos, tolerance)) {
             target = entity;
@@ -195,14 +195,11 @@ bool BreakTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     if (!target) return false;
 
     // Find all intersection points on the target with other entities.
-    std::vector<math::Vec2> allIsects;
-    for (const auto& other : doc.entities()) {
-        if (other->id() == target->id()) continue;
-        const auto* lp = layerMgr.getLayer(other->layer());
-        if (!lp || !lp->visible) continue;
-        auto result = draft::intersect(*target, *other);
-        allIsects.insert(allIsects.end(), result.points.begin(), result.points.end());
-    }
+    std::vector<math::Vec2> allIsects = m_viewport->intersectionEngine().intersections(
+        doc, *target, [&layerMgr](const draft::DraftEntity& other) {
+            const auto* lp = layerMgr.getLayer(other.layerId());
+            return lp && lp->visible;
+        });
 
     auto composite = std::make_unique<doc::CompositeCommand>("Break");
 
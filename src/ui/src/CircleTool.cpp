@@ -30,8 +30,7 @@ bool CircleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -47,7 +46,7 @@ bool CircleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
             double radius = m_center.distanceTo(snappedPos);
             if (radius > 1e-6 && m_viewport && m_viewport->document()) {
                 auto circle = std::make_shared<draft::DraftCircle>(m_center, radius);
-                circle->setLayer(m_viewport->document()->layerManager().currentLayer());
+                circle->setLayerId(m_viewport->document()->layerManager().currentLayerId());
                 auto cmd = std::make_unique<doc::AddEntityCommand>(
                     m_viewport->document()->draftDocument(), circle);
                 m_viewport->document()->undoStack().push(std::move(cmd));
@@ -64,8 +63,7 @@ bool CircleTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldP
         math::Vec2 snappedPos = worldPos;
         if (m_viewport && m_viewport->document()) {
             auto& draftDoc = m_viewport->document()->draftDocument();
-            auto result = m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(),
-                                                        draftDoc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
             snappedPos = result.point;
             m_viewport->setLastSnapResult(result);
         }
@@ -98,7 +98,7 @@ cstr::GeometryRef ConstraintTool::detectFeature(const math::Vec2& worldPos) cons
     double bestDist = tolerance;
 
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
 
         // Check point features
@@ -28,8 +28,7 @@ bool EllipseTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -68,8 +67,7 @@ bool EllipseTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& world
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -112,7 +110,7 @@ void EllipseTool::finishEllipse() {
 
     auto ellipse =
         std::make_shared<draft::DraftEllipse>(m_center, m_semiMajor, semiMinor, m_rotation);
-    ellipse->setLayer(m_viewport->document()->layerManager().currentLayer());
+    ellipse->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
     auto cmd =
         std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), ellipse);
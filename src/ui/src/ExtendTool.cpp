@@ -11,7 +11,7 @@
 #include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftCircle.h"
 #include "horizon/drafting/DraftLine.h"
-#include "horizon/drafting/Intersection.h"
+#include "horizon/drafting/IntersectionEngine.h"
 #include "horizon/drafting/Layer.h"
 #include "horizon/math/Constants.h"
 #include "horizon/math/MathUtils.h"
@@ -21,7 +21,7 @@ namespace hz::ui {
 
 // Helper: copy visual properties from source entity to target.
 static void copyProps(const draft::DraftEntity* src, draft::DraftEntity* dst) {
-    dst->setLayer(src->layer());
+    dst->setLayerId(src->layerId());
     dst->setColor(src->color());
     dst->setLineWidth(src->lineWidth());
     dst->setLineType(src->lineType());
@@ -32,9 +32,9 @@ static void copyProps(const draft::DraftEntity* src, draft::DraftEntity* dst) {
 // ---------------------------------------------------------------------------
 
 static bool extendLine(const draft::DraftLine* line, const math::Vec2& clickPos,
-                       const std::vector<std::shared_ptr<draft::DraftEntity>>& entities,
-                       const draft::LayerManager& layerMgr, doc::CompositeCommand& composite,
-                       draft::DraftDocument& doc) {
+                       draft::IntersectionEngine& engine,
+                       const draft::IntersectionEngine::Filter& isBoundary,
+                       doc::CompositeCommand& composite, draft::DraftDocument& doc) {
     // Determine which endpoint to extend (closest to click).
     double distToStart = (clickPos - line->start()).length();
     double distToEnd = (clickPos - line->end()).length();
@@ -55,24 +55,9 @@ static bool extendLine(const draft::DraftLine* line, const math::Vec2& clickPos,
     if (rayDir.lengthSquared() < 1e-14) return false;
 
     // Find nearest boundary intersection along the ray.
-    math::Vec2 bestPt;
-    double bestDist = 1e30;
-    for (const auto& other : entities) {
-        if (other->id() == line->id()) continue;
-        const auto* lp = layerMgr.getLayer(other->layer());
-        if (!lp || !lp->visible) continue;
-
-        auto pts = draft::intersectRayEntity(rayOrigin, rayDir, *other);
-        for (const auto& pt : pts) {
-            double d = (pt - rayOrigin).length();
-            if (d > 1e-6 && d < bestDist) {
-                bestDist = d;
-                bestPt = pt;
-            }
-        }
-    }
-
-    if (bestDist > 1e29) return false;  // No boundary found.
+    auto hit = engine.nearestRayHit(doc, rayOrigin, rayDir, line->id(), 1e-6, isBoundary);
+    if (!hit) return false;  // No boundary found.
+    math::Vec2 bestPt = *hit;
 
     // Create extended line.
     composite.addCommand(std::make_unique<doc::RemoveEntityCommand>(doc, line->id()));
@@ -91,9 +76,9 @@ static bool extendLine(const draft::DraftLine* line, const math::Vec2& clickPos,
 // ---------------------------------------------------------------------------
 
 static bool extendArc(const draft::DraftArc* arc, const math::Vec2& clickPos,
-                      const std::vector<std::shared_ptr<draft::DraftEntity>>& entities,
-                      const draft::LayerManager& layerMgr, doc::CompositeCommand& composite,
-                      draft::DraftDocument& doc) {
+                      draft::IntersectionEngine& engine,
+                      const draft::IntersectionEngine::Filter& isBoundary,
+                      doc::CompositeCommand& composite, draft::DraftDocument& doc) {
     // Determine which endpoint to extend.
     double distToStart = (clickPos - arc->startPoint()).length();
     double distToEnd = (clickPos - arc->endPoint()).length();
@@ -108,97 +93,30 @@ static bool extendArc(const draft::DraftArc* arc, const math::Vec2& clickPos,
     double arcStart = arc->startAngle();
     double arcEnd = math::normalizeAngle(arcStart + arc->sweepAngle());
 
-    for (const auto& other : entities) {
-        if (other->id() == arc->id()) continue;
-        const auto* lp = layerMgr.getLayer(other->layer());
-        if (!lp || !lp->visible) continue;
-
-        // Intersect other entity with the full circle of this arc.
-        // Use ray from center in all directions — simpler: use extractSegments +
-        // intersectLineCircle.
-        auto segs = draft::extractSegments(*other);
-        for (const auto& [s, e] : segs) {
-            auto pts = draft::intersectLineCircle(s, e, arc->center(), arc->radius());
-            for (const auto& pt : pts) {
-                double angle = math::normalizeAngle(
-                    std::atan2(pt.y - arc->center().y, pt.x - arc->center().x));
-
-                // Check if this angle is in the extension direction (outside current arc).
-                double offset = math::normalizeAngle(angle - arcStart);
-                double arcSweep = arc->sweepAngle();
-                if (offset >= -1e-6 && offset <= arcSweep + 1e-6) continue;  // Inside arc, skip.
-
-                // Compute angular distance from the endpoint being extended.
-                double angleDist;
-                if (extendStart) {
-                    // Extending start backward: angle should be just before arcStart (CCW).
-                    angleDist = math::normalizeAngle(arcStart - angle);
-                } else {
-                    // Extending end forward: angle should be just after arcEnd (CCW).
-                    angleDist = math::normalizeAngle(angle - arcEnd);
-                }
-
-                if (angleDist > 1e-6 && angleDist < bestAngleDist) {
-                    bestAngleDist = angleDist;
-                    bestAngle = angle;
-                    found = true;
-                }
-            }
+    auto pts = engine.circleIntersections(doc, arc->center(), arc->radius(), arc->id(), isBoundary);
+    for (const auto& pt : pts) {
+        double angle =
+            math::normalizeAngle(std::atan2(pt.y - arc->center().y, pt.x - arc->center().x));
+
+        // Check if this angle is in the extension direction (outside current arc).
+        double offset = math::normalizeAngle(angle - arcStart);
+        double arcSweep = arc->sweepAngle();
+        if (offset >= -1e-6 && offset <= arcSweep + 1e-6) continue;  // Inside arc, skip.
+
+        // Compute angular distance from the endpoint being extended.
+        double angleDist;
+        if (extendStart) {
+            // Extending start backward: angle should be just before arcStart (CCW).
+            angleDist = math::normalizeAngle(arcStart - angle);
+        } else {
+            // Extending end forward: angle should be just after arcEnd (CCW).
+            angleDist = math::normalizeAngle(angle - arcEnd);
         }
 
-        // Also check circle/arc entities.
-        if (auto* circ = dynamic_cast<const draft::DraftCircle*>(other.get())) {
-            auto pts = draft::intersectCircleCircle(arc->center(), arc->radius(), circ->center(),
-                                                    circ->radius());
-            for (const auto& pt : pts) {
-                double angle = math::normalizeAngle(
-                    std::atan2(pt.y - arc->center().y, pt.x - arc->center().x));
-                double offset = math::normalizeAngle(angle - arcStart);
-                double arcSweep = arc->sweepAngle();
-                if (offset >= -1e-6 && offset <= arcSweep + 1e-6) continue;
-
-                double angleDist;
-                if (extendStart) {
-                    angleDist = math::normalizeAngle(arcStart - angle);
-                } else {
-                    angleDist = math::normalizeAngle(angle - arcEnd);
-                }
-
-                if (angleDist > 1e-6 && angleDist < bestAngleDist) {
-                    bestAngleDist = angleDist;
-                    bestAngle = angle;
-                    found = true;
-                }
-            }
-        } else if (auto* otherArc = dynamic_cast<const draft::DraftArc*>(other.get())) {
-            auto pts = draft::intersectCircleCircle(arc->center(), arc->radius(),
-                                                    otherArc->center(), otherArc->radius());
-            for (const auto& pt : pts) {
-                // Check the point is on the other arc.
-                double otherAngle = math::normalizeAngle(
-                    std::atan2(pt.y - otherArc->center().y, pt.x - otherArc->center().x));
-                double otherOffset = math::normalizeAngle(otherAngle - otherArc->startAngle());
-                if (otherOffset > otherArc->sweepAngle() + 1e-6) continue;
-
-                double angle = math::normalizeAngle(
-                    std::atan2(pt.y - arc->center().y, pt.x - arc->center().x));
-                double offset = math::normalizeAngle(angle - arcStart);
-                double arcSweep = arc->sweepAngle();
-                if (offset >= -1e-6 && offset <= arcSweep + 1e-6) continue;
-
-                double angleDist;
-                if (extendStart) {
-                    angleDist = math::normalizeAngle(arcStart - angle);
-                } else {
-                    angleDist = math::normalizeAngle(angle - arcEnd);
-                }
-
-                if (angleDist > 1e-6 && angleDist < bestAngleDist) {
-                    bestAngleDist = angleDist;
-                    bestAngle = angle;
-                    found = true;
-                }
-            }
+        if (angleDist > 1e-6 && angleDist < bestAngleDist) {
+            bestAngleDist = angleDist;
+            bestAngle = angle;
+            found = true;
         }
     }
 
@@ -238,7 +156,7 @@ bool ExtendTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     const auto& layerMgr = m_viewport->document()->layerManager();
     std::shared_ptr<draft::DraftEntity> target;
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         if (entity->hitTest(worldPos, tolerance)) {
             target = entity;
@@ -249,11 +167,18 @@ bool ExtendTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
 
     auto composite = std::make_unique<doc::CompositeCommand>("Extend");
 
+    // Boundaries are the entities on visible layers.
+    auto isBoundary = [&layerMgr](const draft::DraftEntity& other) {
+        const auto* lp = layerMgr.getLayer(other.layerId());
+        return lp && lp->visible;
+    };
+    auto& engine = m_viewport->intersectionEngine();
+
     bool success = false;
     if (auto* line = dynamic_cast<const draft::DraftLine*>(target.get())) {
-        success = extendLine(line, worldPos, doc.entities(), layerMgr, *composite, doc);
+        success = extendLine(line, worldPos, engine, isBoundary, *composite, doc);
     } else if (auto* arc = dynamic_cast<const draft::DraftArc*>(target.get())) {
-        success = extendArc(arc, worldPos, doc.entities(), layerMgr, *composite, doc);
+        success = extendArc(arc, worldPos, engine, isBoundary, *composite, doc);
     }
 
     if (success && !composite->empty()) {
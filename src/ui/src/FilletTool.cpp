@@ -41,12 +41,8 @@ bool FilletTool::computeFillet(uint64_t lineAId, const math::Vec2& clickA, uint6
     auto& doc = m_viewport->document()->draftDocument();
 
     // Find the two lines.
-    const draft::DraftLine* lineA = nullptr;
-    const draft::DraftLine* lineB = nullptr;
-    for (const auto& e : doc.entities()) {
-        if (e->id() == lineAId) lineA = dynamic_cast<const draft::DraftLine*>(e.get());
-        if (e->id() == lineBId) lineB = dynamic_cast<const draft::DraftLine*>(e.get());
-    }
+    const auto* lineA = dynamic_cast<const draft::DraftLine*>(doc.findEntity(lineAId).get());
+    const auto* lineB = dynamic_cast<const draft::DraftLine*>(doc.findEntity(lineBId).get());
     if (!lineA || !lineB) return false;
 
     // Find infinite-line intersection (not clamped to segments).
@@ -150,7 +146,7 @@ bool FilletTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     if (m_state == State::SelectFirstLine) {
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             if (dynamic_cast<const draft::DraftLine*>(entity.get()) &&
                 entity->hitTest(worldPos, tolerance)) {
@@ -167,7 +163,7 @@ bool FilletTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
             if (entity->id() == m_firstEntityId) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             if (!dynamic_cast<const draft::DraftLine*>(entity.get())) continue;
             if (!entity->hitTest(worldPos, tolerance)) continue;
@@ -188,18 +184,14 @@ bool FilletTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
 
                 // Add trimmed lines.
                 // Find originals for layer/color.
-                const draft::DraftLine* origA = nullptr;
-                const draft::DraftLine* origB = nullptr;
-                for (const auto& e : doc.entities()) {
-                    if (e->id() == m_firstEntityId)
-                        origA = dynamic_cast<const draft::DraftLine*>(e.get());
-                    if (e->id() == entity->id())
-                        origB = dynamic_cast<const draft::DraftLine*>(e.get());
-                }
+                const auto* origA = dynamic_cast<const draft::DraftLine*>(
+                    doc.findEntity(m_firstEntityId).get());
+                const auto* origB =
+                    dynamic_cast<const draft::DraftLine*>(doc.findEntity(entity->id()).get());
 
                 auto newLineA = std::make_shared<draft::DraftLine>(trimA_start, trimA_end);
                 if (origA) {
-                    newLineA->setLayer(origA->layer());
+                    newLineA->setLayerId(origA->layerId());
                     newLineA->setColor(origA->color());
                     newLineA->setLineWidth(origA->lineWidth());
                     newLineA->setLineType(origA->lineType());
@@ -208,7 +200,7 @@ bool FilletTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
 
                 auto newLineB = std::make_shared<draft::DraftLine>(trimB_start, trimB_end);
                 if (origB) {
-                    newLineB->setLayer(origB->layer());
+                    newLineB->setLayerId(origB->layerId());
                     newLineB->setColor(origB->color());
                     newLineB->setLineWidth(origB->lineWidth());
                     newLineB->setLineType(origB->lineType());
@@ -219,7 +211,7 @@ bool FilletTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
                 auto filletArc =
                     std::make_shared<draft::DraftArc>(arcCenter, arcRadius, arcStart, arcEnd);
                 if (origA) {
-                    filletArc->setLayer(origA->layer());
+                    filletArc->setLayerId(origA->layerId());
                     filletArc->setColor(origA->color());
                     filletArc->setLineWidth(origA->lineWidth());
                     filletArc->setLineType(origA->lineType());
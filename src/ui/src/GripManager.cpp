@@ -298,4 +298,36 @@ bool GripManager::moveGrip(draft::DraftEntity& entity, int gripIndex, const math
     return false;
 }
 
+// ---------------------------------------------------------------------------
+// gripFeature() — constraint feature under a grip
+// ---------------------------------------------------------------------------
+
+std::optional<cstr::GeometryRef> GripManager::gripFeature(const draft::DraftEntity& entity,
+                                                          int gripIndex) {
+    auto point = [&](int featureIndex) {
+        return cstr::GeometryRef{entity.id(), cstr::FeatureType::Point, featureIndex};
+    };
+
+    if (dynamic_cast<const draft::DraftLine*>(&entity)) {
+        if (gripIndex == 0 || gripIndex == 1) return point(gripIndex);
+        return std::nullopt;
+    }
+
+    // Circle quadrants and arc ends change the radius or angles, not a point.
+    if (dynamic_cast<const draft::DraftCircle*>(&entity) ||
+        dynamic_cast<const draft::DraftArc*>(&entity)) {
+        if (gripIndex == 0) return point(0);
+        return std::nullopt;
+    }
+
+    if (auto* e = dynamic_cast<const draft::DraftPolyline*>(&entity)) {
+        if (gripIndex >= 0 && gripIndex < static_cast<int>(e->points().size())) {
+            return point(gripIndex);
+        }
+        return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
 }  // namespace hz::ui
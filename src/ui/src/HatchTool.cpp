@@ -2,6 +2,7 @@
 
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <algorithm>
 #include <cmath>
 
 #include "horizon/document/Commands.h"
@@ -68,7 +69,7 @@ bool HatchTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
 
     const draft::DraftEntity* hitEntity = nullptr;
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         if (entity->hitTest(worldPos, tolerance)) {
             hitEntity = entity.get();
@@ -82,9 +83,26 @@ bool HatchTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     auto boundary = extractBoundary(hitEntity);
     if (boundary.empty()) return true;  // Not a valid boundary source.
 
+    // Closed entities lying entirely inside the boundary become islands.
+    draft::DraftHatch outer(boundary);
+    std::vector<std::vector<math::Vec2>> holes;
+    for (uint64_t id : doc.spatialIndex().query(outer.boundingBox())) {
+        auto other = doc.findEntity(id);
+        if (!other || other.get() == hitEntity) continue;
+        const auto* lp = layerMgr.getLayer(other->layerId());
+        if (!lp || !lp->visible) continue;
+        auto loop = extractBoundary(other.get());
+        if (loop.empty()) continue;
+        if (std::all_of(loop.begin(), loop.end(),
+                        [&outer](const math::Vec2& p) { return outer.contains(p); })) {
+            holes.push_back(std::move(loop));
+        }
+    }
+
     // Create the hatch entity on the current layer.
-    auto hatch = std::make_shared<draft::DraftHatch>(boundary);
-    hatch->setLayer(m_viewport->document()->layerManager().currentLayer());
+    auto hatch = std::make_shared<draft::DraftHatch>(boundary, draft::HatchPattern::Lines, 0.0,
+                                                     1.0, holes);
+    hatch->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
     auto cmd = std::make_unique<doc::AddEntityCommand>(doc, hatch);
     m_viewport->document()->undoStack().push(std::move(cmd));
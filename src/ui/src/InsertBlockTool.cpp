@@ -33,8 +33,7 @@ bool InsertBlockTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worl
     math::Vec2 pos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         pos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -42,7 +41,7 @@ bool InsertBlockTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worl
     // Place a block reference.
     if (m_viewport && m_viewport->document()) {
         auto ref = std::make_shared<draft::DraftBlockRef>(m_definition, pos, m_rotation, m_scale);
-        ref->setLayer(m_viewport->document()->layerManager().currentLayer());
+        ref->setLayerId(m_viewport->document()->layerManager().currentLayerId());
         auto cmd =
             std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), ref);
         m_viewport->document()->undoStack().push(std::move(cmd));
@@ -54,8 +53,7 @@ bool InsertBlockTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& w
     math::Vec2 pos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         pos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -55,6 +55,10 @@ void LayerPanel::createWidgets() {
     connect(m_deleteBtn, &QPushButton::clicked, this, &LayerPanel::onDeleteLayer);
     btnLayout->addWidget(m_deleteBtn);
 
+    m_renameBtn = new QPushButton(tr("Rename"), this);
+    connect(m_renameBtn, &QPushButton::clicked, this, &LayerPanel::onRenameLayer);
+    btnLayout->addWidget(m_renameBtn);
+
     auto* colorBtn = new QPushButton(tr("Color..."), this);
     connect(colorBtn, &QPushButton::clicked, this, &LayerPanel::onColorClicked);
     btnLayout->addWidget(colorBtn);
@@ -159,6 +163,37 @@ void LayerPanel::onDeleteLayer() {
     viewport->update();
 }
 
+void LayerPanel::onRenameLayer() {
+    auto* viewport = m_mainWindow->findChild<ViewportWidget*>();
+    if (!viewport || !viewport->document()) return;
+
+    auto* item = m_tree->currentItem();
+    if (!item) return;
+
+    QString oldName = item->data(0, Qt::UserRole).toString();
+    if (oldName == "0") {
+        QMessageBox::warning(this, tr("Error"), tr("Cannot rename the default layer."));
+        return;
+    }
+
+    bool ok = false;
+    QString newName = QInputDialog::getText(this, tr("Rename Layer"), tr("Layer name:"),
+                                            QLineEdit::Normal, oldName, &ok);
+    if (!ok || newName.isEmpty() || newName == oldName) return;
+
+    if (viewport->document()->layerManager().getLayer(newName.toStdString())) {
+        QMessageBox::warning(this, tr("Error"), tr("Layer '%1' already exists.").arg(newName));
+        return;
+    }
+
+    auto cmd = std::make_unique<doc::RenameLayerCommand>(
+        viewport->document()->layerManager(), viewport->document()->draftDocument(),
+        oldName.toStdString(), newName.toStdString());
+    viewport->document()->undoStack().push(std::move(cmd));
+    refresh();
+    viewport->update();
+}
+
 void LayerPanel::onItemDoubleClicked(QTreeWidgetItem* item, int column) {
     if (!item) return;
 
@@ -31,8 +31,7 @@ bool LeaderTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     math::Vec2 snapped = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snapped = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -49,8 +48,7 @@ bool LeaderTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldP
     math::Vec2 snapped = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snapped = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -100,7 +98,7 @@ void LeaderTool::finishLeader() {
     }
 
     auto leader = std::make_shared<draft::DraftLeader>(m_points, text.toStdString());
-    leader->setLayer(m_viewport->document()->layerManager().currentLayer());
+    leader->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
     auto cmd =
         std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), leader);
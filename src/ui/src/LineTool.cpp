@@ -19,6 +19,7 @@ void LineTool::deactivate() {
     m_state = State::WaitingForStart;
     if (m_viewport) {
         m_viewport->setLastSnapResult({});
+        m_viewport->snapEngine().clearReferencePoint();
     }
     Tool::deactivate();
 }
@@ -30,8 +31,7 @@ bool LineTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -41,17 +41,19 @@ bool LineTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
             m_startPoint = snappedPos;
             m_currentPos = snappedPos;
             m_state = State::WaitingForEnd;
+            if (m_viewport) m_viewport->snapEngine().setReferencePoint(snappedPos);
             return true;
 
         case State::WaitingForEnd:
             // Commit the line via undo command.
             if (m_viewport && m_viewport->document()) {
                 auto line = std::make_shared<draft::DraftLine>(m_startPoint, snappedPos);
-                line->setLayer(m_viewport->document()->layerManager().currentLayer());
+                line->setLayerId(m_viewport->document()->layerManager().currentLayerId());
                 auto cmd = std::make_unique<doc::AddEntityCommand>(
                     m_viewport->document()->draftDocument(), line);
                 m_viewport->document()->undoStack().push(std::move(cmd));
             }
+            if (m_viewport) m_viewport->snapEngine().clearReferencePoint();
             m_state = State::WaitingForStart;
             return true;
     }
@@ -63,8 +65,7 @@ bool LineTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPos
         math::Vec2 snappedPos = worldPos;
         if (m_viewport && m_viewport->document()) {
             auto& draftDoc = m_viewport->document()->draftDocument();
-            auto result = m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(),
-                                                        draftDoc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
             snappedPos = result.point;
             m_viewport->setLastSnapResult(result);
         }
@@ -90,6 +91,7 @@ void LineTool::cancel() {
     m_state = State::WaitingForStart;
     if (m_viewport) {
         m_viewport->setLastSnapResult({});
+        m_viewport->snapEngine().clearReferencePoint();
     }
 }
 
@@ -30,8 +30,7 @@ bool LinearDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
     math::Vec2 snapped = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snapped = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -55,7 +54,7 @@ bool LinearDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
             auto orientation = detectOrientation();
             auto dim = std::make_shared<draft::DraftLinearDimension>(m_point1, m_point2, snapped,
                                                                      orientation);
-            dim->setLayer(m_viewport->document()->layerManager().currentLayer());
+            dim->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
             auto cmd = std::make_unique<doc::AddEntityCommand>(
                 m_viewport->document()->draftDocument(), dim);
@@ -76,8 +75,7 @@ bool LinearDimensionTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec
     math::Vec2 snapped = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snapped = result.point;
         m_viewport->setLastSnapResult(result);
     }
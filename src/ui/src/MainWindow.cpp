@@ -21,10 +21,12 @@
 #include <filesystem>
 #include <functional>
 #include <numbers>
+#include <set>
 
 #include "horizon/document/Commands.h"
 #include "horizon/document/UndoStack.h"
 #include "horizon/drafting/DraftBlockRef.h"
+#include "horizon/drafting/Intersection.h"
 #include "horizon/fileio/DxfFormat.h"
 #include "horizon/fileio/NativeFormat.h"
 #include "horizon/math/BoundingBox.h"
@@ -322,6 +324,7 @@ void MainWindow::createMenus() {
     toolsMenu->addSeparator();
     toolsMenu->addAction(tr("Rectangular &Array"), this, &MainWindow::onRectangularArray);
     toolsMenu->addAction(tr("Polar Arra&y"), this, &MainWindow::onPolarArray);
+    toolsMenu->addAction(tr("Remove &Duplicates"), this, &MainWindow::onRemoveDuplicates);
 
     // ---- Measure ----
     QMenu* measureMenu = menuBar()->addMenu(tr("&Measure"));
@@ -586,8 +589,7 @@ void MainWindow::updateStatusBar() {
         m_statusPrompt->setText(tr("Ready"));
     }
 
-    auto ids = m_viewport->selectionManager().selectedIds();
-    int count = static_cast<int>(ids.size());
+    int count = static_cast<int>(m_viewport->selectionManager().count());
     m_statusSelection->setText(count == 1 ? tr("1 selected") : tr("%1 selected").arg(count));
 }
 
@@ -1206,7 +1208,7 @@ void MainWindow::onDuplicate() {
     std::vector<uint64_t> idVec;
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         idVec.push_back(entity->id());
     }
@@ -1253,7 +1255,7 @@ void MainWindow::onCut() {
     auto composite = std::make_unique<doc::CompositeCommand>("Cut");
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         composite->addCommand(
             std::make_unique<doc::RemoveEntityCommand>(m_document->draftDocument(), entity->id()));
@@ -1299,13 +1301,8 @@ void MainWindow::onViewIsometric() {
 }
 
 void MainWindow::onFitAll() {
-    math::BoundingBox bbox;
-    for (const auto& entity : m_document->draftDocument().entities()) {
-        auto entityBBox = entity->boundingBox();
-        if (entityBBox.isValid()) {
-            bbox.expand(entityBBox);
-        }
-    }
+    // The spatial index's root box is the union of all entity bounds.
+    math::BoundingBox bbox = m_document->draftDocument().spatialIndex().bounds();
     if (bbox.isValid()) {
         m_viewport->camera().fitAll(bbox);
     } else {
@@ -1436,7 +1433,7 @@ void MainWindow::onRectangularArray() {
     std::vector<uint64_t> filteredIds;
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         filteredIds.push_back(entity->id());
     }
@@ -1459,16 +1456,13 @@ void MainWindow::onRectangularArray() {
             if (r == 0 && c == 0) continue;  // Skip original position.
             math::Vec2 offset(c * sx, r * sy);
             for (uint64_t id : filteredIds) {
-                for (const auto& entity : m_document->draftDocument().entities()) {
-                    if (entity->id() == id) {
-                        auto clone = entity->clone();
-                        clone->translate(offset);
-                        newIds.push_back(clone->id());
-                        allClones.push_back(clone);
-                        composite->addCommand(std::make_unique<doc::AddEntityCommand>(
-                            m_document->draftDocument(), clone));
-                        break;
-                    }
+                if (auto entity = m_document->draftDocument().findEntity(id)) {
+                    auto clone = entity->clone();
+                    clone->translate(offset);
+                    newIds.push_back(clone->id());
+                    allClones.push_back(clone);
+                    composite->addCommand(std::make_unique<doc::AddEntityCommand>(
+                        m_document->draftDocument(), clone));
                 }
             }
         }
@@ -1495,7 +1489,7 @@ void MainWindow::onPolarArray() {
     std::vector<uint64_t> filteredIds;
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         filteredIds.push_back(entity->id());
     }
@@ -1517,16 +1511,13 @@ void MainWindow::onPolarArray() {
     for (int i = 1; i < count; ++i) {
         double angle = step * i;
         for (uint64_t id : filteredIds) {
-            for (const auto& entity : m_document->draftDocument().entities()) {
-                if (entity->id() == id) {
-                    auto clone = entity->clone();
-                    clone->rotate(center, angle);
-                    newIds.push_back(clone->id());
-                    allClones.push_back(clone);
-                    composite->addCommand(std::make_unique<doc::AddEntityCommand>(
-                        m_document->draftDocument(), clone));
-                    break;
-                }
+            if (auto entity = m_document->draftDocument().findEntity(id)) {
+                auto clone = entity->clone();
+                clone->rotate(center, angle);
+                newIds.push_back(clone->id());
+                allClones.push_back(clone);
+                composite->addCommand(std::make_unique<doc::AddEntityCommand>(
+                    m_document->draftDocument(), clone));
             }
         }
     }
@@ -1542,6 +1533,52 @@ void MainWindow::onPolarArray() {
     onSelectionChanged();
 }
 
+void MainWindow::onRemoveDuplicates() {
+    auto& sel = m_viewport->selectionManager();
+    auto& draftDoc = m_document->draftDocument();
+
+    // Work on the selection, or on the whole drawing when nothing is selected.
+    // Entities on hidden/locked layers are left alone.
+    const auto& layerMgr = m_document->layerManager();
+    const bool selectionOnly = !sel.empty();
+    std::vector<std::shared_ptr<draft::DraftEntity>> candidates;
+    for (const auto& entity : draftDoc.entities()) {
+        if (selectionOnly && !sel.isSelected(entity->id())) continue;
+        const auto* lp = layerMgr.getLayer(entity->layerId());
+        if (!lp || !lp->visible || lp->locked) continue;
+        candidates.push_back(entity);
+    }
+
+    auto sweep = draft::findAllIntersections(candidates);
+    if (sweep.redundantIds.empty()) {
+        statusBar()->showMessage(tr("No duplicate or overlapped entities found"));
+        return;
+    }
+
+    // Drop the constraints on the removed entities first, as Delete does, then remove
+    // the entities in one batch.
+    auto composite = std::make_unique<doc::CompositeCommand>("Remove Duplicates");
+    auto& cstrSys = m_document->constraintSystem();
+    std::set<uint64_t> removedConstraints;
+    for (uint64_t id : sweep.redundantIds) {
+        for (const auto* c : cstrSys.constraintsForEntity(id)) {
+            if (removedConstraints.insert(c->id()).second) {
+                composite->addCommand(
+                    std::make_unique<doc::RemoveConstraintCommand>(cstrSys, c->id()));
+            }
+        }
+    }
+    composite->addCommand(
+        std::make_unique<doc::RemoveEntitiesCommand>(draftDoc, sweep.redundantIds));
+    m_document->undoStack().push(std::move(composite));
+    for (uint64_t id : sweep.redundantIds) sel.deselect(id);
+
+    statusBar()->showMessage(
+        tr("Removed %1 duplicate or overlapped entities").arg(sweep.redundantIds.size()));
+    m_viewport->update();
+    onSelectionChanged();
+}
+
 // ---------------------------------------------------------------------------
 // Slots -- Dimension tools
 // ---------------------------------------------------------------------------
@@ -1694,7 +1731,7 @@ void MainWindow::onCreateBlock() {
     std::vector<uint64_t> filteredIds;
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         filteredIds.push_back(entity->id());
     }
@@ -1799,7 +1836,7 @@ void MainWindow::onGroupEntities() {
     std::vector<uint64_t> filteredIds;
     for (const auto& entity : m_document->draftDocument().entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         filteredIds.push_back(entity->id());
     }
@@ -1851,9 +1888,7 @@ void MainWindow::onMouseMoved(const hz::math::Vec2& worldPos) {
 }
 
 void MainWindow::onSelectionChanged() {
-    auto ids = m_viewport->selectionManager().selectedIds();
-    std::vector<uint64_t> idVec(ids.begin(), ids.end());
-    m_propertyPanel->updateForSelection(idVec);
+    m_propertyPanel->updateForSelection(m_viewport->selectionManager().selectedIds());
     updateStatusBar();
 }
 
@@ -31,8 +31,7 @@ bool MeasureAngleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -88,8 +87,7 @@ bool MeasureAngleTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2&
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -43,7 +43,7 @@ bool MirrorTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         if (sel.empty()) return false;  // Nothing selected to mirror.
 
         // Apply snapping.
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_axisP1 = result.point;
         m_viewport->setLastSnapResult(result);
 
@@ -52,7 +52,7 @@ bool MirrorTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     }
 
     if (m_state == State::SelectSecondPoint) {
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         math::Vec2 axisP2 = result.point;
         m_viewport->setLastSnapResult(result);
 
@@ -63,7 +63,7 @@ bool MirrorTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         std::vector<uint64_t> idVec;
         for (const auto& entity : doc.entities()) {
             if (!sel.isSelected(entity->id())) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             idVec.push_back(entity->id());
         }
@@ -91,7 +91,7 @@ bool MirrorTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldP
     m_currentPos = worldPos;
     if (m_state == State::SelectSecondPoint && m_viewport && m_viewport->document()) {
         auto& doc = m_viewport->document()->draftDocument();
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_currentPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
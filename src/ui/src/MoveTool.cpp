@@ -33,7 +33,7 @@ bool MoveTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     const auto& layerMgr = m_viewport->document()->layerManager();
     for (const auto& entity : doc.entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         if (entity->hitTest(worldPos, tolerance)) {
             hitSelected = true;
@@ -44,7 +44,7 @@ bool MoveTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
 
     // Apply snapping.
     math::Vec2 snappedPos = worldPos;
-    auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+    auto result = m_viewport->snapEngine().snap(worldPos, doc);
     snappedPos = result.point;
     m_viewport->setLastSnapResult(result);
 
@@ -61,8 +61,7 @@ bool MoveTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPos
 
     math::Vec2 snappedPos = worldPos;
     auto& draftDoc = m_viewport->document()->draftDocument();
-    auto result =
-        m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+    auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
     snappedPos = result.point;
     m_viewport->setLastSnapResult(result);
 
@@ -74,9 +73,10 @@ bool MoveTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPos
     const auto& layerMgr = m_viewport->document()->layerManager();
     for (const auto& entity : doc.entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         entity->translate(delta);
+        doc.updateEntity(entity);
     }
 
     m_dragCurrent = snappedPos;
@@ -100,9 +100,10 @@ bool MoveTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& /*worldPo
 
     for (const auto& entity : doc.entities()) {
         if (!sel.isSelected(entity->id())) continue;
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         entity->translate(neg);
+        doc.updateEntity(entity);
     }
 
     if (std::abs(m_totalDelta.x) > 1e-10 || std::abs(m_totalDelta.y) > 1e-10) {
@@ -110,7 +111,7 @@ bool MoveTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& /*worldPo
         std::vector<uint64_t> idVec;
         for (const auto& entity : doc.entities()) {
             if (!sel.isSelected(entity->id())) continue;
-            const auto* lp2 = layerMgr.getLayer(entity->layer());
+            const auto* lp2 = layerMgr.getLayer(entity->layerId());
             if (!lp2 || !lp2->visible || lp2->locked) continue;
             idVec.push_back(entity->id());
         }
@@ -144,9 +145,10 @@ void MoveTool::cancel() {
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
             if (!sel.isSelected(entity->id())) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             entity->translate(neg);
+            doc.updateEntity(entity);
         }
     }
     m_dragging = false;
@@ -114,9 +114,9 @@ double OffsetTool::computeDistanceAndSide(int& side) const {
     }
 
     if (auto* ellipse = dynamic_cast<const draft::DraftEllipse*>(m_sourceEntity.get())) {
-        auto pts = ellipse->evaluate(64);
+        auto flat = ellipse->flattened();
         double minDist = 1e18;
-        for (const auto& pt : pts) {
+        for (const auto& pt : flat->points) {
             double d = m_currentPos.distanceTo(pt);
             if (d < minDist) minDist = d;
         }
@@ -245,7 +245,7 @@ bool OffsetTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         // Hit-test to find entity under cursor (skip hidden/locked layers).
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             if (entity->hitTest(worldPos, tolerance)) {
                 m_sourceEntity = entity;
@@ -260,7 +260,7 @@ bool OffsetTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     if (m_state == State::SpecifyDistance) {
         auto offset = computeOffset();
         if (offset) {
-            offset->setLayer(m_sourceEntity->layer());
+            offset->setLayerId(m_sourceEntity->layerId());
             offset->setColor(m_sourceEntity->color());
             offset->setLineWidth(m_sourceEntity->lineWidth());
             offset->setLineType(m_sourceEntity->lineType());
@@ -89,6 +89,46 @@ void OverlayRenderer::renderSnapMarker(QOpenGLExtraFunctions* gl, const render::
             pushSeg(verts, cx - s, cy + s, cx + s, cy - s);
             break;
         }
+        case draft::SnapType::Intersection: {
+            // X cross inside a square
+            pushSeg(verts, cx - s, cy - s, cx + s, cy + s);
+            pushSeg(verts, cx - s, cy + s, cx + s, cy - s);
+            pushSeg(verts, cx - s, cy - s, cx + s, cy - s);
+            pushSeg(verts, cx + s, cy - s, cx + s, cy + s);
+            pushSeg(verts, cx + s, cy + s, cx - s, cy + s);
+            pushSeg(verts, cx - s, cy + s, cx - s, cy - s);
+            break;
+        }
+        case draft::SnapType::Perpendicular: {
+            // Right-angle symbol
+            pushSeg(verts, cx - s, cy + s, cx - s, cy - s);
+            pushSeg(verts, cx - s, cy - s, cx + s, cy - s);
+            pushSeg(verts, cx - s, cy, cx, cy);
+            pushSeg(verts, cx, cy, cx, cy - s);
+            break;
+        }
+        case draft::SnapType::Tangent: {
+            // Circle (12 segments) with a tangent line across the top
+            const int segs = 12;
+            for (int i = 0; i < segs; ++i) {
+                double a1 = 2.0 * M_PI * i / segs;
+                double a2 = 2.0 * M_PI * (i + 1) / segs;
+                pushSeg(verts, cx + s * static_cast<float>(std::cos(a1)),
+                        cy + s * static_cast<float>(std::sin(a1)),
+                        cx + s * static_cast<float>(std::cos(a2)),
+                        cy + s * static_cast<float>(std::sin(a2)));
+            }
+            pushSeg(verts, cx - s, cy + s, cx + s, cy + s);
+            break;
+        }
+        case draft::SnapType::Nearest: {
+            // Hourglass
+            pushSeg(verts, cx - s, cy + s, cx + s, cy + s);
+            pushSeg(verts, cx + s, cy + s, cx - s, cy - s);
+            pushSeg(verts, cx - s, cy - s, cx + s, cy - s);
+            pushSeg(verts, cx + s, cy - s, cx - s, cy + s);
+            break;
+        }
         case draft::SnapType::None:
         default:
             break;
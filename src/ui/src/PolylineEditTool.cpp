@@ -14,6 +14,11 @@
 
 namespace hz::ui {
 
+/// The polyline with the given id, or nullptr if there is none.
+static draft::DraftPolyline* findPolyline(const draft::DraftDocument& doc, uint64_t id) {
+    return dynamic_cast<draft::DraftPolyline*>(doc.findEntity(id).get());
+}
+
 // ---------------------------------------------------------------------------
 // Activation / deactivation
 // ---------------------------------------------------------------------------
@@ -41,15 +46,12 @@ void PolylineEditTool::cancel() {
     if (m_dragging && m_beforeClone && m_viewport && m_viewport->document()) {
         // Restore entity state in-place from before-clone.
         auto& doc = m_viewport->document()->draftDocument();
-        for (auto& entity : doc.entities()) {
-            if (entity->id() == m_editEntityId) {
-                auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
-                auto* beforePoly = dynamic_cast<const draft::DraftPolyline*>(m_beforeClone.get());
-                if (poly && beforePoly) {
-                    poly->setPoints(beforePoly->points());
-                    poly->setClosed(beforePoly->closed());
-                }
-                break;
+        if (auto entity = doc.findEntity(m_editEntityId)) {
+            auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
+            auto* beforePoly = dynamic_cast<const draft::DraftPolyline*>(m_beforeClone.get());
+            if (poly && beforePoly) {
+                poly->setPoints(beforePoly->points());
+                poly->setClosed(beforePoly->closed());
             }
         }
         m_dragging = false;
@@ -78,16 +80,13 @@ void PolylineEditTool::pushSnapshot(const std::string& desc) {
     auto& doc = m_viewport->document()->draftDocument();
 
     // Find current state of the entity.
-    for (const auto& entity : doc.entities()) {
-        if (entity->id() == m_editEntityId) {
-            auto afterClone = entity->clone();
-            auto& cstrSys = m_viewport->document()->constraintSystem();
-            auto cmd = std::make_unique<doc::GripMoveCommand>(doc, m_editEntityId, m_beforeClone,
-                                                              afterClone, cstrSys);
-            m_viewport->document()->undoStack().push(std::move(cmd));
-            m_beforeClone = nullptr;
-            return;
-        }
+    if (auto entity = doc.findEntity(m_editEntityId)) {
+        auto afterClone = entity->clone();
+        auto& cstrSys = m_viewport->document()->constraintSystem();
+        auto cmd = std::make_unique<doc::GripMoveCommand>(doc, m_editEntityId, m_beforeClone,
+                                                          afterClone, cstrSys);
+        m_viewport->document()->undoStack().push(std::move(cmd));
+        m_beforeClone = nullptr;
     }
 }
 
@@ -95,60 +94,52 @@ int PolylineEditTool::findNearestVertex(const math::Vec2& worldPos, double toler
     if (!m_viewport || !m_viewport->document()) return -1;
     auto& doc = m_viewport->document()->draftDocument();
 
-    for (const auto& entity : doc.entities()) {
-        if (entity->id() != m_editEntityId) continue;
-        auto* poly = dynamic_cast<const draft::DraftPolyline*>(entity.get());
-        if (!poly) return -1;
-
-        const auto& pts = poly->points();
-        double bestDist = tolerance;
-        int bestIdx = -1;
-        for (int i = 0; i < static_cast<int>(pts.size()); ++i) {
-            double d = worldPos.distanceTo(pts[i]);
-            if (d < bestDist) {
-                bestDist = d;
-                bestIdx = i;
-            }
+    const auto* poly = findPolyline(doc, m_editEntityId);
+    if (!poly) return -1;
+
+    const auto& pts = poly->points();
+    double bestDist = tolerance;
+    int bestIdx = -1;
+    for (int i = 0; i < static_cast<int>(pts.size()); ++i) {
+        double d = worldPos.distanceTo(pts[i]);
+        if (d < bestDist) {
+            bestDist = d;
+            bestIdx = i;
         }
-        return bestIdx;
     }
-    return -1;
+    return bestIdx;
 }
 
 int PolylineEditTool::findNearestSegment(const math::Vec2& worldPos, math::Vec2& closestPt) const {
     if (!m_viewport || !m_viewport->document()) return -1;
     auto& doc = m_viewport->document()->draftDocument();
 
-    for (const auto& entity : doc.entities()) {
-        if (entity->id() != m_editEntityId) continue;
-        auto* poly = dynamic_cast<const draft::DraftPolyline*>(entity.get());
-        if (!poly) return -1;
-
-        const auto& pts = poly->points();
-        int segCount = static_cast<int>(pts.size()) - 1;
-        if (poly->closed() && pts.size() >= 2) segCount += 1;
-
-        double bestDist = 1e18;
-        int bestIdx = -1;
-
-        for (int i = 0; i < segCount; ++i) {
-            const math::Vec2& a = pts[i];
-            const math::Vec2& b = pts[(i + 1) % pts.size()];
-            math::Vec2 ab = b - a;
-            math::Vec2 ap = worldPos - a;
-            double lenSq = ab.lengthSquared();
-            double t = (lenSq < 1e-14) ? 0.0 : math::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
-            math::Vec2 proj = a + ab * t;
-            double d = worldPos.distanceTo(proj);
-            if (d < bestDist) {
-                bestDist = d;
-                bestIdx = i;
-                closestPt = proj;
-            }
+    const auto* poly = findPolyline(doc, m_editEntityId);
+    if (!poly) return -1;
+
+    const auto& pts = poly->points();
+    int segCount = static_cast<int>(pts.size()) - 1;
+    if (poly->closed() && pts.size() >= 2) segCount += 1;
+
+    double bestDist = 1e18;
+    int bestIdx = -1;
+
+    for (int i = 0; i < segCount; ++i) {
+        const math::Vec2& a = pts[i];
+        const math::Vec2& b = pts[(i + 1) % pts.size()];
+        math::Vec2 ab = b - a;
+        math::Vec2 ap = worldPos - a;
+        double lenSq = ab.lengthSquared();
+        double t = (lenSq < 1e-14) ? 0.0 : math::clamp(ap.dot(ab) / lenSq, 0.0, 1.0);
+        math::Vec2 proj = a + ab * t;
+        double d = worldPos.distanceTo(proj);
+        if (d < bestDist) {
+            bestDist = d;
+            bestIdx = i;
+            closestPt = proj;
         }
-        return bestIdx;
     }
-    return -1;
+    return bestIdx;
 }
 
 // ---------------------------------------------------------------------------
@@ -168,7 +159,7 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
     if (m_editEntityId == 0) {
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             if (!dynamic_cast<const draft::DraftPolyline*>(entity.get())) continue;
             if (entity->hitTest(worldPos, tolerance)) {
@@ -185,11 +176,8 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
         int idx = findNearestVertex(worldPos, gripTol);
         if (idx >= 0) {
             // Start dragging this vertex.
-            for (const auto& entity : doc.entities()) {
-                if (entity->id() == m_editEntityId) {
-                    m_beforeClone = entity->clone();
-                    break;
-                }
+            if (auto entity = doc.findEntity(m_editEntityId)) {
+                m_beforeClone = entity->clone();
             }
             m_dragging = true;
             m_dragVertexIndex = idx;
@@ -200,7 +188,7 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
             if (entity->id() == m_editEntityId) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             if (!dynamic_cast<const draft::DraftPolyline*>(entity.get())) continue;
             if (entity->hitTest(worldPos, tolerance)) {
@@ -219,17 +207,12 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
         math::Vec2 closestPt;
         int segIdx = findNearestSegment(worldPos, closestPt);
         if (segIdx >= 0) {
-            for (auto& entity : doc.entities()) {
-                if (entity->id() != m_editEntityId) continue;
-                auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
-                if (!poly) break;
-
-                m_beforeClone = entity->clone();
+            if (auto* poly = findPolyline(doc, m_editEntityId)) {
+                m_beforeClone = poly->clone();
                 auto pts = poly->points();
                 pts.insert(pts.begin() + segIdx + 1, closestPt);
                 poly->setPoints(pts);
                 pushSnapshot("Add vertex");
-                break;
             }
         }
         m_mode = Mode::MoveVertex;
@@ -239,20 +222,13 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
     if (m_mode == Mode::RemoveVertex) {
         int idx = findNearestVertex(worldPos, gripTol);
         if (idx >= 0) {
-            for (auto& entity : doc.entities()) {
-                if (entity->id() != m_editEntityId) continue;
-                auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
-                if (!poly) break;
-
-                const auto& pts = poly->points();
-                if (pts.size() <= 2) break;  // Min 2 points.
-
-                m_beforeClone = entity->clone();
-                auto newPts = pts;
+            auto* poly = findPolyline(doc, m_editEntityId);
+            if (poly && poly->points().size() > 2) {  // Min 2 points.
+                m_beforeClone = poly->clone();
+                auto newPts = poly->points();
                 newPts.erase(newPts.begin() + idx);
                 poly->setPoints(newPts);
                 pushSnapshot("Remove vertex");
-                break;
             }
         }
         m_mode = Mode::MoveVertex;
@@ -263,18 +239,14 @@ bool PolylineEditTool::mousePressEvent(QMouseEvent* event, const math::Vec2& wor
         const auto& layerMgr = m_viewport->document()->layerManager();
         for (const auto& entity : doc.entities()) {
             if (entity->id() == m_editEntityId) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             auto* otherPoly = dynamic_cast<const draft::DraftPolyline*>(entity.get());
             if (!otherPoly) continue;
             if (!entity->hitTest(worldPos, tolerance)) continue;
 
             // Find current polyline.
-            draft::DraftPolyline* myPoly = nullptr;
-            for (auto& e : doc.entities()) {
-                if (e->id() == m_editEntityId)
-                    myPoly = dynamic_cast<draft::DraftPolyline*>(e.get());
-            }
+            draft::DraftPolyline* myPoly = findPolyline(doc, m_editEntityId);
             if (!myPoly) break;
 
             m_beforeClone = myPoly->clone();
@@ -335,14 +307,9 @@ bool PolylineEditTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2&
 
     if (m_dragging && m_editEntityId != 0 && m_viewport && m_viewport->document()) {
         auto& doc = m_viewport->document()->draftDocument();
-        for (auto& entity : doc.entities()) {
-            if (entity->id() != m_editEntityId) continue;
-            auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
-            if (!poly) break;
-
+        if (auto* poly = findPolyline(doc, m_editEntityId)) {
             // Snap.
-            auto result =
-                m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, doc);
             math::Vec2 snappedPos = result.point;
 
             auto pts = poly->points();
@@ -350,7 +317,6 @@ bool PolylineEditTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2&
                 pts[m_dragVertexIndex] = snappedPos;
                 poly->setPoints(pts);
             }
-            break;
         }
         return true;
     }
@@ -397,15 +363,10 @@ bool PolylineEditTool::keyPressEvent(QKeyEvent* event) {
             // Toggle closed/open.
             if (!m_viewport || !m_viewport->document()) return true;
             auto& doc = m_viewport->document()->draftDocument();
-            for (auto& entity : doc.entities()) {
-                if (entity->id() != m_editEntityId) continue;
-                auto* poly = dynamic_cast<draft::DraftPolyline*>(entity.get());
-                if (!poly) break;
-
-                m_beforeClone = entity->clone();
+            if (auto* poly = findPolyline(doc, m_editEntityId)) {
+                m_beforeClone = poly->clone();
                 poly->setClosed(!poly->closed());
                 pushSnapshot("Toggle closed");
-                break;
             }
             return true;
         }
@@ -432,18 +393,14 @@ std::vector<std::pair<math::Vec2, double>> PolylineEditTool::getPreviewCircles()
     double pixelScale = m_viewport->pixelToWorldScale();
     double dotRadius = 4.0 * pixelScale;
 
-    for (const auto& entity : doc.entities()) {
-        if (entity->id() != m_editEntityId) continue;
-        auto* poly = dynamic_cast<const draft::DraftPolyline*>(entity.get());
-        if (!poly) break;
+    const auto* poly = findPolyline(doc, m_editEntityId);
+    if (!poly) return {};
 
-        std::vector<std::pair<math::Vec2, double>> circles;
-        for (const auto& pt : poly->points()) {
-            circles.push_back({pt, dotRadius});
-        }
-        return circles;
+    std::vector<std::pair<math::Vec2, double>> circles;
+    for (const auto& pt : poly->points()) {
+        circles.push_back({pt, dotRadius});
     }
-    return {};
+    return circles;
 }
 
 std::string PolylineEditTool::promptText() const {
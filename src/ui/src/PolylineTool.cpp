@@ -21,6 +21,7 @@ void PolylineTool::deactivate() {
     m_active = false;
     if (m_viewport) {
         m_viewport->setLastSnapResult({});
+        m_viewport->snapEngine().clearReferencePoint();
     }
     Tool::deactivate();
 }
@@ -41,8 +42,7 @@ bool PolylineTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPo
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -50,6 +50,7 @@ bool PolylineTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPo
     m_points.push_back(snappedPos);
     m_currentPos = snappedPos;
     m_active = true;
+    if (m_viewport) m_viewport->snapEngine().setReferencePoint(snappedPos);
     return true;
 }
 
@@ -59,8 +60,7 @@ bool PolylineTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worl
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -89,13 +89,14 @@ void PolylineTool::cancel() {
     m_active = false;
     if (m_viewport) {
         m_viewport->setLastSnapResult({});
+        m_viewport->snapEngine().clearReferencePoint();
     }
 }
 
 void PolylineTool::finishPolyline() {
     if (m_points.size() >= 2 && m_viewport && m_viewport->document()) {
         auto polyline = std::make_shared<draft::DraftPolyline>(m_points);
-        polyline->setLayer(m_viewport->document()->layerManager().currentLayer());
+        polyline->setLayerId(m_viewport->document()->layerManager().currentLayerId());
         auto cmd = std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(),
                                                            polyline);
         m_viewport->document()->undoStack().push(std::move(cmd));
@@ -104,6 +105,7 @@ void PolylineTool::finishPolyline() {
     m_active = false;
     if (m_viewport) {
         m_viewport->setLastSnapResult({});
+        m_viewport->snapEngine().clearReferencePoint();
     }
 }
 
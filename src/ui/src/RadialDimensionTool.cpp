@@ -37,7 +37,7 @@ bool RadialDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
         const auto& layerMgr = m_viewport->document()->layerManager();
 
         for (const auto& entity : entities) {
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
 
             if (auto* circle = dynamic_cast<const draft::DraftCircle*>(entity.get())) {
@@ -66,7 +66,7 @@ bool RadialDimensionTool::mousePressEvent(QMouseEvent* event, const math::Vec2&
 
         auto dim = std::make_shared<draft::DraftRadialDimension>(m_center, m_radius, m_currentPos,
                                                                  m_isDiameter);
-        dim->setLayer(m_viewport->document()->layerManager().currentLayer());
+        dim->setLayerId(m_viewport->document()->layerManager().currentLayerId());
 
         auto cmd =
             std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), dim);
@@ -30,8 +30,7 @@ bool RectangleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldP
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -46,7 +45,7 @@ bool RectangleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldP
         case State::WaitingForSecondCorner:
             if (m_viewport && m_viewport->document()) {
                 auto rect = std::make_shared<draft::DraftRectangle>(m_firstCorner, snappedPos);
-                rect->setLayer(m_viewport->document()->layerManager().currentLayer());
+                rect->setLayerId(m_viewport->document()->layerManager().currentLayerId());
                 auto cmd = std::make_unique<doc::AddEntityCommand>(
                     m_viewport->document()->draftDocument(), rect);
                 m_viewport->document()->undoStack().push(std::move(cmd));
@@ -63,8 +62,7 @@ bool RectangleTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& wor
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -45,7 +45,7 @@ bool RotateTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         auto& sel = m_viewport->selectionManager();
         if (sel.empty()) return false;
 
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_center = result.point;
         m_viewport->setLastSnapResult(result);
 
@@ -55,7 +55,7 @@ bool RotateTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     }
 
     if (m_state == State::SelectAngle) {
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_viewport->setLastSnapResult(result);
 
         double angle = std::atan2(result.point.y - m_center.y, result.point.x - m_center.x);
@@ -66,7 +66,7 @@ bool RotateTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         std::vector<uint64_t> idVec;
         for (const auto& entity : doc.entities()) {
             if (!sel.isSelected(entity->id())) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             idVec.push_back(entity->id());
         }
@@ -93,7 +93,7 @@ bool RotateTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldP
     m_currentPos = worldPos;
     if (m_state == State::SelectAngle && m_viewport) {
         auto& doc = m_viewport->document()->draftDocument();
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_currentPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -139,7 +139,7 @@ bool RotateTool::keyPressEvent(QKeyEvent* event) {
                     std::vector<uint64_t> idVec;
                     for (const auto& entity : doc.entities()) {
                         if (!sel.isSelected(entity->id())) continue;
-                        const auto* lp2 = layerMgr.getLayer(entity->layer());
+                        const auto* lp2 = layerMgr.getLayer(entity->layerId());
                         if (!lp2 || !lp2->visible || lp2->locked) continue;
                         idVec.push_back(entity->id());
                     }
@@ -61,7 +61,7 @@ bool ScaleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         auto& sel = m_viewport->selectionManager();
         if (sel.empty()) return false;
 
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_basePoint = result.point;
         m_viewport->setLastSnapResult(result);
 
@@ -73,7 +73,7 @@ bool ScaleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     }
 
     if (m_state == State::SelectScaleFactor) {
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_viewport->setLastSnapResult(result);
 
         double mouseDist = m_basePoint.distanceTo(result.point);
@@ -85,7 +85,7 @@ bool ScaleTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         std::vector<uint64_t> idVec;
         for (const auto& entity : doc.entities()) {
             if (!sel.isSelected(entity->id())) continue;
-            const auto* lp = layerMgr.getLayer(entity->layer());
+            const auto* lp = layerMgr.getLayer(entity->layerId());
             if (!lp || !lp->visible || lp->locked) continue;
             idVec.push_back(entity->id());
         }
@@ -112,7 +112,7 @@ bool ScaleTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPo
     m_currentPos = worldPos;
     if (m_state == State::SelectScaleFactor && m_viewport) {
         auto& doc = m_viewport->document()->draftDocument();
-        auto result = m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, doc);
         m_currentPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -157,7 +157,7 @@ bool ScaleTool::keyPressEvent(QKeyEvent* event) {
                     std::vector<uint64_t> idVec;
                     for (const auto& entity : doc.entities()) {
                         if (!sel.isSelected(entity->id())) continue;
-                        const auto* lp2 = layerMgr.getLayer(entity->layer());
+                        const auto* lp2 = layerMgr.getLayer(entity->layerId());
                         if (!lp2 || !lp2->visible || lp2->locked) continue;
                         idVec.push_back(entity->id());
                     }
@@ -5,10 +5,12 @@
 #include <QMouseEvent>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numbers>
 #include <set>
 
 #include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/DragSession.h"
 #include "horizon/document/Commands.h"
 #include "horizon/document/ConstraintCommands.h"
 #include "horizon/document/ConstraintSolveHelper.h"
@@ -20,25 +22,23 @@
 
 namespace hz::ui {
 
+SelectTool::~SelectTool() = default;
+
 // Expand the current selection to include all group mates of selected entities.
 // Respects layer visibility/lock — hidden/locked entities are NOT added.
 static void expandSelectionToGroups(render::SelectionManager& sel, const draft::DraftDocument& doc,
                                     const draft::LayerManager& layerMgr) {
     std::set<uint64_t> groupIds;
     for (uint64_t id : sel.selectedIds()) {
-        for (const auto& e : doc.entities()) {
-            if (e->id() == id && e->groupId() != 0) {
-                groupIds.insert(e->groupId());
-                break;
-            }
-        }
+        auto e = doc.findEntity(id);
+        if (e && e->groupId() != 0) groupIds.insert(e->groupId());
     }
     if (groupIds.empty()) return;
 
     for (const auto& e : doc.entities()) {
         if (e->groupId() == 0) continue;
         if (groupIds.count(e->groupId()) == 0) continue;
-        const auto* lp = layerMgr.getLayer(e->layer());
+        const auto* lp = layerMgr.getLayer(e->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         sel.select(e->id());
     }
@@ -69,26 +69,40 @@ bool SelectTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
         double gripTol = std::max(8.0 * pixelScale, 0.12);
 
         for (uint64_t id : selectedIds) {
-            for (const auto& e : doc.entities()) {
-                if (e->id() != id) continue;
-                auto grips = GripManager::gripPoints(*e);
-                for (int gi = 0; gi < static_cast<int>(grips.size()); ++gi) {
-                    if (worldPos.distanceTo(grips[gi]) <= gripTol) {
-                        // Start grip drag.
-                        m_draggingGrip = true;
-                        m_gripEntityId = id;
-                        m_gripIndex = gi;
-                        m_gripOrigPos = grips[gi];
-                        m_gripCurrentPos = worldPos;
-                        m_gripBeforeClone = e->clone();
-                        m_gripBeforeClone->setId(e->id());
-                        m_gripBeforeClone->setLayer(e->layer());
-                        m_gripBeforeClone->setColor(e->color());
-                        m_gripBeforeClone->setLineWidth(e->lineWidth());
-                        return true;
+            auto e = doc.findEntity(id);
+            if (!e) continue;
+            auto grips = GripManager::gripPoints(*e);
+            for (int gi = 0; gi < static_cast<int>(grips.size()); ++gi) {
+                if (worldPos.distanceTo(grips[gi]) <= gripTol) {
+                    // Start grip drag.
+                    m_draggingGrip = true;
+                    m_gripEntityId = id;
+                    m_gripIndex = gi;
+                    m_gripOrigPos = grips[gi];
+                    m_gripCurrentPos = worldPos;
+                    m_gripBeforeClone = e->clone();
+                    m_gripBeforeClone->setId(e->id());
+                    m_gripBeforeClone->setLayerId(e->layerId());
+                    m_gripBeforeClone->setColor(e->color());
+                    m_gripBeforeClone->setLineWidth(e->lineWidth());
+
+                    // A constrained point drags its whole constraint component along.
+                    if (auto feature = GripManager::gripFeature(*e, gi)) {
+                        auto session = std::make_unique<cstr::DragSession>(
+                            doc.entities(), m_viewport->document()->constraintSystem(),
+                            *feature);
+                        if (session->constrained()) {
+                            for (uint64_t cid : session->entityIds()) {
+                                if (auto ce = doc.findEntity(cid)) {
+                                    m_dragBefore.push_back(ce->clone());
+                                    m_dragBefore.back()->setId(cid);
+                                }
+                            }
+                            m_dragSession = std::move(session);
+                        }
                     }
+                    return true;
                 }
-                break;
             }
         }
     }
@@ -110,25 +124,31 @@ bool SelectTool::mouseMoveEvent(QMouseEvent* event, const math::Vec2& worldPos)
 
         math::Vec2 snappedPos = worldPos;
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
 
         m_gripCurrentPos = snappedPos;
 
         auto& doc = m_viewport->document()->draftDocument();
-        for (auto& e : doc.entities()) {
-            if (e->id() == m_gripEntityId) {
-                auto fresh = m_gripBeforeClone->clone();
-                fresh->setId(m_gripEntityId);
-                fresh->setLayer(m_gripBeforeClone->layer());
-                fresh->setColor(m_gripBeforeClone->color());
-                fresh->setLineWidth(m_gripBeforeClone->lineWidth());
-                e = fresh;
-                GripManager::moveGrip(*e, m_gripIndex, snappedPos);
-                break;
+        if (m_dragSession) {
+            // Re-solve the dragged component only, warm-started from the last event.
+            m_dragSession->drag(snappedPos);
+            std::vector<std::shared_ptr<draft::DraftEntity>> moved;
+            moved.reserve(m_dragSession->entityIds().size());
+            for (uint64_t id : m_dragSession->entityIds()) {
+                if (auto e = doc.findEntity(id)) moved.push_back(std::move(e));
             }
+            m_dragSession->apply(moved);
+            doc.updateEntities(moved);
+        } else if (doc.findEntity(m_gripEntityId)) {
+            auto fresh = m_gripBeforeClone->clone();
+            fresh->setId(m_gripEntityId);
+            fresh->setLayerId(m_gripBeforeClone->layerId());
+            fresh->setColor(m_gripBeforeClone->color());
+            fresh->setLineWidth(m_gripBeforeClone->lineWidth());
+            GripManager::moveGrip(*fresh, m_gripIndex, snappedPos);
+            doc.replaceEntity(fresh);
         }
 
         m_viewport->update();
@@ -161,19 +181,33 @@ bool SelectTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& worldPo
     if (!m_viewport || !m_viewport->document()) return false;
 
     // --- Grip drag release ---
+    if (m_draggingGrip && m_dragSession) {
+        // The drag already solved as it went: record the component's before and after
+        // states rather than solving again.
+        auto composite = std::make_unique<doc::CompositeCommand>("Grip Edit");
+        composite->addCommand(constrainedDragCommand());
+        m_viewport->document()->undoStack().push(std::move(composite));
+
+        m_dragSession.reset();
+        m_dragBefore.clear();
+        m_draggingGrip = false;
+        m_gripEntityId = 0;
+        m_gripIndex = -1;
+        m_gripBeforeClone = nullptr;
+        m_viewport->setLastSnapResult({});
+        return true;
+    }
+
     if (m_draggingGrip) {
         auto& doc = m_viewport->document()->draftDocument();
 
         std::shared_ptr<draft::DraftEntity> afterClone;
-        for (const auto& e : doc.entities()) {
-            if (e->id() == m_gripEntityId) {
-                afterClone = e->clone();
-                afterClone->setId(e->id());
-                afterClone->setLayer(e->layer());
-                afterClone->setColor(e->color());
-                afterClone->setLineWidth(e->lineWidth());
-                break;
-            }
+        if (auto e = doc.findEntity(m_gripEntityId)) {
+            afterClone = e->clone();
+            afterClone->setId(e->id());
+            afterClone->setLayerId(e->layerId());
+            afterClone->setColor(e->color());
+            afterClone->setLineWidth(e->lineWidth());
         }
 
         if (afterClone && m_gripBeforeClone) {
@@ -216,28 +250,33 @@ bool SelectTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& worldPo
             sel.clearSelection();
         }
 
-        auto candidateIds = doc.spatialIndex().query(selectRect);
-
-        for (uint64_t candId : candidateIds) {
-            for (const auto& entity : doc.entities()) {
-                if (entity->id() != candId) continue;
-                const auto* lp = layerMgr.getLayer(entity->layer());
-                if (!lp || !lp->visible || lp->locked) break;
-
-                if (windowMode) {
-                    math::BoundingBox ebb = entity->boundingBox();
-                    if (!ebb.isValid()) break;
-                    // Window: entity must be fully inside the selection rectangle.
-                    if (selectRect.contains(ebb)) {
-                        sel.select(entity->id());
-                    }
-                } else {
-                    // Already confirmed intersects via R*-tree query.
-                    sel.select(entity->id());
+        const auto& store = doc.entityStore();
+        std::vector<uint64_t> picked;
+        doc.spatialIndex().query(selectRect, [&](uint64_t candId) {
+            // Lines, arcs, circles and polylines are read from the packed store; other
+            // entity types fall back to the entity itself.
+            auto handle = doc.storeHandle(candId);
+            std::shared_ptr<draft::DraftEntity> entity;
+            if (!handle.valid()) {
+                entity = doc.findEntity(candId);
+                if (!entity) return;
+            }
+            const auto* lp = layerMgr.getLayer(entity ? entity->layerId() : store.layer(handle));
+            if (!lp || !lp->visible || lp->locked) return;
+
+            if (windowMode) {
+                math::BoundingBox ebb = entity ? entity->boundingBox() : store.boundingBox(handle);
+                if (!ebb.isValid()) return;
+                // Window: entity must be fully inside the selection rectangle.
+                if (selectRect.contains(ebb)) {
+                    picked.push_back(candId);
                 }
-                break;
+            } else {
+                // Already confirmed intersects via R*-tree query.
+                picked.push_back(candId);
             }
-        }
+        });
+        sel.select(picked);
 
         expandSelectionToGroups(sel, doc, layerMgr);
         m_viewport->update();
@@ -256,23 +295,26 @@ bool SelectTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& worldPo
 
     uint64_t hitId = 0;
     {
-        math::BoundingBox searchBox(
-            math::Vec3(worldPos.x - tolerance, worldPos.y - tolerance, -1e9),
-            math::Vec3(worldPos.x + tolerance, worldPos.y + tolerance, 1e9));
-        auto candidateIds = doc.spatialIndex().query(searchBox);
-
-        for (uint64_t candId : candidateIds) {
-            for (const auto& entity : doc.entities()) {
-                if (entity->id() != candId) continue;
-                const auto* lp = layerMgr.getLayer(entity->layer());
-                if (!lp || !lp->visible || lp->locked) break;
-                if (entity->hitTest(worldPos, tolerance)) {
-                    hitId = entity->id();
-                }
-                break;
+        // Best-first: candidates are hit-tested in order of box distance from
+        // the cursor, stopping at the first one that is actually hit.
+        const auto& store = doc.entityStore();
+        auto hitDistance = [&](uint64_t candId, const math::BoundingBox& bbox) {
+            constexpr double kMiss = std::numeric_limits<double>::infinity();
+            if (auto handle = doc.storeHandle(candId); handle.valid()) {
+                const auto* lp = layerMgr.getLayer(store.layer(handle));
+                if (!lp || !lp->visible || lp->locked) return kMiss;
+                if (!store.hitTest(handle, worldPos, tolerance)) return kMiss;
+                return draft::SpatialIndex::boxDistance(worldPos, bbox);
             }
-            if (hitId != 0) break;
-        }
+            auto entity = doc.findEntity(candId);
+            if (!entity) return kMiss;
+            const auto* lp = layerMgr.getLayer(entity->layerId());
+            if (!lp || !lp->visible || lp->locked) return kMiss;
+            if (!entity->hitTest(worldPos, tolerance)) return kMiss;
+            return draft::SpatialIndex::boxDistance(worldPos, bbox);
+        };
+        auto hits = doc.spatialIndex().nearest(worldPos, 1, tolerance, hitDistance);
+        if (!hits.empty()) hitId = hits.front().value;
     }
 
     bool shiftHeld = (event->modifiers() & Qt::ShiftModifier);
@@ -280,12 +322,7 @@ bool SelectTool::mouseReleaseEvent(QMouseEvent* event, const math::Vec2& worldPo
     if (hitId != 0) {
         // Find the groupId of the hit entity.
         uint64_t hitGroupId = 0;
-        for (const auto& entity : doc.entities()) {
-            if (entity->id() == hitId) {
-                hitGroupId = entity->groupId();
-                break;
-            }
-        }
+        if (auto entity = doc.findEntity(hitId)) hitGroupId = entity->groupId();
 
         if (shiftHeld) {
             if (hitGroupId != 0 && sel.isSelected(hitId)) {
@@ -342,15 +379,10 @@ bool SelectTool::keyPressEvent(QKeyEvent* event) {
         }
 
         for (uint64_t id : ids) {
-            bool canDelete = true;
-            for (const auto& e : doc.entities()) {
-                if (e->id() == id) {
-                    const auto* lp = layerMgr.getLayer(e->layer());
-                    if (!lp || !lp->visible || lp->locked) canDelete = false;
-                    break;
-                }
+            if (auto e = doc.findEntity(id)) {
+                const auto* lp = layerMgr.getLayer(e->layerId());
+                if (!lp || !lp->visible || lp->locked) continue;
             }
-            if (!canDelete) continue;
             composite->addCommand(std::make_unique<doc::RemoveEntityCommand>(doc, id));
         }
         if (!composite->empty()) {
@@ -377,14 +409,11 @@ bool SelectTool::handleConstraintDoubleClick(const math::Vec2& worldPos) {
         const auto entityIds = constraint->referencedEntityIds();
         bool hit = false;
         for (uint64_t eid : entityIds) {
-            for (const auto& e : draftDoc.entities()) {
-                if (e->id() != eid) continue;
-                if (e->hitTest(worldPos, tolerance)) {
-                    hit = true;
-                }
+            auto e = draftDoc.findEntity(eid);
+            if (e && e->hitTest(worldPos, tolerance)) {
+                hit = true;
                 break;
             }
-            if (hit) break;
         }
 
         if (hit) {
@@ -456,27 +485,41 @@ void SelectTool::cancel() {
         return;
     }
 
-    if (m_draggingGrip && m_gripBeforeClone && m_viewport && m_viewport->document()) {
+    if (m_draggingGrip && m_dragSession && m_viewport && m_viewport->document()) {
+        constrainedDragCommand()->undo();
+        m_viewport->update();
+    } else if (m_draggingGrip && m_gripBeforeClone && m_viewport && m_viewport->document()) {
         auto& doc = m_viewport->document()->draftDocument();
-        for (auto& e : doc.entities()) {
-            if (e->id() == m_gripEntityId) {
-                auto restored = m_gripBeforeClone->clone();
-                restored->setId(m_gripEntityId);
-                restored->setLayer(m_gripBeforeClone->layer());
-                restored->setColor(m_gripBeforeClone->color());
-                restored->setLineWidth(m_gripBeforeClone->lineWidth());
-                e = restored;
-                break;
-            }
+        if (doc.findEntity(m_gripEntityId)) {
+            auto restored = m_gripBeforeClone->clone();
+            restored->setId(m_gripEntityId);
+            restored->setLayerId(m_gripBeforeClone->layerId());
+            restored->setColor(m_gripBeforeClone->color());
+            restored->setLineWidth(m_gripBeforeClone->lineWidth());
+            doc.replaceEntity(restored);
         }
         m_viewport->update();
     }
+    m_dragSession.reset();
+    m_dragBefore.clear();
     m_draggingGrip = false;
     m_gripEntityId = 0;
     m_gripIndex = -1;
     m_gripBeforeClone = nullptr;
 }
 
+std::unique_ptr<doc::ApplyConstraintSolveCommand> SelectTool::constrainedDragCommand() const {
+    auto& doc = m_viewport->document()->draftDocument();
+    std::vector<doc::ApplyConstraintSolveCommand::EntitySnapshot> snapshots;
+    snapshots.reserve(m_dragBefore.size());
+    for (const auto& before : m_dragBefore) {
+        auto e = doc.findEntity(before->id());
+        if (!e) continue;
+        snapshots.push_back({before->id(), before, e->clone()});
+    }
+    return std::make_unique<doc::ApplyConstraintSolveCommand>(doc, std::move(snapshots));
+}
+
 std::vector<std::pair<math::Vec2, math::Vec2>> SelectTool::getPreviewLines() const {
     if (m_draggingGrip) {
         return {{m_gripOrigPos, m_gripCurrentPos}};
@@ -40,8 +40,7 @@ bool SplineTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos)
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -58,8 +57,7 @@ bool SplineTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldP
     math::Vec2 snappedPos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         snappedPos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -94,7 +92,7 @@ void SplineTool::cancel() {
 void SplineTool::finishSpline() {
     if (m_controlPoints.size() >= 4 && m_viewport && m_viewport->document()) {
         auto spline = std::make_shared<draft::DraftSpline>(m_controlPoints);
-        spline->setLayer(m_viewport->document()->layerManager().currentLayer());
+        spline->setLayerId(m_viewport->document()->layerManager().currentLayerId());
         auto cmd = std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(),
                                                            spline);
         m_viewport->document()->undoStack().push(std::move(cmd));
@@ -118,6 +118,7 @@ static void restoreEntityState(const draft::DraftEntity& src, draft::DraftEntity
     } else if (auto* s = dynamic_cast<const draft::DraftHatch*>(&src)) {
         auto* d = dynamic_cast<draft::DraftHatch*>(&dst);
         d->setBoundary(s->boundary());
+        d->setHoles(s->holes());
     } else if (auto* s = dynamic_cast<const draft::DraftBlockRef*>(&src)) {
         auto* d = dynamic_cast<draft::DraftBlockRef*>(&dst);
         d->setInsertPos(s->insertPos());
@@ -267,7 +268,7 @@ void StretchTool::collectStretchEntities() {
     math::BoundingBox windowBB(math::Vec3(wMin.x, wMin.y, -1e9), math::Vec3(wMax.x, wMax.y, 1e9));
 
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
 
         // Quick reject: entity must intersect the crossing window.
@@ -306,15 +307,13 @@ void StretchTool::applyCurrentStretch() {
     math::Vec2 disp{m_currentPos.x - m_basePoint.x, m_currentPos.y - m_basePoint.y};
 
     for (const auto& se : m_stretchEntities) {
-        for (const auto& entity : doc.entities()) {
-            if (entity->id() != se.entityId) continue;
-
+        if (auto entity = doc.findEntity(se.entityId)) {
             // Restore to before-state first.
             restoreEntityState(*se.beforeClone, *entity);
 
             // Then apply stretch with current displacement.
             applyStretch(*entity, se.insideIndices, se.totalPoints, disp);
-            break;
+            doc.updateEntity(entity);
         }
     }
 }
@@ -328,10 +327,9 @@ void StretchTool::restoreAllEntities() {
     auto& doc = m_viewport->document()->draftDocument();
 
     for (const auto& se : m_stretchEntities) {
-        for (const auto& entity : doc.entities()) {
-            if (entity->id() != se.entityId) continue;
+        if (auto entity = doc.findEntity(se.entityId)) {
             restoreEntityState(*se.beforeClone, *entity);
-            break;
+            doc.updateEntity(entity);
         }
     }
 }
@@ -374,8 +372,7 @@ bool StretchTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos
         case State::WaitingBasePoint: {
             // Apply snapping for precise base point.
             auto& doc = m_viewport->document()->draftDocument();
-            auto result =
-                m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, doc);
             m_basePoint = result.point;
             m_currentPos = result.point;
             m_viewport->setLastSnapResult(result);
@@ -386,8 +383,7 @@ bool StretchTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos
         case State::Dragging: {
             // Finalize the stretch.
             auto& doc = m_viewport->document()->draftDocument();
-            auto result =
-                m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, doc);
             m_currentPos = result.point;
             m_viewport->setLastSnapResult(result);
 
@@ -405,16 +401,13 @@ bool StretchTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos
             auto composite = std::make_unique<doc::CompositeCommand>("Stretch");
 
             for (auto& se : m_stretchEntities) {
-                for (const auto& entity : doc.entities()) {
-                    if (entity->id() != se.entityId) continue;
-
+                if (auto entity = doc.findEntity(se.entityId)) {
                     auto afterClone = entity->clone();
                     restoreEntityState(*se.beforeClone, *entity);
 
                     auto& cstrSys = m_viewport->document()->constraintSystem();
                     composite->addCommand(std::make_unique<doc::GripMoveCommand>(
                         doc, se.entityId, se.beforeClone, afterClone, cstrSys));
-                    break;
                 }
             }
 
@@ -439,8 +432,7 @@ bool StretchTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& world
 
         case State::Dragging: {
             auto& doc = m_viewport->document()->draftDocument();
-            auto result =
-                m_viewport->snapEngine().snap(worldPos, doc.spatialIndex(), doc.entities());
+            auto result = m_viewport->snapEngine().snap(worldPos, doc);
             m_currentPos = result.point;
             m_viewport->setLastSnapResult(result);
 
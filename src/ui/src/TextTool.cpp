@@ -18,8 +18,7 @@ bool TextTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     math::Vec2 pos = worldPos;
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         pos = result.point;
         m_viewport->setLastSnapResult(result);
     }
@@ -40,7 +39,7 @@ bool TextTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     // Create and add the text entity.
     if (m_viewport && m_viewport->document()) {
         auto txt = std::make_shared<draft::DraftText>(pos, text.toStdString(), textHeight);
-        txt->setLayer(m_viewport->document()->layerManager().currentLayer());
+        txt->setLayerId(m_viewport->document()->layerManager().currentLayerId());
         auto cmd =
             std::make_unique<doc::AddEntityCommand>(m_viewport->document()->draftDocument(), txt);
         m_viewport->document()->undoStack().push(std::move(cmd));
@@ -52,8 +51,7 @@ bool TextTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
 bool TextTool::mouseMoveEvent(QMouseEvent* /*event*/, const math::Vec2& worldPos) {
     if (m_viewport && m_viewport->document()) {
         auto& draftDoc = m_viewport->document()->draftDocument();
-        auto result =
-            m_viewport->snapEngine().snap(worldPos, draftDoc.spatialIndex(), draftDoc.entities());
+        auto result = m_viewport->snapEngine().snap(worldPos, draftDoc);
         m_viewport->setLastSnapResult(result);
     }
     return true;
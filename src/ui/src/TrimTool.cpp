@@ -11,7 +11,7 @@
 #include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftCircle.h"
 #include "horizon/drafting/DraftLine.h"
-#include "horizon/drafting/Intersection.h"
+#include "horizon/drafting/IntersectionEngine.h"
 #include "horizon/math/Constants.h"
 #include "horizon/math/MathUtils.h"
 #include "horizon/ui/ViewportWidget.h"
@@ -67,7 +67,7 @@ static void trimLine(const draft::DraftLine* line, const math::Vec2& clickPos,
         math::Vec2 segStart = line->start() + dir * params[i];
         math::Vec2 segEnd = line->start() + dir * params[i + 1];
         auto newLine = std::make_shared<draft::DraftLine>(segStart, segEnd);
-        newLine->setLayer(line->layer());
+        newLine->setLayerId(line->layerId());
         newLine->setColor(line->color());
         newLine->setLineWidth(line->lineWidth());
         composite.addCommand(std::make_unique<doc::AddEntityCommand>(doc, newLine));
@@ -125,7 +125,7 @@ static void trimCircle(const draft::DraftCircle* circle, const math::Vec2& click
         double sa = angles[i];
         double ea = angles[(i + 1) % n];
         auto arc = std::make_shared<draft::DraftArc>(circle->center(), circle->radius(), sa, ea);
-        arc->setLayer(circle->layer());
+        arc->setLayerId(circle->layerId());
         arc->setColor(circle->color());
         arc->setLineWidth(circle->lineWidth());
         composite.addCommand(std::make_unique<doc::AddEntityCommand>(doc, arc));
@@ -185,7 +185,7 @@ static void trimArc(const draft::DraftArc* arc, const math::Vec2& clickPos,
         double sa = math::normalizeAngle(arcStart + params[i] * arcSweep);
         double ea = math::normalizeAngle(arcStart + params[i + 1] * arcSweep);
         auto newArc = std::make_shared<draft::DraftArc>(arc->center(), arc->radius(), sa, ea);
-        newArc->setLayer(arc->layer());
+        newArc->setLayerId(arc->layerId());
         newArc->setColor(arc->color());
         newArc->setLineWidth(arc->lineWidth());
         composite.addCommand(std::make_unique<doc::AddEntityCommand>(doc, newArc));
@@ -208,7 +208,7 @@ bool TrimTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     const auto& layerMgr = m_viewport->document()->layerManager();
     std::shared_ptr<draft::DraftEntity> target;
     for (const auto& entity : doc.entities()) {
-        const auto* lp = layerMgr.getLayer(entity->layer());
+        const auto* lp = layerMgr.getLayer(entity->layerId());
         if (!lp || !lp->visible || lp->locked) continue;
         if (entity->hitTest(worldPos, tolerance)) {
             target = entity;
@@ -218,12 +218,8 @@ bool TrimTool::mousePressEvent(QMouseEvent* event, const math::Vec2& worldPos) {
     if (!target) return false;
 
     // Find all intersection points on the target with other entities.
-    std::vector<math::Vec2> allIsects;
-    for (const auto& other : doc.entities()) {
-        if (other->id() == target->id()) continue;
-        auto result = draft::intersect(*target, *other);
-        allIsects.insert(allIsects.end(), result.points.begin(), result.points.end());
-    }
+    std::vector<math::Vec2> allIsects =
+        m_viewport->intersectionEngine().intersections(doc, *target);
     if (allIsects.empty()) return false;  // Nothing to trim against.
 
     auto composite = std::make_unique<doc::CompositeCommand>("Trim");
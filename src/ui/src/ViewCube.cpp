@@ -19,6 +19,8 @@ namespace {
 
 constexpr double kCubeRadius = 32.0;  // half-extent of the cube silhouette, px
 constexpr double kMargin = 18.0;      // gap from the top-right viewport corner, px
+constexpr double kHomeGap = 8.0;      // gap between the cube and the home button, px
+constexpr double kHomeHeight = 16.0;  // height of the home button, px
 constexpr double kEps = 1e-6;
 
 // Camera basis: world -> view (screen-right / screen-up / into-screen).
@@ -131,8 +133,9 @@ void ViewCube::paint(QPainter& painter, int vpW, int vpH, const render::Camera&
     }
 
     // Home / isometric button beneath the cube.
-    const double bw = 46, bh = 16;
-    QRectF homeRect(center.x() - bw / 2.0, center.y() + kCubeRadius + 8.0, bw, bh);
+    const double bw = 46;
+    QRectF homeRect(center.x() - bw / 2.0, center.y() + kCubeRadius + kHomeGap, bw,
+                    kHomeHeight);
     painter.setBrush(QColor(48, 53, 63, 235));
     painter.setPen(QPen(edge, 1.0));
     painter.drawRoundedRect(homeRect, 3.0, 3.0);
@@ -146,6 +149,14 @@ void ViewCube::paint(QPainter& painter, int vpW, int vpH, const render::Camera&
     painter.restore();
 }
 
+int ViewCube::paintedHeight() {
+    // A cube corner projects at most sqrt(3) radii from the centre; the home button
+    // hangs below the cube.  Two pixels cover the pens.
+    const double below =
+        std::max(std::sqrt(3.0) * kCubeRadius, kCubeRadius + kHomeGap + kHomeHeight);
+    return static_cast<int>(std::ceil(kMargin + kCubeRadius + below)) + 2;
+}
+
 ViewCube::Region ViewCube::hitTest(const QPoint& pos) const {
     const QPointF p(pos);
     Region best = Region::None;
@@ -6,8 +6,12 @@
 #include <QOpenGLExtraFunctions>
 #include <QPainter>
 #include <QPointF>
+#include <algorithm>
 #include <cmath>
-#include <set>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <unordered_set>
 
 #include "horizon/constraint/Constraint.h"
 #include "horizon/constraint/ConstraintSystem.h"
@@ -15,17 +19,7 @@
 #include "horizon/constraint/ParameterTable.h"
 #include "horizon/constraint/SketchSolver.h"
 #include "horizon/document/Document.h"
-#include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftBlockRef.h"
-#include "horizon/drafting/DraftCircle.h"
-#include "horizon/drafting/DraftDimension.h"
-#include "horizon/drafting/DraftEllipse.h"
-#include "horizon/drafting/DraftHatch.h"
-#include "horizon/drafting/DraftLine.h"
-#include "horizon/drafting/DraftPolyline.h"
-#include "horizon/drafting/DraftRectangle.h"
-#include "horizon/drafting/DraftSpline.h"
-#include "horizon/drafting/DraftText.h"
 #include "horizon/drafting/Layer.h"
 #include "horizon/math/Constants.h"
 #include "horizon/math/Mat4.h"
@@ -34,26 +28,102 @@
 #include "horizon/render/Camera.h"
 #include "horizon/render/GLRenderer.h"
 #include "horizon/render/SelectionManager.h"
+#include "horizon/render/TextLayout.h"
 #include "horizon/ui/GripManager.h"
 #include "horizon/ui/SelectTool.h"
 #include "horizon/ui/Tool.h"
 
 namespace {
 
+/// Offset of the view-mode badge from the top-left corner and its height, px.
+constexpr double kBadgeMargin = 12.0;
+constexpr double kBadgeHeight = 22.0;
+/// Bottom edge of the badge, pen included.
+constexpr int kBadgeBottom = static_cast<int>(kBadgeMargin + kBadgeHeight) + 2;
+
+/// EntityBatch::Member::stroke of an entity drawn as a sub-pixel dot.
+constexpr size_t kDotStroke = std::numeric_limits<size_t>::max();
+
 static hz::math::Vec3 argbToVec3(uint32_t argb) {
     return {static_cast<double>((argb >> 16) & 0xFF) / 255.0,
             static_cast<double>((argb >> 8) & 0xFF) / 255.0,
             static_cast<double>(argb & 0xFF) / 255.0};
 }
 
-struct BatchKey {
-    uint32_t colorARGB;
-    float lineWidth;
-    int lineType;
-    bool operator==(const BatchKey& o) const {
-        return colorARGB == o.colorARGB && lineWidth == o.lineWidth && lineType == o.lineType;
+/// Em size glyphs are rasterized at before conversion to a distance field; the field
+/// stays sharp across the 8pt..200pt range labels are drawn at.
+constexpr int kGlyphPixelSize = 48;
+
+/// Screen pixels per typographic point (Qt's default 96 dpi for off-screen images).
+constexpr double kPixelsPerPoint = 96.0 / 72.0;
+
+/// Distance-field outline offset used for bold annotation text.
+constexpr float kBoldWeight = 0.08f;
+
+/// Layouts kept between frames before unused ones are dropped.
+constexpr size_t kMaxCachedLayouts = 4096;
+
+QFont glyphFont() {
+    QFont font("Arial");
+    font.setPixelSize(kGlyphPixelSize);
+    return font;
+}
+
+/// Rasterize one code point with Qt for the glyph atlas.
+hz::render::GlyphBitmap rasterizeGlyph(char32_t codePoint) {
+    const QFont font = glyphFont();
+    const QFontMetricsF fm(font);
+    const QString text = QString::fromUcs4(&codePoint, 1);
+
+    hz::render::GlyphBitmap glyph;
+    glyph.advance = static_cast<float>(fm.horizontalAdvance(text));
+    const QRectF bounds = fm.boundingRect(text);  // relative to the pen, y down
+    if (bounds.isEmpty()) return glyph;
+
+    // One pixel of slack on every side for antialiasing.
+    const int left = static_cast<int>(std::floor(bounds.left())) - 1;
+    const int top = static_cast<int>(std::floor(bounds.top())) - 1;
+    glyph.width = static_cast<int>(std::ceil(bounds.right())) + 1 - left;
+    glyph.height = static_cast<int>(std::ceil(bounds.bottom())) + 1 - top;
+    glyph.left = static_cast<float>(left);
+    glyph.top = static_cast<float>(-top);
+
+    QImage image(glyph.width, glyph.height, QImage::Format_Alpha8);
+    image.fill(0);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(font);
+        painter.setPen(Qt::black);
+        painter.drawText(QPointF(-left, -top), text);
+    }
+    glyph.coverage.resize(static_cast<size_t>(glyph.width) * glyph.height);
+    for (int y = 0; y < glyph.height; ++y) {
+        std::copy_n(image.constScanLine(y), glyph.width,
+                    glyph.coverage.begin() + static_cast<std::ptrdiff_t>(y) * glyph.width);
     }
-};
+    return glyph;
+}
+
+/// Compile and link a vertex + fragment shader pair.
+unsigned int linkProgram(QOpenGLExtraFunctions* gl, const char* vertSrc, const char* fragSrc) {
+    auto compileShader = [&](unsigned int type, const char* src) -> unsigned int {
+        unsigned int s = gl->glCreateShader(type);
+        gl->glShaderSource(s, 1, &src, nullptr);
+        gl->glCompileShader(s);
+        return s;
+    };
+
+    unsigned int vs = compileShader(GL_VERTEX_SHADER, vertSrc);
+    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragSrc);
+    unsigned int program = gl->glCreateProgram();
+    gl->glAttachShader(program, vs);
+    gl->glAttachShader(program, fs);
+    gl->glLinkProgram(program);
+    gl->glDeleteShader(vs);
+    gl->glDeleteShader(fs);
+    return program;
+}
 
 }  // anonymous namespace
 
@@ -84,22 +154,7 @@ void ViewportRenderer::initTextOverlayGL(QOpenGLExtraFunctions* gl) {
             FragColor = texture(uTex, vUV);
         }
     )";
-
-    auto compileShader = [&](unsigned int type, const char* src) -> unsigned int {
-        unsigned int s = gl->glCreateShader(type);
-        gl->glShaderSource(s, 1, &src, nullptr);
-        gl->glCompileShader(s);
-        return s;
-    };
-
-    unsigned int vs = compileShader(GL_VERTEX_SHADER, vertSrc);
-    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragSrc);
-    m_textOverlayShader = gl->glCreateProgram();
-    gl->glAttachShader(m_textOverlayShader, vs);
-    gl->glAttachShader(m_textOverlayShader, fs);
-    gl->glLinkProgram(m_textOverlayShader);
-    gl->glDeleteShader(vs);
-    gl->glDeleteShader(fs);
+    m_textOverlayShader = linkProgram(gl, vertSrc, fragSrc);
 
     // --- Fullscreen quad (NDC coords + UVs) ---
     // Two triangles covering [-1,1] in clip space.
@@ -114,7 +169,7 @@ void ViewportRenderer::initTextOverlayGL(QOpenGLExtraFunctions* gl) {
     gl->glGenBuffers(1, &m_textOverlayVBO);
     gl->glBindVertexArray(m_textOverlayVAO);
     gl->glBindBuffer(GL_ARRAY_BUFFER, m_textOverlayVBO);
-    gl->glBufferData(GL_ARRAY_BUFFER, sizeof(quadVerts), quadVerts, GL_STATIC_DRAW);
+    gl->glBufferData(GL_ARRAY_BUFFER, sizeof(quadVerts), quadVerts, GL_DYNAMIC_DRAW);
     gl->glEnableVertexAttribArray(0);
     gl->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
     gl->glEnableVertexAttribArray(1);
@@ -130,6 +185,77 @@ void ViewportRenderer::initTextOverlayGL(QOpenGLExtraFunctions* gl) {
     gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     gl->glBindTexture(GL_TEXTURE_2D, 0);
+    m_overlayKey = {};
+
+    // --- Glyph-atlas text: screen-space quads sampling a distance-field atlas ---
+    const char* glyphVertSrc = R"(
+        #version 330 core
+        layout(location = 0) in vec2 aPos;
+        layout(location = 1) in vec2 aUV;
+        layout(location = 2) in vec3 aColor;
+        layout(location = 3) in float aWeight;
+        uniform vec2 uViewport;
+        uniform vec2 uAtlasSize;
+        out vec2 vUV;
+        out vec3 vColor;
+        out float vWeight;
+        void main() {
+            gl_Position = vec4(aPos.x / uViewport.x * 2.0 - 1.0,
+                               1.0 - aPos.y / uViewport.y * 2.0, 0.0, 1.0);
+            vUV = aUV / uAtlasSize;
+            vColor = aColor;
+            vWeight = aWeight;
+        }
+    )";
+    const char* glyphFragSrc = R"(
+        #version 330 core
+        in vec2 vUV;
+        in vec3 vColor;
+        in float vWeight;
+        out vec4 FragColor;
+        uniform sampler2D uAtlas;
+        void main() {
+            float d = texture(uAtlas, vUV).r;
+            float w = max(fwidth(d) * 0.75, 1e-4);
+            float edge = 0.5 - vWeight;
+            float alpha = smoothstep(edge - w, edge + w, d);
+            if (alpha <= 0.0) discard;
+            FragColor = vec4(vColor, alpha);
+        }
+    )";
+    m_glyphShader = linkProgram(gl, glyphVertSrc, glyphFragSrc);
+
+    gl->glGenVertexArrays(1, &m_glyphVAO);
+    gl->glGenBuffers(1, &m_glyphVBO);
+    gl->glBindVertexArray(m_glyphVAO);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, m_glyphVBO);
+    const auto stride = static_cast<int>(render::kTextVertexFloats * sizeof(float));
+    const int sizes[] = {2, 2, 3, 1};
+    size_t offset = 0;
+    for (unsigned int attr = 0; attr < 4; ++attr) {
+        gl->glEnableVertexAttribArray(attr);
+        gl->glVertexAttribPointer(attr, sizes[attr], GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<void*>(offset * sizeof(float)));
+        offset += static_cast<size_t>(sizes[attr]);
+    }
+    gl->glBindVertexArray(0);
+    m_glyphVBOCapacity = 0;
+
+    gl->glGenTextures(1, &m_glyphTex);
+    gl->glBindTexture(GL_TEXTURE_2D, m_glyphTex);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    m_glyphTexRevision = kNeverUploaded;
+
+    if (!m_glyphAtlas) {
+        m_glyphAtlas = std::make_unique<render::GlyphAtlas>(
+            rasterizeGlyph, static_cast<float>(kGlyphPixelSize),
+            static_cast<float>(QFontMetricsF(glyphFont()).ascent()));
+        m_textLayouts = std::make_unique<render::TextLayoutCache>(*m_glyphAtlas);
+    }
 }
 
 void ViewportRenderer::destroyGL(QOpenGLExtraFunctions* gl) {
@@ -141,6 +267,23 @@ void ViewportRenderer::destroyGL(QOpenGLExtraFunctions* gl) {
     m_textOverlayVAO = 0;
     m_textOverlayVBO = 0;
     m_textOverlayShader = 0;
+    m_overlayKey = {};
+    if (m_glyphTex) gl->glDeleteTextures(1, &m_glyphTex);
+    if (m_glyphVAO) gl->glDeleteVertexArrays(1, &m_glyphVAO);
+    if (m_glyphVBO) gl->glDeleteBuffers(1, &m_glyphVBO);
+    if (m_glyphShader) gl->glDeleteProgram(m_glyphShader);
+    m_glyphTex = 0;
+    m_glyphVAO = 0;
+    m_glyphVBO = 0;
+    m_glyphShader = 0;
+
+    for (auto& batch : m_batches) render::GLRenderer::destroyLineBuffer(gl, batch.gpu);
+    m_batches.clear();
+    for (auto& group : m_blockGroups) render::GLRenderer::destroyLineInstances(gl, group.gpu);
+    m_blockGroups.clear();
+    for (auto& [def, block] : m_blockBuffers) render::GLRenderer::destroyLineBuffer(gl, block.gpu);
+    m_blockBuffers.clear();
+    m_displayLists.clear();
 }
 
 // ---------------------------------------------------------------------------
@@ -150,6 +293,7 @@ void ViewportRenderer::destroyGL(QOpenGLExtraFunctions* gl) {
 void ViewportRenderer::recomputeDOF(doc::Document* doc) {
     if (!doc) {
         m_dofAnalysis = {};
+        m_dofCache = {};
         m_dofDirty = false;
         return;
     }
@@ -157,13 +301,15 @@ void ViewportRenderer::recomputeDOF(doc::Document* doc) {
     const auto& csys = doc->constraintSystem();
     if (csys.empty()) {
         m_dofAnalysis = {};
+        m_dofCache = {};
         m_dofDirty = false;
         return;
     }
 
+    // Only components an edit changed are analysed again; the cache has the rest.
     auto params = cstr::ParameterTable::buildFromEntities(doc->draftDocument().entities(), csys);
     cstr::SketchSolver solver;
-    m_dofAnalysis = solver.analyzeDOF(params, csys);
+    m_dofAnalysis = solver.analyzeDOF(params, csys, m_dofCache);
     m_dofDirty = false;
 }
 
@@ -171,31 +317,128 @@ void ViewportRenderer::recomputeDOF(doc::Document* doc) {
 // Entity rendering
 // ---------------------------------------------------------------------------
 
+bool ViewportRenderer::updateVisibleSet(const render::Camera& camera, doc::Document& doc,
+                                        int viewportWidth, int viewportHeight) {
+    // Where a screen pixel lands on the ground plane (z = 0), if it does.
+    auto groundHit = [&](double sx, double sy) -> std::optional<math::Vec2> {
+        auto [origin, dir] = camera.screenToRay(sx, sy, viewportWidth, viewportHeight);
+        if (std::abs(dir.z) < 1e-12) return std::nullopt;
+        double t = -origin.z / dir.z;
+        if (t < 0.0) return std::nullopt;
+        return math::Vec2(origin.x + dir.x * t, origin.y + dir.y * t);
+    };
+
+    // Visible rectangle from the viewport corners; the smallest pixel footprint among
+    // them keeps the sub-pixel test conservative under perspective.
+    const double w = static_cast<double>(viewportWidth);
+    const double h = static_cast<double>(viewportHeight);
+    math::BoundingBox view;
+    double pixelSize = std::numeric_limits<double>::max();
+    const std::pair<double, double> corners[] = {{0.0, 0.0}, {w, 0.0}, {0.0, h}, {w, h}};
+    for (auto [sx, sy] : corners) {
+        auto p0 = groundHit(sx, sy);
+        auto p1 = groundHit(sx + (sx > 0.0 ? -1.0 : 1.0), sy);
+        if (!p0 || !p1) return false;
+        view.expand(math::Vec3(p0->x, p0->y, 0.0));
+        pixelSize = std::min(pixelSize, p0->distanceTo(*p1));
+    }
+    if (!(pixelSize > 0.0)) return false;
+
+    const auto& draftDoc = doc.draftDocument();
+    const auto& index = draftDoc.spatialIndex();
+    const bool zoomChanged =
+        pixelSize > m_visible.pixelSize * 2.0 || pixelSize < m_visible.pixelSize * 0.5;
+    if (m_visible.document == &draftDoc && m_visible.indexRevision == index.revision() &&
+        !zoomChanged && m_visible.region.contains(view)) {
+        return true;
+    }
+
+    const math::Vec3 pad = view.size() * 0.5;
+    m_visible.document = &draftDoc;
+    m_visible.indexRevision = index.revision();
+    m_visible.region = math::BoundingBox(view.min() - pad, view.max() + pad);
+    m_visible.pixelSize = pixelSize;
+    ++m_visible.generation;
+    index.query(m_visible.region, m_visible.ids);
+    std::sort(m_visible.ids.begin(), m_visible.ids.end());
+
+    // Entities under half a pixel (still under one after zooming in 2x) become dots.
+    m_visible.dots.clear();
+    const double dotExtent = pixelSize * 0.5;
+    const auto& store = draftDoc.entityStore();
+    for (uint64_t id : m_visible.ids) {
+        math::BoundingBox box;
+        if (auto handle = draftDoc.storeHandle(id); handle.valid()) {
+            box = store.boundingBox(handle);
+        } else if (auto entity = draftDoc.findEntity(id)) {
+            box = entity->boundingBox();
+        } else {
+            continue;
+        }
+        auto size = box.size();
+        if (std::max(size.x, size.y) >= dotExtent) continue;
+        auto c = box.center();
+        const float half = static_cast<float>(pixelSize * 0.5);
+        m_visible.dots[id] = {static_cast<float>(c.x) - half, static_cast<float>(c.y), 0.0f,
+                              0.0f, static_cast<float>(c.x) + half, static_cast<float>(c.y),
+                              0.0f, 2.0f * half};
+    }
+    return true;
+}
+
 void ViewportRenderer::renderEntities(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
                                       const render::Camera& camera, doc::Document& doc,
-                                      const render::SelectionManager& selection) {
+                                      const render::SelectionManager& selection,
+                                      int viewportWidth, int viewportHeight) {
     m_dimTexts.clear();
+    m_displayLists.beginFrame();
+    ++m_frame;
+    for (auto& batch : m_batches) batch.frameMembers.clear();
+    for (auto& group : m_blockGroups) group.instances.clear();
 
-    const auto& entities = doc.draftDocument().entities();
-    if (entities.empty()) return;
-
+    const auto& draftDoc = doc.draftDocument();
+    const auto& entities = draftDoc.entities();
     const auto& layerMgr = doc.layerManager();
+    const auto& dimStyle = draftDoc.dimensionStyle();
 
-    // Batches keyed by (color, lineWidth).
-    std::vector<std::pair<BatchKey, std::vector<float>>> batches;
+    auto findOrCreateBatch = [&](uint32_t color, float width, int lineType) -> EntityBatch& {
+        for (auto& batch : m_batches) {
+            if (batch.colorARGB == color && batch.lineWidth == width &&
+                batch.lineType == lineType) {
+                return batch;
+            }
+        }
+        EntityBatch batch;
+        batch.colorARGB = color;
+        batch.lineWidth = width;
+        batch.lineType = lineType;
+        m_batches.push_back(std::move(batch));
+        return m_batches.back();
+    };
 
-    auto findOrCreateBatch = [&](const BatchKey& key) -> std::vector<float>& {
-        for (auto& [k, v] : batches) {
-            if (k == key) return v;
+    auto findOrCreateGroup = [&](const draft::BlockDefinition* def, float width,
+                                 int lineType) -> BlockInstanceGroup& {
+        for (auto& group : m_blockGroups) {
+            if (group.definition == def && group.lineWidth == width &&
+                group.lineType == lineType) {
+                return group;
+            }
         }
-        batches.push_back({key, {}});
-        return batches.back().second;
+        BlockInstanceGroup group;
+        group.definition = def;
+        group.lineWidth = width;
+        group.lineType = lineType;
+        m_blockGroups.push_back(std::move(group));
+        return m_blockGroups.back();
     };
 
-    for (const auto& entity : entities) {
+    const bool culled = updateVisibleSet(camera, doc, viewportWidth, viewportHeight);
+    m_visible.bounded = culled;
+
+    auto drawEntity = [&](const draft::DraftEntity* entity) {
         // Layer visibility check.
-        const auto* lp = layerMgr.getLayer(entity->layer());
-        if (lp && !lp->visible) continue;
+        const auto* lp = layerMgr.getLayer(entity->layerId());
+        if (lp && !lp->visible) return;
 
         bool selected = selection.isSelected(entity->id());
 
@@ -243,214 +486,183 @@ void ViewportRenderer::renderEntities(QOpenGLExtraFunctions* gl, render::GLRende
             resolvedLineType = entity->lineType();
         }
 
-        BatchKey key{resolvedColor, resolvedWidth, resolvedLineType};
-
-        // Helper: emit a vertex (x, y, z=0, distance) into a batch.
-        auto emitVert = [](std::vector<float>& v, double x, double y, float dist) {
-            v.push_back(static_cast<float>(x));
-            v.push_back(static_cast<float>(y));
-            v.push_back(0.0f);
-            v.push_back(dist);
-        };
-
-        // Helper: emit a line segment with per-vertex distance for a point sequence.
-        auto emitPointSeq = [&emitVert](std::vector<float>& v, const std::vector<math::Vec2>& pts,
-                                        bool closed) {
-            double cumDist = 0.0;
-            for (size_t i = 0; i + 1 < pts.size(); ++i) {
-                double segLen = pts[i].distanceTo(pts[i + 1]);
-                emitVert(v, pts[i].x, pts[i].y, static_cast<float>(cumDist));
-                cumDist += segLen;
-                emitVert(v, pts[i + 1].x, pts[i + 1].y, static_cast<float>(cumDist));
-            }
-            if (closed && pts.size() >= 2) {
-                double segLen = pts.back().distanceTo(pts[0]);
-                emitVert(v, pts.back().x, pts.back().y, static_cast<float>(cumDist));
-                cumDist += segLen;
-                emitVert(v, pts[0].x, pts[0].y, static_cast<float>(cumDist));
+        if (culled) {
+            auto dot = m_visible.dots.find(entity->id());
+            if (dot != m_visible.dots.end()) {
+                EntityBatch::Member member;
+                member.entityId = entity->id();
+                member.stroke = kDotStroke;
+                member.revision = m_visible.generation;
+                member.count = dot->second.size();
+                member.vertices = &dot->second;
+                findOrCreateBatch(resolvedColor, resolvedWidth, 1).frameMembers.push_back(member);
+                return;
             }
-        };
-
-        if (auto* line = dynamic_cast<const draft::DraftLine*>(entity.get())) {
-            auto& verts = findOrCreateBatch(key);
-            double len = line->start().distanceTo(line->end());
-            emitVert(verts, line->start().x, line->start().y, 0.0f);
-            emitVert(verts, line->end().x, line->end().y, static_cast<float>(len));
-        } else if (auto* circle = dynamic_cast<const draft::DraftCircle*>(entity.get())) {
-            auto verts = circleVertices(circle->center(), circle->radius());
-            renderer.drawCircle(gl, camera, verts, argbToVec3(resolvedColor), resolvedWidth,
-                                resolvedLineType);
-        } else if (auto* arc = dynamic_cast<const draft::DraftArc*>(entity.get())) {
-            auto verts =
-                arcVertices(arc->center(), arc->radius(), arc->startAngle(), arc->endAngle());
-            renderer.drawLines(gl, camera, verts, argbToVec3(resolvedColor), resolvedWidth,
-                               resolvedLineType);
-        } else if (auto* rect = dynamic_cast<const draft::DraftRectangle*>(entity.get())) {
-            auto c = rect->corners();
-            auto& verts = findOrCreateBatch(key);
-            double cumDist = 0.0;
-            for (int i = 0; i < 4; ++i) {
-                int j = (i + 1) % 4;
-                double segLen = c[i].distanceTo(c[j]);
-                emitVert(verts, c[i].x, c[i].y, static_cast<float>(cumDist));
-                cumDist += segLen;
-                emitVert(verts, c[j].x, c[j].y, static_cast<float>(cumDist));
-            }
-        } else if (auto* polyline = dynamic_cast<const draft::DraftPolyline*>(entity.get())) {
-            auto& verts = findOrCreateBatch(key);
-            emitPointSeq(verts, polyline->points(), polyline->closed());
-        } else if (auto* spline = dynamic_cast<const draft::DraftSpline*>(entity.get())) {
-            auto& verts = findOrCreateBatch(key);
-            emitPointSeq(verts, spline->evaluate(), false);
-        } else if (auto* hatch = dynamic_cast<const draft::DraftHatch*>(entity.get())) {
-            auto& verts = findOrCreateBatch(key);
-            // Draw boundary outline with cumulative distance.
-            const auto& bnd = hatch->boundary();
-            double cumDist = 0.0;
-            for (size_t i = 0; i < bnd.size(); ++i) {
-                size_t j = (i + 1) % bnd.size();
-                double segLen = bnd[i].distanceTo(bnd[j]);
-                emitVert(verts, bnd[i].x, bnd[i].y, static_cast<float>(cumDist));
-                cumDist += segLen;
-                emitVert(verts, bnd[j].x, bnd[j].y, static_cast<float>(cumDist));
-            }
-            // Draw hatch fill lines — each starts at distance 0.
-            auto hatchLines = hatch->generateHatchLines();
-            for (const auto& [a, b] : hatchLines) {
-                double segLen = a.distanceTo(b);
-                emitVert(verts, a.x, a.y, 0.0f);
-                emitVert(verts, b.x, b.y, static_cast<float>(segLen));
-            }
-        } else if (auto* ellipse = dynamic_cast<const draft::DraftEllipse*>(entity.get())) {
-            auto& verts = findOrCreateBatch(key);
-            emitPointSeq(verts, ellipse->evaluate(), false);
-        } else if (auto* dim = dynamic_cast<const draft::DraftDimension*>(entity.get())) {
-            const auto& style = doc.draftDocument().dimensionStyle();
-            auto& verts = findOrCreateBatch(key);
-
-            auto addSegments = [&](const std::vector<std::pair<math::Vec2, math::Vec2>>& segs) {
-                for (const auto& [a, b] : segs) {
-                    double segLen = a.distanceTo(b);
-                    emitVert(verts, a.x, a.y, 0.0f);
-                    emitVert(verts, b.x, b.y, static_cast<float>(segLen));
-                }
-            };
+        }
 
-            addSegments(dim->extensionLines(style));
-            addSegments(dim->dimensionLines(style));
-            addSegments(dim->arrowheadLines(style));
-
-            // Collect text for QPainter overlay.
-            m_dimTexts.push_back({dim->textPosition(), dim->displayText(style), resolvedColor});
-        } else if (auto* bref = dynamic_cast<const draft::DraftBlockRef*>(entity.get())) {
-            // Render each sub-entity of the block definition, transformed to world space.
-            for (const auto& subEnt : bref->definition()->entities) {
-                // ByBlock resolution: sub-entity value 0 → use block ref's resolved value.
-                uint32_t subColor = subEnt->color();
-                if (subColor == 0x00000000) subColor = resolvedColor;
-                float subWidth = static_cast<float>(subEnt->lineWidth());
-                if (subWidth == 0.0f) subWidth = resolvedWidth;
-                int subLineType = subEnt->lineType();
-                if (subLineType == 0) subLineType = resolvedLineType;
-                BatchKey subKey{subColor, subWidth, subLineType};
-
-                if (auto* ln = dynamic_cast<const draft::DraftLine*>(subEnt.get())) {
-                    auto p1 = bref->transformPoint(ln->start());
-                    auto p2 = bref->transformPoint(ln->end());
-                    auto& v = findOrCreateBatch(subKey);
-                    double len = p1.distanceTo(p2);
-                    emitVert(v, p1.x, p1.y, 0.0f);
-                    emitVert(v, p2.x, p2.y, static_cast<float>(len));
-                } else if (auto* ci = dynamic_cast<const draft::DraftCircle*>(subEnt.get())) {
-                    auto wc = bref->transformPoint(ci->center());
-                    double wr = ci->radius() * std::abs(bref->uniformScale());
-                    auto cv = circleVertices(wc, wr);
-                    renderer.drawCircle(gl, camera, cv, argbToVec3(subColor), subWidth,
-                                        subLineType);
-                } else if (auto* ar = dynamic_cast<const draft::DraftArc*>(subEnt.get())) {
-                    auto wc = bref->transformPoint(ar->center());
-                    double wr = ar->radius() * std::abs(bref->uniformScale());
-                    double sa = ar->startAngle() + bref->rotation();
-                    double ea = ar->endAngle() + bref->rotation();
-                    if (bref->uniformScale() < 0.0) {
-                        double tmp = sa;
-                        sa = -ea;
-                        ea = -tmp;
-                    }
-                    auto av = arcVertices(wc, wr, sa, ea);
-                    renderer.drawLines(gl, camera, av, argbToVec3(subColor), subWidth, subLineType);
-                } else if (auto* re = dynamic_cast<const draft::DraftRectangle*>(subEnt.get())) {
-                    auto c = re->corners();
-                    auto& v = findOrCreateBatch(subKey);
-                    double cumDist = 0.0;
-                    for (int i = 0; i < 4; ++i) {
-                        auto wp1 = bref->transformPoint(c[i]);
-                        auto wp2 = bref->transformPoint(c[(i + 1) % 4]);
-                        double segLen = wp1.distanceTo(wp2);
-                        emitVert(v, wp1.x, wp1.y, static_cast<float>(cumDist));
-                        cumDist += segLen;
-                        emitVert(v, wp2.x, wp2.y, static_cast<float>(cumDist));
-                    }
-                } else if (auto* pl = dynamic_cast<const draft::DraftPolyline*>(subEnt.get())) {
-                    auto& v = findOrCreateBatch(subKey);
-                    const auto& pts = pl->points();
-                    double cumDist = 0.0;
-                    for (size_t i = 0; i + 1 < pts.size(); ++i) {
-                        auto wp1 = bref->transformPoint(pts[i]);
-                        auto wp2 = bref->transformPoint(pts[i + 1]);
-                        double segLen = wp1.distanceTo(wp2);
-                        emitVert(v, wp1.x, wp1.y, static_cast<float>(cumDist));
-                        cumDist += segLen;
-                        emitVert(v, wp2.x, wp2.y, static_cast<float>(cumDist));
-                    }
-                    if (pl->closed() && pts.size() >= 2) {
-                        auto wp1 = bref->transformPoint(pts.back());
-                        auto wp2 = bref->transformPoint(pts[0]);
-                        double segLen = wp1.distanceTo(wp2);
-                        emitVert(v, wp1.x, wp1.y, static_cast<float>(cumDist));
-                        cumDist += segLen;
-                        emitVert(v, wp2.x, wp2.y, static_cast<float>(cumDist));
-                    }
-                } else if (auto* sp = dynamic_cast<const draft::DraftSpline*>(subEnt.get())) {
-                    auto& v = findOrCreateBatch(subKey);
-                    auto evalPts = sp->evaluate();
-                    double cumDist = 0.0;
-                    for (size_t i = 0; i + 1 < evalPts.size(); ++i) {
-                        auto wp1 = bref->transformPoint(evalPts[i]);
-                        auto wp2 = bref->transformPoint(evalPts[i + 1]);
-                        double segLen = wp1.distanceTo(wp2);
-                        emitVert(v, wp1.x, wp1.y, static_cast<float>(cumDist));
-                        cumDist += segLen;
-                        emitVert(v, wp2.x, wp2.y, static_cast<float>(cumDist));
-                    }
-                } else if (auto* el = dynamic_cast<const draft::DraftEllipse*>(subEnt.get())) {
-                    auto& v = findOrCreateBatch(subKey);
-                    auto evalPts = el->evaluate();
-                    double cumDist = 0.0;
-                    for (size_t i = 0; i + 1 < evalPts.size(); ++i) {
-                        auto wp1 = bref->transformPoint(evalPts[i]);
-                        auto wp2 = bref->transformPoint(evalPts[i + 1]);
-                        double segLen = wp1.distanceTo(wp2);
-                        emitVert(v, wp1.x, wp1.y, static_cast<float>(cumDist));
-                        cumDist += segLen;
-                        emitVert(v, wp2.x, wp2.y, static_cast<float>(cumDist));
-                    }
-                }
-            }
-        } else if (auto* txt = dynamic_cast<const draft::DraftText*>(entity.get())) {
-            // Text entity — collect for QPainter overlay.
-            m_dimTexts.push_back({txt->position(), txt->text(), resolvedColor, txt->textHeight(),
-                                  txt->rotation(), static_cast<int>(txt->alignment())});
+        if (auto* bref = dynamic_cast<const draft::DraftBlockRef*>(entity)) {
+            const auto* def = bref->definition().get();
+            render::GLRenderer::LineInstance inst;
+            double c = std::cos(bref->rotation()) * bref->uniformScale();
+            double s = std::sin(bref->rotation()) * bref->uniformScale();
+            inst.offsetX = static_cast<float>(bref->insertPos().x);
+            inst.offsetY = static_cast<float>(bref->insertPos().y);
+            inst.axisX = static_cast<float>(c);
+            inst.axisY = static_cast<float>(s);
+            math::Vec3 rgb = argbToVec3(resolvedColor);
+            inst.r = static_cast<float>(rgb.x);
+            inst.g = static_cast<float>(rgb.y);
+            inst.b = static_cast<float>(rgb.z);
+            findOrCreateGroup(def, resolvedWidth, resolvedLineType).instances.push_back(inst);
+            return;
+        }
+
+        const auto& list = m_displayLists.get(*entity, dimStyle);
+
+        // Stroke styles left at 0 (ByBlock) take the entity's resolved values.
+        for (size_t i = 0; i < list.strokes.size(); ++i) {
+            const auto& stroke = list.strokes[i];
+            uint32_t color = stroke.color != 0 ? stroke.color : resolvedColor;
+            float width =
+                stroke.lineWidth != 0.0 ? static_cast<float>(stroke.lineWidth) : resolvedWidth;
+            int lineType = stroke.lineType != 0 ? stroke.lineType : resolvedLineType;
+
+            EntityBatch::Member member;
+            member.entityId = entity->id();
+            member.stroke = i;
+            member.revision = list.revision;
+            member.count = stroke.vertices.size();
+            member.vertices = &stroke.vertices;
+            findOrCreateBatch(color, width, lineType).frameMembers.push_back(member);
         }
+
+        // Collect text for the glyph-atlas text pass.
+        for (const auto& text : list.texts) {
+            m_dimTexts.push_back({text.position, text.text, resolvedColor, text.height,
+                                  text.rotation, text.alignment});
+        }
+    };
+
+    if (culled) {
+        for (uint64_t id : m_visible.ids) {
+            if (auto entity = draftDoc.findEntity(id)) drawEntity(entity.get());
+        }
+    } else {
+        for (const auto& entity : entities) drawEntity(entity.get());
     }
 
-    // Draw all batches.
-    for (const auto& [key, verts] : batches) {
-        if (!verts.empty()) {
-            renderer.drawLines(gl, camera, verts, argbToVec3(key.colorARGB), key.lineWidth,
-                               key.lineType);
+    // Upload what changed, draw every batch, and drop batches nothing uses any more.
+    for (auto& batch : m_batches) {
+        syncBatch(gl, renderer, batch);
+        renderer.drawLineBuffer(gl, camera, batch.gpu, argbToVec3(batch.colorARGB),
+                                batch.lineWidth, batch.lineType);
+    }
+    for (auto it = m_batches.begin(); it != m_batches.end();) {
+        if (it->members.empty()) {
+            render::GLRenderer::destroyLineBuffer(gl, it->gpu);
+            it = m_batches.erase(it);
+        } else {
+            ++it;
         }
     }
+
+    // Block references: one instanced draw per definition stroke.  Instance data is only
+    // re-sent when a reference was added, moved or restyled.
+    for (auto it = m_blockGroups.begin(); it != m_blockGroups.end();) {
+        auto& group = *it;
+        if (group.instances.empty()) {
+            render::GLRenderer::destroyLineInstances(gl, group.gpu);
+            it = m_blockGroups.erase(it);
+            continue;
+        }
+        auto& block = syncBlockBuffer(gl, renderer, *group.definition);
+        if (group.instances != group.uploaded || group.gpu.geometryVbo != block.gpu.vbo) {
+            renderer.uploadLineInstances(gl, group.gpu, block.gpu, group.instances);
+            group.uploaded = group.instances;
+        }
+        for (const auto& stroke : block.strokes) {
+            math::Vec3 color = argbToVec3(stroke.color);
+            float width =
+                stroke.lineWidth != 0.0 ? static_cast<float>(stroke.lineWidth) : group.lineWidth;
+            int lineType = stroke.lineType != 0 ? stroke.lineType : group.lineType;
+            renderer.drawLineInstances(gl, camera, group.gpu, stroke.firstVertex,
+                                       stroke.vertexCount, stroke.color != 0 ? &color : nullptr,
+                                       width, lineType);
+        }
+        ++it;
+    }
+    for (auto it = m_blockBuffers.begin(); it != m_blockBuffers.end();) {
+        if (it->second.frame != m_frame) {
+            render::GLRenderer::destroyLineBuffer(gl, it->second.gpu);
+            it = m_blockBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Keep lists of entities that are merely hidden; shed those of deleted entities.
+    m_displayLists.trim(entities.size() * 2 + 1024);
+}
+
+ViewportRenderer::BlockBuffer& ViewportRenderer::syncBlockBuffer(
+    QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
+    const draft::BlockDefinition& definition) {
+    const auto geom = definition.geometry();
+    auto [it, inserted] = m_blockBuffers.try_emplace(&definition);
+    BlockBuffer& block = it->second;
+    block.frame = m_frame;
+    if (!inserted && block.stamp == geom->stamp) return block;
+
+    block.stamp = geom->stamp;
+    block.strokes.clear();
+    std::vector<float> vertices;
+    for (const auto& stroke : geom->display.strokes) {
+        BlockBuffer::Stroke s;
+        s.color = stroke.color;
+        s.lineWidth = stroke.lineWidth;
+        s.lineType = stroke.lineType;
+        s.firstVertex = vertices.size() / 4;
+        s.vertexCount = stroke.vertices.size() / 4;
+        vertices.insert(vertices.end(), stroke.vertices.begin(), stroke.vertices.end());
+        block.strokes.push_back(s);
+    }
+    renderer.uploadLineBuffer(gl, block.gpu, vertices);
+    return block;
+}
+
+void ViewportRenderer::syncBatch(QOpenGLExtraFunctions* gl, render::GLRenderer& renderer,
+                                 EntityBatch& batch) {
+    auto& current = batch.members;
+    const auto& next = batch.frameMembers;
+
+    bool repack = current.size() != next.size();
+    for (size_t i = 0; !repack && i < next.size(); ++i) {
+        repack = current[i].entityId != next[i].entityId ||
+                 current[i].stroke != next[i].stroke || current[i].count != next[i].count;
+    }
+
+    if (repack) {
+        batch.vertices.clear();
+        current = next;
+        for (auto& member : current) {
+            member.offset = batch.vertices.size();
+            batch.vertices.insert(batch.vertices.end(), member.vertices->begin(),
+                                  member.vertices->end());
+        }
+        renderer.uploadLineBuffer(gl, batch.gpu, batch.vertices);
+        return;
+    }
+
+    // Same strokes in the same slots: rewrite only the re-tessellated ones.
+    for (size_t i = 0; i < next.size(); ++i) {
+        auto& member = current[i];
+        if (member.revision == next[i].revision) continue;
+        member.revision = next[i].revision;
+        std::copy(next[i].vertices->begin(), next[i].vertices->end(),
+                  batch.vertices.begin() + static_cast<std::ptrdiff_t>(member.offset));
+        renderer.patchLineBuffer(gl, batch.gpu, member.offset, next[i].vertices->data(),
+                                 member.count);
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -522,19 +734,34 @@ void ViewportRenderer::renderGrips(QOpenGLExtraFunctions* gl, render::GLRenderer
                                    const render::Camera& camera, doc::Document& doc,
                                    const render::SelectionManager& selection,
                                    double pixelToWorldScale) {
-    auto selectedIds = selection.selectedIds();
-    if (selectedIds.empty()) return;
+    if (selection.empty()) return;
+
+    // The squares only change with the selection, the zoom or an entity edit (which
+    // always goes through the spatial index), so rebuild them only then.
+    const auto& draftDoc = doc.draftDocument();
+    auto& cache = m_gripCache;
+    if (cache.document == &draftDoc && cache.selectionGeneration == selection.generation() &&
+        cache.indexRevision == draftDoc.spatialIndex().revision() &&
+        cache.pixelSize == pixelToWorldScale) {
+        if (!cache.vertices.empty()) {
+            renderer.drawLines(gl, camera, cache.vertices, math::Vec3{0.0, 1.0, 0.3}, 1.5f);
+        }
+        return;
+    }
+    cache.document = &draftDoc;
+    cache.selectionGeneration = selection.generation();
+    cache.indexRevision = draftDoc.spatialIndex().revision();
+    cache.pixelSize = pixelToWorldScale;
 
     // Grip square size in world units (6 pixels).
     double s = 6.0 * pixelToWorldScale;
 
-    std::vector<float> verts;
+    std::vector<float>& verts = cache.vertices;
+    verts.clear();
     math::Vec3 green{0.0, 1.0, 0.3};
 
-    const auto& draftDoc = doc.draftDocument();
-    for (uint64_t id : selectedIds) {
-        for (const auto& e : draftDoc.entities()) {
-            if (e->id() != id) continue;
+    for (uint64_t id : selection.selectedIds()) {
+        if (auto e = draftDoc.findEntity(id)) {
             auto grips = GripManager::gripPoints(*e);
             for (const auto& g : grips) {
                 float gx = static_cast<float>(g.x);
@@ -578,7 +805,6 @@ void ViewportRenderer::renderGrips(QOpenGLExtraFunctions* gl, render::GLRenderer
                 verts.push_back(0.0f);
                 verts.push_back(side * 4.0f);
             }
-            break;
         }
     }
 
@@ -671,64 +897,29 @@ QPointF ViewportRenderer::worldToScreen(const render::Camera& camera, const math
     return {sx, sy};
 }
 
-void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& camera,
-                                         doc::Document* doc,
-                                         const render::SelectionManager& selection,
-                                         int viewportWidth, int viewportHeight,
-                                         double pixelToWorldScale) {
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing);
-
-    // Helper to draw a single text item at a world position.
-    struct TextItem {
-        math::Vec2 worldPos;
-        std::string text;
-        uint32_t color;
-        int fontSize;
-        bool bold;
-        double rotation = 0.0;
-        int alignment = 1;  // 0=Left, 1=Center, 2=Right
-    };
-
-    auto drawItem = [&](const TextItem& item) {
-        QPointF sp = worldToScreen(camera, item.worldPos, viewportWidth, viewportHeight);
-        QColor qc(static_cast<int>((item.color >> 16) & 0xFF),
-                  static_cast<int>((item.color >> 8) & 0xFF), static_cast<int>(item.color & 0xFF));
-        painter.setPen(qc);
-
-        QFont font("Arial", item.fontSize);
-        font.setBold(item.bold);
-        painter.setFont(font);
-
-        QString text = QString::fromUtf8(item.text.c_str());
-        QFontMetrics fm(painter.font());
-        int tw = fm.horizontalAdvance(text);
-        int th = fm.ascent();
-
-        if (std::abs(item.rotation) > 1e-6) {
-            painter.save();
-            painter.translate(sp);
-            // QPainter rotates clockwise in degrees; world rotation is CCW radians.
-            painter.rotate(-item.rotation * 180.0 / 3.14159265358979323846);
-            double dx = 0.0;
-            if (item.alignment == 0)
-                dx = 0.0;
-            else if (item.alignment == 1)
-                dx = -tw * 0.5;
-            else
-                dx = -tw;
-            painter.drawText(QPointF(dx, th * 0.25), text);
-            painter.restore();
-        } else {
-            double dx = 0.0;
-            if (item.alignment == 0)
-                dx = 0.0;
-            else if (item.alignment == 1)
-                dx = -tw * 0.5;
-            else
-                dx = -tw;
-            painter.drawText(QPointF(sp.x() + dx, sp.y() + th * 0.25), text);
-        }
+void ViewportRenderer::collectTextVertices(const render::Camera& camera, doc::Document* doc,
+                                           const render::SelectionManager& selection,
+                                           int viewportWidth, int viewportHeight,
+                                           double pixelToWorldScale) {
+    m_glyphVertices.clear();
+
+    auto addItem = [&](const math::Vec2& worldPos, const std::string& text, uint32_t color,
+                       int fontSize, bool bold, double rotation, int alignment) {
+        const render::TextLayout& layout = m_textLayouts->layout(text);
+        QPointF sp = worldToScreen(camera, worldPos, viewportWidth, viewportHeight);
+        math::Vec3 rgb = argbToVec3(color);
+
+        render::TextPlacement placement;
+        placement.x = static_cast<float>(sp.x());
+        placement.y = static_cast<float>(sp.y());
+        placement.pixelSize = static_cast<float>(fontSize * kPixelsPerPoint);
+        placement.rotation = static_cast<float>(rotation);
+        placement.alignment = alignment;
+        placement.r = static_cast<float>(rgb.x);
+        placement.g = static_cast<float>(rgb.y);
+        placement.b = static_cast<float>(rgb.z);
+        placement.weight = bold ? kBoldWeight : 0.0f;
+        render::appendTextVertices(layout, *m_glyphAtlas, placement, m_glyphVertices);
     };
 
     // --- Dimension + text entity text ---
@@ -743,7 +934,7 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
             if (dt.textHeight > 0.0) {
                 fs = std::max(8, std::min(200, static_cast<int>(dt.textHeight * pxPerWorld * 0.4)));
             }
-            drawItem({dt.worldPos, dt.text, dt.color, fs, false, dt.rotation, dt.alignment});
+            addItem(dt.worldPos, dt.text, dt.color, fs, false, dt.rotation, dt.alignment);
         }
     }
 
@@ -751,20 +942,31 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
     if (doc) {
         const auto& csys = doc->constraintSystem();
         if (!csys.empty()) {
-            const auto& entities = doc->draftDocument().entities();
+            const auto& draftDoc = doc->draftDocument();
             // Yellow annotation color: QColor(255, 200, 0) = 0xFFFFC800
             constexpr uint32_t kAnnotationColor = 0xFFFFC800;
 
-            // Collect selected entity IDs to skip their constraint annotations.
-            auto selectedIds = selection.selectedIds();
-            std::set<uint64_t> selectedSet(selectedIds.begin(), selectedIds.end());
+            // Only constraints on entities near the view, each once, unless the view is
+            // unbounded.
+            std::vector<const cstr::Constraint*> shown;
+            if (m_visible.bounded && m_visible.document == &draftDoc) {
+                std::unordered_set<const cstr::Constraint*> seen;
+                for (uint64_t id : m_visible.ids) {
+                    for (const auto* c : csys.constraintsForEntity(id)) {
+                        if (seen.insert(c).second) shown.push_back(c);
+                    }
+                }
+            } else {
+                shown.reserve(csys.constraints().size());
+                for (const auto& c : csys.constraints()) shown.push_back(c.get());
+            }
 
-            for (const auto& c : csys.constraints()) {
+            for (const auto* c : shown) {
                 // Skip annotations for constraints whose entities are selected.
                 auto refIds = c->referencedEntityIds();
                 bool anySelected = false;
                 for (uint64_t eid : refIds) {
-                    if (selectedSet.count(eid)) {
+                    if (selection.isSelected(eid)) {
                         anySelected = true;
                         break;
                     }
@@ -801,7 +1003,7 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
                         symbol = "F";
                         break;
                     case cstr::ConstraintType::Distance: {
-                        auto* dc = dynamic_cast<const cstr::DistanceConstraint*>(c.get());
+                        auto* dc = dynamic_cast<const cstr::DistanceConstraint*>(c);
                         if (dc) {
                             char buf[32];
                             snprintf(buf, sizeof(buf), "%.2f", dc->dimensionalValue());
@@ -810,7 +1012,7 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
                         break;
                     }
                     case cstr::ConstraintType::Angle: {
-                        auto* ac = dynamic_cast<const cstr::AngleConstraint*>(c.get());
+                        auto* ac = dynamic_cast<const cstr::AngleConstraint*>(c);
                         if (ac) {
                             char buf[32];
                             snprintf(buf, sizeof(buf), "%.1f\xC2\xB0",
@@ -824,12 +1026,12 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
                 // Compute indicator position: midpoint of referenced features.
                 try {
                     if (!refIds.empty()) {
-                        const auto* e1 = cstr::findEntity(refIds[0], entities);
+                        auto e1 = draftDoc.findEntity(refIds[0]);
                         if (e1) {
                             auto snaps = e1->snapPoints();
                             if (!snaps.empty()) pos = snaps[0];
                             if (refIds.size() > 1) {
-                                const auto* e2 = cstr::findEntity(refIds.back(), entities);
+                                auto e2 = draftDoc.findEntity(refIds.back());
                                 if (e2) {
                                     auto snaps2 = e2->snapPoints();
                                     if (!snaps2.empty()) {
@@ -846,23 +1048,78 @@ void ViewportRenderer::renderTextToImage(QImage& image, const render::Camera& ca
                 // Offset slightly above the position.
                 pos.y += pixelToWorldScale * 12.0;
 
-                // Arial 9pt annotations.
-                drawItem({pos, symbol, color, 9, true});
+                // Arial 9pt bold annotations.
+                addItem(pos, symbol, color, 9, true, 0.0, 1);
             }
         }
     }
+}
+
+void ViewportRenderer::drawGlyphText(QOpenGLExtraFunctions* gl, int viewportWidth,
+                                     int viewportHeight) {
+    if (m_glyphVertices.empty()) return;
+
+    // Re-upload the atlas only when glyphs were added since the last frame.
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D, m_glyphTex);
+    if (m_glyphTexRevision != m_glyphAtlas->revision()) {
+        gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_glyphAtlas->width(), m_glyphAtlas->height(),
+                         0, GL_RED, GL_UNSIGNED_BYTE, m_glyphAtlas->pixels().data());
+        gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        gl->glGenerateMipmap(GL_TEXTURE_2D);
+        m_glyphTexRevision = m_glyphAtlas->revision();
+    }
+
+    const size_t bytes = m_glyphVertices.size() * sizeof(float);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, m_glyphVBO);
+    if (bytes > m_glyphVBOCapacity) {
+        m_glyphVBOCapacity = std::max(bytes, m_glyphVBOCapacity * 2);
+        gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_glyphVBOCapacity), nullptr,
+                         GL_DYNAMIC_DRAW);
+    }
+    gl->glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                        m_glyphVertices.data());
+
+    gl->glDisable(GL_DEPTH_TEST);
+    gl->glEnable(GL_BLEND);
+    gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    gl->glUseProgram(m_glyphShader);
+    gl->glUniform1i(gl->glGetUniformLocation(m_glyphShader, "uAtlas"), 0);
+    gl->glUniform2f(gl->glGetUniformLocation(m_glyphShader, "uViewport"),
+                    static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+    gl->glUniform2f(gl->glGetUniformLocation(m_glyphShader, "uAtlasSize"),
+                    static_cast<float>(m_glyphAtlas->width()),
+                    static_cast<float>(m_glyphAtlas->height()));
+
+    gl->glBindVertexArray(m_glyphVAO);
+    gl->glDrawArrays(GL_TRIANGLES, 0,
+                     static_cast<int>(m_glyphVertices.size() / render::kTextVertexFloats));
+    gl->glBindVertexArray(0);
+
+    gl->glUseProgram(0);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glEnable(GL_DEPTH_TEST);
+}
+
+void ViewportRenderer::paintOverlayToImage(QImage& image, const render::Camera& camera,
+                                           const QString& label, int viewportWidth,
+                                           int viewportHeight) {
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
 
     // Orientation gizmo (top-right) and view-mode badge (top-left).
     m_viewCube.paint(painter, viewportWidth, viewportHeight, camera);
 
     {
-        const QString label = ViewCube::orientationLabel(camera);
         QFont badgeFont("Arial", 9);
         badgeFont.setBold(true);
         painter.setFont(badgeFont);
         QFontMetrics fm(badgeFont);
         const int tw = fm.horizontalAdvance(label);
-        QRectF badge(12.0, 12.0, tw + 20.0, 22.0);
+        QRectF badge(kBadgeMargin, kBadgeMargin, tw + 20.0, kBadgeHeight);
         painter.setRenderHint(QPainter::Antialiasing, true);
         painter.setBrush(QColor(40, 44, 52, 210));
         painter.setPen(QPen(QColor(90, 98, 112), 1.0));
@@ -880,18 +1137,59 @@ void ViewportRenderer::blitTextOverlay(QOpenGLExtraFunctions* gl, const render::
                                        int viewportHeight, double pixelToWorldScale) {
     if (viewportWidth <= 0 || viewportHeight <= 0) return;
 
-    // 1. Render text to a QImage (QPainter on QImage is pure CPU).
-    QImage image(viewportWidth, viewportHeight, QImage::Format_RGBA8888_Premultiplied);
-    image.fill(Qt::transparent);
-    renderTextToImage(image, camera, doc, selection, viewportWidth, viewportHeight,
-                      pixelToWorldScale);
+    // 1. Entity, dimension and annotation text: cached layouts emitted as atlas quads.
+    if (m_glyphAtlas) {
+        const uint64_t generation = m_glyphAtlas->generation();
+        collectTextVertices(camera, doc, selection, viewportWidth, viewportHeight,
+                            pixelToWorldScale);
+        // A full atlas starts over, invalidating quads emitted earlier this frame.
+        if (m_glyphAtlas->generation() != generation) {
+            collectTextVertices(camera, doc, selection, viewportWidth, viewportHeight,
+                                pixelToWorldScale);
+        }
+        m_textLayouts->trim(kMaxCachedLayouts);
+        drawGlyphText(gl, viewportWidth, viewportHeight);
+    }
 
-    // 2. Upload QImage pixels to the GL texture.
-    gl->glBindTexture(GL_TEXTURE_2D, m_textOverlayTex);
-    gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, viewportWidth, viewportHeight, 0, GL_RGBA,
-                     GL_UNSIGNED_BYTE, image.constBits());
+    // 2. Gizmo and badge: painted with QPainter into a QImage (pure CPU) covering the
+    // strip along the top edge they occupy, and uploaded as a GL texture.  Both depend
+    // only on the viewport size and camera orientation, so the strip is repainted and
+    // re-uploaded only when one of those changes.
+    const math::Vec3 forward = (camera.target() - camera.eye()).normalized();
+    const math::Vec3& up = camera.up();
+    OverlayKey key{viewportWidth,
+                   viewportHeight,
+                   {forward.x, forward.y, forward.z, up.x, up.y, up.z},
+                   ViewCube::orientationLabel(camera)};
+    if (key != m_overlayKey) {
+        const int strip =
+            std::min(viewportHeight, std::max(ViewCube::paintedHeight(), kBadgeBottom));
+        QImage image(viewportWidth, strip, QImage::Format_RGBA8888_Premultiplied);
+        image.fill(Qt::transparent);
+        paintOverlayToImage(image, camera, key.label, viewportWidth, viewportHeight);
+
+        gl->glBindTexture(GL_TEXTURE_2D, m_textOverlayTex);
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, viewportWidth, strip, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, image.constBits());
+
+        if (key.width != m_overlayKey.width || key.height != m_overlayKey.height) {
+            // The quad covers the strip only, placed as in a full-viewport quad: texture
+            // row r lands where row r of a viewport-sized image would.
+            const float y1 = -1.f + 2.f * static_cast<float>(strip) / viewportHeight;
+            const float quadVerts[] = {
+                // pos        uv
+                -1.f, -1.f, 0.f, 0.f, 1.f, -1.f, 1.f, 0.f, 1.f,  y1,  1.f, 1.f,
+
+                -1.f, -1.f, 0.f, 0.f, 1.f, y1,   1.f, 1.f, -1.f, y1,  0.f, 1.f,
+            };
+            gl->glBindBuffer(GL_ARRAY_BUFFER, m_textOverlayVBO);
+            gl->glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quadVerts), quadVerts);
+            gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        m_overlayKey = std::move(key);
+    }
 
-    // 3. Draw a fullscreen quad with alpha blending.
+    // 3. Draw the strip with alpha blending.
     // Use premultiplied-alpha blend (GL_ONE) since the QImage is premultiplied.
     gl->glDisable(GL_DEPTH_TEST);
     gl->glEnable(GL_BLEND);
@@ -152,7 +152,7 @@ void ViewportWidget::initializeGL() {
     // focal surface (panels #2d–#32, data surfaces #1e, viewport ~#1c1d21).
     m_renderer->setBackgroundColor(0.11f, 0.115f, 0.13f);
 
-    // Set up GL resources for text overlay (QImage -> texture -> quad).
+    // Set up GL resources for glyph-atlas text and the gizmo overlay (QImage -> texture).
     m_viewportRenderer.initTextOverlayGL(gl);
 }
 
@@ -185,7 +185,7 @@ void ViewportWidget::paintGL() {
     // Render document entities (collects dimension text info).
     if (m_document) {
         m_viewportRenderer.renderEntities(gl, *m_renderer, m_camera, *m_document,
-                                          m_selectionManager);
+                                          m_selectionManager, width(), height());
     }
 
     // Render grip squares on selected entities.
@@ -210,10 +210,11 @@ void ViewportWidget::paintGL() {
     m_overlayRenderer.render(gl, m_camera, m_renderer.get(), width(), height(),
                              pixelToWorldScale());
 
-    // Render text overlay: paint to an offscreen QImage (QPainter on QImage
-    // is pure CPU -- no Windows bitmap mask operations), then upload as a GL
-    // texture and draw a fullscreen quad.  This avoids the Qt 6.10
-    // qpixmap_win.cpp assertion triggered by QPainter on QOpenGLWidget.
+    // Render text as glyph-atlas quads, then the gizmo overlay: painted into an
+    // offscreen QImage (QPainter on QImage is pure CPU -- no Windows bitmap mask
+    // operations) when the view changes, uploaded as a GL texture and drawn as a
+    // quad.  This avoids the Qt 6.10 qpixmap_win.cpp assertion triggered by
+    // QPainter on QOpenGLWidget.
     m_viewportRenderer.blitTextOverlay(gl, m_camera, m_document, m_selectionManager, width(),
                                        height(), pixelToWorldScale());
 }
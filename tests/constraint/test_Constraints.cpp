@@ -65,6 +65,73 @@ TEST(ConstraintSystem, RemoveConstraintsForEntity) {
     EXPECT_TRUE(sys.empty());
 }
 
+TEST(ConstraintSystem, ComponentsFollowSharedEntities) {
+    cstr::ConstraintSystem sys;
+
+    cstr::GeometryRef refA{1, cstr::FeatureType::Point, 0};
+    cstr::GeometryRef refB{2, cstr::FeatureType::Point, 0};
+    cstr::GeometryRef refC{3, cstr::FeatureType::Point, 0};
+    cstr::GeometryRef refD{4, cstr::FeatureType::Point, 0};
+
+    sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(refA, refB));
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(refC, math::Vec2{0.0, 0.0}));
+    sys.addConstraint(std::make_shared<cstr::HorizontalConstraint>(refB, refD));
+
+    const auto& components = sys.components();
+    ASSERT_EQ(components.size(), 2u);
+    EXPECT_EQ(components[0].constraintIndices, (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(components[0].entityIds, (std::vector<uint64_t>{1, 2, 4}));
+    EXPECT_EQ(components[0].equationCount, 3);
+    EXPECT_EQ(components[1].constraintIndices, (std::vector<size_t>{1}));
+    EXPECT_EQ(components[1].entityIds, (std::vector<uint64_t>{3}));
+
+    // Cached until the constraint set changes.
+    EXPECT_EQ(&sys.components(), &components);
+    uint64_t revision = sys.revision();
+    sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(refC, refD));
+    EXPECT_NE(sys.revision(), revision);
+    ASSERT_EQ(sys.components().size(), 1u);
+    EXPECT_EQ(sys.components()[0].entityIds.size(), 4u);
+}
+
+TEST(ConstraintSystem, EntityIndexFollowsEdits) {
+    cstr::ConstraintSystem sys;
+
+    cstr::GeometryRef refA{1, cstr::FeatureType::Point, 0};
+    cstr::GeometryRef refB{2, cstr::FeatureType::Point, 0};
+    cstr::GeometryRef refC{3, cstr::FeatureType::Point, 0};
+
+    auto ab = std::make_shared<cstr::CoincidentConstraint>(refA, refB);
+    auto bc = std::make_shared<cstr::CoincidentConstraint>(refB, refC);
+    auto b = std::make_shared<cstr::FixedConstraint>(refB, math::Vec2{0.0, 0.0});
+    auto ca = std::make_shared<cstr::HorizontalConstraint>(refC, refA);
+    for (const auto& c : std::vector<std::shared_ptr<cstr::Constraint>>{ab, bc, b, ca}) {
+        sys.addConstraint(c);
+    }
+
+    // Lookups list constraints in system order.
+    EXPECT_EQ(sys.constraintsForEntity(2),
+              (std::vector<const cstr::Constraint*>{ab.get(), bc.get(), b.get()}));
+    EXPECT_TRUE(sys.constraintsForEntity(9).empty());
+
+    sys.removeConstraint(bc->id());
+    EXPECT_EQ(sys.constraintsForEntity(2),
+              (std::vector<const cstr::Constraint*>{ab.get(), b.get()}));
+    EXPECT_EQ(sys.constraintsForEntity(3), (std::vector<const cstr::Constraint*>{ca.get()}));
+
+    // A cascade removes the entity's constraints from the other entities' lists too.
+    auto removed = sys.removeConstraintsForEntity(1);
+    ASSERT_EQ(removed.size(), 2u);
+    EXPECT_EQ(removed[0], ab);
+    EXPECT_EQ(removed[1], ca);
+    EXPECT_EQ(sys.constraintsForEntity(2), (std::vector<const cstr::Constraint*>{b.get()}));
+    EXPECT_TRUE(sys.constraintsForEntity(3).empty());
+    EXPECT_TRUE(sys.removeConstraintsForEntity(1).empty());
+
+    sys.clear();
+    EXPECT_TRUE(sys.constraintsForEntity(2).empty());
+}
+
 // --- Residual tests ---
 
 TEST(Constraints, CoincidentResidual) {
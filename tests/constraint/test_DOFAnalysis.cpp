@@ -0,0 +1,325 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "horizon/constraint/Constraint.h"
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/GeometryRef.h"
+#include "horizon/constraint/ParameterTable.h"
+#include "horizon/constraint/SketchSolver.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/math/Vec2.h"
+
+using namespace hz;
+
+namespace hz::cstr {
+
+struct SketchSolverAccess {
+    static int jacobianRank(const SketchSolver& solver, const ParameterTable& params,
+                            const ConstraintSystem& constraints, bool sparse) {
+        return solver.jacobianRank(params, constraints, sparse);
+    }
+    static Eigen::Index equations(const SketchSolver& solver, const ParameterTable& params,
+                                  const ConstraintSystem& constraints) {
+        return solver.buildSparseJacobian(params, constraints).rows();
+    }
+};
+
+}  // namespace hz::cstr
+
+namespace {
+
+cstr::GeometryRef point(uint64_t id, int index) {
+    return {id, cstr::FeatureType::Point, index};
+}
+
+/// Adds a fully constrained staircase of `steps` unit lines starting at @p origin:
+/// alternately horizontal and vertical, joined end to start, the first point fixed.
+/// Returns the line ids.
+std::vector<uint64_t> addStaircase(draft::DraftDocument& doc, cstr::ConstraintSystem& sys,
+                                   const math::Vec2& origin, int steps) {
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < steps; ++i) {
+        const math::Vec2 start = origin + math::Vec2((i + 1) / 2, i / 2);
+        const math::Vec2 end = start + (i % 2 == 0 ? math::Vec2(1, 0) : math::Vec2(0, 1));
+        auto line = std::make_shared<draft::DraftLine>(start, end);
+        doc.addEntity(line);
+        ids.push_back(line->id());
+    }
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(point(ids[0], 0), origin));
+    for (int i = 0; i < steps; ++i) {
+        if (i % 2 == 0) {
+            sys.addConstraint(
+                std::make_shared<cstr::HorizontalConstraint>(point(ids[i], 0), point(ids[i], 1)));
+        } else {
+            sys.addConstraint(
+                std::make_shared<cstr::VerticalConstraint>(point(ids[i], 0), point(ids[i], 1)));
+        }
+        sys.addConstraint(
+            std::make_shared<cstr::DistanceConstraint>(point(ids[i], 0), point(ids[i], 1), 1.0));
+        if (i > 0) {
+            sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(point(ids[i - 1], 1),
+                                                                           point(ids[i], 0)));
+        }
+    }
+    return ids;
+}
+
+/// An n x n grid of unit cells built from separate horizontal and vertical lines whose
+/// ends meet at coincident nodes, the bottom row and left column dimensioned and the
+/// origin fixed: a closed mesh, fully constrained.  With @p redundant every edge is
+/// dimensioned, which over-constrains it consistently.
+void addGrid(draft::DraftDocument& doc, cstr::ConstraintSystem& sys, int n, bool redundant) {
+    std::vector<std::vector<cstr::GeometryRef>> ends((n + 1) * (n + 1));
+    auto edge = [&](int i0, int j0, int i1, int j1, bool dimensioned) {
+        auto line = std::make_shared<draft::DraftLine>(math::Vec2(i0, j0), math::Vec2(i1, j1));
+        doc.addEntity(line);
+        const uint64_t id = line->id();
+        if (j0 == j1) {
+            sys.addConstraint(std::make_shared<cstr::HorizontalConstraint>(point(id, 0),
+                                                                           point(id, 1)));
+        } else {
+            sys.addConstraint(
+                std::make_shared<cstr::VerticalConstraint>(point(id, 0), point(id, 1)));
+        }
+        if (dimensioned) {
+            sys.addConstraint(
+                std::make_shared<cstr::DistanceConstraint>(point(id, 0), point(id, 1), 1.0));
+        }
+        ends[j0 * (n + 1) + i0].push_back(point(id, 0));
+        ends[j1 * (n + 1) + i1].push_back(point(id, 1));
+    };
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i < n; ++i) edge(i, j, i + 1, j, redundant || j == 0);
+    }
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j < n; ++j) edge(i, j, i, j + 1, redundant || i == 0);
+    }
+    for (const auto& refs : ends) {
+        for (size_t k = 1; k < refs.size(); ++k) {
+            sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(refs[0], refs[k]));
+        }
+    }
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(ends[0][0], math::Vec2{0, 0}));
+}
+
+/// Sparse and dense Jacobian rank of the whole system, and its equation count.
+struct Ranks {
+    int sparse;
+    int dense;
+    Eigen::Index equations;
+};
+
+Ranks ranks(const draft::DraftDocument& doc, const cstr::ConstraintSystem& sys) {
+    auto params = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    cstr::SketchSolver solver;
+    return {cstr::SketchSolverAccess::jacobianRank(solver, params, sys, true),
+            cstr::SketchSolverAccess::jacobianRank(solver, params, sys, false),
+            cstr::SketchSolverAccess::equations(solver, params, sys)};
+}
+
+cstr::DOFAnalysis analyze(const draft::DraftDocument& doc, const cstr::ConstraintSystem& sys,
+                          cstr::DOFCache& cache) {
+    auto params = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    return cstr::SketchSolver().analyzeDOF(params, sys, cache);
+}
+
+}  // namespace
+
+TEST(DOFAnalysis, OpenChainsNeedNoFactorization) {
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    addStaircase(doc, sys, {0, 0}, 30);
+
+    cstr::DOFCache cache;
+    auto dof = analyze(doc, sys, cache);
+    EXPECT_EQ(dof.totalDOF, 0);
+    EXPECT_EQ(cache.structural, 1);
+    EXPECT_EQ(cache.numeric, 0);
+    for (const auto& [id, status] : dof.entityStatus) {
+        EXPECT_EQ(status, cstr::EntityDOFStatus::FullyConstrained);
+    }
+}
+
+TEST(DOFAnalysis, ClosedLoopMatchesUncachedAnalysis) {
+    // A rectangle pinned at one corner: width and height stay free.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    const math::Vec2 corners[] = {{0, 0}, {4, 0}, {4, 3}, {0, 3}};
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 4; ++i) {
+        auto line = std::make_shared<draft::DraftLine>(corners[i], corners[(i + 1) % 4]);
+        doc.addEntity(line);
+        ids.push_back(line->id());
+    }
+    for (int i = 0; i < 4; ++i) {
+        sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(point(ids[i], 1),
+                                                                       point(ids[(i + 1) % 4], 0)));
+        if (i % 2 == 0) {
+            sys.addConstraint(
+                std::make_shared<cstr::HorizontalConstraint>(point(ids[i], 0), point(ids[i], 1)));
+        } else {
+            sys.addConstraint(
+                std::make_shared<cstr::VerticalConstraint>(point(ids[i], 0), point(ids[i], 1)));
+        }
+    }
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(point(ids[0], 0), corners[0]));
+
+    cstr::DOFCache cache;
+    auto dof = analyze(doc, sys, cache);
+    EXPECT_EQ(dof.totalDOF, 2);
+    EXPECT_EQ(cache.structural + cache.numeric, 1);
+
+    auto params = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    cstr::SketchSolver dense;
+    dense.setBackend(cstr::SolverBackend::Dense);
+    EXPECT_EQ(dense.analyzeDOF(params, sys).totalDOF, 2);
+}
+
+TEST(DOFAnalysis, RedundantConstraintsAreFactored) {
+    // Structurally the two equations match two parameters; numerically they are one.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    auto line = std::make_shared<draft::DraftLine>(math::Vec2{0, 0}, math::Vec2{2, 0});
+    doc.addEntity(line);
+    sys.addConstraint(
+        std::make_shared<cstr::HorizontalConstraint>(point(line->id(), 0), point(line->id(), 1)));
+    sys.addConstraint(
+        std::make_shared<cstr::HorizontalConstraint>(point(line->id(), 0), point(line->id(), 1)));
+
+    cstr::DOFCache cache;
+    auto dof = analyze(doc, sys, cache);
+    EXPECT_EQ(cache.numeric, 1);
+    EXPECT_EQ(dof.totalDOF, 3);
+    EXPECT_EQ(dof.entityStatus.at(line->id()), cstr::EntityDOFStatus::OverConstrained);
+}
+
+TEST(DOFAnalysis, OnlyChangedComponentsAreReanalysed) {
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    std::vector<std::vector<uint64_t>> stairs;
+    for (int i = 0; i < 20; ++i) stairs.push_back(addStaircase(doc, sys, {20.0 * i, 0}, 6));
+
+    cstr::DOFCache cache;
+    analyze(doc, sys, cache);
+    EXPECT_EQ(cache.reused, 0);
+    EXPECT_EQ(cache.structural + cache.numeric, 20);
+
+    analyze(doc, sys, cache);
+    EXPECT_EQ(cache.reused, 20);
+
+    // Move one line: only its staircase's Jacobian changes.
+    auto* moved = dynamic_cast<draft::DraftLine*>(doc.findEntity(stairs[3][2]).get());
+    moved->setEnd(moved->end() + math::Vec2(0.5, 0.0));
+    analyze(doc, sys, cache);
+    EXPECT_EQ(cache.reused, 19);
+    EXPECT_EQ(cache.structural + cache.numeric, 1);
+
+    // Over-constrain another; its status does not spread to the rest.
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(point(stairs[7][0], 1),
+                                                              math::Vec2{500.0, 0.0}));
+    auto dof = analyze(doc, sys, cache);
+    EXPECT_EQ(cache.reused, 19);
+    EXPECT_EQ(dof.entityStatus.at(stairs[7][3]), cstr::EntityDOFStatus::OverConstrained);
+    EXPECT_EQ(dof.entityStatus.at(stairs[8][3]), cstr::EntityDOFStatus::FullyConstrained);
+    EXPECT_EQ(cache.entries.size(), 20u);
+}
+
+TEST(JacobianRank, ClosedMeshIsProvenFullRankWithoutQR) {
+    // Not triangular: the Gram-matrix Cholesky settles it.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    addGrid(doc, sys, 6, false);
+
+    const Ranks r = ranks(doc, sys);
+    EXPECT_EQ(r.sparse, r.dense);
+    EXPECT_EQ(r.sparse, r.equations);
+
+    cstr::DOFCache cache;
+    EXPECT_EQ(analyze(doc, sys, cache).totalDOF, 0);
+    EXPECT_EQ(cache.structural, 1);
+    EXPECT_EQ(cache.numeric, 0);
+}
+
+TEST(JacobianRank, RedundantMeshMatchesDense) {
+    // Extra rows, but the parameter columns stay independent: rank is the column count.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    addGrid(doc, sys, 6, true);
+
+    const Ranks r = ranks(doc, sys);
+    EXPECT_EQ(r.sparse, r.dense);
+    EXPECT_LT(r.sparse, r.equations);
+
+    cstr::DOFCache cache;
+    auto dof = analyze(doc, sys, cache);
+    EXPECT_EQ(dof.totalDOF, 0);
+    for (const auto& [id, status] : dof.entityStatus) {
+        EXPECT_EQ(status, cstr::EntityDOFStatus::OverConstrained);
+    }
+}
+
+TEST(JacobianRank, SingularConfigurationIsNotTakenAsFullRank) {
+    // Two unit links spanning 2 units: the three distances are collinear, so one of
+    // them is dependent although the pattern matches every equation.  The links are
+    // tilted so that no Jacobian entry is exactly zero.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    auto a = std::make_shared<draft::DraftLine>(math::Vec2{0, 0}, math::Vec2{0.6, 0.8});
+    auto b = std::make_shared<draft::DraftLine>(math::Vec2{0.6, 0.8}, math::Vec2{1.2, 1.6});
+    doc.addEntity(a);
+    doc.addEntity(b);
+    sys.addConstraint(std::make_shared<cstr::FixedConstraint>(point(a->id(), 0), math::Vec2{}));
+    sys.addConstraint(
+        std::make_shared<cstr::CoincidentConstraint>(point(a->id(), 1), point(b->id(), 0)));
+    sys.addConstraint(
+        std::make_shared<cstr::DistanceConstraint>(point(a->id(), 0), point(a->id(), 1), 1.0));
+    sys.addConstraint(
+        std::make_shared<cstr::DistanceConstraint>(point(b->id(), 0), point(b->id(), 1), 1.0));
+    sys.addConstraint(
+        std::make_shared<cstr::DistanceConstraint>(point(a->id(), 0), point(b->id(), 1), 2.0));
+
+    const Ranks r = ranks(doc, sys);
+    EXPECT_EQ(r.dense, r.equations - 1);
+    EXPECT_EQ(r.sparse, r.dense);
+
+    cstr::DOFCache cache;
+    analyze(doc, sys, cache);
+    EXPECT_EQ(cache.structural, 0);
+    EXPECT_EQ(cache.numeric, 1);
+}
+
+TEST(DOFAnalysisPerf, ReanalysisAfterOneEdit) {
+    // 500 staircases of 10 lines: 20k equations over 20k parameters.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    std::vector<uint64_t> first;
+    for (int i = 0; i < 500; ++i) {
+        auto ids = addStaircase(doc, sys, {20.0 * (i % 25), 20.0 * (i / 25)}, 10);
+        if (i == 0) first = ids;
+    }
+
+    cstr::DOFCache cache;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto full = analyze(doc, sys, cache);
+    auto mid = std::chrono::high_resolution_clock::now();
+    auto* moved = dynamic_cast<draft::DraftLine*>(doc.findEntity(first[4]).get());
+    moved->setEnd(moved->end() + math::Vec2(0.0, 0.25));
+    auto again = analyze(doc, sys, cache);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double fullMs = std::chrono::duration<double, std::milli>(mid - start).count();
+    double againMs = std::chrono::duration<double, std::milli>(end - mid).count();
+    std::cout << "[PERF] 20k equations, DOF analysis: " << fullMs
+              << " ms, after one edit: " << againMs << " ms" << std::endl;
+    EXPECT_EQ(full.totalDOF, 0);
+    EXPECT_EQ(again.totalDOF, 0);
+    EXPECT_EQ(cache.reused, 499);
+#ifdef NDEBUG
+    EXPECT_LT(againMs, 100.0);
+#else
+    EXPECT_LT(againMs, 1000.0);
+#endif
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "horizon/constraint/Constraint.h"
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/DragSession.h"
+#include "horizon/constraint/GeometryRef.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/math/Vec2.h"
+
+using namespace hz;
+
+namespace {
+
+/// A zigzag chain of `links` unit lines along the x axis, joined end to start, its
+/// first point fixed at the origin.  The joints are free to bend.
+struct Chain {
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    std::vector<uint64_t> ids;
+
+    explicit Chain(int links) {
+        auto joint = [](int i) { return math::Vec2{0.8 * i, i % 2 == 0 ? 0.0 : 0.6}; };
+        for (int i = 0; i < links; ++i) {
+            auto line = std::make_shared<draft::DraftLine>(joint(i), joint(i + 1));
+            doc.addEntity(line);
+            ids.push_back(line->id());
+        }
+        sys.addConstraint(std::make_shared<cstr::FixedConstraint>(start(0), math::Vec2{0, 0}));
+        for (int i = 0; i < links; ++i) {
+            sys.addConstraint(std::make_shared<cstr::DistanceConstraint>(start(i), end(i), 1.0));
+            if (i > 0) {
+                sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(end(i - 1),
+                                                                               start(i)));
+            }
+        }
+    }
+
+    cstr::GeometryRef start(int i) const { return {ids[i], cstr::FeatureType::Point, 0}; }
+    cstr::GeometryRef end(int i) const { return {ids[i], cstr::FeatureType::Point, 1}; }
+};
+
+}  // namespace
+
+TEST(DragSession, UnconstrainedEntityIsLeftToTheCaller) {
+    Chain chain(3);
+    auto loose = std::make_shared<draft::DraftLine>(math::Vec2{0, 5}, math::Vec2{1, 5});
+    chain.doc.addEntity(loose);
+
+    cstr::DragSession session(chain.doc.entities(), chain.sys,
+                              {loose->id(), cstr::FeatureType::Point, 1});
+    EXPECT_FALSE(session.constrained());
+    EXPECT_TRUE(session.entityIds().empty());
+}
+
+TEST(DragSession, ComponentFollowsTheCursor) {
+    Chain chain(6);
+    Chain other(2);  // a separate component in the same system
+    for (const auto& c : other.sys.constraints()) chain.sys.addConstraint(c);
+    for (const auto& e : other.doc.entities()) chain.doc.addEntity(e);
+
+    cstr::DragSession session(chain.doc.entities(), chain.sys, chain.end(5));
+    ASSERT_TRUE(session.constrained());
+    EXPECT_EQ(session.entityIds().size(), 6u);
+
+    // Swing the tip a little further on every event, as a mouse drag would.
+    for (int step = 1; step <= 10; ++step) {
+        const double a = 0.1 * step;
+        auto result = session.drag({4.0 * std::cos(a), 4.0 * std::sin(a)});
+        EXPECT_EQ(result.status, cstr::SolveStatus::Converged) << "step " << step;
+    }
+
+    const auto& params = session.params();
+    math::Vec2 tip = params.pointPosition(chain.end(5));
+    EXPECT_NEAR(tip.x, 4.0 * std::cos(1.0), 1e-8);
+    EXPECT_NEAR(tip.y, 4.0 * std::sin(1.0), 1e-8);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_NEAR(params.pointPosition(chain.start(i)).distanceTo(
+                        params.pointPosition(chain.end(i))),
+                    1.0, 1e-8);
+    }
+
+    session.apply(chain.doc.entities());
+    auto* last = dynamic_cast<draft::DraftLine*>(chain.doc.entities()[5].get());
+    EXPECT_NEAR(last->end().y, 4.0 * std::sin(1.0), 1e-8);
+    auto* untouched = dynamic_cast<draft::DraftLine*>(chain.doc.entities()[7].get());
+    EXPECT_DOUBLE_EQ(untouched->end().x, 1.6);
+}
+
+TEST(DragSession, UnreachableTargetKeepsLastSolution) {
+    Chain chain(3);
+    cstr::DragSession session(chain.doc.entities(), chain.sys, chain.end(2));
+    ASSERT_TRUE(session.constrained());
+
+    EXPECT_EQ(session.drag({2.0, 2.0}).status, cstr::SolveStatus::Converged);
+    Eigen::VectorXd before = session.params().values();
+
+    // Three unit links cannot reach 10 units from the origin.
+    auto result = session.drag({10.0, 0.0});
+    EXPECT_NE(result.status, cstr::SolveStatus::Converged);
+    EXPECT_EQ(session.params().values(), before);
+
+    // And the drag carries on once the cursor is back in reach.
+    EXPECT_EQ(session.drag({2.0, 1.5}).status, cstr::SolveStatus::Converged);
+}
+
+TEST(DragSessionPerf, OnlyTheDraggedComponentIsSolved) {
+    // 2000 small chains, 10000 constraints in all; a drag touches one chain.
+    Chain sketch(3);
+    for (int i = 1; i < 2000; ++i) {
+        Chain chain(3);
+        for (const auto& c : chain.sys.constraints()) sketch.sys.addConstraint(c);
+        for (const auto& e : chain.doc.entities()) sketch.doc.addEntity(e);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    cstr::DragSession session(sketch.doc.entities(), sketch.sys, sketch.end(2));
+    auto begun = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(session.constrained());
+    EXPECT_EQ(session.params().parameterCount(), 12);
+
+    constexpr int kEvents = 60;
+    for (int step = 1; step <= kEvents; ++step) {
+        const double a = 0.01 * step;
+        auto result = session.drag({2.0 * std::cos(a), 2.0 * std::sin(a)});
+        EXPECT_EQ(result.status, cstr::SolveStatus::Converged) << "step " << step;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double setupMs = std::chrono::duration<double, std::milli>(begun - start).count();
+    double avgMs = std::chrono::duration<double, std::milli>(end - begun).count() / kEvents;
+    std::cout << "[PERF] 10k constraints, drag setup: " << setupMs
+              << " ms, avg drag event: " << avgMs << " ms" << std::endl;
+#ifdef NDEBUG
+    EXPECT_LT(avgMs, 1.0);
+#else
+    EXPECT_LT(avgMs, 10.0);
+#endif
+}
+
+TEST(DragSessionPerf, ThousandLinkChainDrag) {
+    // One connected component: ~3000 equations over 4000 parameters.
+    Chain chain(1000);
+    cstr::DragSession session(chain.doc.entities(), chain.sys, chain.end(999));
+    ASSERT_TRUE(session.constrained());
+
+    constexpr int kEvents = 60;
+    int iterations = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int step = 1; step <= kEvents; ++step) {
+        auto result = session.drag({800.0 - 0.5 * step, 0.5 * step});
+        EXPECT_EQ(result.status, cstr::SolveStatus::Converged) << "step " << step;
+        iterations += result.iterations;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double avgMs = std::chrono::duration<double, std::milli>(end - start).count() / kEvents;
+    std::cout << "[PERF] 1000-link chain, avg drag event: " << avgMs << " ms, "
+              << static_cast<double>(iterations) / kEvents << " iterations" << std::endl;
+#ifdef NDEBUG
+    EXPECT_LT(avgMs, 40.0);
+#else
+    EXPECT_LT(avgMs, 400.0);
+#endif
+}
@@ -118,3 +118,23 @@ TEST(ParameterTable, HasEntity) {
     params.registerEntity(*line);
     EXPECT_TRUE(params.hasEntity(line->id()));
 }
+
+TEST(ParameterTable, SubsetAndAssign) {
+    cstr::ParameterTable params;
+
+    auto line = std::make_shared<draft::DraftLine>(math::Vec2{0, 0}, math::Vec2{10, 0});
+    auto circle = std::make_shared<draft::DraftCircle>(math::Vec2{5, 5}, 3.0);
+    params.registerEntity(*line);
+    params.registerEntity(*circle);
+
+    auto part = params.subset({circle->id(), 999});
+    EXPECT_FALSE(part.hasEntity(line->id()));
+    ASSERT_EQ(part.parameterCount(), 3);
+    cstr::GeometryRef center{circle->id(), cstr::FeatureType::Point, 0};
+    EXPECT_DOUBLE_EQ(part.pointPosition(center).x, 5.0);
+
+    part.values()(2) = 4.0;  // radius
+    params.assign(part);
+    EXPECT_DOUBLE_EQ(params.values()(6), 4.0);
+    EXPECT_DOUBLE_EQ(params.values()(2), 10.0);  // line untouched
+}
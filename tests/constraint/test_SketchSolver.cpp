@@ -175,3 +175,44 @@ TEST(SketchSolver, OverConstrainedDetection) {
                 result.status == cstr::SolveStatus::Inconsistent ||
                 result.status == cstr::SolveStatus::FailedToConverge);
 }
+
+TEST(SketchSolver, IndependentComponentsSolvedSeparately) {
+    // 200 independent, fully constrained slots plus one contradictory one.
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+    for (int i = 0; i <= 200; ++i) {
+        const double y = 10.0 * i;
+        auto line = std::make_shared<draft::DraftLine>(math::Vec2{0.2, y + 0.1},
+                                                       math::Vec2{4.0, y + 0.5});
+        doc.addEntity(line);
+        cstr::GeometryRef start{line->id(), cstr::FeatureType::Point, 0};
+        cstr::GeometryRef end{line->id(), cstr::FeatureType::Point, 1};
+        sys.addConstraint(std::make_shared<cstr::FixedConstraint>(start, math::Vec2{0.0, y}));
+        sys.addConstraint(std::make_shared<cstr::HorizontalConstraint>(start, end));
+        sys.addConstraint(std::make_shared<cstr::DistanceConstraint>(start, end, 5.0));
+        if (i == 200) {
+            sys.addConstraint(std::make_shared<cstr::FixedConstraint>(end, math::Vec2{1.0, y}));
+        }
+    }
+    ASSERT_EQ(sys.components().size(), 201u);
+
+    auto params = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    cstr::SketchSolver solver;
+    auto result = solver.solve(params, sys);
+
+    EXPECT_TRUE(result.status == cstr::SolveStatus::OverConstrained ||
+                result.status == cstr::SolveStatus::Inconsistent);
+    ASSERT_EQ(result.componentStatus.size(), 201u);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(result.componentStatus[i], cstr::SolveStatus::Success);
+    }
+    EXPECT_EQ(result.componentStatus[200], result.status);
+
+    params.applyToEntities(doc.entities());
+    for (int i = 0; i < 200; ++i) {
+        auto* line = dynamic_cast<draft::DraftLine*>(doc.entities()[i].get());
+        ASSERT_NE(line, nullptr);
+        EXPECT_NEAR(line->end().x, 5.0, 1e-6);
+        EXPECT_NEAR(line->end().y, 10.0 * i, 1e-6);
+    }
+}
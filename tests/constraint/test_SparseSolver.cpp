@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "horizon/constraint/Constraint.h"
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/constraint/GeometryRef.h"
+#include "horizon/constraint/ParameterTable.h"
+#include "horizon/constraint/SketchSolver.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/math/Vec2.h"
+
+using namespace hz;
+
+namespace {
+
+/// A staircase of `steps` unit lines, alternately horizontal and vertical, joined end
+/// to start with the first point fixed.  Initial positions are perturbed so the solver
+/// has work to do.  Fully constrained unless `lastLength` is false, which leaves the
+/// last line's length free (one degree of freedom).
+struct Staircase {
+    draft::DraftDocument doc;
+    cstr::ConstraintSystem sys;
+
+    explicit Staircase(int steps, bool lastLength = true) {
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < steps; ++i) {
+            const double x = (i + 1) / 2 + 0.05 * std::sin(i * 1.7);
+            const double y = i / 2 + 0.05 * std::cos(i * 2.3);
+            const math::Vec2 end = i % 2 == 0 ? math::Vec2{x + 1.1, y + 0.1}
+                                              : math::Vec2{x - 0.1, y + 0.9};
+            auto line = std::make_shared<draft::DraftLine>(math::Vec2{x, y}, end);
+            doc.addEntity(line);
+            ids.push_back(line->id());
+        }
+
+        using cstr::FeatureType;
+        sys.addConstraint(std::make_shared<cstr::FixedConstraint>(
+            cstr::GeometryRef{ids[0], FeatureType::Point, 0}, math::Vec2{0.0, 0.0}));
+        for (int i = 0; i < steps; ++i) {
+            cstr::GeometryRef start{ids[i], FeatureType::Point, 0};
+            cstr::GeometryRef end{ids[i], FeatureType::Point, 1};
+            if (i % 2 == 0) {
+                sys.addConstraint(std::make_shared<cstr::HorizontalConstraint>(start, end));
+            } else {
+                sys.addConstraint(std::make_shared<cstr::VerticalConstraint>(start, end));
+            }
+            if (lastLength || i + 1 < steps) {
+                sys.addConstraint(std::make_shared<cstr::DistanceConstraint>(start, end, 1.0));
+            }
+            if (i > 0) {
+                cstr::GeometryRef prevEnd{ids[i - 1], FeatureType::Point, 1};
+                sys.addConstraint(std::make_shared<cstr::CoincidentConstraint>(prevEnd, start));
+            }
+        }
+    }
+
+    cstr::ParameterTable params() const {
+        return cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    }
+};
+
+double solveMs(cstr::SolverBackend backend, int steps, cstr::SolveResult* out = nullptr) {
+    Staircase stairs(steps);
+    auto params = stairs.params();
+    cstr::SketchSolver solver;
+    solver.setBackend(backend);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto result = solver.solve(params, stairs.sys);
+    auto end = std::chrono::high_resolution_clock::now();
+    if (out) *out = result;
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+TEST(SparseSolver, AutomaticSwitchesOnSize) {
+    cstr::SketchSolver solver;
+    EXPECT_FALSE(solver.usesSparse(10, 12));
+    EXPECT_TRUE(solver.usesSparse(cstr::SketchSolver::kSparseThreshold, 10));
+    EXPECT_TRUE(solver.usesSparse(10, cstr::SketchSolver::kSparseThreshold));
+
+    solver.setBackend(cstr::SolverBackend::Dense);
+    EXPECT_FALSE(solver.usesSparse(100000, 100000));
+    solver.setBackend(cstr::SolverBackend::Sparse);
+    EXPECT_TRUE(solver.usesSparse(1, 1));
+}
+
+TEST(SparseSolver, MatchesDenseSolution) {
+    Staircase stairs(30);
+    auto denseParams = stairs.params();
+    auto sparseParams = stairs.params();
+
+    cstr::SketchSolver dense;
+    dense.setBackend(cstr::SolverBackend::Dense);
+    cstr::SketchSolver sparse;
+    sparse.setBackend(cstr::SolverBackend::Sparse);
+
+    auto denseResult = dense.solve(denseParams, stairs.sys);
+    auto sparseResult = sparse.solve(sparseParams, stairs.sys);
+
+    EXPECT_EQ(denseResult.status, cstr::SolveStatus::Success);
+    EXPECT_EQ(sparseResult.status, cstr::SolveStatus::Success);
+    EXPECT_EQ(sparseResult.degreesOfFreedom, 0);
+    EXPECT_LT(sparseResult.residualNorm, 1e-8);
+    EXPECT_LT((denseParams.values() - sparseParams.values()).lpNorm<Eigen::Infinity>(), 1e-6);
+
+    // The last step of the staircase ends at (15, 15).
+    const int n = sparseParams.parameterCount();
+    EXPECT_NEAR(sparseParams.values()(n - 2), 15.0, 1e-6);
+    EXPECT_NEAR(sparseParams.values()(n - 1), 15.0, 1e-6);
+}
+
+TEST(SparseSolver, ReportsRemainingFreedom) {
+    Staircase stairs(40, /*lastLength=*/false);
+    auto params = stairs.params();
+
+    cstr::SketchSolver solver;
+    solver.setBackend(cstr::SolverBackend::Sparse);
+    auto result = solver.solve(params, stairs.sys);
+    EXPECT_EQ(result.status, cstr::SolveStatus::UnderConstrained);
+    EXPECT_EQ(result.degreesOfFreedom, 1);
+
+    cstr::SketchSolver dense;
+    dense.setBackend(cstr::SolverBackend::Dense);
+    auto denseDOF = dense.analyzeDOF(params, stairs.sys);
+    auto sparseDOF = solver.analyzeDOF(params, stairs.sys);
+    EXPECT_EQ(denseDOF.totalDOF, 1);
+    EXPECT_EQ(sparseDOF.totalDOF, 1);
+    EXPECT_EQ(sparseDOF.entityStatus.size(), 40u);
+}
+
+TEST(SparseSolver, DetectsOverConstraint) {
+    Staircase stairs(20);
+    auto ids = stairs.sys.constraints().front()->referencedEntityIds();
+    // Pin the first line's end where its unit length cannot reach.
+    stairs.sys.addConstraint(std::make_shared<cstr::FixedConstraint>(
+        cstr::GeometryRef{ids[0], cstr::FeatureType::Point, 1}, math::Vec2{3.0, 0.0}));
+    auto params = stairs.params();
+
+    cstr::SketchSolver solver;
+    solver.setBackend(cstr::SolverBackend::Sparse);
+    auto result = solver.solve(params, stairs.sys);
+    EXPECT_TRUE(result.status == cstr::SolveStatus::OverConstrained ||
+                result.status == cstr::SolveStatus::Inconsistent);
+
+    auto dof = solver.analyzeDOF(params, stairs.sys);
+    EXPECT_EQ(dof.entityStatus.begin()->second, cstr::EntityDOFStatus::OverConstrained);
+}
+
+TEST(SparseSolver, WorkspaceReanalysesAChangedPatternOfTheSameSize) {
+    // Two independent angle constraints.  A zero-length line drops its constraint's
+    // Jacobian row, so degenerating the first line and then the third gives J^T J
+    // patterns with equal non-zero counts but different structure.
+    draft::DraftDocument doc;
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 4; ++i) {
+        auto line = std::make_shared<draft::DraftLine>(math::Vec2{0.0, 2.0 * i},
+                                                       math::Vec2{1.0, 2.0 * i + 0.3 * i});
+        doc.addEntity(line);
+        ids.push_back(line->id());
+    }
+    cstr::ConstraintSystem sys;
+    using cstr::FeatureType;
+    for (int i = 0; i < 4; i += 2) {
+        sys.addConstraint(std::make_shared<cstr::AngleConstraint>(
+            cstr::GeometryRef{ids[i], FeatureType::Line, 0},
+            cstr::GeometryRef{ids[i + 1], FeatureType::Line, 0}, 0.5));
+    }
+
+    auto collapse = [&ids](cstr::ParameterTable& params, int line) {
+        const int i = params.parameterIndex({ids[line], FeatureType::Line, 0});
+        params.values()(i + 2) = params.values()(i);
+        params.values()(i + 3) = params.values()(i + 1);
+    };
+
+    cstr::SketchSolver solver;
+    solver.setBackend(cstr::SolverBackend::Sparse);
+    solver.setMaxIterations(5);
+
+    cstr::SolverWorkspace workspace;
+    auto first = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    collapse(first, 0);
+    solver.solve(first, sys, workspace);
+    ASSERT_FALSE(workspace.patternOuter.empty());
+
+    auto second = cstr::ParameterTable::buildFromEntities(doc.entities(), sys);
+    collapse(second, 2);
+    auto reference = second;
+    cstr::SolverWorkspace fresh;
+    fresh.damping = workspace.damping;
+
+    solver.solve(second, sys, workspace);
+    solver.solve(reference, sys, fresh);
+    EXPECT_EQ(workspace.patternInner, fresh.patternInner);
+    EXPECT_LT((second.values() - reference.values()).lpNorm<Eigen::Infinity>(), 1e-12);
+}
+
+TEST(SparseSolverPerf, DenseVersusSparse) {
+    for (int steps : {5, 10, 25, 50, 100, 200}) {
+        double denseMs = solveMs(cstr::SolverBackend::Dense, steps);
+        double sparseMs = solveMs(cstr::SolverBackend::Sparse, steps);
+        std::cout << "[PERF] " << steps * 4 << " parameters: dense " << denseMs
+                  << " ms, sparse " << sparseMs << " ms" << std::endl;
+    }
+}
+
+TEST(SparseSolverPerf, TwoThousandLinesUnder500ms) {
+    // Dense, the 8000 x 8000 Jacobian alone would be 512 MB.
+    cstr::SolveResult result;
+    double ms = solveMs(cstr::SolverBackend::Automatic, 2000, &result);
+    std::cout << "[PERF] 2k lines (8k parameters), automatic backend: " << ms << " ms"
+              << std::endl;
+    EXPECT_EQ(result.status, cstr::SolveStatus::Success);
+#ifdef NDEBUG
+    EXPECT_LT(ms, 500.0);
+#else
+    // Unoptimized Eigen is an order of magnitude slower; only bind in Release.
+    EXPECT_LT(ms, 5000.0);
+#endif
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "horizon/constraint/ConstraintSystem.h"
+#include "horizon/document/Commands.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+
+using namespace hz::doc;
+using namespace hz::draft;
+using namespace hz::math;
+
+namespace {
+
+/// A row of unit lines at x = 0, 2, 4, ...; returns their ids.
+std::vector<uint64_t> addLines(DraftDocument& doc, size_t count) {
+    std::vector<std::shared_ptr<DraftEntity>> lines;
+    std::vector<uint64_t> ids;
+    for (size_t i = 0; i < count; ++i) {
+        double x = 2.0 * static_cast<double>(i);
+        lines.push_back(std::make_shared<DraftLine>(Vec2(x, 0), Vec2(x + 1, 0)));
+        ids.push_back(lines.back()->id());
+    }
+    doc.addEntities(lines);
+    return ids;
+}
+
+size_t countInBox(const DraftDocument& doc, double minX, double minY, double maxX,
+                  double maxY) {
+    return doc.spatialIndex()
+        .query(BoundingBox(Vec3(minX, minY, -1), Vec3(maxX, maxY, 1)))
+        .size();
+}
+
+}  // namespace
+
+TEST(TransformCommandsTest, MoveManyEntitiesAndUndo) {
+    DraftDocument doc;
+    hz::cstr::ConstraintSystem constraints;
+    auto ids = addLines(doc, 10000);  // large enough to run the transforms in parallel
+    auto untouched = std::make_shared<DraftCircle>(Vec2(-50, -50), 1.0);
+    doc.addEntity(untouched);
+
+    // Move all but the first line: the index is rebuilt in one step.
+    std::vector<uint64_t> moved(ids.begin() + 1, ids.end());
+    MoveEntityCommand cmd(doc, moved, Vec2(0, 100), constraints);
+    cmd.execute();
+    EXPECT_DOUBLE_EQ(doc.findEntity(ids.back())->boundingBox().min().y, 100.0);
+    EXPECT_EQ(countInBox(doc, -1e6, 99, 1e6, 101), moved.size());
+    EXPECT_EQ(countInBox(doc, -1e6, -1, 1e6, 1), 1u);
+    EXPECT_EQ(doc.entityStore().boundingBox(doc.storeHandle(ids.back())).min().y, 100.0);
+
+    cmd.undo();
+    EXPECT_EQ(countInBox(doc, -1e6, -1, 1e6, 1), ids.size());
+    EXPECT_EQ(countInBox(doc, -1e6, 99, 1e6, 101), 0u);
+
+    // A small move patches the index entity by entity.
+    MoveEntityCommand small(doc, {ids[0], ids[1]}, Vec2(0, -10), constraints);
+    small.execute();
+    EXPECT_EQ(countInBox(doc, -1e6, -11, 1e6, -9), 2u);
+    EXPECT_EQ(countInBox(doc, -60, -60, -40, -40), 1u);
+}
+
+TEST(TransformCommandsTest, CopyCommandsAddAndRemoveInBatches) {
+    DraftDocument doc;
+    auto ids = addLines(doc, 5000);
+
+    RotateEntityCommand rotate(doc, ids, Vec2(0, 0), 3.14159265358979323846);
+    rotate.execute();
+    ASSERT_EQ(doc.entities().size(), 10000u);
+    auto copies = rotate.rotatedIds();
+    ASSERT_EQ(copies.size(), ids.size());
+    EXPECT_NE(copies[0], ids[0]);
+    EXPECT_EQ(doc.entities()[5000]->id(), copies[0]);  // appended in source order
+    EXPECT_EQ(countInBox(doc, -1e6, -1, -0.5, 1), ids.size());
+
+    rotate.undo();
+    ASSERT_EQ(doc.entities().size(), ids.size());
+    EXPECT_EQ(doc.findEntity(copies[0]), nullptr);
+    EXPECT_EQ(countInBox(doc, -1e6, -1, -0.5, 1), 0u);
+    EXPECT_EQ(doc.entityStore().size(), ids.size());
+
+    // Redo reuses the same copies.
+    rotate.execute();
+    EXPECT_EQ(rotate.rotatedIds(), copies);
+
+    // Duplicating a few entities into a large document patches the index.
+    DuplicateEntityCommand dup(doc, {ids[0], ids[1], ids[2]}, Vec2(0, 5));
+    dup.execute();
+    EXPECT_EQ(countInBox(doc, -1e6, 4, 1e6, 6), 3u);
+    dup.undo();
+    EXPECT_EQ(countInBox(doc, -1e6, 4, 1e6, 6), 0u);
+    EXPECT_EQ(doc.findEntity(ids[3])->id(), ids[3]);
+    EXPECT_EQ(doc.entities().size(), 10000u);
+}
+
+TEST(TransformCommandsTest, RemoveEntitiesInOneBatchAndUndo) {
+    DraftDocument doc;
+    auto ids = addLines(doc, 100);
+    std::vector<uint64_t> removed;
+    for (size_t i = 0; i < ids.size(); i += 3) removed.push_back(ids[i]);
+    removed.push_back(0);  // unknown ids are ignored
+
+    RemoveEntitiesCommand cmd(doc, removed);
+    cmd.execute();
+    EXPECT_EQ(doc.entities().size(), ids.size() - (removed.size() - 1));
+    EXPECT_EQ(doc.findEntity(ids[0]), nullptr);
+    EXPECT_EQ(doc.entities()[0]->id(), ids[1]);  // the rest keep their order
+    EXPECT_EQ(countInBox(doc, -1, -1, 0.5, 1), 0u);
+
+    cmd.undo();
+    EXPECT_EQ(doc.entities().size(), ids.size());
+    EXPECT_EQ(doc.findEntity(ids[0])->id(), ids[0]);
+    EXPECT_EQ(countInBox(doc, -1e6, -1, 1e6, 1), ids.size());
+
+    cmd.execute();
+    EXPECT_EQ(doc.entities().size(), ids.size() - (removed.size() - 1));
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <random>
+
+#include "horizon/drafting/BlockDefinition.h"
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftBlockRef.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftHatch.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/math/Constants.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+namespace {
+
+std::shared_ptr<BlockDefinition> makeDefinition() {
+    auto def = std::make_shared<BlockDefinition>();
+    def->name = "Fixture";
+    def->basePoint = Vec2(1, 1);
+    def->entities = {
+        std::make_shared<DraftLine>(Vec2(0, 0), Vec2(3, 1)),
+        std::make_shared<DraftCircle>(Vec2(2, 2), 0.75),
+        std::make_shared<DraftArc>(Vec2(-1, 1), 1.0, 0.5, 2.5),
+        std::make_shared<DraftPolyline>(std::vector<Vec2>{{0, 3}, {1, 4}, {2, 3}}, true),
+    };
+    return def;
+}
+
+}  // namespace
+
+TEST(BlockRefTest, CachedQueriesMatchSubEntityExpansion) {
+    auto def = makeDefinition();
+    DraftBlockRef ref(def, Vec2(10, -4), 0.7, -1.5);
+
+    // Bounds: every corner of every sub-entity box, transformed.
+    BoundingBox expected;
+    for (const auto& ent : def->entities) {
+        auto bb = ent->boundingBox();
+        for (Vec2 c : {Vec2(bb.min().x, bb.min().y), Vec2(bb.max().x, bb.min().y),
+                       Vec2(bb.max().x, bb.max().y), Vec2(bb.min().x, bb.max().y)}) {
+            Vec2 w = ref.transformPoint(c);
+            expected.expand(Vec3(w.x, w.y, 0.0));
+        }
+    }
+    auto bbox = ref.boundingBox();
+    EXPECT_NEAR(bbox.min().x, expected.min().x, 1e-9);
+    EXPECT_NEAR(bbox.min().y, expected.min().y, 1e-9);
+    EXPECT_NEAR(bbox.max().x, expected.max().x, 1e-9);
+    EXPECT_NEAR(bbox.max().y, expected.max().y, 1e-9);
+
+    // Picking: the bounds pre-check must never hide a hit.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dx(expected.min().x - 1, expected.max().x + 1);
+    std::uniform_real_distribution<double> dy(expected.min().y - 1, expected.max().y + 1);
+    for (int i = 0; i < 2000; ++i) {
+        Vec2 p(dx(rng), dy(rng));
+        Vec2 defPt = ref.inverseTransformPoint(p);
+        bool brute = false;
+        for (const auto& ent : def->entities) brute = brute || ent->hitTest(defPt, 0.2 / 1.5);
+        EXPECT_EQ(ref.hitTest(p, 0.2), brute);
+    }
+
+    // Snapping: insert point first, then every sub-entity snap point in order.
+    auto snaps = ref.snapPoints();
+    size_t k = 1;
+    EXPECT_EQ(snaps[0].x, 10.0);
+    for (const auto& ent : def->entities) {
+        for (const auto& sp : ent->snapPoints()) {
+            ASSERT_LT(k, snaps.size());
+            Vec2 w = ref.transformPoint(sp);
+            EXPECT_NEAR(snaps[k].x, w.x, 1e-9);
+            EXPECT_NEAR(snaps[k].y, w.y, 1e-9);
+            ++k;
+        }
+    }
+    EXPECT_EQ(k, snaps.size());
+}
+
+TEST(BlockRefTest, GeometryIsSharedAndRebuiltOnDefinitionEdits) {
+    auto def = makeDefinition();
+    DraftBlockRef a(def, Vec2(0, 0));
+    DraftBlockRef b(def, Vec2(50, 0), 1.0, 2.0);
+
+    const BlockGeometry* geom = def->geometry().get();
+    a.boundingBox();
+    b.hitTest(Vec2(50, 0), 0.1);
+    EXPECT_EQ(def->geometry().get(), geom);
+    EXPECT_EQ(geom->display.strokes.size(), def->entities.size());
+
+    // Editing a template in place invalidates the shared geometry.
+    uint64_t stamp = def->contentStamp();
+    def->entities[0]->translate(Vec2(100, 0));
+    EXPECT_NE(def->contentStamp(), stamp);
+    EXPECT_GT(a.boundingBox().max().x, 100.0);
+    EXPECT_TRUE(a.hitTest(Vec2(100.5, -0.5), 0.01));
+
+    // So does moving the base point or adding an entity.
+    def->basePoint = Vec2(0, 0);
+    EXPECT_TRUE(a.hitTest(Vec2(103, 1), 0.01));
+    def->entities.push_back(std::make_shared<DraftLine>(Vec2(-20, 0), Vec2(-19, 0)));
+    EXPECT_DOUBLE_EQ(a.boundingBox().min().x, -20.0);
+}
+
+TEST(BlockRefTest, GeometryIsSharedAcrossThreads) {
+    auto def = makeDefinition();
+    // Building tessellates the hatch, whose fill cache is not thread-safe.
+    def->entities.push_back(std::make_shared<DraftHatch>(
+        std::vector<Vec2>{{0, 0}, {4, 0}, {4, 4}, {0, 4}}, HatchPattern::CrossHatch, 0.3, 0.25));
+    std::vector<std::future<std::shared_ptr<const BlockGeometry>>> futures;
+    for (int t = 0; t < 8; ++t) {
+        futures.push_back(std::async(std::launch::async, [&def]() {
+            std::shared_ptr<const BlockGeometry> geom;
+            for (int i = 0; i < 200; ++i) geom = def->geometry();
+            return geom;
+        }));
+    }
+    auto geom = def->geometry();
+    for (auto& f : futures) EXPECT_EQ(f.get(), geom);  // built once
+    EXPECT_EQ(def->geometry(), geom);
+
+    // Reordering the templates takes markModified().
+    uint64_t stamp = def->contentStamp();
+    std::swap(def->entities[0], def->entities[1]);
+    def->markModified();
+    EXPECT_NE(def->contentStamp(), stamp);
+    EXPECT_NE(def->geometry(), geom);
+    EXPECT_EQ(geom->display.strokes.size(), def->entities.size());  // old result still valid
+
+    // A copy tracks its own content.
+    BlockDefinition copy = *def;
+    copy.basePoint = Vec2(0, 0);
+    EXPECT_NE(copy.contentStamp(), def->contentStamp());
+}
+
+TEST(BlockRefTest, LocalTessellationIsRelativeToBasePoint) {
+    auto def = std::make_shared<BlockDefinition>();
+    def->basePoint = Vec2(5, 5);
+    def->entities = {std::make_shared<DraftLine>(Vec2(5, 5), Vec2(7, 5))};
+
+    const auto geom = def->geometry();
+    const auto& strokes = geom->display.strokes;
+    ASSERT_EQ(strokes.size(), 1u);
+    ASSERT_EQ(strokes[0].vertices.size(), 8u);
+    EXPECT_FLOAT_EQ(strokes[0].vertices[0], 0.0f);
+    EXPECT_FLOAT_EQ(strokes[0].vertices[4], 2.0f);
+    EXPECT_FLOAT_EQ(strokes[0].vertices[7], 2.0f);
+
+    // A reference places the local geometry with its own transform.
+    DraftBlockRef ref(def, Vec2(1, 1), kHalfPi, 3.0);
+    Vec2 end = ref.localToWorld(Vec2(strokes[0].vertices[4], strokes[0].vertices[5]));
+    EXPECT_NEAR(end.x, 1.0, 1e-12);
+    EXPECT_NEAR(end.y, 7.0, 1e-12);
+    EXPECT_NEAR(ref.worldToLocal(end).x, 2.0, 1e-12);
+}
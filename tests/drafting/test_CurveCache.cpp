@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "horizon/drafting/DraftEllipse.h"
+#include "horizon/drafting/DraftSpline.h"
+#include "horizon/math/Constants.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+namespace {
+
+/// A wavy open spline with `count` control points.
+std::vector<Vec2> wave(size_t count) {
+    std::vector<Vec2> pts;
+    for (size_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(i);
+        pts.emplace_back(x, 3.0 * std::sin(0.7 * x) + ((i % 3 == 0) ? 1.0 : 0.0));
+    }
+    return pts;
+}
+
+}  // namespace
+
+TEST(CurveCacheTest, SplineFlatteningMeetsToleranceAndIsCached) {
+    DraftSpline spline(wave(40));
+    const double tol = 0.01;
+    auto flat = spline.flatten(tol);
+    EXPECT_EQ(spline.flatten(tol), flat);
+    EXPECT_EQ(spline.flatten(tol * 1.1), flat);  // same bucket
+
+    // Every point of a dense fixed sampling lies within the tolerance of the polyline.
+    for (const auto& p : spline.evaluate(256)) EXPECT_TRUE(flat->nearPoint(p, tol + 1e-9));
+    EXPECT_EQ(flat->points.front().x, spline.evaluate(4).front().x);
+    EXPECT_EQ(flat->points.back().y, spline.evaluate(4).back().y);
+
+    // Mutation invalidates; the old result stays usable.
+    spline.translate(Vec2(0.0, 10.0));
+    auto moved = spline.flatten(tol);
+    EXPECT_NE(moved, flat);
+    EXPECT_NEAR(moved->points.front().y, flat->points.front().y + 10.0, 1e-12);
+    EXPECT_NE(spline.flattened(), nullptr);
+}
+
+TEST(CurveCacheTest, SplineBoundsAreAnalytic) {
+    for (bool closed : {false, true}) {
+        DraftSpline spline(wave(25), closed);
+        auto box = spline.boundingBox();
+        double minY = 1e300, maxY = -1e300, minX = 1e300, maxX = -1e300;
+        for (const auto& p : spline.evaluate(2000)) {
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+        EXPECT_NEAR(box.min().x, minX, 1e-6);
+        EXPECT_NEAR(box.max().x, maxX, 1e-6);
+        EXPECT_NEAR(box.min().y, minY, 1e-6);
+        EXPECT_NEAR(box.max().y, maxY, 1e-6);
+        EXPECT_LE(box.min().y, minY);
+        EXPECT_GE(box.max().y, maxY);
+    }
+}
+
+TEST(CurveCacheTest, LongSplineHitTestMatchesBruteForce) {
+    DraftSpline spline(wave(5000));
+    auto flat = spline.flattened();
+    ASSERT_GT(flat->points.size(), 5000u);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> dx(-2.0, 5002.0), dy(-5.0, 6.0);
+    for (int i = 0; i < 500; ++i) {
+        Vec2 p(dx(rng), dy(rng));
+        const double tol = 0.3;
+        bool brute = false;
+        const auto& pts = flat->points;
+        for (size_t k = 0; k + 1 < pts.size() && !brute; ++k) {
+            Vec2 ab = pts[k + 1] - pts[k];
+            double t = std::clamp((p - pts[k]).dot(ab) / ab.lengthSquared(), 0.0, 1.0);
+            brute = p.distanceTo(pts[k] + ab * t) <= tol;
+        }
+        EXPECT_EQ(spline.hitTest(p, tol), brute);
+    }
+}
+
+TEST(CurveCacheTest, EllipseFlatteningFollowsTolerance) {
+    DraftEllipse ellipse(Vec2(1, 2), 50.0, 20.0, 0.3);
+    auto coarse = ellipse.flatten(0.5);
+    auto fine = ellipse.flatten(0.005);
+    EXPECT_LT(coarse->points.size(), fine->points.size());
+    EXPECT_EQ(ellipse.flatten(0.5), coarse);
+
+    // Chord midpoints stay within the tolerance of the true ellipse.
+    for (const auto& flat : {coarse, fine}) {
+        const double tol = CurveCache::bucketTolerance(flat->bucket);
+        const auto& pts = flat->points;
+        for (size_t i = 0; i + 1 < pts.size(); ++i) {
+            double t = kTwoPi * (static_cast<double>(i) + 0.5) /
+                       static_cast<double>(pts.size() - 1);
+            Vec2 local(50.0 * std::cos(t), 20.0 * std::sin(t));
+            Vec2 onCurve(1 + local.x * std::cos(0.3) - local.y * std::sin(0.3),
+                         2 + local.x * std::sin(0.3) + local.y * std::cos(0.3));
+            EXPECT_TRUE(flat->nearPoint(onCurve, tol + 1e-9));
+        }
+    }
+
+    ellipse.setSemiMinor(10.0);
+    EXPECT_NE(ellipse.flatten(0.5), coarse);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "horizon/drafting/BlockDefinition.h"
+#include "horizon/drafting/DisplayList.h"
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftBlockRef.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftText.h"
+#include "horizon/math/Constants.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+TEST(DisplayListTest, TessellatesInWorldSpaceWithCumulativeDistance) {
+    DimensionStyle style;
+
+    DraftLine line(Vec2(1, 2), Vec2(4, 6));
+    auto list = buildDisplayList(line, style);
+    ASSERT_EQ(list.strokes.size(), 1u);
+    const auto& v = list.strokes[0].vertices;
+    ASSERT_EQ(v.size(), 8u);
+    EXPECT_FLOAT_EQ(v[0], 1.0f);
+    EXPECT_FLOAT_EQ(v[5], 6.0f);
+    EXPECT_FLOAT_EQ(v[7], 5.0f);
+    EXPECT_EQ(list.strokes[0].color, 0u);
+
+    DraftCircle circle(Vec2(0, 0), 2.0);
+    list = buildDisplayList(circle, style);
+    ASSERT_EQ(list.strokes.size(), 1u);
+    EXPECT_EQ(list.strokes[0].vertices.size(), 64u * 8u);
+
+    // A quarter arc gets a quarter of the circle's segments.
+    DraftArc arc(Vec2(0, 0), 1.0, 0.0, kHalfPi);
+    list = buildDisplayList(arc, style);
+    ASSERT_EQ(list.strokes.size(), 1u);
+    EXPECT_EQ(list.strokes[0].vertices.size(), 16u * 8u);
+
+    DraftText text(Vec2(3, 3), "label", 5.0);
+    list = buildDisplayList(text, style);
+    EXPECT_TRUE(list.strokes.empty());
+    ASSERT_EQ(list.texts.size(), 1u);
+    EXPECT_EQ(list.texts[0].text, "label");
+    EXPECT_DOUBLE_EQ(list.texts[0].height, 5.0);
+}
+
+TEST(DisplayListTest, CacheRebuildsOnlyWhenEntityVersionChanges) {
+    DimensionStyle style;
+    DisplayListCache cache;
+    DraftLine line(Vec2(0, 0), Vec2(1, 0));
+
+    uint64_t first = cache.get(line, style).revision;
+    EXPECT_NE(first, 0u);
+    EXPECT_EQ(cache.get(line, style).revision, first);
+
+    // Style properties are resolved at draw time and do not invalidate the list.
+    line.setColor(0xFF00FF00);
+    EXPECT_EQ(cache.get(line, style).revision, first);
+
+    line.translate(Vec2(5, 0));
+    const auto& moved = cache.get(line, style);
+    EXPECT_NE(moved.revision, first);
+    EXPECT_FLOAT_EQ(moved.strokes[0].vertices[0], 5.0f);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(DisplayListTest, BlockRefTracksDefinitionAndKeepsSubEntityStyles) {
+    auto def = std::make_shared<BlockDefinition>();
+    def->name = "B";
+    auto sub = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    auto colored = std::make_shared<DraftCircle>(Vec2(0, 0), 1.0);
+    colored->setColor(0xFFFF0000);
+    def->entities = {sub, colored};
+
+    DraftBlockRef ref(def, Vec2(10, 0), 0.0, 2.0);
+    DimensionStyle style;
+    DisplayListCache cache;
+
+    const auto& list = cache.get(ref, style);
+    ASSERT_EQ(list.strokes.size(), 2u);
+    EXPECT_EQ(list.strokes[0].color, 0u);  // ByBlock
+    EXPECT_EQ(list.strokes[1].color, 0xFFFF0000u);
+    EXPECT_FLOAT_EQ(list.strokes[0].vertices[4], 12.0f);
+    uint64_t first = list.revision;
+
+    // Editing the definition does not touch the reference's version but must still
+    // invalidate its display list.
+    sub->translate(Vec2(0, 1));
+    const auto& edited = cache.get(ref, style);
+    EXPECT_NE(edited.revision, first);
+    EXPECT_FLOAT_EQ(edited.strokes[0].vertices[1], 2.0f);
+}
+
+TEST(DisplayListTest, TrimDropsOnlyEntriesUnusedThisFrame) {
+    DimensionStyle style;
+    DisplayListCache cache;
+    DraftLine a(Vec2(0, 0), Vec2(1, 0));
+    DraftLine b(Vec2(0, 1), Vec2(1, 1));
+
+    cache.beginFrame();
+    cache.get(a, style);
+    cache.get(b, style);
+    cache.beginFrame();
+    cache.get(a, style);
+
+    cache.trim(2);
+    EXPECT_EQ(cache.size(), 2u);
+    cache.trim(1);
+    EXPECT_EQ(cache.size(), 1u);
+}
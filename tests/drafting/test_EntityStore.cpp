@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/drafting/DraftText.h"
+#include "horizon/drafting/EntityStore.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+namespace {
+
+void expectSameBox(const BoundingBox& a, const BoundingBox& b) {
+    ASSERT_EQ(a.isValid(), b.isValid());
+    if (!a.isValid()) return;
+    EXPECT_DOUBLE_EQ(a.min().x, b.min().x);
+    EXPECT_DOUBLE_EQ(a.min().y, b.min().y);
+    EXPECT_DOUBLE_EQ(a.max().x, b.max().x);
+    EXPECT_DOUBLE_EQ(a.max().y, b.max().y);
+}
+
+}  // namespace
+
+TEST(EntityStoreTest, QueriesMatchEntityVirtuals) {
+    std::vector<std::shared_ptr<DraftEntity>> entities = {
+        std::make_shared<DraftLine>(Vec2(0, 0), Vec2(4, 3)),
+        std::make_shared<DraftCircle>(Vec2(1, 1), 2.0),
+        std::make_shared<DraftArc>(Vec2(-2, 0), 1.5, 5.5, 1.0),  // wraps through 0
+        std::make_shared<DraftPolyline>(std::vector<Vec2>{{0, 0}, {2, 0}, {2, 2}}, true),
+    };
+    entities[1]->setLayer("EntityStoreTest-Layer");
+
+    EntityStore store;
+    std::vector<EntityHandle> handles;
+    for (const auto& e : entities) handles.push_back(store.sync(*e));
+    EXPECT_EQ(store.size(), 4u);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-4.0, 5.0);
+    for (size_t k = 0; k < entities.size(); ++k) {
+        const auto& e = entities[k];
+        auto h = handles[k];
+        ASSERT_TRUE(store.contains(h));
+        EXPECT_EQ(store.id(h), e->id());
+        EXPECT_EQ(store.layer(h), e->layerId());
+        expectSameBox(store.boundingBox(h), e->boundingBox());
+        for (int i = 0; i < 200; ++i) {
+            Vec2 p(coord(rng), coord(rng));
+            EXPECT_EQ(store.hitTest(h, p, 0.3), e->hitTest(p, 0.3));
+        }
+    }
+
+    BoundingBox all;
+    for (const auto& e : entities) all.expand(e->boundingBox());
+    expectSameBox(store.bounds(), all);
+
+    DraftText text(Vec2(0, 0), "x", 1.0);
+    EXPECT_FALSE(store.sync(text).valid());
+    EXPECT_EQ(store.size(), 4u);
+}
+
+TEST(EntityStoreTest, HandlesSurviveRemovalOfOtherRows) {
+    EntityStore store;
+    std::vector<std::shared_ptr<DraftLine>> lines;
+    std::vector<EntityHandle> handles;
+    for (int i = 0; i < 5; ++i) {
+        lines.push_back(std::make_shared<DraftLine>(Vec2(i, 0), Vec2(i, 1)));
+        handles.push_back(store.sync(*lines.back()));
+    }
+    auto first = handles[0];
+    auto last = handles[4];
+
+    store.remove(first);
+    EXPECT_FALSE(store.contains(first));
+    EXPECT_EQ(store.lines().size(), 4u);
+
+    // The last row was moved into the hole; its handle still resolves to it.
+    ASSERT_TRUE(store.contains(last));
+    EXPECT_EQ(store.id(last), lines[4]->id());
+    EXPECT_DOUBLE_EQ(store.boundingBox(last).min().x, 4.0);
+
+    // A reused slot does not revive the stale handle.
+    auto extra = std::make_shared<DraftLine>(Vec2(9, 9), Vec2(10, 10));
+    auto reused = store.sync(*extra);
+    EXPECT_EQ(reused.slot, first.slot);
+    EXPECT_FALSE(store.contains(first));
+    EXPECT_TRUE(store.contains(reused));
+
+    // Removing through a stale handle is a no-op.
+    store.remove(first);
+    EXPECT_TRUE(store.contains(reused));
+    EXPECT_EQ(store.size(), 5u);
+}
+
+TEST(EntityStoreTest, PolylinePointPoolStaysConsistent) {
+    EntityStore store;
+    auto a = std::make_shared<DraftPolyline>(std::vector<Vec2>{{0, 0}, {1, 0}});
+    auto b = std::make_shared<DraftPolyline>(std::vector<Vec2>{{5, 5}, {6, 5}, {6, 6}});
+    auto ha = store.sync(*a);
+    auto hb = store.sync(*b);
+
+    // Grow, shrink and remove repeatedly so runs are abandoned and the pool compacts.
+    for (int i = 0; i < 20; ++i) {
+        std::vector<Vec2> pts;
+        for (int k = 0; k <= i % 6 + 1; ++k) pts.emplace_back(k, i);
+        a->setPoints(pts);
+        EXPECT_EQ(store.sync(*a, ha), ha);
+    }
+    store.remove(ha);
+    ha = store.sync(*a);
+
+    for (const auto& [p, h] : {std::pair{a, ha}, std::pair{b, hb}}) {
+        ASSERT_TRUE(store.contains(h));
+        auto run = store.polylinePoints(store.row(h));
+        ASSERT_EQ(run.size(), p->points().size());
+        for (size_t i = 0; i < run.size(); ++i) {
+            EXPECT_EQ(run[i].x, p->points()[i].x);
+            EXPECT_EQ(run[i].y, p->points()[i].y);
+        }
+    }
+    EXPECT_LE(store.polylines().points.size(), 2 * (a->points().size() + b->points().size()));
+}
+
+TEST(EntityStoreTest, DocumentKeepsStoreInStep) {
+    DraftDocument doc;
+    auto line = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    auto text = std::make_shared<DraftText>(Vec2(0, 0), "t", 1.0);
+    doc.addEntity(line);
+    doc.addEntity(text);
+    const auto& store = doc.entityStore();
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_FALSE(doc.storeHandle(text->id()).valid());
+
+    line->translate(Vec2(10, 0));
+    doc.updateEntity(line);
+    EXPECT_DOUBLE_EQ(store.boundingBox(doc.storeHandle(line->id())).min().x, 10.0);
+
+    // Replacing an entity with one of another type moves it to the other table.
+    auto circle = std::make_shared<DraftCircle>(Vec2(3, 3), 1.0);
+    circle->setId(line->id());
+    doc.replaceEntity(circle);
+    auto h = doc.storeHandle(line->id());
+    ASSERT_TRUE(store.contains(h));
+    EXPECT_EQ(store.kind(h), PrimitiveKind::Circle);
+    EXPECT_EQ(store.lines().size(), 0u);
+
+    doc.removeEntity(circle->id());
+    EXPECT_EQ(store.size(), 0u);
+
+    doc.addEntities({std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 1)),
+                     std::make_shared<DraftArc>(Vec2(0, 0), 1.0, 0.0, 1.0)});
+    EXPECT_EQ(store.size(), 2u);
+    doc.clear();
+    EXPECT_EQ(store.size(), 0u);
+}
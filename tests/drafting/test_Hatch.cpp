@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "horizon/drafting/DraftHatch.h"
+#include "horizon/math/Constants.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+namespace {
+
+double totalLength(const DraftHatch::Segments& segs) {
+    double len = 0.0;
+    for (const auto& [a, b] : segs) len += a.distanceTo(b);
+    return len;
+}
+
+std::vector<Vec2> square(double x0, double y0, double size) {
+    return {{x0, y0}, {x0 + size, y0}, {x0 + size, y0 + size}, {x0, y0 + size}};
+}
+
+}  // namespace
+
+TEST(HatchTest, FillsOuterBoundary) {
+    DraftHatch hatch(square(0, 0, 10), HatchPattern::Lines, 0.0, 1.0);
+    const auto& lines = hatch.generateHatchLines();
+    ASSERT_EQ(lines.size(), 10u);
+    EXPECT_NEAR(totalLength(lines), 100.0, 1e-9);
+
+    DraftHatch cross(square(0, 0, 10), HatchPattern::CrossHatch, 0.0, 1.0);
+    EXPECT_EQ(cross.generateHatchLines().size(), 20u);
+}
+
+TEST(HatchTest, HolesAreCutOutAndNestedIslandsRefilled) {
+    DraftHatch hatch(square(0, 0, 10), HatchPattern::Lines, 0.0, 1.0, {square(2, 2, 6)});
+    // Lines through the hole split in two: 4 whole lines + 6 split ones.
+    EXPECT_EQ(hatch.generateHatchLines().size(), 16u);
+    EXPECT_NEAR(totalLength(hatch.generateHatchLines()), 100.0 - 36.0, 1e-9);
+    EXPECT_TRUE(hatch.contains(Vec2(1, 1)));
+    EXPECT_FALSE(hatch.contains(Vec2(5, 5)));
+
+    hatch.setHoles({square(2, 2, 6), square(4, 4, 2)});
+    EXPECT_NEAR(totalLength(hatch.generateHatchLines()), 100.0 - 36.0 + 4.0, 1e-9);
+    EXPECT_TRUE(hatch.contains(Vec2(5, 5)));
+}
+
+TEST(HatchTest, ScanLinesThroughVerticesPairCorrectly) {
+    // A diamond whose side vertices lie exactly on the scan line y = 0.
+    std::vector<Vec2> diamond = {{0, -1.5}, {2, 0}, {0, 1.5}, {-2, 0}};
+    DraftHatch hatch(diamond, HatchPattern::Lines, 0.0, 1.0);
+    const auto& lines = hatch.generateHatchLines();
+    ASSERT_EQ(lines.size(), 3u);
+    for (const auto& [a, b] : lines) {
+        EXPECT_NEAR(a.y, b.y, 1e-12);
+        EXPECT_LE(a.x, b.x);
+    }
+    // The line through both side vertices spans the full width.
+    EXPECT_NEAR(lines[1].first.distanceTo(lines[1].second), 4.0, 1e-9);
+}
+
+TEST(HatchTest, FillIsCachedAndSharedWithClones) {
+    DraftHatch hatch(square(0, 0, 10), HatchPattern::Lines, kHalfPi / 2.0, 0.5);
+    const auto* first = hatch.generateHatchLines().data();
+    EXPECT_EQ(hatch.generateHatchLines().data(), first);
+
+    auto copy = hatch.clone();
+    EXPECT_EQ(static_cast<DraftHatch&>(*copy).generateHatchLines().data(), first);
+
+    hatch.translate(Vec2(1, 0));
+    const auto& moved = hatch.generateHatchLines();
+    EXPECT_NE(moved.data(), first);
+    EXPECT_NEAR(totalLength(moved),
+                totalLength(static_cast<DraftHatch&>(*copy).generateHatchLines()), 1e-9);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftDocument.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/drafting/IntersectionEngine.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+TEST(IntersectionEngineTest, IntersectionsMatchBruteForceAndHonourFilter) {
+    DraftDocument doc;
+    auto target = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(10, 0));
+    doc.addEntity(target);
+    auto crossA = std::make_shared<DraftLine>(Vec2(2, -1), Vec2(2, 1));
+    auto crossB = std::make_shared<DraftCircle>(Vec2(7, 0), 1.0);
+    auto far = std::make_shared<DraftLine>(Vec2(50, -1), Vec2(50, 1));
+    doc.addEntity(crossA);
+    doc.addEntity(crossB);
+    doc.addEntity(far);
+
+    IntersectionEngine engine;
+    auto pts = engine.intersections(doc, *target);
+    size_t bruteForce = 0;
+    for (const auto& other : doc.entities()) {
+        if (other->id() != target->id()) bruteForce += intersect(*target, *other).points.size();
+    }
+    EXPECT_EQ(pts.size(), bruteForce);
+    EXPECT_EQ(pts.size(), 3u);
+
+    auto onlyLines = [](const DraftEntity& e) { return dynamic_cast<const DraftLine*>(&e); };
+    pts = engine.intersections(doc, *target, onlyLines);
+    ASSERT_EQ(pts.size(), 1u);
+    EXPECT_NEAR(pts[0].x, 2.0, 1e-9);
+}
+
+TEST(IntersectionEngineTest, SegmentCacheFollowsEntityVersion) {
+    auto poly = std::make_shared<DraftPolyline>(
+        std::vector<Vec2>{Vec2(0, 0), Vec2(1, 0), Vec2(1, 1)}, false);
+
+    IntersectionEngine engine;
+    const auto* first = &engine.segments(*poly);
+    EXPECT_EQ(first->size(), 2u);
+    EXPECT_EQ(&engine.segments(*poly), first);
+    EXPECT_EQ(engine.cachedEntityCount(), 1u);
+
+    poly->addPoint(Vec2(0, 1));
+    EXPECT_EQ(engine.segments(*poly).size(), 3u);
+    EXPECT_EQ(engine.cachedEntityCount(), 1u);
+}
+
+TEST(IntersectionEngineTest, NearestRayHitFindsClosestBoundary) {
+    DraftDocument doc;
+    auto source = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    doc.addEntity(source);
+    // Many boundaries far away, one near, and one behind the ray origin.
+    for (int i = 0; i < 200; ++i) {
+        double x = 100.0 + i;
+        doc.addEntity(std::make_shared<DraftLine>(Vec2(x, -1), Vec2(x, 1)));
+    }
+    doc.addEntity(std::make_shared<DraftCircle>(Vec2(20, 0), 2.0));
+    doc.addEntity(std::make_shared<DraftLine>(Vec2(-5, -1), Vec2(-5, 1)));
+
+    IntersectionEngine engine;
+    auto hit = engine.nearestRayHit(doc, Vec2(1, 0), Vec2(1, 0), source->id());
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_NEAR(hit->x, 18.0, 1e-9);
+    EXPECT_NEAR(hit->y, 0.0, 1e-9);
+
+    // Filtering the circle out leaves the first far line.
+    auto noCircles = [](const DraftEntity& e) { return !dynamic_cast<const DraftCircle*>(&e); };
+    hit = engine.nearestRayHit(doc, Vec2(1, 0), Vec2(1, 0), source->id(), 1e-6, noCircles);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_NEAR(hit->x, 100.0, 1e-9);
+
+    // Nothing lies along +y.
+    EXPECT_FALSE(engine.nearestRayHit(doc, Vec2(1, 0), Vec2(0, 1), source->id()).has_value());
+}
+
+TEST(IntersectionEngineTest, CircleIntersectionsRespectOtherArcSweep) {
+    DraftDocument doc;
+    auto self = std::make_shared<DraftArc>(Vec2(0, 0), 5.0, 0.0, 1.0);
+    doc.addEntity(self);
+    auto line = std::make_shared<DraftLine>(Vec2(-10, 0), Vec2(10, 0));
+    // Upper half of a circle centred at (0, 5).
+    auto arc = std::make_shared<DraftArc>(Vec2(0, 5), 5.0, 0.0, 3.14159);
+    doc.addEntity(line);
+    doc.addEntity(arc);
+
+    IntersectionEngine engine;
+    auto pts = engine.circleIntersections(doc, self->center(), self->radius(), self->id());
+    // Two from the line.  The circles cross at y = 2.5, below the arc's centre, so the
+    // upper-half arc contributes nothing.
+    EXPECT_EQ(pts.size(), 2u);
+    for (const auto& pt : pts) EXPECT_NEAR(pt.y, 0.0, 1e-9);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "horizon/drafting/DraftArc.h"
+#include "horizon/drafting/DraftCircle.h"
+#include "horizon/drafting/DraftHatch.h"
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/DraftPolyline.h"
+#include "horizon/drafting/Intersection.h"
+#include "horizon/math/Constants.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+using Entities = std::vector<std::shared_ptr<DraftEntity>>;
+
+TEST(IntersectionSweepTest, MatchesBruteForceOnRandomSegments) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> pos(0.0, 1000.0);
+    std::uniform_real_distribution<double> step(-20.0, 20.0);
+    Entities entities;
+    for (int i = 0; i < 2000; ++i) {
+        Vec2 a(pos(rng), pos(rng));
+        entities.push_back(std::make_shared<DraftLine>(a, a + Vec2(step(rng), step(rng))));
+    }
+
+    size_t bruteForce = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        for (size_t j = i + 1; j < entities.size(); ++j) {
+            bruteForce += intersect(*entities[i], *entities[j]).points.size();
+        }
+    }
+    ASSERT_GT(bruteForce, 0u);
+
+    SweepOptions serial;
+    serial.threads = 1;
+    auto result = findAllIntersections(entities, serial);
+    EXPECT_EQ(result.intersections.size(), bruteForce);
+    for (const auto& cluster : result.intersections) EXPECT_EQ(cluster.entityIds.size(), 2u);
+
+    SweepOptions parallel;
+    parallel.threads = 4;
+    auto parallelResult = findAllIntersections(entities, parallel);
+    ASSERT_EQ(parallelResult.intersections.size(), result.intersections.size());
+    for (size_t i = 0; i < result.intersections.size(); ++i) {
+        EXPECT_EQ(parallelResult.intersections[i].entityIds, result.intersections[i].entityIds);
+    }
+}
+
+TEST(IntersectionSweepTest, CirclesAndArcsAreSplitIntoMonotonePieces) {
+    auto circle = std::make_shared<DraftCircle>(Vec2(0, 0), 5.0);
+    auto horizontal = std::make_shared<DraftLine>(Vec2(-10, 1), Vec2(10, 1));
+    // Upper-left quarter of a circle through the line's path.
+    auto arc = std::make_shared<DraftArc>(Vec2(3, 0), 4.0, kHalfPi, kPi);
+    auto result = findAllIntersections({circle, horizontal, arc});
+
+    // Line x circle: 2, line x arc: 1, circle x arc: 1 (upper crossing only).
+    EXPECT_EQ(result.intersections.size(), 4u);
+    for (const auto& cluster : result.intersections) {
+        EXPECT_EQ(cluster.entityIds.size(), 2u);
+    }
+    EXPECT_TRUE(result.overlaps.empty());
+    EXPECT_TRUE(result.redundantIds.empty());
+}
+
+TEST(IntersectionSweepTest, EndpointContactsAreOptIn) {
+    auto a = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(5, 0));
+    auto b = std::make_shared<DraftLine>(Vec2(5, 0), Vec2(5, 5));
+    auto t = std::make_shared<DraftLine>(Vec2(2, 0), Vec2(2, -3));  // T-junction on `a`.
+
+    auto result = findAllIntersections({a, b, t});
+    ASSERT_EQ(result.intersections.size(), 1u);
+    EXPECT_NEAR(result.intersections[0].point.x, 2.0, 1e-9);
+
+    SweepOptions options;
+    options.includeEndpointContacts = true;
+    result = findAllIntersections({a, b, t}, options);
+    EXPECT_EQ(result.intersections.size(), 2u);
+}
+
+TEST(IntersectionSweepTest, FindsOverlapClustersAndRedundantEntities) {
+    auto line = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(10, 0));
+    auto duplicate = std::make_shared<DraftLine>(Vec2(10, 0), Vec2(0, 0));
+    auto inside = std::make_shared<DraftLine>(Vec2(2, 0), Vec2(5, 0));
+    auto partial = std::make_shared<DraftLine>(Vec2(8, 0), Vec2(15, 0));
+    auto box = std::make_shared<DraftPolyline>(
+        std::vector<Vec2>{Vec2(20, 0), Vec2(30, 0), Vec2(30, 10), Vec2(20, 10)}, true);
+    auto edge = std::make_shared<DraftLine>(Vec2(30, 2), Vec2(30, 8));
+
+    auto circle = std::make_shared<DraftCircle>(Vec2(50, 50), 3.0);
+    auto circleCopy = std::make_shared<DraftCircle>(Vec2(50, 50), 3.0);
+    auto arcOnCircle = std::make_shared<DraftArc>(Vec2(50, 50), 3.0, 5.5, 1.0);  // Wraps 2pi.
+    auto separate = std::make_shared<DraftCircle>(Vec2(80, 80), 1.0);
+
+    Entities entities{line, duplicate, inside, partial, box, edge,
+                      circle, circleCopy, arcOnCircle, separate};
+    auto result = findAllIntersections(entities);
+
+    std::vector<uint64_t> expectedRedundant{duplicate->id(), inside->id(), edge->id(),
+                                            circleCopy->id(), arcOnCircle->id()};
+    std::sort(expectedRedundant.begin(), expectedRedundant.end());
+    EXPECT_EQ(result.redundantIds, expectedRedundant);
+
+    ASSERT_EQ(result.overlaps.size(), 3u);
+    auto sorted = [](std::vector<uint64_t> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    EXPECT_EQ(result.overlaps[0].entityIds,
+              sorted({line->id(), duplicate->id(), inside->id(), partial->id()}));
+    EXPECT_EQ(result.overlaps[1].entityIds, sorted({box->id(), edge->id()}));
+    EXPECT_EQ(result.overlaps[2].entityIds,
+              sorted({circle->id(), circleCopy->id(), arcOnCircle->id()}));
+}
+
+TEST(IntersectionSweepTest, HatchesNeitherCoverNorAreCovered) {
+    std::vector<Vec2> square{Vec2(0, 0), Vec2(10, 0), Vec2(10, 10), Vec2(0, 10)};
+    auto outline = std::make_shared<DraftPolyline>(square, true);
+    auto hatch = std::make_shared<DraftHatch>(square);
+    auto result = findAllIntersections({outline, hatch});
+    EXPECT_TRUE(result.redundantIds.empty());
+    result = findAllIntersections({hatch, outline});
+    EXPECT_TRUE(result.redundantIds.empty());
+
+    // A line along the hatch's edge is not redundant; a copy of it still is.
+    auto edge = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(10, 0));
+    auto edgeCopy = std::make_shared<DraftLine>(Vec2(2, 0), Vec2(6, 0));
+    result = findAllIntersections({hatch, edge});
+    EXPECT_TRUE(result.redundantIds.empty());
+    result = findAllIntersections({hatch, edge, edgeCopy});
+    EXPECT_EQ(result.redundantIds, std::vector<uint64_t>{edgeCopy->id()});
+}
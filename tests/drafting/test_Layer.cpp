@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "horizon/drafting/DraftLine.h"
+#include "horizon/drafting/Layer.h"
+
+using namespace hz::draft;
+using namespace hz::math;
+
+TEST(LayerTest, InterningIsStableAndDefaultLayerIsZero) {
+    EXPECT_EQ(LayerNames::intern("0"), kDefaultLayerId);
+    LayerId walls = LayerNames::intern("LayerTest-Walls");
+    EXPECT_EQ(LayerNames::intern(std::string("LayerTest-Walls")), walls);
+    EXPECT_EQ(LayerNames::name(walls), "LayerTest-Walls");
+    EXPECT_EQ(LayerNames::find("LayerTest-Walls"), walls);
+    EXPECT_FALSE(LayerNames::find("LayerTest-NeverInterned").has_value());
+}
+
+TEST(LayerTest, ManagerLooksUpByHandleAndName) {
+    LayerManager mgr;
+    LayerProperties props;
+    props.name = "LayerTest-Doors";
+    props.color = 0xFF00FF00;
+    mgr.addLayer(props);
+
+    LayerId id = LayerNames::intern("LayerTest-Doors");
+    ASSERT_NE(mgr.getLayer(id), nullptr);
+    EXPECT_EQ(mgr.getLayer(id), mgr.getLayer("LayerTest-Doors"));
+    EXPECT_EQ(mgr.getLayer(id)->color, 0xFF00FF00u);
+    EXPECT_EQ(mgr.getLayer(LayerNames::intern("LayerTest-Missing")), nullptr);
+    EXPECT_EQ(mgr.layerNames(), (std::vector<std::string>{"0", "LayerTest-Doors"}));
+}
+
+TEST(LayerTest, RenameMovesPropertiesAndCurrentLayer) {
+    LayerManager mgr;
+    LayerProperties props;
+    props.name = "LayerTest-Old";
+    props.lineWidth = 2.5;
+    mgr.addLayer(props);
+    LayerId oldId = LayerNames::intern("LayerTest-Old");
+    mgr.setCurrentLayer(oldId);
+
+    auto newId = mgr.renameLayer(oldId, "LayerTest-New");
+    ASSERT_TRUE(newId.has_value());
+    EXPECT_EQ(mgr.getLayer(oldId), nullptr);
+    ASSERT_NE(mgr.getLayer(*newId), nullptr);
+    EXPECT_EQ(mgr.getLayer(*newId)->name, "LayerTest-New");
+    EXPECT_DOUBLE_EQ(mgr.getLayer(*newId)->lineWidth, 2.5);
+    EXPECT_EQ(mgr.currentLayerId(), *newId);
+    EXPECT_EQ(mgr.currentLayer(), "LayerTest-New");
+
+    // The default layer and taken names are refused.
+    EXPECT_FALSE(mgr.renameLayer(kDefaultLayerId, "LayerTest-X").has_value());
+    EXPECT_FALSE(mgr.renameLayer(*newId, "0").has_value());
+}
+
+TEST(LayerTest, RemoveKeepsDefaultAndCurrentLayers) {
+    LayerManager mgr;
+    LayerProperties props;
+    props.name = "LayerTest-Temp";
+    mgr.addLayer(props);
+    LayerId id = LayerNames::intern("LayerTest-Temp");
+
+    mgr.removeLayer(kDefaultLayerId);
+    EXPECT_NE(mgr.getLayer(kDefaultLayerId), nullptr);
+
+    mgr.setCurrentLayer(id);
+    mgr.removeLayer(id);
+    EXPECT_NE(mgr.getLayer(id), nullptr);
+
+    mgr.setCurrentLayer(kDefaultLayerId);
+    mgr.removeLayer("LayerTest-Temp");
+    EXPECT_EQ(mgr.getLayer(id), nullptr);
+}
+
+TEST(LayerTest, EntitiesCarryHandlesThroughClone) {
+    DraftLine line(Vec2(0, 0), Vec2(1, 0));
+    EXPECT_EQ(line.layerId(), kDefaultLayerId);
+    EXPECT_EQ(line.layer(), "0");
+
+    line.setLayer("LayerTest-Entities");
+    EXPECT_EQ(line.layerId(), LayerNames::intern("LayerTest-Entities"));
+    auto copy = line.clone();
+    EXPECT_EQ(copy->layerId(), line.layerId());
+    EXPECT_EQ(copy->layer(), "LayerTest-Entities");
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
+#include "horizon/drafting/DraftArc.h"
 #include "horizon/drafting/DraftCircle.h"
 #include "horizon/drafting/DraftDocument.h"
 #include "horizon/drafting/DraftLine.h"
@@ -98,6 +101,32 @@ TEST(SpatialIndexTest, RebuildFromEntities) {
     EXPECT_EQ(results[0], circle->id());
 }
 
+TEST(SpatialIndexTest, RevisionChangesOnEveryMutation) {
+    SpatialIndex index;
+    auto line = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(10, 10));
+    uint64_t rev = index.revision();
+
+    auto expectBumped = [&]() {
+        EXPECT_NE(index.revision(), rev);
+        rev = index.revision();
+    };
+    index.insert(line);
+    expectBumped();
+    line->translate(Vec2(1, 0));
+    index.update(line);
+    expectBumped();
+    index.remove(line->id());
+    expectBumped();
+    index.rebuild({line});
+    expectBumped();
+    index.clear();
+    expectBumped();
+
+    // Queries leave it alone.
+    (void)index.query(BoundingBox(Vec3(-1, -1, 0), Vec3(1, 1, 0)));
+    EXPECT_EQ(index.revision(), rev);
+}
+
 // --- DraftDocument integration tests ---
 
 TEST(DraftDocumentSpatialTest, AddEntityUpdatesSpatialIndex) {
@@ -136,6 +165,100 @@ TEST(DraftDocumentSpatialTest, ClearEmptiesSpatialIndex) {
     EXPECT_TRUE(results.empty());
 }
 
+TEST(DraftDocumentSpatialTest, FindEntityTracksAddRemoveAndClear) {
+    DraftDocument doc;
+    std::vector<std::shared_ptr<DraftLine>> lines;
+    for (int i = 0; i < 5; ++i) {
+        auto line = std::make_shared<DraftLine>(Vec2(i, 0), Vec2(i, 1));
+        lines.push_back(line);
+        doc.addEntity(line);
+    }
+    for (const auto& line : lines) EXPECT_EQ(doc.findEntity(line->id()), line);
+
+    // Removing from the middle shifts later slots, keeping their order; lookups must
+    // follow.
+    doc.removeEntity(lines[1]->id());
+    EXPECT_EQ(doc.findEntity(lines[1]->id()), nullptr);
+    EXPECT_EQ(doc.entities(), (std::vector<std::shared_ptr<DraftEntity>>{lines[0], lines[2],
+                                                                          lines[3], lines[4]}));
+    for (size_t i : {0u, 2u, 3u, 4u}) EXPECT_EQ(doc.findEntity(lines[i]->id()), lines[i]);
+
+    // Lookups follow a second removal too.
+    doc.removeEntity(lines[3]->id());
+    EXPECT_EQ(doc.findEntity(lines[3]->id()), nullptr);
+    for (size_t i : {0u, 2u, 4u}) EXPECT_EQ(doc.findEntity(lines[i]->id()), lines[i]);
+
+    // Undo of a removal re-adds the same entity.
+    doc.addEntity(lines[1]);
+    EXPECT_EQ(doc.findEntity(lines[1]->id()), lines[1]);
+
+    doc.addEntities({std::make_shared<DraftCircle>(Vec2(9, 9), 1.0)});
+    EXPECT_EQ(doc.findEntity(doc.entities().back()->id()), doc.entities().back());
+
+    doc.clear();
+    EXPECT_EQ(doc.findEntity(lines[0]->id()), nullptr);
+}
+
+TEST(DraftDocumentSpatialTest, AddingAnExistingIdReplacesIt) {
+    DraftDocument doc;
+    auto a = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 1));
+    auto b = std::make_shared<DraftLine>(Vec2(5, 5), Vec2(6, 6));
+    doc.addEntity(a);
+    doc.addEntity(b);
+    auto withId = [](uint64_t id, Vec2 start, Vec2 end) {
+        auto line = std::make_shared<DraftLine>(start, end);
+        line->setId(id);
+        return line;
+    };
+    auto hitsNear = [&doc](double c) {
+        return doc.spatialIndex().query(BoundingBox(Vec3(c - 1, c - 1, 0), Vec3(c + 1, c + 1, 0)));
+    };
+
+    // Same id, new geometry: it takes the old slot, and the old bounds are gone.
+    auto moved = withId(a->id(), Vec2(20, 20), Vec2(20.5, 20.5));
+    doc.addEntity(moved);
+    ASSERT_EQ(doc.entities().size(), 2u);
+    EXPECT_EQ(doc.entities()[0], moved);
+    EXPECT_EQ(doc.findEntity(a->id()), moved);
+    EXPECT_TRUE(hitsNear(0.5).empty());
+    EXPECT_EQ(hitsNear(20.25).size(), 1u);
+
+    // In a batch, against the document and within the batch itself.
+    auto again = withId(b->id(), Vec2(40, 40), Vec2(40.5, 40.5));
+    auto c = std::make_shared<DraftLine>(Vec2(8, 8), Vec2(9, 9));
+    auto c2 = withId(c->id(), Vec2(60, 60), Vec2(60.5, 60.5));
+    doc.addEntities({again, c, c2});
+    ASSERT_EQ(doc.entities().size(), 3u);
+    EXPECT_EQ(doc.findEntity(b->id()), again);
+    EXPECT_EQ(doc.findEntity(c->id()), c2);
+    EXPECT_TRUE(hitsNear(5.5).empty());
+    EXPECT_EQ(hitsNear(40.25).size(), 1u);
+    EXPECT_EQ(hitsNear(60.25).size(), 1u);
+    EXPECT_TRUE(hitsNear(8.5).empty());
+}
+
+TEST(DraftDocumentSpatialTest, ReplaceEntityKeepsSlotAndReindexes) {
+    DraftDocument doc;
+    auto a = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 1));
+    auto b = std::make_shared<DraftLine>(Vec2(5, 5), Vec2(6, 6));
+    doc.addEntity(a);
+    doc.addEntity(b);
+
+    auto moved = std::make_shared<DraftLine>(Vec2(50, 50), Vec2(51, 51));
+    moved->setId(a->id());
+    EXPECT_TRUE(doc.replaceEntity(moved));
+    EXPECT_EQ(doc.entities().front(), moved);
+    EXPECT_EQ(doc.findEntity(a->id()), moved);
+    EXPECT_TRUE(doc.spatialIndex().query(BoundingBox(Vec3(-1, -1, 0), Vec3(2, 2, 0))).empty());
+    auto hits = doc.spatialIndex().query(BoundingBox(Vec3(49, 49, 0), Vec3(52, 52, 0)));
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], a->id());
+
+    auto stranger = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    EXPECT_FALSE(doc.replaceEntity(stranger));
+    EXPECT_EQ(doc.entities().size(), 2u);
+}
+
 // --- SnapEngine spatial-index overload tests ---
 
 TEST(SnapEngineTest, SpatialSnapFindsNearbyEntity) {
@@ -150,7 +273,7 @@ TEST(SnapEngineTest, SpatialSnapFindsNearbyEntity) {
     engine.setGridSpacing(10.0);
 
     Vec2 cursor(0.9, 0.9);
-    SnapResult result = engine.snap(cursor, doc.spatialIndex(), doc.entities());
+    SnapResult result = engine.snap(cursor, doc);
     EXPECT_EQ(result.type, SnapType::Endpoint);
     EXPECT_NEAR(result.point.x, 1.0, 1e-7);
     EXPECT_NEAR(result.point.y, 1.0, 1e-7);
@@ -166,8 +289,174 @@ TEST(SnapEngineTest, SpatialSnapReturnsGridWhenNoEntityNearby) {
     engine.setGridSpacing(1.0);
 
     Vec2 cursor(5.1, 5.2);
-    SnapResult result = engine.snap(cursor, doc.spatialIndex(), doc.entities());
+    SnapResult result = engine.snap(cursor, doc);
     EXPECT_EQ(result.type, SnapType::Grid);
     EXPECT_NEAR(result.point.x, 5.0, 1e-7);
     EXPECT_NEAR(result.point.y, 5.0, 1e-7);
 }
+
+TEST(SpatialIndexTest, NearestReturnsClosestEntitiesFirst) {
+    SpatialIndex index;
+    auto a = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    auto b = std::make_shared<DraftLine>(Vec2(5, 0), Vec2(6, 0));
+    auto c = std::make_shared<DraftCircle>(Vec2(20, 0), 1.0);
+    index.rebuild({a, b, c});
+
+    auto result = index.nearest(Vec2(4.5, 0), 2, 100.0, [](uint64_t, const BoundingBox& bb) {
+        return SpatialIndex::boxDistance(Vec2(4.5, 0), bb);
+    });
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].value, b->id());
+    EXPECT_EQ(result[1].value, a->id());
+}
+
+TEST(SnapEngineTest, SpatialSnapPicksClosestOfOverlappingCandidates) {
+    DraftDocument doc;
+    // Long line whose box covers the cursor, and a short line with an
+    // endpoint right next to it.
+    auto longLine = std::make_shared<DraftLine>(Vec2(-10, -10), Vec2(10, 10));
+    doc.addEntity(longLine);
+    auto shortLine = std::make_shared<DraftLine>(Vec2(0.3, 0.0), Vec2(3, 0));
+    doc.addEntity(shortLine);
+
+    SnapEngine engine;
+    engine.setSnapTolerance(1.0);
+    engine.setGridSpacing(100.0);
+
+    SnapResult result = engine.snap(Vec2(0.2, 0.1), doc);
+    EXPECT_EQ(result.type, SnapType::Endpoint);
+    EXPECT_NEAR(result.point.x, 0.3, 1e-9);
+    EXPECT_NEAR(result.point.y, 0.0, 1e-9);
+}
+
+TEST(DraftEntityTest, VersionChangesOnGeometryEdits) {
+    auto line = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(1, 0));
+    uint64_t v0 = line->version();
+    line->setEnd(Vec2(2, 0));
+    uint64_t v1 = line->version();
+    EXPECT_NE(v1, v0);
+    line->translate(Vec2(1, 1));
+    EXPECT_NE(line->version(), v1);
+
+    // A clone that takes over the original id must not alias its version.
+    auto copy = line->clone();
+    copy->setId(line->id());
+    copy->rotate(Vec2(0, 0), 1.0);
+    EXPECT_NE(copy->version(), line->version());
+}
+
+TEST(SnapEngineTest, IntersectionSnapUsesCachedPairsUntilEdited) {
+    DraftDocument doc;
+    auto a = std::make_shared<DraftLine>(Vec2(-5, -5), Vec2(5, 5));
+    auto b = std::make_shared<DraftLine>(Vec2(-5, 5), Vec2(5, -5));
+    doc.addEntity(a);
+    doc.addEntity(b);
+
+    SnapEngine engine;
+    engine.setSnapTolerance(1.0);
+    engine.setGridSpacing(100.0);
+
+    SnapResult result = engine.snap(Vec2(0.3, -0.2), doc);
+    EXPECT_EQ(result.type, SnapType::Intersection);
+    EXPECT_NEAR(result.point.x, 0.0, 1e-9);
+    EXPECT_NEAR(result.point.y, 0.0, 1e-9);
+    EXPECT_EQ(engine.intersectionCacheSize(), 1u);
+
+    // Moving one line invalidates the cached pair through its version.
+    b->translate(Vec2(1, 0));
+    doc.spatialIndex().update(b);
+    result = engine.snap(Vec2(0.3, 0.2), doc);
+    EXPECT_EQ(result.type, SnapType::Intersection);
+    EXPECT_NEAR(result.point.x, 0.5, 1e-9);
+    EXPECT_NEAR(result.point.y, 0.5, 1e-9);
+    EXPECT_EQ(engine.intersectionCacheSize(), 1u);
+
+    engine.setModeEnabled(SnapType::Intersection, false);
+    result = engine.snap(Vec2(0.3, 0.2), doc);
+    EXPECT_NE(result.type, SnapType::Intersection);
+}
+
+TEST(SnapEngineTest, PerpendicularAndTangentNeedReferencePoint) {
+    DraftDocument doc;
+    auto line = std::make_shared<DraftLine>(Vec2(0, 0), Vec2(10, 0));
+    auto circle = std::make_shared<DraftCircle>(Vec2(20, 0), 2.0);
+    doc.addEntity(line);
+    doc.addEntity(circle);
+
+    SnapEngine engine;
+    engine.setSnapTolerance(0.5);
+    engine.setGridSpacing(100.0);
+
+    EXPECT_EQ(engine.snap(Vec2(4.2, 0.1), doc).type, SnapType::None);
+
+    engine.setReferencePoint(Vec2(4, 6));
+    SnapResult result = engine.snap(Vec2(4.2, 0.1), doc);
+    EXPECT_EQ(result.type, SnapType::Perpendicular);
+    EXPECT_NEAR(result.point.x, 4.0, 1e-9);
+    EXPECT_NEAR(result.point.y, 0.0, 1e-9);
+
+    // Tangent from (24, 0) to the circle: angle acos(r/d) = 60 degrees off the axis.
+    engine.setReferencePoint(Vec2(24, 0));
+    Vec2 expected(20 + 2.0 * 0.5, 2.0 * std::sqrt(3.0) / 2.0);
+    result = engine.snap(expected + Vec2(0.1, 0.1), doc);
+    EXPECT_EQ(result.type, SnapType::Tangent);
+    EXPECT_NEAR(result.point.x, expected.x, 1e-9);
+    EXPECT_NEAR(result.point.y, expected.y, 1e-9);
+
+    engine.clearReferencePoint();
+    EXPECT_EQ(engine.snap(expected + Vec2(0.1, 0.1), doc).type, SnapType::None);
+}
+
+TEST(SnapEngineTest, NearestIsFallbackAndRespectsArcSweep) {
+    DraftDocument doc;
+    auto arc = std::make_shared<DraftArc>(Vec2(0, 0), 5.0, 0.0, 1.5707963267948966);
+    doc.addEntity(arc);
+
+    SnapEngine engine;
+    engine.setSnapTolerance(0.5);
+    engine.setGridSpacing(100.0);
+
+    Vec2 onSweep(5.2 * std::cos(0.3), 5.2 * std::sin(0.3));
+    EXPECT_EQ(engine.snap(onSweep, doc).type, SnapType::None);
+
+    engine.setModeEnabled(SnapType::Nearest, true);
+    SnapResult result = engine.snap(onSweep, doc);
+    EXPECT_EQ(result.type, SnapType::Nearest);
+    EXPECT_NEAR(result.point.x, 5.0 * std::cos(0.3), 1e-9);
+    EXPECT_NEAR(result.point.y, 5.0 * std::sin(0.3), 1e-9);
+
+    // Off the sweep the closest point is an endpoint, which the Endpoint mode claims.
+    result = engine.snap(Vec2(5.1, -0.3), doc);
+    EXPECT_EQ(result.type, SnapType::Endpoint);
+
+    // Outside the aperture of every curve nothing snaps.
+    EXPECT_EQ(engine.snap(Vec2(-5.0, 0.0), doc).type, SnapType::None);
+}
+
+TEST(SnapEngineTest, DenseApertureKeepsTheClosestEntities) {
+    // Far more lines cross the aperture than the engine examines; the two under the
+    // cursor are added last.  The scene sits around (50, 50), away from grid points.
+    DraftDocument doc;
+    const Vec2 o(50, 50);
+    for (int i = 0; i < 300; ++i) {
+        const double y = 0.5 + 0.0015 * i;
+        doc.addEntity(std::make_shared<DraftLine>(o + Vec2(-10, y), o + Vec2(10, y)));
+    }
+    doc.addEntity(std::make_shared<DraftLine>(o + Vec2(-10, -9.95), o + Vec2(10, 10.05)));
+    doc.addEntity(std::make_shared<DraftLine>(o + Vec2(-10, 10.05), o + Vec2(10, -9.95)));
+
+    SnapEngine engine;
+    engine.setSnapTolerance(1.0);
+    engine.setGridSpacing(100.0);
+
+    SnapResult result = engine.snap(o + Vec2(0.02, 0.0), doc);
+    EXPECT_EQ(result.type, SnapType::Intersection);
+    EXPECT_NEAR(result.point.x, o.x, 1e-9);
+    EXPECT_NEAR(result.point.y, o.y + 0.05, 1e-9);
+
+    engine.setModeEnabled(SnapType::Intersection, false);
+    engine.setModeEnabled(SnapType::Nearest, true);
+    result = engine.snap(o + Vec2(0.3, 0.0), doc);
+    EXPECT_EQ(result.type, SnapType::Nearest);
+    EXPECT_NEAR(result.point.distanceTo(o + Vec2(0.3, 0.0)), 0.25 / std::sqrt(2.0), 1e-9);
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 
+#include "horizon/drafting/DraftDocument.h"
 #include "horizon/drafting/DraftLine.h"
 #include "horizon/drafting/SnapEngine.h"
 #include "horizon/drafting/SpatialIndex.h"
@@ -22,8 +25,8 @@ TEST(SpatialIndexPerfTest, TenThousandEntitySnapUnder1ms) {
         entities.push_back(line);
     }
 
-    SpatialIndex index;
-    index.rebuild(entities);
+    DraftDocument doc;
+    doc.addEntities(std::move(entities));
 
     SnapEngine engine;
     engine.setSnapTolerance(2.0);
@@ -32,7 +35,7 @@ TEST(SpatialIndexPerfTest, TenThousandEntitySnapUnder1ms) {
     Vec2 cursor(250.0, 250.0);
     auto start = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < 1000; ++i) {
-        engine.snap(cursor, index, entities);
+        engine.snap(cursor, doc);
     }
     auto end = std::chrono::high_resolution_clock::now();
 
@@ -90,3 +93,98 @@ TEST(SpatialIndexPerfTest, TenThousandEntityBoxSelectUnder5ms) {
     std::cout << "[PERF] 10k entities, avg box query: " << avgMs << " ms" << std::endl;
     EXPECT_LT(avgMs, 5.0) << "Box query too slow: " << avgMs << " ms average";
 }
+
+namespace {
+
+std::vector<std::shared_ptr<DraftEntity>> makeLineGrid(uint64_t count) {
+    std::vector<std::shared_ptr<DraftEntity>> entities;
+    entities.reserve(count);
+    const uint64_t side = static_cast<uint64_t>(std::sqrt(static_cast<double>(count))) + 1;
+    for (uint64_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(i % side) * 5.0;
+        double y = static_cast<double>(i / side) * 5.0;
+        auto line = std::make_shared<DraftLine>(Vec2(x, y), Vec2(x + 3, y + 3));
+        line->setId(i + 1);
+        entities.push_back(line);
+    }
+    return entities;
+}
+
+}  // namespace
+
+TEST(SpatialIndexPerfTest, BulkRebuildFasterThanIncrementalInsert) {
+    auto entities = makeLineGrid(100000);
+
+    SpatialIndex incremental;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& e : entities) incremental.insert(e);
+    auto end = std::chrono::high_resolution_clock::now();
+    double incrementalMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    SpatialIndex bulk;
+    start = std::chrono::high_resolution_clock::now();
+    bulk.rebuild(entities);
+    end = std::chrono::high_resolution_clock::now();
+    double bulkMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "[PERF] 100k entity build: incremental " << incrementalMs << " ms, bulk "
+              << bulkMs << " ms" << std::endl;
+    EXPECT_LT(bulkMs, incrementalMs);
+}
+
+TEST(SpatialIndexPerfTest, BulkRebuildQueryComparison) {
+    auto entities = makeLineGrid(100000);
+
+    SpatialIndex incremental;
+    for (const auto& e : entities) incremental.insert(e);
+    SpatialIndex bulk;
+    bulk.rebuild(entities);
+
+    std::vector<BoundingBox> windows;
+    for (int i = 0; i < 1000; ++i) {
+        double x = static_cast<double>((i * 131) % 1500);
+        double y = static_cast<double>((i * 197) % 1500);
+        windows.emplace_back(Vec3(x, y, -1e9), Vec3(x + 20, y + 20, 1e9));
+    }
+
+    auto timeQueries = [&windows](const SpatialIndex& index, std::size_t& hits) {
+        hits = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& w : windows) hits += index.query(w).size();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    std::size_t incrementalHits = 0;
+    std::size_t bulkHits = 0;
+    double incrementalMs = timeQueries(incremental, incrementalHits);
+    double bulkMs = timeQueries(bulk, bulkHits);
+
+    std::cout << "[PERF] 100k entities, 1000 box queries: incremental " << incrementalMs
+              << " ms, bulk " << bulkMs << " ms" << std::endl;
+    // Timings are reported for tracking only: on shared runners the noise is
+    // larger than the difference. The packed tree must answer identically.
+    EXPECT_EQ(bulkHits, incrementalHits);
+}
+
+TEST(SpatialIndexPerfTest, HundredThousandEntityDragUpdatesStayLocal) {
+    auto entities = makeLineGrid(100000);
+    SpatialIndex index;
+    index.rebuild(entities);
+
+    // Simulate a grip drag: one entity nudged on every "mouse event".
+    auto dragged = std::static_pointer_cast<DraftLine>(entities[50000]);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        dragged->translate(Vec2(0.01, 0.0));
+        index.update(dragged);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double avgMs = std::chrono::duration<double, std::milli>(end - start).count() / 1000.0;
+    std::cout << "[PERF] 100k entities, avg single-entity update: " << avgMs << " ms" << std::endl;
+
+    auto bb = dragged->boundingBox();
+    auto hits = index.query(bb);
+    EXPECT_NE(std::find(hits.begin(), hits.end(), dragged->id()), hits.end());
+    EXPECT_LT(avgMs, 1.0) << "Per-event index update should not rebuild the tree";
+}
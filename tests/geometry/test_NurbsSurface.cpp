@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <cmath>
+#include <iostream>
 
 #include "horizon/geometry/curves/NurbsCurve.h"
 #include "horizon/geometry/surfaces/NurbsSurface.h"
@@ -686,3 +688,143 @@ TEST(NurbsSurfaceTest, ConicalSurface) {
         EXPECT_NEAR(pt.z, height, 0.5);
     }
 }
+
+// ===========================================================================
+// Analytic evaluation
+// ===========================================================================
+
+namespace {
+
+/// The two-pass reference: rows as rational V-curves, combined in U with unit weights.
+Vec3 twoPassReference(const NurbsSurface& srf, double u, double v) {
+    std::vector<Vec3> rowPts;
+    for (int i = 0; i < srf.controlPointCountU(); ++i) {
+        NurbsCurve row(srf.controlPoints()[i], srf.weights()[i], srf.knotsV(), srf.degreeV());
+        rowPts.push_back(row.evaluate(v));
+    }
+    std::vector<double> unit(rowPts.size(), 1.0);
+    return NurbsCurve(rowPts, unit, srf.knotsU(), srf.degreeU()).evaluate(u);
+}
+
+/// A cubic-by-quadratic surface with interior knots and non-separable weights.
+NurbsSurface bumpySurface() {
+    std::vector<std::vector<Vec3>> pts(5, std::vector<Vec3>(4));
+    std::vector<std::vector<double>> wts(5, std::vector<double>(4));
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            pts[i][j] = {2.0 * i, 3.0 * j, std::sin(1.3 * i + 0.7 * j) * 2.0};
+            wts[i][j] = 1.0 + 0.4 * ((i * 3 + j * 5) % 4);
+        }
+    }
+    return NurbsSurface(pts, wts, {0, 0, 0, 0, 0.4, 1, 1, 1, 1}, {0, 0, 0, 0.3, 1, 1, 1}, 3, 2);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// 22. evaluate keeps the two-pass semantics, also above the stack-buffer degree
+// ---------------------------------------------------------------------------
+TEST(NurbsSurfaceTest, EvaluateMatchesTwoPassReference) {
+    const int highDegree = NurbsSurface::kMaxStackDegree + 1;
+    std::vector<std::vector<Vec3>> highPts(highDegree + 1, std::vector<Vec3>(2));
+    std::vector<std::vector<double>> highWts(highDegree + 1, std::vector<double>(2, 1.0));
+    for (int i = 0; i <= highDegree; ++i) {
+        highPts[i] = {{static_cast<double>(i), 0, std::cos(i)}, {static_cast<double>(i), 1, 0}};
+        highWts[i][1] = 1.0 + 0.1 * i;
+    }
+    const NurbsSurface surfaces[] = {
+        bumpySurface(),
+        NurbsSurface::makeSphere({1, 2, 3}, 3.0),
+        NurbsSurface::makeTorus({0, 0, 0}, {0, 1, 1}, 5.0, 2.0),
+        NurbsSurface(highPts, highWts, clampedKnots(highDegree + 1, highDegree),
+                     clampedKnots(2, 1), highDegree, 1),
+    };
+    for (const auto& srf : surfaces) {
+        for (int i = 0; i <= 12; ++i) {
+            const double u = srf.uMin() + (srf.uMax() - srf.uMin()) * i / 12.0;
+            for (int j = 0; j <= 12; ++j) {
+                const double v = srf.vMin() + (srf.vMax() - srf.vMin()) * j / 12.0;
+                EXPECT_NEAR(srf.evaluate(u, v).distanceTo(twoPassReference(srf, u, v)), 0.0,
+                            1e-10)
+                    << "u=" << u << " v=" << v;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 23. Analytic first and second derivatives agree with central differences
+// ---------------------------------------------------------------------------
+TEST(NurbsSurfaceTest, AnalyticDerivativesMatchFiniteDifferences) {
+    const NurbsSurface srf = bumpySurface();
+    const double h = 1e-5;
+    // Parameters away from the interior knots (0.4 in U, 0.3 in V) and the domain ends.
+    for (double u : {0.1, 0.25, 0.55, 0.9}) {
+        for (double v : {0.15, 0.5, 0.85}) {
+            const SurfaceDerivatives d = srf.evaluateWithDerivatives(u, v, 2);
+            const SurfaceDerivatives uPlus = srf.evaluateWithDerivatives(u + h, v);
+            const SurfaceDerivatives uMinus = srf.evaluateWithDerivatives(u - h, v);
+            const SurfaceDerivatives vPlus = srf.evaluateWithDerivatives(u, v + h);
+            const SurfaceDerivatives vMinus = srf.evaluateWithDerivatives(u, v - h);
+
+            const double scale = 1.0 / (2.0 * h);
+            EXPECT_NEAR(d.point.distanceTo(srf.evaluate(u, v)), 0.0, 1e-12);
+            EXPECT_NEAR(d.du.distanceTo((uPlus.point - uMinus.point) * scale), 0.0, 1e-5);
+            EXPECT_NEAR(d.dv.distanceTo((vPlus.point - vMinus.point) * scale), 0.0, 1e-5);
+            EXPECT_NEAR(d.duu.distanceTo((uPlus.du - uMinus.du) * scale), 0.0, 1e-4);
+            EXPECT_NEAR(d.duv.distanceTo((vPlus.du - vMinus.du) * scale), 0.0, 1e-4);
+            EXPECT_NEAR(d.duv.distanceTo((uPlus.dv - uMinus.dv) * scale), 0.0, 1e-4);
+            EXPECT_NEAR(d.dvv.distanceTo((vPlus.dv - vMinus.dv) * scale), 0.0, 1e-4);
+
+            // Lower orders leave the higher derivatives zero.
+            const SurfaceDerivatives first = srf.evaluateWithDerivatives(u, v, 1);
+            EXPECT_EQ(first.duu.length(), 0.0);
+            EXPECT_NEAR(first.du.distanceTo(d.du), 0.0, 1e-12);
+            EXPECT_EQ(srf.evaluateWithDerivatives(u, v, 0).du.length(), 0.0);
+        }
+    }
+
+    // Bilinear: the mixed derivative is the twist vector, the pure seconds vanish.
+    auto plane = NurbsSurface::makePlane({0, 0, 0}, {1, 0, 0}, {0, 1, 0}, 4.0, 2.0);
+    const SurfaceDerivatives p = plane.evaluateWithDerivatives(0.3, 0.6, 2);
+    EXPECT_NEAR(p.du.distanceTo({4, 0, 0}), 0.0, 1e-12);
+    EXPECT_NEAR(p.dv.distanceTo({0, 2, 0}), 0.0, 1e-12);
+    EXPECT_NEAR(p.duu.length() + p.duv.length() + p.dvv.length(), 0.0, 1e-12);
+}
+
+// ---------------------------------------------------------------------------
+// 24. closestPoint converges to a true foot point on a curved rational surface
+// ---------------------------------------------------------------------------
+TEST(NurbsSurfaceTest, ClosestPointIsFootPoint) {
+    const NurbsSurface srf = bumpySurface();
+    for (const Vec3 query : {Vec3{3.1, 4.2, 5.0}, Vec3{6.0, 2.0, -4.0}, Vec3{4.5, 5.5, 0.3}}) {
+        auto [u, v] = srf.closestPoint(query, 1e-12);
+        const SurfaceDerivatives d = srf.evaluateWithDerivatives(u, v);
+        const Vec3 diff = d.point - query;
+        // Interior minimum: the offset is perpendicular to both tangents.
+        ASSERT_GT(u, srf.uMin());
+        ASSERT_LT(u, srf.uMax());
+        EXPECT_NEAR(diff.dot(d.du) / d.du.length(), 0.0, 1e-8) << "query z=" << query.z;
+        EXPECT_NEAR(diff.dot(d.dv) / d.dv.length(), 0.0, 1e-8) << "query z=" << query.z;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 25. Tessellation evaluates each vertex once, without allocating
+// ---------------------------------------------------------------------------
+TEST(NurbsSurfacePerf, TessellateTorusAtFullResolution) {
+    auto torus = NurbsSurface::makeTorus({0, 0, 0}, {0, 0, 1}, 5.0, 2.0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto mesh = torus.tessellate(0.05);  // 201 x 201 vertices
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "[PERF] torus tessellation, " << mesh.positions.size() / 3
+              << " vertices: " << ms << " ms" << std::endl;
+    EXPECT_EQ(mesh.positions.size(), 201u * 201u * 3u);
+#ifdef NDEBUG
+    EXPECT_LT(ms, 40.0);
+#else
+    EXPECT_LT(ms, 400.0);
+#endif
+}
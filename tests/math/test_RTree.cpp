@@ -127,7 +127,9 @@ TEST(RTreeTest, DeepTreeMultiLevelSplits) {
     BoundingBox small(Vec3(100, -1, -1e9), Vec3(101.5, 2, 1e9));
     auto few = tree.query(small);
     EXPECT_EQ(few.size(), 1u);
-    if (!few.empty()) EXPECT_EQ(few[0], 50u);
+    if (!few.empty()) {
+        EXPECT_EQ(few[0], 50u);
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -185,3 +187,257 @@ TEST(RTreeTest, QueryAllReturnsEverything) {
     auto results = tree.query(everything);
     EXPECT_EQ(results.size(), 100u);
 }
+
+// ---------------------------------------------------------------------------
+// 13. Bulk load of an empty batch yields an empty, usable tree
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, BulkLoadEmpty) {
+    RTree<uint64_t> tree(std::vector<std::pair<uint64_t, BoundingBox>>{});
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.query(BoundingBox(Vec3(-1e9, -1e9, -1e9), Vec3(1e9, 1e9, 1e9))).empty());
+    tree.insert(7, BoundingBox(Vec3(0, 0, 0), Vec3(1, 1, 0)));
+    EXPECT_EQ(tree.size(), 1u);
+}
+
+// ---------------------------------------------------------------------------
+// 14. Bulk load answers queries exactly like incremental insertion
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, BulkLoadMatchesIncrementalQueries) {
+    std::vector<std::pair<uint64_t, BoundingBox>> items;
+    RTree<uint64_t, 4, 2> incremental;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        double x = static_cast<double>((i * 37) % 100) * 3.0;
+        double y = static_cast<double>((i * 11) % 97) * 3.0;
+        BoundingBox bb(Vec3(x, y, 0), Vec3(x + 1 + static_cast<double>(i % 5), y + 1, 0));
+        items.emplace_back(i, bb);
+        incremental.insert(i, bb);
+    }
+
+    RTree<uint64_t, 4, 2> packed(items);
+    EXPECT_EQ(packed.size(), 1000u);
+
+    for (double q = 0.0; q < 300.0; q += 23.0) {
+        BoundingBox window(Vec3(q, q * 0.5, -1e9), Vec3(q + 40.0, q * 0.5 + 25.0, 1e9));
+        auto a = packed.query(window);
+        auto b = incremental.query(window);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        EXPECT_EQ(a, b);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 15. Insert and remove keep working on a bulk-loaded tree
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, BulkLoadThenInsertAndRemove) {
+    std::vector<std::pair<uint64_t, BoundingBox>> items;
+    for (uint64_t i = 0; i < 100; ++i) {
+        double x = static_cast<double>(i) * 2.0;
+        items.emplace_back(i, BoundingBox(Vec3(x, 0, 0), Vec3(x + 1, 1, 0)));
+    }
+    RTree<uint64_t> tree;
+    tree.insert(999, BoundingBox(Vec3(-50, -50, 0), Vec3(-40, -40, 0)));
+    tree.bulkLoad(std::move(items));  // replaces previous contents
+    EXPECT_EQ(tree.size(), 100u);
+    EXPECT_TRUE(tree.query(BoundingBox(Vec3(-60, -60, -1e9), Vec3(-30, -30, 1e9))).empty());
+
+    tree.insert(500, BoundingBox(Vec3(1000, 0, 0), Vec3(1001, 1, 0)));
+    tree.remove(10);
+    EXPECT_EQ(tree.size(), 100u);
+
+    auto hits = tree.query(BoundingBox(Vec3(19.5, -1, -1e9), Vec3(20.5, 2, 1e9)));
+    EXPECT_TRUE(hits.empty());
+    hits = tree.query(BoundingBox(Vec3(999, -1, -1e9), Vec3(1002, 2, 1e9)));
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], 500u);
+}
+
+// ---------------------------------------------------------------------------
+// 16. Removing most entries condenses the tree and keeps queries exact
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, RemoveManyCondensesTree) {
+    RTree<uint64_t, 4, 2> tree;
+    for (uint64_t i = 0; i < 400; ++i) {
+        double x = static_cast<double>(i % 20) * 2.0;
+        double y = static_cast<double>(i / 20) * 2.0;
+        tree.insert(i, BoundingBox(Vec3(x, y, 0), Vec3(x + 1, y + 1, 0)));
+    }
+    // Remove every entry except multiples of 7.
+    for (uint64_t i = 0; i < 400; ++i) {
+        if (i % 7 != 0) {
+            EXPECT_TRUE(tree.remove(i));
+        }
+    }
+    EXPECT_FALSE(tree.remove(1));  // already gone
+    EXPECT_EQ(tree.size(), 58u);
+
+    auto all = tree.query(BoundingBox(Vec3(-1, -1, -1e9), Vec3(100, 100, 1e9)));
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), 58u);
+    for (size_t k = 0; k < all.size(); ++k) {
+        EXPECT_EQ(all[k], static_cast<uint64_t>(k * 7));
+        EXPECT_TRUE(tree.contains(all[k]));
+    }
+    EXPECT_FALSE(tree.contains(3));
+
+    // Drain completely, then make sure the tree is reusable.
+    for (uint64_t v : all) tree.remove(v);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.query(BoundingBox(Vec3(-1, -1, -1e9), Vec3(100, 100, 1e9))).empty());
+    tree.insert(1, BoundingBox(Vec3(0, 0, 0), Vec3(1, 1, 0)));
+    EXPECT_EQ(tree.query(BoundingBox(Vec3(0, 0, -1e9), Vec3(1, 1, 1e9))).size(), 1u);
+}
+
+// ---------------------------------------------------------------------------
+// 17. Update moves an entry, both within its leaf and across the tree
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, UpdateInPlaceAndRelocate) {
+    RTree<uint64_t, 4, 2> tree;
+    for (uint64_t i = 0; i < 100; ++i) {
+        double x = static_cast<double>(i) * 3.0;
+        tree.insert(i, BoundingBox(Vec3(x, 0, 0), Vec3(x + 2, 2, 0)));
+    }
+
+    // Shrink entry 10 within its own box: stays findable, size unchanged.
+    EXPECT_TRUE(tree.update(10, BoundingBox(Vec3(30.5, 0.5, 0), Vec3(31, 1, 0))));
+    auto hits = tree.query(BoundingBox(Vec3(30.4, 0.4, -1e9), Vec3(31.1, 1.1, 1e9)));
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], 10u);
+    EXPECT_TRUE(tree.query(BoundingBox(Vec3(31.5, 1.5, -1e9), Vec3(32, 2, 1e9))).empty());
+
+    // Move entry 20 far away: old location empty, new location hit.
+    EXPECT_TRUE(tree.update(20, BoundingBox(Vec3(1000, 1000, 0), Vec3(1001, 1001, 0))));
+    EXPECT_TRUE(tree.query(BoundingBox(Vec3(60.5, 0.5, -1e9), Vec3(61, 1, 1e9))).empty());
+    hits = tree.query(BoundingBox(Vec3(999, 999, -1e9), Vec3(1002, 1002, 1e9)));
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], 20u);
+
+    EXPECT_FALSE(tree.update(12345, BoundingBox(Vec3(0, 0, 0), Vec3(1, 1, 0))));
+    EXPECT_EQ(tree.size(), 100u);
+}
+
+// ---------------------------------------------------------------------------
+// 18. k-nearest by box distance matches a brute-force ranking
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, NearestMatchesBruteForce) {
+    RTree<uint64_t, 4, 2> tree;
+    std::vector<BoundingBox> boxes;
+    for (uint64_t i = 0; i < 300; ++i) {
+        double x = static_cast<double>((i * 53) % 211);
+        double y = static_cast<double>((i * 29) % 173);
+        boxes.emplace_back(Vec3(x, y, 0), Vec3(x + 0.5, y + 0.5, 0));
+        tree.insert(i, boxes.back());
+    }
+
+    const Vec2 p(100.2, 80.7);
+    auto result = tree.nearest(p, 5);
+    ASSERT_EQ(result.size(), 5u);
+
+    std::vector<double> dists;
+    for (const auto& bb : boxes) dists.push_back(RTree<uint64_t>::boxDistance(p, bb));
+    std::sort(dists.begin(), dists.end());
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_DOUBLE_EQ(result[i].distance, dists[i]);
+        const auto& bb = boxes[result[i].value];
+        EXPECT_DOUBLE_EQ(result[i].distance, RTree<uint64_t>::boxDistance(p, bb));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 19. Nearest honours maxDist and a custom distance callback
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, NearestWithCallbackAndMaxDist) {
+    RTree<uint64_t> tree;
+    // Two overlapping boxes; the callback says value 2 is closer even though
+    // both boxes contain the query point.
+    tree.insert(1, BoundingBox(Vec3(0, 0, 0), Vec3(10, 10, 0)));
+    tree.insert(2, BoundingBox(Vec3(4, 4, 0), Vec3(6, 6, 0)));
+    tree.insert(3, BoundingBox(Vec3(50, 50, 0), Vec3(51, 51, 0)));
+
+    int calls = 0;
+    auto dist = [&calls](const uint64_t& v, const BoundingBox&) {
+        ++calls;
+        return v == 2 ? 0.5 : (v == 1 ? 3.0 : 1.0);
+    };
+    auto result = tree.nearest(Vec2(5, 5), 2, 10.0, dist);
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].value, 2u);
+    EXPECT_EQ(result[1].value, 1u);
+    // Value 3's box is ~64 units away: pruned without calling the callback.
+    EXPECT_EQ(calls, 2);
+
+    EXPECT_TRUE(tree.nearest(Vec2(30, 30), 3, 5.0).empty());
+    EXPECT_TRUE(RTree<uint64_t>().nearest(Vec2(0, 0), 3).empty());
+}
+
+// ---------------------------------------------------------------------------
+// 20. Visitor query sees the same hits and can stop early
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, VisitorQueryWithEarlyTermination) {
+    RTree<uint64_t, 4, 2> tree;
+    for (uint64_t i = 0; i < 200; ++i) {
+        double x = static_cast<double>(i % 20) * 2.0;
+        double y = static_cast<double>(i / 20) * 2.0;
+        tree.insert(i, BoundingBox(Vec3(x, y, 0), Vec3(x + 1, y + 1, 0)));
+    }
+    const BoundingBox search(Vec3(5, 5, 0), Vec3(15, 15, 0));
+
+    std::vector<uint64_t> visited;
+    EXPECT_TRUE(tree.query(search, [&visited](uint64_t v) { visited.push_back(v); }));
+    auto expected = tree.query(search);
+    std::sort(visited.begin(), visited.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(visited, expected);
+    ASSERT_GT(expected.size(), 3u);
+
+    int calls = 0;
+    EXPECT_FALSE(tree.query(search, [&calls](uint64_t) { return ++calls < 3; }));
+    EXPECT_EQ(calls, 3);
+}
+
+// ---------------------------------------------------------------------------
+// 21. Buffer query clears and reuses the caller's vector
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, BufferQueryReusesCapacity) {
+    RTree<uint64_t> tree;
+    for (uint64_t i = 0; i < 100; ++i) {
+        double x = static_cast<double>(i);
+        tree.insert(i, BoundingBox(Vec3(x, 0, 0), Vec3(x + 0.5, 1, 0)));
+    }
+
+    std::vector<uint64_t> buffer{999, 998};
+    tree.query(BoundingBox(Vec3(-1, -1, 0), Vec3(200, 2, 0)), buffer);
+    EXPECT_EQ(buffer.size(), 100u);
+    const auto* data = buffer.data();
+
+    tree.query(BoundingBox(Vec3(9.9, 0, 0), Vec3(10.1, 1, 0)), buffer);
+    ASSERT_EQ(buffer.size(), 1u);
+    EXPECT_EQ(buffer[0], 10u);
+    EXPECT_EQ(buffer.data(), data);  // no reallocation
+
+    tree.query(BoundingBox(Vec3(500, 500, 0), Vec3(501, 501, 0)), buffer);
+    EXPECT_TRUE(buffer.empty());
+}
+
+// ---------------------------------------------------------------------------
+// 22. 2D tree ignores z; RTree3D discriminates on it
+// ---------------------------------------------------------------------------
+TEST(RTreeTest, ThreeDimensionalVariantSeparatesZ) {
+    RTree<uint64_t> flat;
+    RTree3D<uint64_t> solid;
+    for (uint64_t i = 0; i < 50; ++i) {
+        double z = static_cast<double>(i) * 10.0;
+        BoundingBox bb(Vec3(0, 0, z), Vec3(1, 1, z + 1));
+        flat.insert(i, bb);
+        solid.insert(i, bb);
+    }
+    const BoundingBox search(Vec3(0.5, 0.5, 100.5), Vec3(0.6, 0.6, 100.6));
+    EXPECT_EQ(flat.query(search).size(), 50u);
+    auto hits = solid.query(search);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], 10u);
+
+    EXPECT_TRUE(solid.update(10, BoundingBox(Vec3(0, 0, 1000), Vec3(1, 1, 1001))));
+    EXPECT_TRUE(solid.query(search).empty());
+    EXPECT_EQ(solid.size(), 50u);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "horizon/render/SelectionManager.h"
+
+using namespace hz::render;
+
+TEST(SelectionManagerTest, MatchesReferenceSetUnderRandomEdits) {
+    SelectionManager sel;
+    std::set<uint64_t> reference;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<uint64_t> idDist(0, 3000);
+    std::uniform_int_distribution<int> opDist(0, 9);
+
+    for (int step = 0; step < 20000; ++step) {
+        uint64_t id = idDist(rng);
+        int op = opDist(rng);
+        if (op < 5) {
+            sel.select(id);
+            reference.insert(id);
+        } else if (op < 8) {
+            sel.deselect(id);
+            reference.erase(id);
+        } else if (op < 9) {
+            sel.toggle(id);
+            if (!reference.erase(id)) reference.insert(id);
+        } else if (step % 500 == 0) {
+            sel.clearSelection();
+            reference.clear();
+        }
+    }
+
+    EXPECT_EQ(sel.count(), reference.size());
+    for (uint64_t id = 0; id <= 3000; ++id) {
+        EXPECT_EQ(sel.isSelected(id), reference.count(id) == 1) << id;
+    }
+    const auto& ids = sel.selectedIds();
+    EXPECT_TRUE(std::equal(ids.begin(), ids.end(), reference.begin(), reference.end()));
+}
+
+TEST(SelectionManagerTest, GenerationAdvancesOnlyOnChange) {
+    SelectionManager sel;
+    uint64_t g = sel.generation();
+
+    sel.select(5);
+    EXPECT_GT(sel.generation(), g);
+    g = sel.generation();
+
+    sel.select(5);    // already selected
+    sel.deselect(6);  // not selected
+    sel.clearSelection();
+    EXPECT_GT(sel.generation(), g);
+    g = sel.generation();
+    sel.clearSelection();  // already empty
+    EXPECT_EQ(sel.generation(), g);
+}
+
+TEST(SelectionManagerTest, BulkSelectAndDeselect) {
+    SelectionManager sel;
+    std::vector<uint64_t> ids(100000);
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = i + 1;
+
+    uint64_t g = sel.generation();
+    sel.select(ids);
+    EXPECT_EQ(sel.generation(), g + 1);
+    EXPECT_EQ(sel.count(), ids.size());
+    EXPECT_TRUE(sel.isSelected(50000));
+    EXPECT_FALSE(sel.isSelected(100001));
+
+    std::vector<uint64_t> evens;
+    for (uint64_t id : ids) {
+        if (id % 2 == 0) evens.push_back(id);
+    }
+    sel.deselect(evens);
+    EXPECT_EQ(sel.generation(), g + 2);
+    EXPECT_EQ(sel.count(), ids.size() / 2);
+    EXPECT_TRUE(sel.isSelected(1));
+    EXPECT_FALSE(sel.isSelected(2));
+    EXPECT_EQ(sel.selectedIds().front(), 1u);
+    EXPECT_EQ(sel.selectedIds().back(), 99999u);
+}
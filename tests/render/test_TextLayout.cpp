@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "horizon/render/GlyphAtlas.h"
+#include "horizon/render/TextLayout.h"
+
+using namespace hz::render;
+
+namespace {
+
+/// Every glyph is a solid box whose width depends on the code point; space is blank.
+struct BoxRasterizer {
+    int* calls;
+    GlyphBitmap operator()(char32_t cp) const {
+        ++*calls;
+        GlyphBitmap g;
+        g.advance = 10.0f;
+        if (cp == U' ') return g;
+        g.width = 4 + static_cast<int>(cp % 5);
+        g.height = 12;
+        g.left = 1.0f;
+        g.top = 12.0f;
+        g.coverage.assign(static_cast<size_t>(g.width) * g.height, 255);
+        return g;
+    }
+};
+
+}  // namespace
+
+TEST(TextLayoutTest, LayoutsAreCachedAndGlyphsRasterizedOnce) {
+    int calls = 0;
+    GlyphAtlas atlas(BoxRasterizer{&calls}, 16.0f, 12.0f);
+    TextLayoutCache cache(atlas);
+
+    const TextLayout& a = cache.layout("12.50 mm");
+    EXPECT_EQ(calls, 7);  // '1', '2', '.', '5', '0', ' ', 'm'
+    EXPECT_FLOAT_EQ(a.width, 80.0f);
+    EXPECT_EQ(a.glyphs.size(), 7u);  // the space has no quad
+    EXPECT_FLOAT_EQ(a.glyphs[1].x0, 10.0f + 1.0f - GlyphAtlas::kSpread);
+    EXPECT_FLOAT_EQ(a.glyphs[1].x1 - a.glyphs[1].x0,
+                    static_cast<float>(4 + '2' % 5 + 2 * GlyphAtlas::kSpread));
+
+    EXPECT_EQ(&cache.layout("12.50 mm"), &a);
+    cache.layout("250");
+    EXPECT_EQ(calls, 7);
+    EXPECT_EQ(cache.size(), 2u);
+
+    // Multi-byte UTF-8 decodes to a single glyph.
+    EXPECT_EQ(cache.layout("45.0\xC2\xB0").glyphs.size(), 5u);
+    EXPECT_EQ(calls, 9);  // '4' and U+00B0
+}
+
+TEST(TextLayoutTest, DistanceFieldMarksTheOutline) {
+    std::vector<uint8_t> box(10 * 10, 255);
+    auto field = coverageToDistanceField(box, 10, 10, 4);
+    ASSERT_EQ(field.size(), 18u * 18u);
+    auto at = [&](int x, int y) { return field[static_cast<size_t>(y) * 18 + x]; };
+
+    EXPECT_EQ(at(0, 0), 0);      // far outside
+    EXPECT_EQ(at(9, 9), 255);    // deep inside
+    EXPECT_GT(at(4, 9), 128);    // first inside column
+    EXPECT_LT(at(3, 9), 128);    // last outside column
+    EXPECT_GT(at(5, 9), at(4, 9));
+    EXPECT_LT(at(2, 9), at(3, 9));
+}
+
+TEST(TextLayoutTest, AtlasGrowthKeepsEarlierGlyphs) {
+    int calls = 0;
+    GlyphAtlas atlas(BoxRasterizer{&calls}, 16.0f, 12.0f, 48, 1024);
+    TextLayoutCache cache(atlas);
+
+    const Glyph first = atlas.glyph(U'A');
+    const uint64_t generation = atlas.generation();
+    std::string many;
+    for (char32_t c = U'a'; c <= U'z'; ++c) many.push_back(static_cast<char>(c));
+    cache.layout(many);
+
+    EXPECT_GT(atlas.height(), 256);
+    EXPECT_EQ(atlas.generation(), generation);
+    const Glyph& again = atlas.glyph(U'A');
+    EXPECT_EQ(again.u0, first.u0);
+    EXPECT_EQ(again.v0, first.v0);
+    const auto centre = static_cast<size_t>((first.v0 + 9) * 48 + first.u0 + 8);
+    EXPECT_GT(atlas.pixels()[centre], 128);
+
+    // Past the maximum height the atlas starts over and stale layouts are rebuilt.
+    GlyphAtlas small(BoxRasterizer{&calls}, 16.0f, 12.0f, 32, 64);
+    TextLayoutCache smallCache(small);
+    const TextLayout& ab = smallCache.layout("AB");
+    const uint64_t before = small.generation();
+    smallCache.layout("CDEFGH");
+    EXPECT_GT(small.generation(), before);
+    const TextLayout& rebuilt = smallCache.layout("AB");
+    EXPECT_EQ(rebuilt.atlasGeneration, small.generation());
+    EXPECT_EQ(&rebuilt, &ab);
+    EXPECT_EQ(rebuilt.glyphs.size(), 2u);
+}
+
+TEST(TextLayoutTest, PlacementAlignsAndRotates) {
+    int calls = 0;
+    GlyphAtlas atlas(BoxRasterizer{&calls}, 16.0f, 12.0f);
+    TextLayoutCache cache(atlas);
+    const TextLayout& layout = cache.layout("AA");
+
+    std::vector<float> verts;
+    TextPlacement right;
+    right.x = 100.0f;
+    right.y = 50.0f;
+    right.pixelSize = 32.0f;  // twice the atlas size
+    right.alignment = 2;
+    appendTextVertices(layout, atlas, right, verts);
+    ASSERT_EQ(verts.size(), 2 * 6 * kTextVertexFloats);
+    // Second glyph's right edge: (10 + 1 + w + spread - 20) * 2 left of the anchor.
+    const float w = static_cast<float>(4 + 'A' % 5);
+    EXPECT_FLOAT_EQ(verts[6 * kTextVertexFloats + 1 * kTextVertexFloats],
+                    100.0f + 2.0f * (11.0f + w + GlyphAtlas::kSpread - 20.0f));
+    // Baseline a quarter ascent below the anchor (screen y grows down).
+    const float y0 = 12.0f - 12.0f - GlyphAtlas::kSpread - 3.0f;
+    EXPECT_FLOAT_EQ(verts[1], 50.0f - 2.0f * y0);
+
+    // A quarter turn maps the layout's +x onto screen up.
+    verts.clear();
+    TextPlacement up;
+    up.pixelSize = 16.0f;
+    up.alignment = 0;
+    up.rotation = 1.5707963267948966f;
+    appendTextVertices(layout, atlas, up, verts);
+    const float* v0 = &verts[0];
+    const float* v1 = &verts[kTextVertexFloats];  // same y in layout, larger x
+    EXPECT_NEAR(v1[0], v0[0], 1e-4);
+    EXPECT_LT(v1[1], v0[1]);
+}